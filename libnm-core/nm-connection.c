@@ -48,7 +48,13 @@ static guint signals[LAST_SIGNAL] = { 0 };
 typedef struct {
 	NMConnection *self;
 
-	GHashTable *settings;
+	/* the settings, indexed by NMMetaSettingType. */
+	NMSetting *settings[_NM_META_SETTING_TYPE_NUM];
+	guint n_settings;
+
+	/* if set, the settings are not yet loaded. It gets invoked (once)
+	 * before the settings are accessed the first time. */
+	NMConnectionLoadSettingsFcn load_settings_fcn;
 
 	/* D-Bus path of the connection, if any */
 	char *path;
@@ -59,20 +65,85 @@ G_DEFINE_INTERFACE (NMConnection, nm_connection, G_TYPE_OBJECT)
 static NMConnectionPrivate *nm_connection_get_private (NMConnection *connection);
 #define NM_CONNECTION_GET_PRIVATE(o) (nm_connection_get_private ((NMConnection *)o))
 
+static NMConnectionPrivate *
+_connection_get_private_loaded (NMConnection *connection)
+{
+	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
+
+	if (G_UNLIKELY (priv->load_settings_fcn)) {
+		NMConnectionLoadSettingsFcn load_settings_fcn = g_steal_pointer (&priv->load_settings_fcn);
+
+		load_settings_fcn (connection);
+	}
+	return priv;
+}
+
+#define NM_CONNECTION_GET_PRIVATE_LOADED(o) (_connection_get_private_loaded ((NMConnection *)o))
+
 /*****************************************************************************/
 
-static gpointer
-_gtype_to_hash_key (GType gtype)
+static int
+_meta_type_cmp_priority (gconstpointer p_a, gconstpointer p_b, gpointer user_data)
 {
-#if NM_MORE_ASSERTS
-	_nm_unused const gsize *const test_gtype_typedef = &gtype;
+	const NMMetaSettingType a = *((const NMMetaSettingType *) p_a);
+	const NMMetaSettingType b = *((const NMMetaSettingType *) p_b);
 
-	nm_assert ((GType) (GPOINTER_TO_SIZE (GSIZE_TO_POINTER (gtype))) == gtype);
-	G_STATIC_ASSERT_EXPR (sizeof (gpointer) >= sizeof (gsize));
-	G_STATIC_ASSERT_EXPR (sizeof (gsize) == sizeof (GType));
-#endif
+	/* same order as _get_settings_sort(). The meta types are already
+	 * sorted by setting name. */
+	NM_CMP_DIRECT (nm_meta_setting_infos[a].setting_priority, nm_meta_setting_infos[b].setting_priority);
+	NM_CMP_DIRECT (a, b);
+	return 0;
+}
+
+/* the setting types in the order in which we iterate over the settings
+ * of a connection: by priority, then by name. */
+static const NMMetaSettingType *
+_meta_types_by_priority (void)
+{
+	static NMMetaSettingType arr[_NM_META_SETTING_TYPE_NUM];
+	static gsize initialized = 0;
+
+	if (g_once_init_enter (&initialized)) {
+		NMMetaSettingType i;
+
+		for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++)
+			arr[i] = i;
+		g_qsort_with_data (arr,
+		                   _NM_META_SETTING_TYPE_NUM,
+		                   sizeof (arr[0]),
+		                   _meta_type_cmp_priority,
+		                   NULL);
+		g_once_init_leave (&initialized, 1);
+	}
+	return arr;
+}
+
+/* iterate over the settings of @priv in priority order. Start with
+ * *@p_idx at zero. */
+static NMSetting *
+_settings_iter_next (NMConnectionPrivate *priv, guint *p_idx)
+{
+	const NMMetaSettingType *by_priority = _meta_types_by_priority ();
+	NMSetting *setting;
+
+	while (*p_idx < _NM_META_SETTING_TYPE_NUM) {
+		setting = priv->settings[by_priority[(*p_idx)++]];
+		if (setting)
+			return setting;
+	}
+	return NULL;
+}
+
+static NMMetaSettingType
+_setting_get_meta_type (NMSetting *setting)
+{
+	const NMMetaSettingInfo *setting_info = NM_SETTING_GET_CLASS (setting)->setting_info;
+
+	nm_assert (setting_info);
+	nm_assert (setting_info->meta_type < _NM_META_SETTING_TYPE_NUM);
+	nm_assert (setting_info->get_setting_gtype () == G_OBJECT_TYPE (setting));
 
-	return GSIZE_TO_POINTER (gtype);
+	return setting_info->meta_type;
 }
 
 /*****************************************************************************/
@@ -92,9 +163,25 @@ _setting_release (NMConnection *connection, NMSetting *setting)
 }
 
 static gboolean
-_setting_release_hfr (gpointer key, gpointer value, gpointer user_data)
+_settings_clear (NMConnection *connection, NMConnectionPrivate *priv)
 {
-	_setting_release (user_data, value);
+	NMMetaSettingType i;
+	NMSetting *setting;
+
+	/* the content gets replaced. No need to load it anymore. */
+	priv->load_settings_fcn = NULL;
+
+	if (priv->n_settings == 0)
+		return FALSE;
+
+	for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++) {
+		setting = g_steal_pointer (&priv->settings[i]);
+		if (setting) {
+			_setting_release (connection, setting);
+			g_object_unref (setting);
+		}
+	}
+	priv->n_settings = 0;
 	return TRUE;
 }
 
@@ -102,19 +189,29 @@ static void
 _nm_connection_add_setting (NMConnection *connection, NMSetting *setting)
 {
 	NMConnectionPrivate *priv;
-	GType setting_type;
+	NMMetaSettingType meta_type;
 	NMSetting *s_old;
 
 	nm_assert (NM_IS_CONNECTION (connection));
 	nm_assert (NM_IS_SETTING (setting));
 
-	priv = NM_CONNECTION_GET_PRIVATE (connection);
-	setting_type = G_OBJECT_TYPE (setting);
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
+	meta_type = _setting_get_meta_type (setting);
 
-	if ((s_old = g_hash_table_lookup (priv->settings, _gtype_to_hash_key (setting_type))))
+	s_old = priv->settings[meta_type];
+	if (s_old == setting) {
+		/* the setting is already added and we took another reference. */
+		g_object_unref (setting);
+		return;
+	}
+
+	if (s_old) {
 		_setting_release (connection, s_old);
+		g_object_unref (s_old);
+	} else
+		priv->n_settings++;
 
-	g_hash_table_insert (priv->settings, _gtype_to_hash_key (setting_type), setting);
+	priv->settings[meta_type] = setting;
 
 	g_signal_connect (setting, "notify", (GCallback) setting_changed_cb, connection);
 }
@@ -134,6 +231,7 @@ nm_connection_add_setting (NMConnection *connection, NMSetting *setting)
 {
 	g_return_if_fail (NM_IS_CONNECTION (connection));
 	g_return_if_fail (NM_IS_SETTING (setting));
+	g_return_if_fail (NM_SETTING_GET_CLASS (setting)->setting_info);
 
 	_nm_connection_add_setting (connection, setting);
 	g_signal_emit (connection, signals[CHANGED], 0);
@@ -143,16 +241,22 @@ gboolean
 _nm_connection_remove_setting (NMConnection *connection, GType setting_type)
 {
 	NMConnectionPrivate *priv;
+	const NMMetaSettingInfo *setting_info;
 	NMSetting *setting;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
 	g_return_val_if_fail (g_type_is_a (setting_type, NM_TYPE_SETTING), FALSE);
 
-	priv = NM_CONNECTION_GET_PRIVATE (connection);
-	setting = g_hash_table_lookup (priv->settings, _gtype_to_hash_key (setting_type));
+	setting_info = nm_meta_setting_infos_by_gtype (setting_type);
+	if (!setting_info)
+		return FALSE;
+
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
+	setting = g_steal_pointer (&priv->settings[setting_info->meta_type]);
 	if (setting) {
+		priv->n_settings--;
 		g_signal_handlers_disconnect_by_func (setting, setting_changed_cb, connection);
-		g_hash_table_remove (priv->settings, _gtype_to_hash_key (setting_type));
+		g_object_unref (setting);
 		g_signal_emit (connection, signals[CHANGED], 0);
 		return TRUE;
 	}
@@ -174,19 +278,40 @@ nm_connection_remove_setting (NMConnection *connection, GType setting_type)
 }
 
 static gpointer
-_connection_get_setting (NMConnection *connection, GType setting_type)
+_connection_get_setting_by_meta_type (NMConnection *connection, NMMetaSettingType meta_type)
 {
 	NMSetting *setting;
 
 	nm_assert (NM_IS_CONNECTION (connection));
-	nm_assert (g_type_is_a (setting_type, NM_TYPE_SETTING));
+	nm_assert (meta_type < _NM_META_SETTING_TYPE_NUM);
 
-	setting = g_hash_table_lookup (NM_CONNECTION_GET_PRIVATE (connection)->settings,
-	                               _gtype_to_hash_key (setting_type));
-	nm_assert (!setting || G_TYPE_CHECK_INSTANCE_TYPE (setting, setting_type));
+	setting = NM_CONNECTION_GET_PRIVATE_LOADED (connection)->settings[meta_type];
+	nm_assert (!setting || G_OBJECT_TYPE (setting) == nm_meta_setting_infos[meta_type].get_setting_gtype ());
 	return setting;
 }
 
+static gpointer
+_connection_get_setting_by_meta_type_check (NMConnection *connection, NMMetaSettingType meta_type)
+{
+	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
+
+	return _connection_get_setting_by_meta_type (connection, meta_type);
+}
+
+static gpointer
+_connection_get_setting (NMConnection *connection, GType setting_type)
+{
+	const NMMetaSettingInfo *setting_info;
+
+	nm_assert (NM_IS_CONNECTION (connection));
+	nm_assert (g_type_is_a (setting_type, NM_TYPE_SETTING));
+
+	setting_info = nm_meta_setting_infos_by_gtype (setting_type);
+	if (!setting_info)
+		return NULL;
+	return _connection_get_setting_by_meta_type (connection, setting_info->meta_type);
+}
+
 static gpointer
 _connection_get_setting_check (NMConnection *connection, GType setting_type)
 {
@@ -220,10 +345,10 @@ nm_connection_get_setting_ip_config (NMConnection *connection,
 {
 	nm_assert_addr_family (addr_family);
 
-	return NM_SETTING_IP_CONFIG (_connection_get_setting (connection,
-	                                                        (addr_family == AF_INET)
-	                                                      ? NM_TYPE_SETTING_IP4_CONFIG
-	                                                      : NM_TYPE_SETTING_IP6_CONFIG));
+	return NM_SETTING_IP_CONFIG (_connection_get_setting_by_meta_type (connection,
+	                                                                     (addr_family == AF_INET)
+	                                                                   ? NM_META_SETTING_TYPE_IP4_CONFIG
+	                                                                   : NM_META_SETTING_TYPE_IP6_CONFIG));
 }
 
 /**
@@ -240,12 +365,12 @@ nm_connection_get_setting_ip_config (NMConnection *connection,
 NMSetting *
 nm_connection_get_setting_by_name (NMConnection *connection, const char *name)
 {
-	GType type;
+	const NMMetaSettingInfo *setting_info;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 
-	type = nm_setting_lookup_type (name);
-	return type ? _connection_get_setting (connection, type) : NULL;
+	setting_info = nm_meta_setting_infos_by_name (name);
+	return setting_info ? _connection_get_setting_by_meta_type (connection, setting_info->meta_type) : NULL;
 }
 
 /*****************************************************************************/
@@ -410,10 +535,9 @@ _nm_connection_replace_settings (NMConnection *connection,
 		settings = g_slist_prepend (settings, setting);
 	}
 
-	if (g_hash_table_size (priv->settings) > 0) {
-		g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, connection);
+	if (_settings_clear (connection, priv))
 		changed = TRUE;
-	} else
+	else
 		changed = (settings != NULL);
 
 	/* Note: @settings might be empty in which case the connection
@@ -475,7 +599,7 @@ nm_connection_replace_settings_from_connection (NMConnection *connection,
                                                 NMConnection *new_connection)
 {
 	NMConnectionPrivate *priv, *new_priv;
-	GHashTableIter iter;
+	NMMetaSettingType i;
 	NMSetting *setting;
 	gboolean changed;
 
@@ -493,15 +617,16 @@ nm_connection_replace_settings_from_connection (NMConnection *connection,
 	 */
 
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
-	new_priv = NM_CONNECTION_GET_PRIVATE (new_connection);
+	new_priv = NM_CONNECTION_GET_PRIVATE_LOADED (new_connection);
 
-	if ((changed = g_hash_table_size (priv->settings) > 0))
-		g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, connection);
+	changed = _settings_clear (connection, priv);
 
-	if (g_hash_table_size (new_priv->settings)) {
-		g_hash_table_iter_init (&iter, new_priv->settings);
-		while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting))
-			_nm_connection_add_setting (connection, nm_setting_duplicate (setting));
+	if (new_priv->n_settings > 0) {
+		for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++) {
+			setting = new_priv->settings[i];
+			if (setting)
+				_nm_connection_add_setting (connection, nm_setting_duplicate (setting));
+		}
 		changed = TRUE;
 	}
 
@@ -524,10 +649,8 @@ nm_connection_clear_settings (NMConnection *connection)
 
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
 
-	if (g_hash_table_size (priv->settings) > 0) {
-		g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, connection);
+	if (_settings_clear (connection, priv))
 		g_signal_emit (connection, signals[CHANGED], 0);
-	}
 }
 
 /**
@@ -547,24 +670,32 @@ nm_connection_compare (NMConnection *a,
                        NMConnection *b,
                        NMSettingCompareFlags flags)
 {
-	GHashTableIter iter;
-	NMSetting *src;
+	NMConnectionPrivate *a_priv;
+	NMConnectionPrivate *b_priv;
+	NMMetaSettingType i;
 
 	if (a == b)
 		return TRUE;
 	if (!a || !b)
 		return FALSE;
 
+	a_priv = NM_CONNECTION_GET_PRIVATE_LOADED (a);
+	b_priv = NM_CONNECTION_GET_PRIVATE_LOADED (b);
+
 	/* B / A: ensure settings in B that are not in A make the comparison fail */
-	if (g_hash_table_size (NM_CONNECTION_GET_PRIVATE (a)->settings) !=
-	    g_hash_table_size (NM_CONNECTION_GET_PRIVATE (b)->settings))
+	if (a_priv->n_settings != b_priv->n_settings)
 		return FALSE;
 
 	/* A / B: ensure all settings in A match corresponding ones in B */
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (a)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &src)) {
-		NMSetting *cmp = nm_connection_get_setting (b, G_OBJECT_TYPE (src));
+	for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++) {
+		NMSetting *src = a_priv->settings[i];
+		NMSetting *cmp = b_priv->settings[i];
 
+		if (!src) {
+			if (cmp)
+				return FALSE;
+			continue;
+		}
 		if (   !cmp
 		    || !_nm_setting_compare (a, src, b, cmp, flags))
 			return FALSE;
@@ -580,20 +711,23 @@ diff_one_connection (NMConnection *a,
                      gboolean invert_results,
                      GHashTable *diffs)
 {
-	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (a);
-	GHashTableIter iter;
-	NMSetting *a_setting = NULL;
+	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE_LOADED (a);
+	NMConnectionPrivate *b_priv = b ? NM_CONNECTION_GET_PRIVATE_LOADED (b) : NULL;
+	NMMetaSettingType i;
 	gboolean diff_found = FALSE;
 
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &a_setting)) {
-		NMSetting *b_setting = NULL;
-		const char *setting_name = nm_setting_get_name (a_setting);
+	for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++) {
+		NMSetting *a_setting = priv->settings[i];
+		NMSetting *b_setting;
+		const char *setting_name;
 		GHashTable *results;
 		gboolean new_results = TRUE;
 
-		if (b)
-			b_setting = nm_connection_get_setting (b, G_OBJECT_TYPE (a_setting));
+		if (!a_setting)
+			continue;
+
+		setting_name = nm_setting_get_name (a_setting);
+		b_setting = b_priv ? b_priv->settings[i] : NULL;
 
 		results = g_hash_table_lookup (diffs, setting_name);
 		if (results)
@@ -668,15 +802,14 @@ nm_connection_diff (NMConnection *a,
 NMSetting *
 _nm_connection_find_base_type_setting (NMConnection *connection)
 {
-	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
-	GHashTableIter iter;
+	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
 	NMSetting *setting = NULL;
 	NMSetting *s_iter;
 	NMSettingPriority setting_prio = NM_SETTING_PRIORITY_USER;
 	NMSettingPriority s_iter_prio;
+	guint idx = 0;
 
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &s_iter)) {
+	while ((s_iter = _settings_iter_next (priv, &idx))) {
 		s_iter_prio = _nm_setting_get_base_type_priority (s_iter);
 		if (s_iter_prio == NM_SETTING_PRIORITY_INVALID)
 			continue;
@@ -774,13 +907,12 @@ _nm_connection_detect_bluetooth_type (NMConnection *self)
 const char *
 _nm_connection_detect_slave_type (NMConnection *connection, NMSetting **out_s_port)
 {
-	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
-	GHashTableIter iter;
+	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
 	const char *slave_type = NULL;
 	NMSetting *s_port = NULL, *s_iter;
+	guint idx = 0;
 
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &s_iter)) {
+	while ((s_iter = _settings_iter_next (priv, &idx))) {
 		const char *name = nm_setting_get_name (s_iter);
 		const char *i_slave_type = NULL;
 
@@ -1567,14 +1699,15 @@ _nm_connection_verify (NMConnection *connection, GError **error)
 gboolean
 nm_connection_verify_secrets (NMConnection *connection, GError **error)
 {
-	GHashTableIter iter;
+	NMConnectionPrivate *priv;
 	NMSetting *setting;
+	guint idx = 0;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
 	g_return_val_if_fail (!error || !*error, FALSE);
 
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (connection)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
+	while ((setting = _settings_iter_next (priv, &idx))) {
 		if (!nm_setting_verify_secrets (setting, connection, error))
 			return FALSE;
 	}
@@ -1997,27 +2130,19 @@ nm_connection_need_secrets (NMConnection *connection,
                             GPtrArray **hints)
 {
 	NMConnectionPrivate *priv;
-	GHashTableIter hiter;
-	GSList *settings = NULL;
-	GSList *iter;
-	const char *name = NULL;
 	NMSetting *setting;
+	guint idx = 0;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 	if (hints)
 		g_return_val_if_fail (*hints == NULL, NULL);
 
-	priv = NM_CONNECTION_GET_PRIVATE (connection);
-
-	/* Get list of settings in priority order */
-	g_hash_table_iter_init (&hiter, priv->settings);
-	while (g_hash_table_iter_next (&hiter, NULL, (gpointer) &setting))
-		settings = g_slist_insert_sorted (settings, setting, _nm_setting_compare_priority);
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
 
-	for (iter = settings; iter; iter = g_slist_next (iter)) {
+	/* the settings are iterated in priority order */
+	while ((setting = _settings_iter_next (priv, &idx))) {
 		GPtrArray *secrets;
 
-		setting = NM_SETTING (iter->data);
 		secrets = _nm_setting_need_secrets (setting);
 		if (secrets) {
 			if (hints)
@@ -2025,13 +2150,11 @@ nm_connection_need_secrets (NMConnection *connection,
 			else
 				g_ptr_array_free (secrets, TRUE);
 
-			name = nm_setting_get_name (setting);
-			break;
+			return nm_setting_get_name (setting);
 		}
 	}
 
-	g_slist_free (settings);
-	return name;
+	return NULL;
 }
 
 /**
@@ -2061,13 +2184,14 @@ nm_connection_clear_secrets_with_flags (NMConnection *connection,
                                         NMSettingClearSecretsWithFlagsFn func,
                                         gpointer user_data)
 {
-	GHashTableIter iter;
+	NMConnectionPrivate *priv;
 	NMSetting *setting;
+	guint idx = 0;
 
 	g_return_if_fail (NM_IS_CONNECTION (connection));
 
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (connection)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
+	while ((setting = _settings_iter_next (priv, &idx))) {
 		g_signal_handlers_block_by_func (setting, (GCallback) setting_changed_cb, connection);
 		_nm_setting_clear_secrets (setting, func, user_data);
 		g_signal_handlers_unblock_by_func (setting, (GCallback) setting_changed_cb, connection);
@@ -2297,6 +2421,7 @@ nm_connection_is_type (NMConnection *connection, const char *type)
 	return nm_streq0 (type, nm_connection_get_connection_type (connection));
 }
 
+#if NM_MORE_ASSERTS > 5
 static int
 _get_settings_sort (gconstpointer p_a, gconstpointer p_b, gpointer unused)
 {
@@ -2314,6 +2439,7 @@ _get_settings_sort (gconstpointer p_a, gconstpointer p_b, gpointer unused)
 	nm_assert_not_reached ();
 	return 0;
 }
+#endif
 
 /**
  * nm_connection_get_settings:
@@ -2335,12 +2461,35 @@ NMSetting **
 nm_connection_get_settings (NMConnection *connection,
                             guint *out_length)
 {
+	NMConnectionPrivate *priv;
+	NMSetting **arr;
+	NMSetting *setting;
+	guint idx = 0;
+	guint i = 0;
+
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 
-	return (NMSetting **) nm_utils_hash_values_to_array (NM_CONNECTION_GET_PRIVATE (connection)->settings,
-	                                                     _get_settings_sort,
-	                                                     NULL,
-	                                                     out_length);
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
+
+	if (priv->n_settings == 0) {
+		NM_SET_OUT (out_length, 0);
+		return NULL;
+	}
+
+	/* the settings are iterated in the order of _get_settings_sort(). */
+	arr = g_new (NMSetting *, priv->n_settings + 1u);
+	while ((setting = _settings_iter_next (priv, &idx)))
+		arr[i++] = setting;
+	nm_assert (i == priv->n_settings);
+	arr[i] = NULL;
+
+#if NM_MORE_ASSERTS > 5
+	for (i = 1; i < priv->n_settings; i++)
+		nm_assert (_get_settings_sort (&arr[i - 1], &arr[i], NULL) < 0);
+#endif
+
+	NM_SET_OUT (out_length, priv->n_settings);
+	return arr;
 }
 
 /**
@@ -2390,11 +2539,11 @@ _nm_connection_aggregate (NMConnection *connection,
                           gpointer arg)
 {
 	NMConnectionPrivate *priv;
-	GHashTableIter iter;
 	NMSetting *setting;
 	gboolean arg_boolean;
 	gboolean completed_early;
 	gpointer my_arg;
+	guint idx = 0;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
 
@@ -2411,11 +2560,10 @@ _nm_connection_aggregate (NMConnection *connection,
 	g_return_val_if_reached (FALSE);
 
 good:
-	priv = NM_CONNECTION_GET_PRIVATE (connection);
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
 
 	completed_early = FALSE;
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
+	while ((setting = _settings_iter_next (priv, &idx))) {
 		if (_nm_setting_aggregate (setting, type, my_arg)) {
 			completed_early = TRUE;
 			break;
@@ -2447,15 +2595,16 @@ good:
 void
 nm_connection_dump (NMConnection *connection)
 {
-	GHashTableIter iter;
+	NMConnectionPrivate *priv;
 	NMSetting *setting;
+	guint idx = 0;
 	char *str;
 
 	if (!connection)
 		return;
 
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (connection)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
+	priv = NM_CONNECTION_GET_PRIVATE_LOADED (connection);
+	while ((setting = _settings_iter_next (priv, &idx))) {
 		str = nm_setting_to_string (setting);
 		g_print ("%s\n", str);
 		g_free (str);
@@ -2485,6 +2634,33 @@ nm_connection_set_path (NMConnection *connection, const char *path)
 	priv->path = g_strdup (path);
 }
 
+/**
+ * _nm_connection_set_load_settings_fcn:
+ * @connection: the #NMConnection
+ * @load_settings_fcn: (allow-none): the function to load the settings.
+ *
+ * Mark the content of @connection as not yet loaded. The first time that the
+ * settings of @connection are accessed, @load_settings_fcn gets called to
+ * fill them in. Replacing or clearing the settings before that, drops the
+ * function without calling it.
+ */
+void
+_nm_connection_set_load_settings_fcn (NMConnection *connection,
+                                      NMConnectionLoadSettingsFcn load_settings_fcn)
+{
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+
+	NM_CONNECTION_GET_PRIVATE (connection)->load_settings_fcn = load_settings_fcn;
+}
+
+gboolean
+_nm_connection_has_load_settings_fcn (NMConnection *connection)
+{
+	g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
+
+	return !!NM_CONNECTION_GET_PRIVATE (connection)->load_settings_fcn;
+}
+
 /**
  * nm_connection_get_path:
  * @connection: the #NMConnection
@@ -2734,7 +2910,7 @@ nm_connection_get_virtual_device_description (NMConnection *connection)
 NMSetting8021x *
 nm_connection_get_setting_802_1x (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_802_1X);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_802_1X);
 }
 
 /**
@@ -2748,7 +2924,7 @@ nm_connection_get_setting_802_1x (NMConnection *connection)
 NMSettingBluetooth *
 nm_connection_get_setting_bluetooth (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BLUETOOTH);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BLUETOOTH);
 }
 
 /**
@@ -2762,7 +2938,7 @@ nm_connection_get_setting_bluetooth (NMConnection *connection)
 NMSettingBond *
 nm_connection_get_setting_bond (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BOND);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BOND);
 }
 
 /**
@@ -2776,7 +2952,7 @@ nm_connection_get_setting_bond (NMConnection *connection)
 NMSettingTeam *
 nm_connection_get_setting_team (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TEAM);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TEAM);
 }
 
 /**
@@ -2790,7 +2966,7 @@ nm_connection_get_setting_team (NMConnection *connection)
 NMSettingTeamPort *
 nm_connection_get_setting_team_port (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TEAM_PORT);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TEAM_PORT);
 }
 
 /**
@@ -2804,7 +2980,7 @@ nm_connection_get_setting_team_port (NMConnection *connection)
 NMSettingBridge *
 nm_connection_get_setting_bridge (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BRIDGE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BRIDGE);
 }
 
 /**
@@ -2818,7 +2994,7 @@ nm_connection_get_setting_bridge (NMConnection *connection)
 NMSettingCdma *
 nm_connection_get_setting_cdma (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_CDMA);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_CDMA);
 }
 
 /**
@@ -2832,7 +3008,7 @@ nm_connection_get_setting_cdma (NMConnection *connection)
 NMSettingConnection *
 nm_connection_get_setting_connection (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_CONNECTION);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_CONNECTION);
 }
 
 /**
@@ -2846,7 +3022,7 @@ nm_connection_get_setting_connection (NMConnection *connection)
 NMSettingDcb *
 nm_connection_get_setting_dcb (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_DCB);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_DCB);
 }
 
 /**
@@ -2862,7 +3038,7 @@ nm_connection_get_setting_dcb (NMConnection *connection)
 NMSettingDummy *
 nm_connection_get_setting_dummy (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_DUMMY);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_DUMMY);
 }
 
 /**
@@ -2876,7 +3052,7 @@ nm_connection_get_setting_dummy (NMConnection *connection)
 NMSettingGeneric *
 nm_connection_get_setting_generic (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_GENERIC);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_GENERIC);
 }
 
 /**
@@ -2890,7 +3066,7 @@ nm_connection_get_setting_generic (NMConnection *connection)
 NMSettingGsm *
 nm_connection_get_setting_gsm (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_GSM);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_GSM);
 }
 
 /**
@@ -2904,7 +3080,7 @@ nm_connection_get_setting_gsm (NMConnection *connection)
 NMSettingInfiniband *
 nm_connection_get_setting_infiniband (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_INFINIBAND);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_INFINIBAND);
 }
 
 /**
@@ -2923,7 +3099,7 @@ nm_connection_get_setting_infiniband (NMConnection *connection)
 NMSettingIPConfig *
 nm_connection_get_setting_ip4_config (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_IP4_CONFIG);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_IP4_CONFIG);
 }
 
 /**
@@ -2939,7 +3115,7 @@ nm_connection_get_setting_ip4_config (NMConnection *connection)
 NMSettingIPTunnel *
 nm_connection_get_setting_ip_tunnel (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_IP_TUNNEL);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_IP_TUNNEL);
 }
 
 /**
@@ -2958,7 +3134,7 @@ nm_connection_get_setting_ip_tunnel (NMConnection *connection)
 NMSettingIPConfig *
 nm_connection_get_setting_ip6_config (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_IP6_CONFIG);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_IP6_CONFIG);
 }
 
 /**
@@ -2974,7 +3150,7 @@ nm_connection_get_setting_ip6_config (NMConnection *connection)
 NMSettingMacsec *
 nm_connection_get_setting_macsec (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_MACSEC);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_MACSEC);
 }
 
 /**
@@ -2990,7 +3166,7 @@ nm_connection_get_setting_macsec (NMConnection *connection)
 NMSettingMacvlan *
 nm_connection_get_setting_macvlan (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_MACVLAN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_MACVLAN);
 }
 
 /**
@@ -3004,7 +3180,7 @@ nm_connection_get_setting_macvlan (NMConnection *connection)
 NMSettingOlpcMesh *
 nm_connection_get_setting_olpc_mesh (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OLPC_MESH);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OLPC_MESH);
 }
 
 /**
@@ -3020,7 +3196,7 @@ nm_connection_get_setting_olpc_mesh (NMConnection *connection)
 NMSettingOvsBridge *
 nm_connection_get_setting_ovs_bridge (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_BRIDGE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_BRIDGE);
 }
 
 /**
@@ -3036,7 +3212,7 @@ nm_connection_get_setting_ovs_bridge (NMConnection *connection)
 NMSettingOvsInterface *
 nm_connection_get_setting_ovs_interface (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_INTERFACE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_INTERFACE);
 }
 
 /**
@@ -3052,7 +3228,7 @@ nm_connection_get_setting_ovs_interface (NMConnection *connection)
 NMSettingOvsPatch *
 nm_connection_get_setting_ovs_patch (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_PATCH);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_PATCH);
 }
 
 /**
@@ -3068,7 +3244,7 @@ nm_connection_get_setting_ovs_patch (NMConnection *connection)
 NMSettingOvsPort *
 nm_connection_get_setting_ovs_port (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_PORT);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_PORT);
 }
 
 /**
@@ -3082,7 +3258,7 @@ nm_connection_get_setting_ovs_port (NMConnection *connection)
 NMSettingPpp *
 nm_connection_get_setting_ppp (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_PPP);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_PPP);
 }
 
 /**
@@ -3096,7 +3272,7 @@ nm_connection_get_setting_ppp (NMConnection *connection)
 NMSettingPppoe *
 nm_connection_get_setting_pppoe (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_PPPOE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_PPPOE);
 }
 
 /**
@@ -3112,7 +3288,7 @@ nm_connection_get_setting_pppoe (NMConnection *connection)
 NMSettingProxy *
 nm_connection_get_setting_proxy (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_PROXY);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_PROXY);
 }
 
 /**
@@ -3126,7 +3302,7 @@ nm_connection_get_setting_proxy (NMConnection *connection)
 NMSettingSerial *
 nm_connection_get_setting_serial (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_SERIAL);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_SERIAL);
 }
 
 /**
@@ -3142,7 +3318,7 @@ nm_connection_get_setting_serial (NMConnection *connection)
 NMSettingTCConfig *
 nm_connection_get_setting_tc_config (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TC_CONFIG);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TC_CONFIG);
 }
 
 /**
@@ -3158,7 +3334,7 @@ nm_connection_get_setting_tc_config (NMConnection *connection)
 NMSettingTun *
 nm_connection_get_setting_tun (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TUN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TUN);
 }
 
 /**
@@ -3172,7 +3348,7 @@ nm_connection_get_setting_tun (NMConnection *connection)
 NMSettingVpn *
 nm_connection_get_setting_vpn (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_VPN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_VPN);
 }
 
 /**
@@ -3188,7 +3364,7 @@ nm_connection_get_setting_vpn (NMConnection *connection)
 NMSettingVxlan *
 nm_connection_get_setting_vxlan (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_VXLAN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_VXLAN);
 }
 
 /**
@@ -3202,7 +3378,7 @@ nm_connection_get_setting_vxlan (NMConnection *connection)
 NMSettingWimax *
 nm_connection_get_setting_wimax (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIMAX);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIMAX);
 }
 
 /**
@@ -3216,7 +3392,7 @@ nm_connection_get_setting_wimax (NMConnection *connection)
 NMSettingWired *
 nm_connection_get_setting_wired (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIRED);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIRED);
 }
 
 /**
@@ -3230,7 +3406,7 @@ nm_connection_get_setting_wired (NMConnection *connection)
 NMSettingAdsl *
 nm_connection_get_setting_adsl (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_ADSL);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_ADSL);
 }
 
 /**
@@ -3244,7 +3420,7 @@ nm_connection_get_setting_adsl (NMConnection *connection)
 NMSettingWireless *
 nm_connection_get_setting_wireless (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIRELESS);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIRELESS);
 }
 
 /**
@@ -3258,7 +3434,7 @@ nm_connection_get_setting_wireless (NMConnection *connection)
 NMSettingWirelessSecurity *
 nm_connection_get_setting_wireless_security (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIRELESS_SECURITY);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIRELESS_SECURITY);
 }
 
 /**
@@ -3272,7 +3448,7 @@ nm_connection_get_setting_wireless_security (NMConnection *connection)
 NMSettingBridgePort *
 nm_connection_get_setting_bridge_port (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BRIDGE_PORT);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BRIDGE_PORT);
 }
 
 /**
@@ -3286,7 +3462,7 @@ nm_connection_get_setting_bridge_port (NMConnection *connection)
 NMSettingVlan *
 nm_connection_get_setting_vlan (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_VLAN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_VLAN);
 }
 
 NMSettingBluetooth *
@@ -3307,8 +3483,7 @@ nm_connection_private_free (NMConnectionPrivate *priv)
 {
 	NMConnection *self = priv->self;
 
-	g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, self);
-	g_hash_table_destroy (priv->settings);
+	_settings_clear (self, priv);
 	g_free (priv->path);
 
 	g_slice_free (NMConnectionPrivate, priv);
@@ -3331,10 +3506,6 @@ nm_connection_get_private (NMConnection *connection)
 		                         priv, (GDestroyNotify) nm_connection_private_free);
 
 		priv->self = connection;
-		priv->settings = g_hash_table_new_full (nm_direct_hash,
-		                                        NULL,
-		                                        NULL,
-		                                        g_object_unref);
 	}
 
 	return priv;
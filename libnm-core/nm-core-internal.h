@@ -290,6 +290,13 @@ gboolean _nm_connection_ensure_normalized (NMConnection *connection,
 
 gboolean _nm_connection_remove_setting (NMConnection *connection, GType setting_type);
 
+typedef void (*NMConnectionLoadSettingsFcn) (NMConnection *connection);
+
+void _nm_connection_set_load_settings_fcn (NMConnection *connection,
+                                           NMConnectionLoadSettingsFcn load_settings_fcn);
+
+gboolean _nm_connection_has_load_settings_fcn (NMConnection *connection);
+
 #if NM_MORE_ASSERTS
 extern const char _nmtst_connection_unchanging_user_data;
 void nmtst_connection_assert_unchanging (NMConnection *connection);
@@ -750,6 +757,8 @@ typedef gboolean  (*NMSettInfoPropMissingFromDBusFcn)   (NMSetting     *setting,
 typedef GVariant *(*NMSettInfoPropGPropToDBusFcn)       (const GValue *from);
 typedef void      (*NMSettInfoPropGPropFromDBusFcn)     (GVariant *from,
                                                          GValue *to);
+typedef gboolean  (*NMSettInfoPropGPropEqualFcn)        (const GValue *a,
+                                                         const GValue *b);
 
 const NMSettInfoSetting *nmtst_sett_info_settings (void);
 
@@ -764,6 +773,12 @@ typedef struct {
 	 * on the GValue value of the GObject property. */
 	NMSettInfoPropGPropToDBusFcn       gprop_to_dbus_fcn;
 	NMSettInfoPropGPropFromDBusFcn     gprop_from_dbus_fcn;
+
+	/* If set, compare_property() compares the GValues of the property
+	 * with this function, instead of converting both sides to GVariant.
+	 * This is only valid if the conversion to D-Bus is injective, that
+	 * is, if the property has no @to_dbus_fcn. */
+	NMSettInfoPropGPropEqualFcn        gprop_equal_fcn;
 } NMSettInfoPropertType;
 
 struct _NMSettInfoProperty {
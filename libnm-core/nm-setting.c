@@ -205,6 +205,62 @@ _gprop_to_dbus_fcn_flags (const GValue *val)
 	return g_variant_new_uint32 (g_value_get_flags (val));
 }
 
+static gboolean
+_gprop_equal_fcn_plain (const GValue *a, const GValue *b)
+{
+	nm_assert (G_VALUE_TYPE (a) == G_VALUE_TYPE (b));
+
+	switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (a))) {
+	case G_TYPE_BOOLEAN:
+		return (!g_value_get_boolean (a)) == (!g_value_get_boolean (b));
+	case G_TYPE_UCHAR:
+		return g_value_get_uchar (a) == g_value_get_uchar (b);
+	case G_TYPE_INT:
+		return g_value_get_int (a) == g_value_get_int (b);
+	case G_TYPE_UINT:
+		return g_value_get_uint (a) == g_value_get_uint (b);
+	case G_TYPE_INT64:
+		return g_value_get_int64 (a) == g_value_get_int64 (b);
+	case G_TYPE_UINT64:
+		return g_value_get_uint64 (a) == g_value_get_uint64 (b);
+	case G_TYPE_DOUBLE:
+		return g_value_get_double (a) == g_value_get_double (b);
+	case G_TYPE_ENUM:
+		return g_value_get_enum (a) == g_value_get_enum (b);
+	case G_TYPE_FLAGS:
+		return g_value_get_flags (a) == g_value_get_flags (b);
+	}
+	nm_assert_not_reached ();
+	return FALSE;
+}
+
+static gboolean
+_gprop_equal_fcn_string (const GValue *a, const GValue *b)
+{
+	return nm_streq0 (g_value_get_string (a), g_value_get_string (b));
+}
+
+static gboolean
+_gprop_equal_fcn_strv (const GValue *a, const GValue *b)
+{
+	/* %NULL and an empty strv are different, because only the former is
+	 * the default value and omitted from D-Bus. */
+	return _nm_utils_strv_equal (g_value_get_boxed (a), g_value_get_boxed (b));
+}
+
+static gboolean
+_gprop_equal_fcn_bytes (const GValue *a, const GValue *b)
+{
+	GBytes *bytes_a = g_value_get_boxed (a);
+	GBytes *bytes_b = g_value_get_boxed (b);
+
+	if (bytes_a == bytes_b)
+		return TRUE;
+	if (!bytes_a || !bytes_b)
+		return FALSE;
+	return g_bytes_equal (bytes_a, bytes_b);
+}
+
 gboolean
 _nm_properties_override_assert (const NMSettInfoProperty *prop_info)
 {
@@ -402,39 +458,51 @@ _nm_setting_class_commit_full (NMSettingClass *setting_class,
 		nm_assert (p->param_spec);
 
 		vtype = p->param_spec->value_type;
-		if (vtype == G_TYPE_BOOLEAN)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BOOLEAN);
-		else if (vtype == G_TYPE_UCHAR)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BYTE);
-		else if (vtype == G_TYPE_INT)
+		if (vtype == G_TYPE_BOOLEAN) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BOOLEAN,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_UCHAR) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BYTE,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_INT)
 			p->property_type = &nm_sett_info_propert_type_plain_i;
 		else if (vtype == G_TYPE_UINT)
 			p->property_type = &nm_sett_info_propert_type_plain_u;
-		else if (vtype == G_TYPE_INT64)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_INT64);
-		else if (vtype == G_TYPE_UINT64)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_UINT64);
-		else if (vtype == G_TYPE_STRING)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING);
-		else if (vtype == G_TYPE_DOUBLE)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_DOUBLE);
-		else if (vtype == G_TYPE_STRV)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING_ARRAY);
-		else if (vtype == G_TYPE_BYTES) {
+		else if (vtype == G_TYPE_INT64) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_INT64,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_UINT64) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_UINT64,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_STRING) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_string);
+		} else if (vtype == G_TYPE_DOUBLE) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_DOUBLE,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_STRV) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING_ARRAY,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_strv);
+		} else if (vtype == G_TYPE_BYTES) {
 			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BYTESTRING,
-			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_bytes);
+			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_bytes,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_bytes);
 		} else if (g_type_is_a (vtype, G_TYPE_ENUM)) {
 			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_INT32,
-			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_enum);
+			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_enum,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
 		} else if (g_type_is_a (vtype, G_TYPE_FLAGS)) {
 			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_UINT32,
-			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_flags);
+			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_flags,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
 		} else
 			nm_assert_not_reached ();
 
 has_property_type:
 		nm_assert (p->property_type);
 		nm_assert (p->property_type->dbus_type);
+		nm_assert (!p->property_type->gprop_equal_fcn || !p->property_type->to_dbus_fcn);
+		nm_assert (!p->property_type->gprop_equal_fcn || p->param_spec);
 		nm_assert (g_variant_type_string_is_valid ((const char *) p->property_type->dbus_type));
 	}
 
@@ -1359,7 +1427,23 @@ compare_property (const NMSettInfoSetting *sett_info,
 	                                                    flags))
 		return NM_TERNARY_DEFAULT;
 
-	if (set_b) {
+	if (!set_b)
+		return NM_TERNARY_TRUE;
+
+	if (property_info->property_type->gprop_equal_fcn) {
+		nm_auto_unset_gvalue GValue value1 = G_VALUE_INIT;
+		nm_auto_unset_gvalue GValue value2 = G_VALUE_INIT;
+
+		/* Fast path: compare the native values. As the conversion to D-Bus
+		 * is injective for these types, this gives the same result as comparing
+		 * the GVariants below, but without creating them. */
+		g_value_init (&value1, param_spec->value_type);
+		g_value_init (&value2, param_spec->value_type);
+		g_object_get_property (G_OBJECT (set_a), param_spec->name, &value1);
+		g_object_get_property (G_OBJECT (set_b), param_spec->name, &value2);
+		if (!property_info->property_type->gprop_equal_fcn (&value1, &value2))
+			return NM_TERNARY_FALSE;
+	} else {
 		gs_unref_variant GVariant *value1  = NULL;
 		gs_unref_variant GVariant *value2  = NULL;
 
@@ -2358,11 +2442,13 @@ const NMSettInfoPropertType nm_sett_info_propert_type_deprecated_ignore_u = {
 };
 
 const NMSettInfoPropertType nm_sett_info_propert_type_plain_i = {
-	.dbus_type   = G_VARIANT_TYPE_INT32,
+	.dbus_type       = G_VARIANT_TYPE_INT32,
+	.gprop_equal_fcn = _gprop_equal_fcn_plain,
 };
 
 const NMSettInfoPropertType nm_sett_info_propert_type_plain_u = {
-	.dbus_type   = G_VARIANT_TYPE_UINT32,
+	.dbus_type       = G_VARIANT_TYPE_UINT32,
+	.gprop_equal_fcn = _gprop_equal_fcn_plain,
 };
 
 /*****************************************************************************/
@@ -3447,6 +3447,118 @@ test_connection_diff_different (void)
 	g_object_unref (b);
 }
 
+static NMConnection *
+_create_compare_perf_connection (guint i)
+{
+	NMConnection *connection;
+	NMSettingIPConfig *s_ip4;
+	NMSettingIPConfig *s_ip6;
+	char sbuf[100];
+
+	connection = nmtst_create_minimal_connection (nm_sprintf_buf (sbuf, "profile-%u", i),
+	                                              NULL,
+	                                              NM_SETTING_WIRED_SETTING_NAME,
+	                                              NULL);
+	g_object_set (nm_connection_get_setting_connection (connection),
+	              NM_SETTING_CONNECTION_INTERFACE_NAME, nm_sprintf_buf (sbuf, "eth%u", i % 1000),
+	              NM_SETTING_CONNECTION_AUTOCONNECT_PRIORITY, (int) (i % 100),
+	              NULL);
+	g_object_set (nm_connection_get_setting_wired (connection),
+	              NM_SETTING_WIRED_MTU, (guint) 1500,
+	              NM_SETTING_WIRED_CLONED_MAC_ADDRESS, "stable",
+	              NULL);
+
+	s_ip4 = NM_SETTING_IP_CONFIG (nm_setting_ip4_config_new ());
+	g_object_set (s_ip4,
+	              NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_MANUAL,
+	              NM_SETTING_IP_CONFIG_GATEWAY, "192.168.0.1",
+	              NM_SETTING_IP_CONFIG_ROUTE_METRIC, (gint64) 100,
+	              NULL);
+	nmtst_setting_ip_config_add_address (s_ip4, nm_sprintf_buf (sbuf, "192.168.%u.%u", (i / 250) % 250, (i % 250) + 2), 16);
+	nmtst_setting_ip_config_add_route (s_ip4, "10.0.0.0", 8, "192.168.0.254", 200);
+	nm_setting_ip_config_add_dns (s_ip4, "192.168.0.1");
+	nm_setting_ip_config_add_dns_search (s_ip4, "example.com");
+	nm_connection_add_setting (connection, NM_SETTING (s_ip4));
+
+	s_ip6 = NM_SETTING_IP_CONFIG (nm_setting_ip6_config_new ());
+	g_object_set (s_ip6,
+	              NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP6_CONFIG_METHOD_AUTO,
+	              NM_SETTING_IP6_CONFIG_ADDR_GEN_MODE, (int) NM_SETTING_IP6_CONFIG_ADDR_GEN_MODE_STABLE_PRIVACY,
+	              NULL);
+	nm_connection_add_setting (connection, NM_SETTING (s_ip6));
+
+	return connection;
+}
+
+static void
+test_connection_compare_perf (void)
+{
+	const guint N = g_test_perf () ? 10000 : 500;
+	gs_unref_ptrarray GPtrArray *profiles = g_ptr_array_new_with_free_func (g_object_unref);
+	gs_unref_ptrarray GPtrArray *clones = g_ptr_array_new_with_free_func (g_object_unref);
+	gint64 t_start;
+	guint n_modified = 0;
+	guint n_different;
+	guint i;
+
+	for (i = 0; i < N; i++) {
+		NMConnection *a = _create_compare_perf_connection (i);
+		NMConnection *b = nm_simple_connection_new_clone (a);
+
+		/* modify every 4th clone, each time a property of another type. */
+		switch (i % 16) {
+		case 1:
+			g_object_set (nm_connection_get_setting_connection (b),
+			              NM_SETTING_CONNECTION_ID, "modified",
+			              NULL);
+			break;
+		case 5:
+			g_object_set (nm_connection_get_setting_wired (b),
+			              NM_SETTING_WIRED_MTU, (guint) 9000,
+			              NULL);
+			break;
+		case 9:
+			g_object_set (nm_connection_get_setting_connection (b),
+			              NM_SETTING_CONNECTION_AUTOCONNECT, FALSE,
+			              NULL);
+			break;
+		case 13:
+			nm_setting_ip_config_add_dns_search (nm_connection_get_setting_ip4_config (b), "example.org");
+			break;
+		}
+		if (i % 4 == 1)
+			n_modified++;
+
+		g_ptr_array_add (profiles, a);
+		g_ptr_array_add (clones, b);
+	}
+
+	t_start = g_get_monotonic_time ();
+	n_different = 0;
+	for (i = 0; i < N; i++) {
+		if (!nm_connection_compare (profiles->pdata[i], clones->pdata[i], NM_SETTING_COMPARE_FLAG_EXACT))
+			n_different++;
+	}
+	g_test_message ("compare %u profiles: %.3f msec",
+	                N, (g_get_monotonic_time () - t_start) / 1000.0);
+	g_assert_cmpint (n_different, ==, n_modified);
+
+	t_start = g_get_monotonic_time ();
+	n_different = 0;
+	for (i = 0; i < N; i++) {
+		gs_unref_hashtable GHashTable *out_diffs = NULL;
+
+		if (!nm_connection_diff (profiles->pdata[i], clones->pdata[i], NM_SETTING_COMPARE_FLAG_EXACT, &out_diffs)) {
+			g_assert (out_diffs);
+			n_different++;
+		} else
+			g_assert (!out_diffs);
+	}
+	g_test_message ("diff %u profiles: %.3f msec",
+	                N, (g_get_monotonic_time () - t_start) / 1000.0);
+	g_assert_cmpint (n_different, ==, n_modified);
+}
+
 static void
 test_connection_diff_no_secrets (void)
 {
@@ -8978,6 +9090,7 @@ int main (int argc, char **argv)
 	g_test_add_func ("/core/general/test_connection_diff_a_only", test_connection_diff_a_only);
 	g_test_add_func ("/core/general/test_connection_diff_same", test_connection_diff_same);
 	g_test_add_func ("/core/general/test_connection_diff_different", test_connection_diff_different);
+	g_test_add_func ("/core/general/test_connection_compare_perf", test_connection_compare_perf);
 	g_test_add_func ("/core/general/test_connection_diff_no_secrets", test_connection_diff_no_secrets);
 	g_test_add_func ("/core/general/test_connection_diff_inferrable", test_connection_diff_inferrable);
 	g_test_add_func ("/core/general/test_connection_good_base_types", test_connection_good_base_types);
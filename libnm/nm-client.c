@@ -264,6 +264,11 @@ typedef struct {
 	GCancellable *name_owner_get_cancellable;
 	GCancellable *get_managed_objects_cancellable;
 
+	/* with NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS, the GetSettingsBulkItem
+	 * entries that wait to be fetched with the next GetAllSettings() call. */
+	GArray *get_settings_bulk_pending;
+	GCancellable *get_settings_bulk_cancellable;
+
 	CList queue_notify_lst_head;
 	CList notify_event_lst_head;
 
@@ -298,6 +303,7 @@ typedef struct {
 	bool notify_event_lst_changed:1;
 	bool check_dbobj_visible_all:1;
 	bool nm_running:1;
+	bool get_settings_bulk_unsupported:1;
 
 	struct {
 		NMLDBusPropertyO property_o[_PROPERTY_O_IDX_NM_NUM];
@@ -2855,12 +2861,15 @@ _dbus_handle_changes_commit (NMClient *self,
 		_init_start_check_complete (self);
 }
 
+static void _get_settings_bulk_flush (NMClient *self);
+
 static void
 _dbus_handle_changes (NMClient *self,
                       const char *log_context,
                       gboolean allow_init_start_check_complete)
 {
 	_dbus_handle_obj_changed_dbus (self, log_context);
+	_get_settings_bulk_flush (self);
 	_dbus_handle_changes_commit (self, allow_init_start_check_complete);
 }
 
@@ -3222,14 +3231,11 @@ _nm_client_get_settings_call_cb (GObject *source, GAsyncResult *result, gpointer
 	_dbus_handle_changes_commit (self, TRUE);
 }
 
-void
-_nm_client_get_settings_call (NMClient *self,
-                              NMLDBusObject *dbobj)
+static void
+_get_settings_call_single (NMClient *self,
+                           NMLDBusObject *dbobj,
+                           GCancellable *cancellable)
 {
-	GCancellable *cancellable;
-
-	cancellable = _nm_remote_settings_get_settings_prepare (NM_REMOTE_CONNECTION (dbobj->nmobj));
-
 	_nm_client_dbus_call_simple (self,
 	                             cancellable,
 	                             dbobj->dbus_path->str,
@@ -3243,6 +3249,194 @@ _nm_client_get_settings_call (NMClient *self,
 	                             dbobj->nmobj);
 }
 
+typedef struct {
+	NMRemoteConnection *remote_connection;
+
+	/* the cancellable from _nm_remote_settings_get_settings_prepare(). If
+	 * it got cancelled, the request for this profile is obsolete. */
+	GCancellable *cancellable;
+} GetSettingsBulkItem;
+
+static void
+_get_settings_bulk_item_clear (gpointer data)
+{
+	GetSettingsBulkItem *item = data;
+
+	g_object_unref (item->remote_connection);
+	g_object_unref (item->cancellable);
+}
+
+static void
+_get_settings_bulk_call_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	gs_unref_array GArray *items = NULL;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_variant GVariant *settings_all = NULL;
+	gs_unref_hashtable GHashTable *settings_by_path = NULL;
+	gs_free_error GError *error = NULL;
+	NMClient *self;
+	NMClientPrivate *priv;
+	GVariantIter iter;
+	const char *object_path;
+	GVariant *settings;
+	guint i;
+
+	nm_utils_user_data_unpack (user_data, &self, &items);
+
+	ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &error);
+	if (   !ret
+	    && nm_utils_error_is_cancelled (error))
+		return;
+
+	priv = NM_CLIENT_GET_PRIVATE (self);
+
+	if (!ret) {
+		NML_NMCLIENT_LOG_T (self, "GetAllSettings() for %u profiles completed with error: %s",
+		                    items->len,
+		                    error->message);
+		if (g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD)) {
+			/* the server does not support the method. Don't try again. */
+			priv->get_settings_bulk_unsupported = TRUE;
+		}
+
+		/* fallback to fetching the profiles individually. */
+		for (i = 0; i < items->len; i++) {
+			GetSettingsBulkItem *item = &g_array_index (items, GetSettingsBulkItem, i);
+
+			if (g_cancellable_is_cancelled (item->cancellable))
+				continue;
+			_get_settings_call_single (self,
+			                           _nm_object_get_dbobj (item->remote_connection),
+			                           item->cancellable);
+		}
+		return;
+	}
+
+	NML_NMCLIENT_LOG_T (self, "GetAllSettings() for %u profiles completed with success",
+	                    items->len);
+
+	g_variant_get (ret, "(@a{oa{sa{sv}}})", &settings_all);
+
+	settings_by_path = g_hash_table_new_full (nm_str_hash,
+	                                          g_str_equal,
+	                                          NULL,
+	                                          (GDestroyNotify) g_variant_unref);
+	g_variant_iter_init (&iter, settings_all);
+	while (g_variant_iter_next (&iter, "{&o@a{sa{sv}}}", &object_path, &settings))
+		g_hash_table_insert (settings_by_path, (char *) object_path, settings);
+
+	for (i = 0; i < items->len; i++) {
+		GetSettingsBulkItem *item = &g_array_index (items, GetSettingsBulkItem, i);
+
+		if (g_cancellable_is_cancelled (item->cancellable))
+			continue;
+
+		/* profiles that are missing in the result are not visible to us. */
+		_nm_remote_settings_get_settings_commit (item->remote_connection,
+		                                         g_hash_table_lookup (settings_by_path,
+		                                                              _nm_object_get_path (item->remote_connection)));
+	}
+
+	_dbus_handle_changes_commit (self, TRUE);
+}
+
+static void
+_get_settings_bulk_flush (NMClient *self)
+{
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (self);
+	gs_unref_array GArray *items = NULL;
+	GVariantBuilder builder;
+	guint i, j;
+
+	if (!priv->get_settings_bulk_pending)
+		return;
+
+	items = g_steal_pointer (&priv->get_settings_bulk_pending);
+
+	/* drop the requests that got obsoleted in the meantime. */
+	for (i = 0, j = 0; i < items->len; i++) {
+		GetSettingsBulkItem *item = &g_array_index (items, GetSettingsBulkItem, i);
+
+		if (g_cancellable_is_cancelled (item->cancellable)) {
+			_get_settings_bulk_item_clear (item);
+			continue;
+		}
+		if (i != j)
+			g_array_index (items, GetSettingsBulkItem, j) = *item;
+		j++;
+	}
+	/* the dropped items are already cleared. Don't let g_array_set_size()
+	 * clear them again. */
+	g_array_set_clear_func (items, NULL);
+	g_array_set_size (items, j);
+	g_array_set_clear_func (items, _get_settings_bulk_item_clear);
+
+	if (   items->len == 0
+	    || !priv->name_owner)
+		return;
+
+	if (items->len == 1) {
+		GetSettingsBulkItem *item = &g_array_index (items, GetSettingsBulkItem, 0);
+
+		_get_settings_call_single (self,
+		                           _nm_object_get_dbobj (item->remote_connection),
+		                           item->cancellable);
+		return;
+	}
+
+	if (!priv->get_settings_bulk_cancellable)
+		priv->get_settings_bulk_cancellable = g_cancellable_new ();
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("ao"));
+	for (i = 0; i < items->len; i++) {
+		g_variant_builder_add (&builder,
+		                       "o",
+		                       _nm_object_get_path (g_array_index (items, GetSettingsBulkItem, i).remote_connection));
+	}
+
+	NML_NMCLIENT_LOG_T (self, "GetAllSettings() for %u profiles", items->len);
+
+	_nm_client_dbus_call_simple (self,
+	                             priv->get_settings_bulk_cancellable,
+	                             NM_DBUS_PATH_SETTINGS,
+	                             NM_DBUS_INTERFACE_SETTINGS,
+	                             "GetAllSettings",
+	                             g_variant_new ("(ao)", &builder),
+	                             G_VARIANT_TYPE ("(a{oa{sa{sv}}})"),
+	                             G_DBUS_CALL_FLAGS_NONE,
+	                             NM_DBUS_DEFAULT_TIMEOUT_MSEC,
+	                             _get_settings_bulk_call_cb,
+	                             nm_utils_user_data_pack (self, g_steal_pointer (&items)));
+}
+
+void
+_nm_client_get_settings_call (NMClient *self,
+                              NMLDBusObject *dbobj)
+{
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (self);
+	GetSettingsBulkItem *item;
+	GCancellable *cancellable;
+
+	cancellable = _nm_remote_settings_get_settings_prepare (NM_REMOTE_CONNECTION (dbobj->nmobj));
+
+	if (   !NM_FLAGS_HAS (priv->instance_flags, NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS)
+	    || priv->get_settings_bulk_unsupported) {
+		_get_settings_call_single (self, dbobj, cancellable);
+		return;
+	}
+
+	/* enqueue the request. The requests get collected while processing
+	 * the D-Bus changes and are fetched together by _get_settings_bulk_flush(). */
+	if (!priv->get_settings_bulk_pending) {
+		priv->get_settings_bulk_pending = g_array_new (FALSE, FALSE, sizeof (GetSettingsBulkItem));
+		g_array_set_clear_func (priv->get_settings_bulk_pending, _get_settings_bulk_item_clear);
+	}
+	g_array_set_size (priv->get_settings_bulk_pending, priv->get_settings_bulk_pending->len + 1);
+	item = &g_array_index (priv->get_settings_bulk_pending, GetSettingsBulkItem, priv->get_settings_bulk_pending->len - 1);
+	item->remote_connection = g_object_ref (NM_REMOTE_CONNECTION (dbobj->nmobj));
+	item->cancellable = g_object_ref (cancellable);
+}
+
 static void
 _dbus_settings_updated_cb (GDBusConnection *connection,
                            const char *sender_name,
@@ -3274,10 +3468,19 @@ _dbus_settings_updated_cb (GDBusConnection *connection,
 		return;
 	}
 
+	if (_nm_connection_has_load_settings_fcn (NM_CONNECTION (dbobj->nmobj))) {
+		/* with NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS, the settings were
+		 * not yet fetched. Nothing to refresh. */
+		NML_NMCLIENT_LOG_T (self, "%s: [%s] Updated signal received for not yet loaded settings",
+		                    log_context, object_path);
+		return;
+	}
+
 	NML_NMCLIENT_LOG_T (self, "%s: [%s] Updated signal received",
 	                    log_context, object_path);
 
 	_nm_client_get_settings_call (self, dbobj);
+	_get_settings_bulk_flush (self);
 }
 
 /*****************************************************************************/
@@ -6919,6 +7122,8 @@ _init_release_all (NMClient *self)
 
 	nm_clear_g_cancellable (&priv->permissions_cancellable);
 	nm_clear_g_cancellable (&priv->get_managed_objects_cancellable);
+	nm_clear_g_cancellable (&priv->get_settings_bulk_cancellable);
+	priv->get_settings_bulk_unsupported = FALSE;
 
 	nm_clear_g_dbus_connection_signal (priv->dbus_connection,
 	                                   &priv->dbsid_nm_object_manager);
@@ -7825,6 +8030,7 @@ dispose (GObject *object)
 
 	_init_release_all (self);
 
+	nm_assert (!priv->get_settings_bulk_pending);
 	nm_assert (c_list_is_empty (&priv->dbus_objects_lst_head_watched_only));
 	nm_assert (c_list_is_empty (&priv->dbus_objects_lst_head_on_dbus));
 	nm_assert (c_list_is_empty (&priv->dbus_objects_lst_head_with_nmobj_not_ready));
@@ -7981,6 +8187,10 @@ nm_client_class_init (NMClientClass *client_class)
 	 * property to know whether permissions are ready. Note that permissions are only fetched
 	 * when NMClient has a D-Bus name owner.
 	 *
+	 * The flags %NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS and
+	 * %NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS can only be set during
+	 * construction.
+	 *
 	 * Since: 1.24
 	 */
 	obj_properties[PROP_INSTANCE_FLAGS] =
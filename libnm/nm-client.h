@@ -24,12 +24,26 @@ G_BEGIN_DECLS
  *   can be disabled. You can toggle this flag to enable and disable automatic
  *   fetching of the permissions. Watch also nm_client_get_permissions_state()
  *   to know whether the permissions are up to date.
+ * @NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS: by default, NMClient fetches
+ *   the settings of each connection profile with a separate "GetSettings" call.
+ *   With this flag, the settings of all profiles that appear at the same time
+ *   (like during initialization) are fetched with one "GetAllSettings" call.
+ *   If NetworkManager does not support that method, NMClient falls back
+ *   to the per-profile calls. Since 1.26.
+ * @NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS: don't fetch the settings of
+ *   the connection profiles during initialization. Instead, the settings of a
+ *   #NMRemoteConnection are fetched synchronously when they are accessed the
+ *   first time. Until then, the profile is considered visible. If fetching
+ *   the settings fails, the profile has no settings afterwards and
+ *   nm_remote_connection_get_visible() returns %FALSE. Since 1.26.
  *
  * Since: 1.24
  */
 typedef enum { /*< flags >*/
 	NM_CLIENT_INSTANCE_FLAGS_NONE                      = 0,
 	NM_CLIENT_INSTANCE_FLAGS_NO_AUTO_FETCH_PERMISSIONS = 1,
+	NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS         = 2,
+	NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS         = 4,
 } NMClientInstanceFlags;
 
 #define NM_TYPE_CLIENT            (nm_client_get_type ())
@@ -695,14 +695,65 @@ is_ready (NMObject *nmobj)
 
 /*****************************************************************************/
 
+static void
+_load_settings_lazy (NMConnection *connection)
+{
+	NMRemoteConnection *self = NM_REMOTE_CONNECTION (connection);
+	NMClient *client;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_variant GVariant *settings = NULL;
+	gs_free_error GError *error = NULL;
+
+	client = _nm_object_get_client (self);
+	if (!client)
+		return;
+
+	ret = _nm_client_dbus_call_sync (client,
+	                                 NULL,
+	                                 _nm_object_get_path (self),
+	                                 NM_DBUS_INTERFACE_SETTINGS_CONNECTION,
+	                                 "GetSettings",
+	                                 g_variant_new ("()"),
+	                                 G_VARIANT_TYPE ("(a{sa{sv}})"),
+	                                 G_DBUS_CALL_FLAGS_NONE,
+	                                 NM_DBUS_DEFAULT_TIMEOUT_MSEC,
+	                                 TRUE,
+	                                 &error);
+	if (!ret) {
+		NML_NMCLIENT_LOG_T (client, "[%s] lazy GetSettings() completed with error: %s",
+		                    _nm_object_get_path (self),
+		                    error->message);
+	} else {
+		NML_NMCLIENT_LOG_T (client, "[%s] lazy GetSettings() completed with success",
+		                    _nm_object_get_path (self));
+		g_variant_get (ret,
+		               "(@a{sa{sv}})",
+		               &settings);
+	}
+
+	_nm_remote_settings_get_settings_commit (self, settings);
+}
+
 static void
 register_client (NMObject *nmobj,
                  NMClient *client,
                  NMLDBusObject *dbobj)
 {
+	NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE (nmobj);
+
 	NM_OBJECT_CLASS (nm_remote_connection_parent_class)->register_client (nmobj, client, dbobj);
 	nm_connection_set_path (NM_CONNECTION (nmobj),
 	                        dbobj->dbus_path->str);
+
+	if (NM_FLAGS_HAS (nm_client_get_instance_flags (client), NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS)) {
+		/* the profile is ready right away. The settings get fetched
+		 * when they are accessed the first time. */
+		priv->is_initialized = TRUE;
+		priv->visible = TRUE;
+		_nm_connection_set_load_settings_fcn (NM_CONNECTION (nmobj), _load_settings_lazy);
+		return;
+	}
+
 	_nm_client_get_settings_call (client, dbobj);
 }
 
@@ -712,6 +763,7 @@ unregister_client (NMObject *nmobj,
                    NMLDBusObject *dbobj)
 {
 	nm_clear_g_cancellable (&NM_REMOTE_CONNECTION_GET_PRIVATE (nmobj)->get_settings_cancellable);
+	_nm_connection_set_load_settings_fcn (NM_CONNECTION (nmobj), NULL);
 	NM_OBJECT_CLASS (nm_remote_connection_parent_class)->unregister_client (nmobj, client, dbobj);
 }
 
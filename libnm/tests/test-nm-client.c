@@ -1301,6 +1301,214 @@ test_connection_invalid (void)
 
 /*****************************************************************************/
 
+static void
+_get_settings_call_counts (NMTstcServiceInfo *sinfo,
+                           guint *out_get_settings,
+                           guint *out_get_all_settings)
+{
+	gs_unref_variant GVariant *ret = NULL;
+	gs_free_error GError *error = NULL;
+
+	ret = g_dbus_proxy_call_sync (sinfo->proxy,
+	                              "GetSettingsCallCounts",
+	                              NULL,
+	                              G_DBUS_CALL_FLAGS_NO_AUTO_START,
+	                              3000,
+	                              NULL,
+	                              &error);
+	nmtst_assert_success (ret, error);
+	g_variant_get (ret, "(uu)", out_get_settings, out_get_all_settings);
+}
+
+static void
+_get_settings_add_connections (NMTstcServiceInfo *sinfo,
+                               NMConnection *connection,
+                               NMSettingConnection *s_con,
+                               guint n,
+                               char **out_first_path)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		gs_free char *id = g_strdup_printf ("test-connection-get-settings-%u", i);
+		gs_free char *path = NULL;
+
+		g_object_set (s_con,
+		              NM_SETTING_CONNECTION_ID, id,
+		              NM_SETTING_CONNECTION_UUID, nmtst_uuid_generate (),
+		              NULL);
+		nmtstc_service_add_connection (sinfo,
+		                               connection,
+		                               TRUE,
+		                               &path);
+		if (i == 0 && out_first_path)
+			*out_first_path = g_steal_pointer (&path);
+	}
+}
+
+static void
+test_connection_get_settings (gconstpointer test_data)
+{
+	const NMClientInstanceFlags instance_flags = GPOINTER_TO_UINT (test_data);
+	NMTSTC_SERVICE_INFO_SETUP (my_sinfo)
+	gs_unref_object NMConnection *connection = NULL;
+	gs_unref_object NMClient *client = NULL;
+	NMSettingConnection *s_con;
+	const GPtrArray *connections;
+	NMRemoteConnection *remote;
+	gs_free char *path_updated = NULL;
+	gulong signal_id;
+	guint n_get_settings;
+	guint n_get_all_settings;
+	guint i;
+
+	connection = nmtst_create_minimal_connection ("test-connection-get-settings", NULL, NM_SETTING_WIRED_SETTING_NAME, &s_con);
+	nmtst_connection_normalize (connection);
+
+	_get_settings_add_connections (my_sinfo, connection, s_con, 5, &path_updated);
+
+	client = nmtstc_context_object_new (NM_TYPE_CLIENT,
+	                                    TRUE,
+	                                    NM_CLIENT_INSTANCE_FLAGS, (guint) instance_flags,
+	                                    NULL);
+	g_assert_cmpint (nm_client_get_instance_flags (client), ==, instance_flags);
+
+	connections = nm_client_get_connections (client);
+	g_assert (connections);
+	g_assert_cmpint (connections->len, ==, 5);
+
+	/* check that the profiles were fetched the way the flags ask for. */
+	_get_settings_call_counts (my_sinfo, &n_get_settings, &n_get_all_settings);
+	if (NM_FLAGS_HAS (instance_flags, NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS)) {
+		g_assert_cmpint (n_get_settings, ==, 0);
+		g_assert_cmpint (n_get_all_settings, ==, 0);
+	} else if (NM_FLAGS_HAS (instance_flags, NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS)) {
+		g_assert_cmpint (n_get_settings, ==, 0);
+		g_assert_cmpint (n_get_all_settings, ==, 1);
+	} else {
+		g_assert_cmpint (n_get_settings, ==, 5);
+		g_assert_cmpint (n_get_all_settings, ==, 0);
+	}
+
+	for (i = 0; i < connections->len; i++) {
+		NMConnection *con = connections->pdata[i];
+
+		g_assert (NM_IS_REMOTE_CONNECTION (con));
+		g_assert (nm_remote_connection_get_visible (NM_REMOTE_CONNECTION (con)));
+
+		/* with the lazy flag, this loads the settings. */
+		g_assert (g_str_has_prefix (nm_connection_get_id (con), "test-connection-get-settings-"));
+		nmtst_assert_connection_verifies_without_normalization (con);
+
+		if (NM_FLAGS_HAS (instance_flags, NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS)) {
+			_get_settings_call_counts (my_sinfo, &n_get_settings, &n_get_all_settings);
+			g_assert_cmpint (n_get_settings, ==, i + 1);
+			g_assert_cmpint (n_get_all_settings, ==, 0);
+		}
+	}
+
+	/* an update of a profile gets fetched in all modes. */
+	remote = nm_client_get_connection_by_path (client, path_updated);
+	g_assert (NM_IS_REMOTE_CONNECTION (remote));
+	g_object_set (s_con,
+	              NM_SETTING_CONNECTION_ID, "test-connection-get-settings-updated",
+	              NM_SETTING_CONNECTION_UUID, nm_connection_get_uuid (NM_CONNECTION (remote)),
+	              NULL);
+	signal_id = g_signal_connect_swapped (remote, NM_CONNECTION_CHANGED, G_CALLBACK (loop_quit), gl.loop);
+	nmtstc_service_update_connection (my_sinfo,
+	                                  path_updated,
+	                                  connection,
+	                                  TRUE);
+	g_assert (nmtst_main_loop_run (gl.loop, 2000));
+	nm_clear_g_signal_handler (remote, &signal_id);
+	g_assert_cmpstr (nm_connection_get_id (NM_CONNECTION (remote)), ==, "test-connection-get-settings-updated");
+}
+
+static void
+test_connection_get_settings_fail (gconstpointer test_data)
+{
+	const NMClientInstanceFlags instance_flags = GPOINTER_TO_UINT (test_data);
+	NMTSTC_SERVICE_INFO_SETUP (my_sinfo)
+	gs_unref_object NMConnection *connection = NULL;
+	gs_unref_object NMClient *client = NULL;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_free_error GError *error = NULL;
+	NMSettingConnection *s_con;
+	const GPtrArray *connections;
+	NMRemoteConnection *remote;
+	gs_free char *path_failed = NULL;
+	guint n_get_settings;
+	guint n_get_all_settings;
+	guint i;
+
+	connection = nmtst_create_minimal_connection ("test-connection-get-settings", NULL, NM_SETTING_WIRED_SETTING_NAME, &s_con);
+	nmtst_connection_normalize (connection);
+
+	_get_settings_add_connections (my_sinfo, connection, s_con, 5, &path_failed);
+
+	/* GetSettings() for the first profile fails with permission denied. */
+	ret = g_dbus_proxy_call_sync (my_sinfo->proxy,
+	                              "ConnectionSetVisible",
+	                              g_variant_new_parsed ("(false, {'path': %s})", path_failed),
+	                              G_DBUS_CALL_FLAGS_NO_AUTO_START,
+	                              3000,
+	                              NULL,
+	                              &error);
+	nmtst_assert_success (ret, error);
+	nm_clear_pointer (&ret, g_variant_unref);
+
+	/* and GetAllSettings() fails altogether. */
+	ret = g_dbus_proxy_call_sync (my_sinfo->proxy,
+	                              "SetGetAllSettingsFail",
+	                              g_variant_new ("(b)", TRUE),
+	                              G_DBUS_CALL_FLAGS_NO_AUTO_START,
+	                              3000,
+	                              NULL,
+	                              &error);
+	nmtst_assert_success (ret, error);
+
+	client = nmtstc_context_object_new (NM_TYPE_CLIENT,
+	                                    TRUE,
+	                                    NM_CLIENT_INSTANCE_FLAGS, (guint) instance_flags,
+	                                    NULL);
+
+	connections = nm_client_get_connections (client);
+	g_assert (connections);
+	g_assert_cmpint (connections->len, ==, 5);
+
+	_get_settings_call_counts (my_sinfo, &n_get_settings, &n_get_all_settings);
+	if (NM_FLAGS_HAS (instance_flags, NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS)) {
+		g_assert_cmpint (n_get_settings, ==, 0);
+		g_assert_cmpint (n_get_all_settings, ==, 0);
+	} else {
+		/* the failed GetAllSettings() call falls back to one call per profile. */
+		g_assert_cmpint (n_get_settings, ==, 5);
+		g_assert_cmpint (n_get_all_settings, ==, 1);
+	}
+
+	/* the profile whose settings failed to load has no settings
+	 * and is reported as not visible. */
+	remote = nm_client_get_connection_by_path (client, path_failed);
+	g_assert (NM_IS_REMOTE_CONNECTION (remote));
+	g_assert_cmpstr (nm_connection_get_id (NM_CONNECTION (remote)), ==, NULL);
+	g_assert (!nm_connection_get_setting_connection (NM_CONNECTION (remote)));
+	g_assert (!nm_remote_connection_get_visible (remote));
+
+	for (i = 0; i < connections->len; i++) {
+		NMConnection *con = connections->pdata[i];
+
+		if (con == NM_CONNECTION (remote))
+			continue;
+		g_assert (nm_remote_connection_get_visible (NM_REMOTE_CONNECTION (con)));
+		g_assert (g_str_has_prefix (nm_connection_get_id (con), "test-connection-get-settings-"));
+	}
+
+	_get_settings_call_counts (my_sinfo, &n_get_settings, &n_get_all_settings);
+	g_assert_cmpint (n_get_settings, ==, 5);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -1321,6 +1529,11 @@ main (int argc, char **argv)
 	g_test_add_func ("/libnm/activate-virtual", test_activate_virtual);
 	g_test_add_func ("/libnm/device-connection-compatibility", test_device_connection_compatibility);
 	g_test_add_func ("/libnm/connection/invalid", test_connection_invalid);
+	g_test_add_data_func ("/libnm/connection/get-settings/default", GUINT_TO_POINTER (NM_CLIENT_INSTANCE_FLAGS_NONE), test_connection_get_settings);
+	g_test_add_data_func ("/libnm/connection/get-settings/bulk", GUINT_TO_POINTER (NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS), test_connection_get_settings);
+	g_test_add_data_func ("/libnm/connection/get-settings/lazy", GUINT_TO_POINTER (NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS), test_connection_get_settings);
+	g_test_add_data_func ("/libnm/connection/get-settings-fail/bulk", GUINT_TO_POINTER (NM_CLIENT_INSTANCE_FLAGS_BULK_GET_SETTINGS), test_connection_get_settings_fail);
+	g_test_add_data_func ("/libnm/connection/get-settings-fail/lazy", GUINT_TO_POINTER (NM_CLIENT_INSTANCE_FLAGS_LAZY_GET_SETTINGS), test_connection_get_settings_fail);
 
 	return g_test_run ();
 }
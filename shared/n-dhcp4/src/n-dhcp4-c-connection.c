@@ -156,6 +156,23 @@ int n_dhcp4_c_connection_listen(NDhcp4CConnection *connection) {
                 connection->fd_udp = c_close(connection->fd_udp);
         }
 
+        if (connection->client_config->shared_packet_socket) {
+                /*
+                 * Incoming packets are read from a socket shared with other
+                 * clients and handed to us via
+                 * n_dhcp4_c_connection_dispatch_packet(). We only need a
+                 * socket to send on, which is never polled.
+                 */
+                r = n_dhcp4_c_socket_packet_new_tx(&fd_packet);
+                if (r)
+                        return r;
+
+                connection->state = N_DHCP4_C_CONNECTION_STATE_PACKET;
+                connection->fd_packet = fd_packet;
+                fd_packet = -1;
+                return 0;
+        }
+
         r = n_dhcp4_c_socket_packet_new(&fd_packet, connection->client_config->ifindex);
         if (r)
                 return r;
@@ -202,11 +219,21 @@ int n_dhcp4_c_connection_connect(NDhcp4CConnection *connection,
                 goto exit_fd;
         }
 
-        r = packet_shutdown(connection->fd_packet);
-        if (r < 0)
-                goto exit_epoll;
+        if (connection->client_config->shared_packet_socket) {
+                /*
+                 * The send-only packet socket has nothing queued, so there is
+                 * nothing to drain. Drop it right away.
+                 */
+                connection->fd_packet = c_close(connection->fd_packet);
+                connection->state = N_DHCP4_C_CONNECTION_STATE_UDP;
+        } else {
+                r = packet_shutdown(connection->fd_packet);
+                if (r < 0)
+                        goto exit_epoll;
+
+                connection->state = N_DHCP4_C_CONNECTION_STATE_DRAINING;
+        }
 
-        connection->state = N_DHCP4_C_CONNECTION_STATE_DRAINING;
         connection->fd_udp = fd_udp;
         connection->client_ip = client->s_addr;
         connection->server_ip = server->s_addr;
@@ -1136,6 +1163,68 @@ int n_dhcp4_c_connection_dispatch_timer(NDhcp4CConnection *connection,
         return 0;
 }
 
+static int n_dhcp4_c_connection_dispatch_incoming(NDhcp4CConnection *connection,
+                                                  NDhcp4Incoming **incomingp,
+                                                  NDhcp4Incoming **messagep) {
+        NDhcp4Incoming *message = *incomingp;
+        char serv_addr[INET_ADDRSTRLEN];
+        char client_addr[INET_ADDRSTRLEN];
+        uint8_t type;
+        int r;
+
+        r = n_dhcp4_c_connection_verify_incoming(connection, message, &type);
+        if (r == N_DHCP4_E_MALFORMED || r == N_DHCP4_E_UNEXPECTED)
+                return r;
+        else if (r != 0)
+                return N_DHCP4_E_AGAIN;
+
+        if (type == N_DHCP4_MESSAGE_OFFER || type == N_DHCP4_MESSAGE_ACK) {
+                n_dhcp4_c_log(connection->client_config, LOG_INFO,
+                              "received %s of %s from %s",
+                              message_type_to_str(type),
+                              inet_ntop(AF_INET, &message->message.header.yiaddr,
+                                        client_addr, sizeof(client_addr)),
+                              inet_ntop(AF_INET, &message->message.header.siaddr,
+                                        serv_addr, sizeof(serv_addr)));
+        } else {
+                n_dhcp4_c_log(connection->client_config, LOG_INFO,
+                              "received %s from %s",
+                              message_type_to_str(type),
+                              inet_ntop(AF_INET, &message->message.header.siaddr,
+                                        serv_addr, sizeof(serv_addr)));
+        }
+
+        switch (type) {
+        case N_DHCP4_MESSAGE_OFFER:
+        case N_DHCP4_MESSAGE_ACK:
+        case N_DHCP4_MESSAGE_NAK:
+                /*
+                 * Remember the start time of the transaction, and the base
+                 * time of any relative timestamps from the pending request.
+                 * Thes same times applies to the response, and sholud be
+                 * copied over.
+                 */
+                message->userdata.start_time = connection->request->userdata.start_time;
+                message->userdata.base_time = connection->request->userdata.base_time;
+
+                if (type != N_DHCP4_MESSAGE_OFFER) {
+                        /*
+                         * We only allow one reply to ACK or NAK, but for OFFER we must
+                         * accept several, so we do not free the pinned request.
+                         */
+                        connection->request = n_dhcp4_outgoing_free(connection->request);
+                }
+
+                break;
+        default:
+                break;
+        }
+
+        *messagep = message;
+        *incomingp = NULL;
+        return 0;
+}
+
 /*
  * Returns:
  *  0                     on success
@@ -1146,9 +1235,6 @@ int n_dhcp4_c_connection_dispatch_timer(NDhcp4CConnection *connection,
 int n_dhcp4_c_connection_dispatch_io(NDhcp4CConnection *connection,
                                      NDhcp4Incoming **messagep) {
         _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = NULL;
-        char serv_addr[INET_ADDRSTRLEN];
-        char client_addr[INET_ADDRSTRLEN];
-        uint8_t type;
         int r;
 
         switch (connection->state) {
@@ -1200,55 +1286,35 @@ int n_dhcp4_c_connection_dispatch_io(NDhcp4CConnection *connection,
                 return -ENOTRECOVERABLE;
         }
 
-        r = n_dhcp4_c_connection_verify_incoming(connection, message, &type);
-        if (r == N_DHCP4_E_MALFORMED || r == N_DHCP4_E_UNEXPECTED)
-                return r;
-        else if (r != 0)
-                return N_DHCP4_E_AGAIN;
-
-        if (type == N_DHCP4_MESSAGE_OFFER || type == N_DHCP4_MESSAGE_ACK) {
-                n_dhcp4_c_log(connection->client_config, LOG_INFO,
-                              "received %s of %s from %s",
-                              message_type_to_str(type),
-                              inet_ntop(AF_INET, &message->message.header.yiaddr,
-                                        client_addr, sizeof(client_addr)),
-                              inet_ntop(AF_INET, &message->message.header.siaddr,
-                                        serv_addr, sizeof(serv_addr)));
-        } else {
-                n_dhcp4_c_log(connection->client_config, LOG_INFO,
-                              "received %s from %s",
-                              message_type_to_str(type),
-                              inet_ntop(AF_INET, &message->message.header.siaddr,
-                                        serv_addr, sizeof(serv_addr)));
-        }
+        return n_dhcp4_c_connection_dispatch_incoming(connection, &message, messagep);
+}
 
-        switch (type) {
-        case N_DHCP4_MESSAGE_OFFER:
-        case N_DHCP4_MESSAGE_ACK:
-        case N_DHCP4_MESSAGE_NAK:
-                /*
-                 * Remember the start time of the transaction, and the base
-                 * time of any relative timestamps from the pending request.
-                 * Thes same times applies to the response, and sholud be
-                 * copied over.
-                 */
-                message->userdata.start_time = connection->request->userdata.start_time;
-                message->userdata.base_time = connection->request->userdata.base_time;
+/*
+ * Same as n_dhcp4_c_connection_dispatch_io(), but for a packet that was read
+ * by the caller from a shared packet socket. Such packets are only relevant as
+ * long as we have no UDP socket, otherwise they are dropped.
+ *
+ * Returns:
+ *  0                     on success
+ *  N_DHCP4_E_MALFORMED   if the packet is malformed
+ *  N_DHCP4_E_UNEXPECTED  if the packet contains unexpected data
+ *  N_DHCP4_E_AGAIN       if the packet was dropped
+ */
+int n_dhcp4_c_connection_dispatch_packet(NDhcp4CConnection *connection,
+                                         const void *data,
+                                         size_t n_data,
+                                         NDhcp4Incoming **messagep) {
+        _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = NULL;
+        int r;
 
-                if (type != N_DHCP4_MESSAGE_OFFER) {
-                        /*
-                         * We only allow one reply to ACK or NAK, but for OFFER we must
-                         * accept several, so we do not free the pinned request.
-                         */
-                        connection->request = n_dhcp4_outgoing_free(connection->request);
-                }
+        if (connection->state != N_DHCP4_C_CONNECTION_STATE_PACKET)
+                return N_DHCP4_E_AGAIN;
 
-                break;
-        default:
-                break;
-        }
+        r = n_dhcp4_incoming_new(&message, data, n_data);
+        if (r == N_DHCP4_E_MALFORMED)
+                return r;
+        else if (r)
+                return N_DHCP4_E_AGAIN;
 
-        *messagep = message;
-        message = NULL;
-        return 0;
+        return n_dhcp4_c_connection_dispatch_incoming(connection, &message, messagep);
 }
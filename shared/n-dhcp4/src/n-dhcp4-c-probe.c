@@ -1219,15 +1219,10 @@ int n_dhcp4_client_probe_dispatch_timer(NDhcp4ClientProbe *probe, uint64_t ns_no
         return 0;
 }
 
-/**
- * n_dhcp4_client_probe_dispatch_connection() - XXX
- */
-int n_dhcp4_client_probe_dispatch_io(NDhcp4ClientProbe *probe, uint32_t events) {
-        _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = NULL;
+static int n_dhcp4_client_probe_dispatch_message(NDhcp4ClientProbe *probe, int r, NDhcp4Incoming *message_take) {
+        _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = message_take;
         uint8_t type;
-        int r;
 
-        r = n_dhcp4_c_connection_dispatch_io(&probe->connection, &message);
         if (r) {
                 if (r == N_DHCP4_E_AGAIN)
                         return 0;
@@ -1290,6 +1285,28 @@ int n_dhcp4_client_probe_dispatch_io(NDhcp4ClientProbe *probe, uint32_t events)
         return 0;
 }
 
+/**
+ * n_dhcp4_client_probe_dispatch_connection() - XXX
+ */
+int n_dhcp4_client_probe_dispatch_io(NDhcp4ClientProbe *probe, uint32_t events) {
+        NDhcp4Incoming *message = NULL;
+        int r;
+
+        r = n_dhcp4_c_connection_dispatch_io(&probe->connection, &message);
+        return n_dhcp4_client_probe_dispatch_message(probe, r, message);
+}
+
+/**
+ * n_dhcp4_client_probe_dispatch_packet() - dispatch packet from shared socket
+ */
+int n_dhcp4_client_probe_dispatch_packet(NDhcp4ClientProbe *probe, const void *data, size_t n_data) {
+        NDhcp4Incoming *message = NULL;
+        int r;
+
+        r = n_dhcp4_c_connection_dispatch_packet(&probe->connection, data, n_data, &message);
+        return n_dhcp4_client_probe_dispatch_message(probe, r, message);
+}
+
 /**
  * n_dhcp4_client_probe_update_mtu() - XXX
  */
@@ -94,6 +94,7 @@ int n_dhcp4_client_config_dup(NDhcp4ClientConfig *config, NDhcp4ClientConfig **d
         dup->n_mac = config->n_mac;
         memcpy(dup->broadcast_mac, config->broadcast_mac, sizeof(dup->broadcast_mac));
         dup->n_broadcast_mac = config->n_broadcast_mac;
+        dup->shared_packet_socket = config->shared_packet_socket;
         dup->log.level = config->log.level;
         dup->log.func = config->log.func;
         dup->log.data = config->log.data;
@@ -251,6 +252,25 @@ _c_public_ int n_dhcp4_client_config_set_client_id(NDhcp4ClientConfig *config, c
         return 0;
 }
 
+/**
+ * n_dhcp4_client_config_set_shared_packet_socket() - set shared-packet-socket property
+ * @config:                     client configuration to operate on
+ * @shared_packet_socket:       value to set
+ *
+ * This sets the shared-packet-socket property of the client configuration.
+ *
+ * The default is false, in which case every client opens its own AF_PACKET
+ * socket with its own BPF filter while it has no IP address configured. If
+ * set to true, the client does not listen on a packet socket at all. Instead,
+ * the caller reads all packets from a single socket created via
+ * n_dhcp4_client_packet_socket_new(), and hands them to the client running on
+ * the receiving interface via n_dhcp4_client_dispatch_packet(). This avoids
+ * one socket and one filter per client when running many clients.
+ */
+_c_public_ void n_dhcp4_client_config_set_shared_packet_socket(NDhcp4ClientConfig *config, bool shared_packet_socket) {
+        config->shared_packet_socket = shared_packet_socket;
+}
+
 _c_public_ void n_dhcp4_client_config_set_log_level(NDhcp4ClientConfig *config, int level) {
         config->log.level = level;
 }
@@ -626,6 +646,24 @@ static int n_dhcp4_client_dispatch_io(NDhcp4Client *client, struct epoll_event *
         return r;
 }
 
+static int n_dhcp4_client_dispatch_error(NDhcp4Client *client, int r) {
+        if (r == N_DHCP4_E_DOWN) {
+                /* continue normally */
+                return n_dhcp4_client_raise(client,
+                                            NULL,
+                                            N_DHCP4_CLIENT_EVENT_DOWN);
+        }
+
+        if (r >= _N_DHCP4_E_INTERNAL) {
+                n_dhcp4_c_log(client->config, LOG_ERR,
+                              "invalid internal error code %d after dispatch",
+                              r);
+                return N_DHCP4_E_INTERNAL;
+        }
+
+        return r;
+}
+
 /**
  * n_dhcp4_client_dispatch() - dispatch client
  * @client:                     client to operate on
@@ -672,23 +710,9 @@ _c_public_ int n_dhcp4_client_dispatch(NDhcp4Client *client) {
                 }
 
                 if (r) {
-                        if (r == N_DHCP4_E_DOWN) {
-                                r = n_dhcp4_client_raise(client,
-                                                         NULL,
-                                                         N_DHCP4_CLIENT_EVENT_DOWN);
-                                if (r)
-                                        return r;
-
-                                /* continue normally */
-                        } else if (r) {
-                                if (r >= _N_DHCP4_E_INTERNAL) {
-                                        n_dhcp4_c_log(client->config, LOG_ERR,
-                                                      "invalid internal error code %d after dispatch",
-                                                      r);
-                                        return N_DHCP4_E_INTERNAL;
-                                }
+                        r = n_dhcp4_client_dispatch_error(client, r);
+                        if (r)
                                 return r;
-                        }
                 }
         }
 
@@ -697,6 +721,99 @@ _c_public_ int n_dhcp4_client_dispatch(NDhcp4Client *client) {
         return client->preempted ? N_DHCP4_E_PREEMPTED : 0;
 }
 
+/**
+ * n_dhcp4_client_dispatch_packet() - dispatch packet from shared socket
+ * @client:                     client to operate on
+ * @data:                       DHCP payload of the packet
+ * @n_data:                     length of @data in bytes
+ *
+ * This hands a packet read from a shared packet socket to @client. The caller
+ * is responsible to only pass packets received on the interface @client runs
+ * on. Packets that do not belong to the current transaction of @client are
+ * silently dropped, just like they would be on a private socket. Packets
+ * arriving after the client switched to its UDP socket are dropped as well.
+ *
+ * This must only be used on clients configured via
+ * n_dhcp4_client_config_set_shared_packet_socket(). Any resulting events are
+ * queued on the client and can be retrieved via n_dhcp4_client_pop_event().
+ *
+ * Return: 0 on success, negative error code on failure.
+ */
+_c_public_ int n_dhcp4_client_dispatch_packet(NDhcp4Client *client, const void *data, size_t n_data) {
+        int r;
+
+        c_assert(client->config->shared_packet_socket);
+
+        if (!client->current_probe)
+                return 0;
+
+        r = n_dhcp4_client_probe_dispatch_packet(client->current_probe, data, n_data);
+        if (r) {
+                r = n_dhcp4_client_dispatch_error(client, r);
+                if (r)
+                        return r;
+        }
+
+        n_dhcp4_client_arm_timer(client);
+
+        return 0;
+}
+
+/**
+ * n_dhcp4_client_packet_socket_new() - create shared packet socket
+ * @fdp:                        output argument for the new socket
+ *
+ * This creates a non-blocking packet socket that receives the DHCP replies
+ * of all interfaces. It is meant to be shared by all clients configured via
+ * n_dhcp4_client_config_set_shared_packet_socket(). The caller owns the socket
+ * and must close it eventually. Use n_dhcp4_client_packet_socket_recv() to
+ * read from it whenever it is readable.
+ *
+ * Return: 0 on success, negative error code on failure.
+ */
+_c_public_ int n_dhcp4_client_packet_socket_new(int *fdp) {
+        return n_dhcp4_c_socket_packet_new(fdp, 0);
+}
+
+/**
+ * n_dhcp4_client_packet_socket_recv() - read from shared packet socket
+ * @fd:                         socket created via n_dhcp4_client_packet_socket_new()
+ * @buf:                        buffer to read the DHCP payload into
+ * @n_buf:                      size of @buf in bytes
+ * @n_datap:                    output argument for the length of the payload
+ * @ifindexp:                   output argument for the receiving interface
+ *
+ * This reads the next packet from @fd, strips the IP and UDP headers and
+ * returns the DHCP payload together with the interface it was received on.
+ * The caller is expected to hand it to the client running on that interface
+ * via n_dhcp4_client_dispatch_packet(). The buffer should be large enough to
+ * hold any UDP payload (UINT16_MAX bytes).
+ *
+ * If a packet was read but had to be discarded, 0 is returned and @n_datap is
+ * set to 0. The caller should call this again, until N_DHCP4_E_PREEMPTED is
+ * returned to signal that the socket is drained.
+ *
+ * Return: 0 on success, N_DHCP4_E_PREEMPTED if there is nothing to read,
+ *         negative error code on failure.
+ */
+_c_public_ int n_dhcp4_client_packet_socket_recv(int fd,
+                                                 void *buf,
+                                                 size_t n_buf,
+                                                 size_t *n_datap,
+                                                 int *ifindexp) {
+        int r;
+
+        r = n_dhcp4_c_socket_packet_recvfrom(fd, buf, n_buf, n_datap, ifindexp);
+        if (r == N_DHCP4_E_AGAIN || r == N_DHCP4_E_DOWN)
+                return N_DHCP4_E_PREEMPTED;
+        else if (r == N_DHCP4_E_MALFORMED)
+                *n_datap = 0;
+        else if (r)
+                return r;
+
+        return 0;
+}
+
 /**
  * n_dhcp4_client_pop_event() - fetch pending event
  * @client:                     client to operate on
@@ -242,6 +242,7 @@ struct NDhcp4ClientConfig {
         size_t n_broadcast_mac;
         uint8_t *client_id;
         size_t n_client_id;
+        bool shared_packet_socket;
         struct {
                 int level;
                 NDhcp4LogFunc func;
@@ -454,7 +455,15 @@ struct NDhcp4ServerLease {
         CList server_link;
 
         NDhcp4Incoming *request;
-        NDhcp4Incoming *reply;
+
+        struct in_addr yiaddr;          /* address to offer/ack, or INADDR_ANY */
+        uint32_t lifetime;              /* lifetime in seconds */
+
+        uint8_t *options;               /* appended options, as code/len/data */
+        size_t n_options;
+
+        uint8_t client_id[1 + 16];      /* htype + chaddr, without client-id */
+        size_t n_client_id;
 };
 
 #define N_DHCP4_SERVER_LEASE_NULL(_x) {                                         \
@@ -506,6 +515,7 @@ void n_dhcp4_incoming_get_yiaddr(NDhcp4Incoming *message, struct in_addr *yiaddr
 /* sockets */
 
 int n_dhcp4_c_socket_packet_new(int *sockfdp, int ifindex);
+int n_dhcp4_c_socket_packet_new_tx(int *sockfdp);
 int n_dhcp4_c_socket_udp_new(int *sockfdp,
                              int ifindex,
                              const struct in_addr *client_addr,
@@ -535,6 +545,11 @@ int n_dhcp4_s_socket_udp_broadcast(int sockfd,
                                    const struct in_addr *inaddr_src,
                                    NDhcp4Outgoing *message);
 
+int n_dhcp4_c_socket_packet_recvfrom(int sockfd,
+                                     uint8_t *buf,
+                                     size_t n_buf,
+                                     size_t *n_datap,
+                                     int *ifindexp);
 int n_dhcp4_c_socket_packet_recv(int sockfd,
                                  uint8_t *buf,
                                  size_t n_buf,
@@ -611,6 +626,10 @@ int n_dhcp4_c_connection_dispatch_timer(NDhcp4CConnection *connection,
                                         uint64_t timestamp);
 int n_dhcp4_c_connection_dispatch_io(NDhcp4CConnection *connection,
                                      NDhcp4Incoming **messagep);
+int n_dhcp4_c_connection_dispatch_packet(NDhcp4CConnection *connection,
+                                         const void *data,
+                                         size_t n_data,
+                                         NDhcp4Incoming **messagep);
 
 /* clients */
 
@@ -628,6 +647,7 @@ int n_dhcp4_client_probe_raise(NDhcp4ClientProbe *probe, NDhcp4CEventNode **node
 void n_dhcp4_client_probe_get_timeout(NDhcp4ClientProbe *probe, uint64_t *timeoutp);
 int n_dhcp4_client_probe_dispatch_timer(NDhcp4ClientProbe *probe, uint64_t ns_now);
 int n_dhcp4_client_probe_dispatch_io(NDhcp4ClientProbe *probe, uint32_t events);
+int n_dhcp4_client_probe_dispatch_packet(NDhcp4ClientProbe *probe, const void *data, size_t n_data);
 int n_dhcp4_client_probe_transition_select(NDhcp4ClientProbe *probe, NDhcp4Incoming *offer, uint64_t ns_now);
 int n_dhcp4_client_probe_transition_accept(NDhcp4ClientProbe *probe, NDhcp4Incoming *ack);
 int n_dhcp4_client_probe_transition_decline(NDhcp4ClientProbe *probe, NDhcp4Incoming *offer, const char *error, uint64_t ns_now);
@@ -668,6 +688,18 @@ int n_dhcp4_s_connection_send_reply(NDhcp4SConnection *connection,
                                     const struct in_addr *server_addr,
                                     NDhcp4Outgoing *reply);
 
+/* server leases */
+
+int n_dhcp4_server_lease_new(NDhcp4ServerLease **leasep, NDhcp4Incoming *message);
+void n_dhcp4_server_lease_link(NDhcp4ServerLease *lease, NDhcp4Server *server);
+void n_dhcp4_server_lease_unlink(NDhcp4ServerLease *lease);
+
+/* server events */
+
+int n_dhcp4_s_event_node_new(NDhcp4SEventNode **nodep);
+NDhcp4SEventNode *n_dhcp4_s_event_node_free(NDhcp4SEventNode *node);
+int n_dhcp4_server_raise(NDhcp4Server *server, NDhcp4SEventNode **nodep, unsigned int event);
+
 /* server connection ips */
 
 void n_dhcp4_s_connection_ip_init(NDhcp4SConnectionIp *ip, struct in_addr addr);
@@ -1,7 +1,8 @@
 /*
  * DHCPv4 Server Connection
  *
- * XXX
+ * The server connection wraps the sockets of a DHCP server. It receives and
+ * classifies requests from clients, and builds and sends the replies.
  */
 
 #include <assert.h>
@@ -261,8 +262,13 @@ static int n_dhcp4_s_connection_new_reply(NDhcp4SConnection *connection,
         int r;
 
         r = n_dhcp4_incoming_query_max_message_size(request, &max_message_size);
-        if (r)
-                return r;
+        if (r) {
+                if (r != N_DHCP4_E_UNSET)
+                        return r;
+
+                /* fall back to the minimum every client must accept */
+                max_message_size = 0;
+        }
 
         r = n_dhcp4_outgoing_new(&message,
                                  max_message_size,
@@ -406,6 +412,9 @@ void n_dhcp4_s_connection_ip_link(NDhcp4SConnectionIp *ip, NDhcp4SConnection *co
 }
 
 void n_dhcp4_s_connection_ip_unlink(NDhcp4SConnectionIp *ip) {
+        if (!ip->connection)
+                return;
+
         ip->connection->ip = NULL;
         ip->connection = NULL;
 }
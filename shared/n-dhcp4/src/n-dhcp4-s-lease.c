@@ -1,5 +1,9 @@
 /*
- * XXX
+ * DHCPv4 Server Leases
+ *
+ * A server lease represents a single request of a client. It is handed to the
+ * API user via server events. The user decides on the address to hand out
+ * (if any), and replies with an offer, an acknowledgement or a rejection.
  */
 
 #include <assert.h>
@@ -12,7 +16,14 @@
 #include "n-dhcp4-private.h"
 
 /**
- * n_dhcp4_server_lease_new() - XXX
+ * n_dhcp4_server_lease_new() - allocate new server lease
+ * @leasep:                     output argument for new lease
+ * @message:                    the request of the client
+ *
+ * This allocates a new lease for the given request. On success, the lease
+ * takes ownership of @message.
+ *
+ * Return: 0 on success, negative error code on failure.
  */
 int n_dhcp4_server_lease_new(NDhcp4ServerLease **leasep, NDhcp4Incoming *message) {
         _c_cleanup_(n_dhcp4_server_lease_unrefp) NDhcp4ServerLease *lease = NULL;
@@ -33,16 +44,45 @@ int n_dhcp4_server_lease_new(NDhcp4ServerLease **leasep, NDhcp4Incoming *message
 }
 
 static void n_dhcp4_server_lease_free(NDhcp4ServerLease *lease) {
-        c_assert(!lease->server);
-
-        c_list_unlink(&lease->server_link);
+        n_dhcp4_server_lease_unlink(lease);
 
         n_dhcp4_incoming_free(lease->request);
+        free(lease->options);
         free(lease);
 }
 
 /**
- * n_dhcp4_server_lease_ref() - XXX
+ * n_dhcp4_server_lease_link() - link lease into server
+ * @lease:                      the lease to operate on
+ * @server:                     the server to link to
+ *
+ * This links @lease into @server. Only linked leases can be replied to. The
+ * link is weak, if the server is destroyed, it unlinks all its leases.
+ */
+void n_dhcp4_server_lease_link(NDhcp4ServerLease *lease, NDhcp4Server *server) {
+        c_assert(!lease->server);
+
+        lease->server = server;
+        c_list_link_tail(&server->lease_list, &lease->server_link);
+}
+
+/**
+ * n_dhcp4_server_lease_unlink() - unlink lease from its server
+ * @lease:                      the lease to operate on
+ *
+ * This unlinks @lease from its server, if it is linked. Replies to an
+ * unlinked lease fail.
+ */
+void n_dhcp4_server_lease_unlink(NDhcp4ServerLease *lease) {
+        lease->server = NULL;
+        c_list_unlink(&lease->server_link);
+}
+
+/**
+ * n_dhcp4_server_lease_ref() - acquire a lease reference
+ * @lease:                      the lease to operate on
+ *
+ * Return: @lease is returned.
  */
 _c_public_ NDhcp4ServerLease *n_dhcp4_server_lease_ref(NDhcp4ServerLease *lease) {
         if (lease)
@@ -51,7 +91,10 @@ _c_public_ NDhcp4ServerLease *n_dhcp4_server_lease_ref(NDhcp4ServerLease *lease)
 }
 
 /**
- * n_dhcp4_server_lease_unref() - XXX
+ * n_dhcp4_server_lease_unref() - release a lease reference
+ * @lease:                      the lease to operate on
+ *
+ * Return: NULL is returned.
  */
 _c_public_ NDhcp4ServerLease *n_dhcp4_server_lease_unref(NDhcp4ServerLease *lease) {
         if (lease && !--lease->n_refs)
@@ -60,7 +103,86 @@ _c_public_ NDhcp4ServerLease *n_dhcp4_server_lease_unref(NDhcp4ServerLease *leas
 }
 
 /**
- * n_dhcp4_server_lease_query() - XXX
+ * n_dhcp4_server_lease_get_client_id() - get the client identifier
+ * @lease:                      the lease to operate on
+ * @idp:                        return argument for the identifier
+ * @n_idp:                      return argument for the length of the identifier
+ *
+ * This returns the identifier of the client that sent the request. This is
+ * the client-identifier option, if the client sent one. Otherwise, it is the
+ * hardware type followed by the client hardware address, as suggested in
+ * RFC-2132. The returned data is owned by the lease.
+ */
+_c_public_ void n_dhcp4_server_lease_get_client_id(NDhcp4ServerLease *lease, const uint8_t **idp, size_t *n_idp) {
+        NDhcp4Header *header;
+        uint8_t *data;
+        size_t n_data;
+        int r;
+
+        r = n_dhcp4_incoming_query(lease->request, N_DHCP4_OPTION_CLIENT_IDENTIFIER, &data, &n_data);
+        if (!r && n_data > 0) {
+                *idp = data;
+                *n_idp = n_data;
+                return;
+        }
+
+        if (!lease->n_client_id) {
+                header = n_dhcp4_incoming_get_header(lease->request);
+
+                lease->client_id[0] = header->htype;
+                lease->n_client_id = 1 + c_min((size_t)header->hlen, sizeof(header->chaddr));
+                memcpy(lease->client_id + 1, header->chaddr, lease->n_client_id - 1);
+        }
+
+        *idp = lease->client_id;
+        *n_idp = lease->n_client_id;
+}
+
+/**
+ * n_dhcp4_server_lease_get_chaddr() - get the client hardware address
+ * @lease:                      the lease to operate on
+ * @chaddrp:                    return argument for the hardware address
+ * @n_chaddrp:                  return argument for the length of the address
+ *
+ * This returns the hardware address of the client that sent the request. The
+ * returned data is owned by the lease.
+ */
+_c_public_ void n_dhcp4_server_lease_get_chaddr(NDhcp4ServerLease *lease, const uint8_t **chaddrp, size_t *n_chaddrp) {
+        NDhcp4Header *header = n_dhcp4_incoming_get_header(lease->request);
+
+        *chaddrp = header->chaddr;
+        *n_chaddrp = c_min((size_t)header->hlen, sizeof(header->chaddr));
+}
+
+/**
+ * n_dhcp4_server_lease_get_requested_ip() - get the address the client asks for
+ * @lease:                      the lease to operate on
+ * @ipp:                        return argument for the address
+ *
+ * This returns the address from the requested-ip option. If the client did
+ * not send that option, this is the client address (ciaddr) of a renewing or
+ * rebinding client. If there is neither, INADDR_ANY is returned.
+ */
+_c_public_ void n_dhcp4_server_lease_get_requested_ip(NDhcp4ServerLease *lease, struct in_addr *ipp) {
+        int r;
+
+        r = n_dhcp4_incoming_query_requested_ip(lease->request, ipp);
+        if (r)
+                *ipp = (struct in_addr){ n_dhcp4_incoming_get_header(lease->request)->ciaddr };
+}
+
+/**
+ * n_dhcp4_server_lease_query() - query an option of the request
+ * @lease:                      the lease to operate on
+ * @option:                     the option to query
+ * @datap:                      return argument for the option data
+ * @n_datap:                    return argument for the length of the data
+ *
+ * This queries an option sent by the client. Options that are handled by the
+ * library itself cannot be queried.
+ *
+ * Return: 0 on success, N_DHCP4_E_UNSET if the option was not sent, or
+ *         N_DHCP4_E_INTERNAL for an option that cannot be queried.
  */
 _c_public_ int n_dhcp4_server_lease_query(NDhcp4ServerLease *lease, uint8_t option, uint8_t **datap, size_t *n_datap) {
         switch (option) {
@@ -82,22 +204,181 @@ _c_public_ int n_dhcp4_server_lease_query(NDhcp4ServerLease *lease, uint8_t opti
         return n_dhcp4_incoming_query(lease->request, option, datap, n_datap);
 }
 
+/**
+ * n_dhcp4_server_lease_set_yiaddr() - set the address to hand out
+ * @lease:                      the lease to operate on
+ * @yiaddr:                     the client address
+ * @lifetime:                   the lifetime of the address, in seconds
+ *
+ * This sets the address and lifetime that are sent with the next offer or
+ * acknowledgement of @lease.
+ */
+_c_public_ void n_dhcp4_server_lease_set_yiaddr(NDhcp4ServerLease *lease, struct in_addr yiaddr, uint32_t lifetime) {
+        lease->yiaddr = yiaddr;
+        lease->lifetime = lifetime;
+}
+
+/**
+ * n_dhcp4_server_lease_append() - append an option to the reply
+ * @lease:                      the lease to operate on
+ * @option:                     the option to append
+ * @data:                       the option data
+ * @n_data:                     the length of the data
+ *
+ * This appends an option (e.g., the router or the DNS servers) to the offer
+ * and acknowledgement that are sent for @lease. Options that are handled by
+ * the library itself cannot be appended.
+ *
+ * Return: 0 on success, N_DHCP4_E_INTERNAL for an option that cannot be
+ *         appended, N_DHCP4_E_DUPLICATE_OPTION if the option was already
+ *         appended, or a negative error code on failure.
+ */
 _c_public_ int n_dhcp4_server_lease_append(NDhcp4ServerLease *lease, uint8_t option, uint8_t *data, size_t n_data) {
-        /* XXX */
-        return -ENOTRECOVERABLE;
+        uint8_t *options;
+        size_t i;
+
+        switch (option) {
+        case N_DHCP4_OPTION_PAD:
+        case N_DHCP4_OPTION_REQUESTED_IP_ADDRESS:
+        case N_DHCP4_OPTION_IP_ADDRESS_LEASE_TIME:
+        case N_DHCP4_OPTION_OVERLOAD:
+        case N_DHCP4_OPTION_MESSAGE_TYPE:
+        case N_DHCP4_OPTION_SERVER_IDENTIFIER:
+        case N_DHCP4_OPTION_CLIENT_IDENTIFIER:
+        case N_DHCP4_OPTION_PARAMETER_REQUEST_LIST:
+        case N_DHCP4_OPTION_MAXIMUM_MESSAGE_SIZE:
+        case N_DHCP4_OPTION_RENEWAL_T1_TIME:
+        case N_DHCP4_OPTION_REBINDING_T2_TIME:
+        case N_DHCP4_OPTION_END:
+                return N_DHCP4_E_INTERNAL;
+        }
+
+        if (n_data > UINT8_MAX)
+                return N_DHCP4_E_INTERNAL;
+
+        for (i = 0; i < lease->n_options; i += 2 + lease->options[i + 1])
+                if (lease->options[i] == option)
+                        return N_DHCP4_E_DUPLICATE_OPTION;
+
+        options = realloc(lease->options, lease->n_options + 2 + n_data);
+        if (!options)
+                return -ENOMEM;
+
+        options[lease->n_options] = option;
+        options[lease->n_options + 1] = n_data;
+        memcpy(options + lease->n_options + 2, data, n_data);
+
+        lease->options = options;
+        lease->n_options += 2 + n_data;
+        return 0;
+}
+
+static int n_dhcp4_server_lease_append_options(NDhcp4ServerLease *lease, NDhcp4Outgoing *reply) {
+        size_t i;
+        int r;
+
+        for (i = 0; i < lease->n_options; i += 2 + lease->options[i + 1]) {
+                r = n_dhcp4_outgoing_append(reply,
+                                            lease->options[i],
+                                            lease->options + i + 2,
+                                            lease->options[i + 1]);
+                if (r)
+                        return r;
+        }
+
+        return 0;
+}
+
+static int n_dhcp4_server_lease_reply(NDhcp4ServerLease *lease, uint8_t type) {
+        _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *reply = NULL;
+        NDhcp4SConnection *connection;
+        int r;
+
+        if (!lease->server || !lease->server->connection.ip)
+                return N_DHCP4_E_INTERNAL;
+
+        connection = &lease->server->connection;
+
+        switch (type) {
+        case N_DHCP4_MESSAGE_OFFER:
+        case N_DHCP4_MESSAGE_ACK:
+                if (lease->yiaddr.s_addr == INADDR_ANY)
+                        return N_DHCP4_E_INVALID_ADDRESS;
+
+                if (type == N_DHCP4_MESSAGE_OFFER)
+                        r = n_dhcp4_s_connection_offer_new(connection,
+                                                           &reply,
+                                                           lease->request,
+                                                           &connection->ip->ip,
+                                                           &lease->yiaddr,
+                                                           lease->lifetime);
+                else
+                        r = n_dhcp4_s_connection_ack_new(connection,
+                                                         &reply,
+                                                         lease->request,
+                                                         &connection->ip->ip,
+                                                         &lease->yiaddr,
+                                                         lease->lifetime);
+                if (r)
+                        return r;
+
+                r = n_dhcp4_server_lease_append_options(lease, reply);
+                if (r)
+                        return r;
+
+                break;
+        case N_DHCP4_MESSAGE_NAK:
+                r = n_dhcp4_s_connection_nak_new(connection,
+                                                 &reply,
+                                                 lease->request,
+                                                 &connection->ip->ip);
+                if (r)
+                        return r;
+
+                break;
+        default:
+                c_assert(0);
+                return N_DHCP4_E_INTERNAL;
+        }
+
+        return n_dhcp4_s_connection_send_reply(connection, &connection->ip->ip, reply);
 }
 
+/**
+ * n_dhcp4_server_lease_offer() - offer an address to the client
+ * @lease:                      the lease to operate on
+ *
+ * This sends a DHCPOFFER for the address set with
+ * n_dhcp4_server_lease_set_yiaddr(), in reply to a DHCPDISCOVER.
+ *
+ * Return: 0 on success, or an error code on failure.
+ */
 _c_public_ int n_dhcp4_server_lease_offer(NDhcp4ServerLease *lease) {
-        /* XXX */
-        return -ENOTRECOVERABLE;
+        return n_dhcp4_server_lease_reply(lease, N_DHCP4_MESSAGE_OFFER);
 }
 
+/**
+ * n_dhcp4_server_lease_ack() - acknowledge the address to the client
+ * @lease:                      the lease to operate on
+ *
+ * This sends a DHCPACK for the address set with
+ * n_dhcp4_server_lease_set_yiaddr(), in reply to a DHCPREQUEST.
+ *
+ * Return: 0 on success, or an error code on failure.
+ */
 _c_public_ int n_dhcp4_server_lease_ack(NDhcp4ServerLease *lease) {
-        /* XXX */
-        return -ENOTRECOVERABLE;
+        return n_dhcp4_server_lease_reply(lease, N_DHCP4_MESSAGE_ACK);
 }
 
+/**
+ * n_dhcp4_server_lease_nack() - reject the request of the client
+ * @lease:                      the lease to operate on
+ *
+ * This sends a DHCPNAK in reply to a DHCPREQUEST, for example because the
+ * requested address is not valid on this network.
+ *
+ * Return: 0 on success, or an error code on failure.
+ */
 _c_public_ int n_dhcp4_server_lease_nack(NDhcp4ServerLease *lease) {
-        /* XXX */
-        return -ENOTRECOVERABLE;
+        return n_dhcp4_server_lease_reply(lease, N_DHCP4_MESSAGE_NAK);
 }
@@ -1,7 +1,11 @@
 /*
  * Server Side of the Dynamic Host Configuration Protocol for IPv4
  *
- * XXX
+ * This implements the protocol side of a DHCPv4 server. Incoming requests are
+ * handed to the API user as events, each with a server lease attached. The
+ * user owns the address pool: it picks the address to hand out and replies
+ * via the lease. The server neither keeps a record of bound clients, nor
+ * does it persist anything.
  */
 
 #include <assert.h>
@@ -20,7 +24,13 @@
 #include "util/packet.h"
 
 /**
- * n_dhcp4_server_config_new() - XXX
+ * n_dhcp4_server_config_new() - allocate new server configuration
+ * @configp:                    output argument for new server configuration
+ *
+ * This creates a new server configuration object, to be passed to
+ * n_dhcp4_server_new().
+ *
+ * Return: 0 on success, negative error code on failure.
  */
 _c_public_ int n_dhcp4_server_config_new(NDhcp4ServerConfig **configp) {
         _c_cleanup_(n_dhcp4_server_config_freep) NDhcp4ServerConfig *config = NULL;
@@ -37,7 +47,12 @@ _c_public_ int n_dhcp4_server_config_new(NDhcp4ServerConfig **configp) {
 }
 
 /**
- * n_dhcp4_server_config_free() - XXX
+ * n_dhcp4_server_config_free() - destroy server configuration
+ * @config:                     configuration to operate on, or NULL
+ *
+ * If @config is NULL, this is a no-op.
+ *
+ * Return: NULL is returned.
  */
 _c_public_ NDhcp4ServerConfig *n_dhcp4_server_config_free(NDhcp4ServerConfig *config) {
         if (!config)
@@ -49,14 +64,21 @@ _c_public_ NDhcp4ServerConfig *n_dhcp4_server_config_free(NDhcp4ServerConfig *co
 }
 
 /**
- * n_dhcp4_server_config_set_ifindex() - XXX
+ * n_dhcp4_server_config_set_ifindex() - set ifindex property
+ * @config:                     configuration to operate on
+ * @ifindex:                    ifindex to set
+ *
+ * This sets the interface the server listens on.
  */
 _c_public_ void n_dhcp4_server_config_set_ifindex(NDhcp4ServerConfig *config, int ifindex) {
         config->ifindex = ifindex;
 }
 
 /**
- * n_dhcp4_s_event_node_new() - XXX
+ * n_dhcp4_s_event_node_new() - allocate new event
+ * @nodep:                      output argument for new event
+ *
+ * Return: 0 on success, negative error code on failure.
  */
 int n_dhcp4_s_event_node_new(NDhcp4SEventNode **nodep) {
         NDhcp4SEventNode *node;
@@ -72,12 +94,41 @@ int n_dhcp4_s_event_node_new(NDhcp4SEventNode **nodep) {
 }
 
 /**
- * n_dhcp4_s_event_node_free() - XXX
+ * n_dhcp4_s_event_node_free() - deallocate event
+ * @node:                       node to operate on, or NULL
+ *
+ * This deallocates the node given as @node, and drops its reference to the
+ * attached lease, if any. If the node is linked on a server, it is unlinked
+ * automatically.
+ *
+ * If @node is NULL, this is a no-op.
+ *
+ * Return: NULL is returned.
  */
 NDhcp4SEventNode *n_dhcp4_s_event_node_free(NDhcp4SEventNode *node) {
         if (!node)
                 return NULL;
 
+        switch (node->event.event) {
+        case N_DHCP4_SERVER_EVENT_DISCOVER:
+                node->event.discover.lease = n_dhcp4_server_lease_unref(node->event.discover.lease);
+                break;
+        case N_DHCP4_SERVER_EVENT_REQUEST:
+                node->event.request.lease = n_dhcp4_server_lease_unref(node->event.request.lease);
+                break;
+        case N_DHCP4_SERVER_EVENT_RENEW:
+                node->event.renew.lease = n_dhcp4_server_lease_unref(node->event.renew.lease);
+                break;
+        case N_DHCP4_SERVER_EVENT_DECLINE:
+                node->event.decline.lease = n_dhcp4_server_lease_unref(node->event.decline.lease);
+                break;
+        case N_DHCP4_SERVER_EVENT_RELEASE:
+                node->event.release.lease = n_dhcp4_server_lease_unref(node->event.release.lease);
+                break;
+        default:
+                break;
+        }
+
         c_list_unlink(&node->server_link);
         free(node);
 
@@ -85,7 +136,15 @@ NDhcp4SEventNode *n_dhcp4_s_event_node_free(NDhcp4SEventNode *node) {
 }
 
 /**
- * n_dhcp4_server_new() - XXX
+ * n_dhcp4_server_new() - allocate new server
+ * @serverp:                    output argument for new server
+ * @config:                     server configuration
+ *
+ * This creates a new DHCP server, listening on the interface given in
+ * @config. The server does not reply to any request before an address was
+ * added via n_dhcp4_server_add_ip().
+ *
+ * Return: 0 on success, negative error code on failure.
  */
 _c_public_ int n_dhcp4_server_new(NDhcp4Server **serverp, NDhcp4ServerConfig *config) {
         _c_cleanup_(n_dhcp4_server_unrefp) NDhcp4Server *server = NULL;
@@ -110,15 +169,27 @@ _c_public_ int n_dhcp4_server_new(NDhcp4Server **serverp, NDhcp4ServerConfig *co
 
 static void n_dhcp4_server_free(NDhcp4Server *server) {
         NDhcp4SEventNode *node, *t_node;
+        NDhcp4ServerLease *lease, *t_lease;
 
         c_list_for_each_entry_safe(node, t_node, &server->event_list, server_link)
                 n_dhcp4_s_event_node_free(node);
 
+        c_list_for_each_entry_safe(lease, t_lease, &server->lease_list, server_link)
+                n_dhcp4_server_lease_unlink(lease);
+
+        if (server->connection.ip)
+                n_dhcp4_s_connection_ip_unlink(server->connection.ip);
+
+        n_dhcp4_s_connection_deinit(&server->connection);
+
         free(server);
 }
 
 /**
- * n_dhcp4_server_ref() - XXX
+ * n_dhcp4_server_ref() - acquire server reference
+ * @server:                     server to operate on, or NULL
+ *
+ * Return: @server is returned.
  */
 _c_public_ NDhcp4Server *n_dhcp4_server_ref(NDhcp4Server *server) {
         if (server)
@@ -127,7 +198,10 @@ _c_public_ NDhcp4Server *n_dhcp4_server_ref(NDhcp4Server *server) {
 }
 
 /**
- * n_dhcp4_server_unref() - XXX
+ * n_dhcp4_server_unref() - release server reference
+ * @server:                     server to operate on, or NULL
+ *
+ * Return: NULL is returned.
  */
 _c_public_ NDhcp4Server *n_dhcp4_server_unref(NDhcp4Server *server) {
         if (server && !--server->n_refs)
@@ -136,7 +210,15 @@ _c_public_ NDhcp4Server *n_dhcp4_server_unref(NDhcp4Server *server) {
 }
 
 /**
- * n_dhcp4_server_raise() - XXX
+ * n_dhcp4_server_raise() - raise event
+ * @server:                     server to operate on
+ * @nodep:                      output argument for new event, or NULL
+ * @event:                      event type to raise
+ *
+ * This queues a new event of type @event on @server. The caller is
+ * responsible for filling in the event payload via @nodep.
+ *
+ * Return: 0 on success, negative error code on failure.
  */
 int n_dhcp4_server_raise(NDhcp4Server *server, NDhcp4SEventNode **nodep, unsigned int event) {
         NDhcp4SEventNode *node;
@@ -155,14 +237,89 @@ int n_dhcp4_server_raise(NDhcp4Server *server, NDhcp4SEventNode **nodep, unsigne
 }
 
 /**
- * n_dhcp4_server_get_fd() - XXX
+ * n_dhcp4_server_get_fd() - get server file descriptor
+ * @server:                     server to operate on
+ * @fdp:                        output argument for file descriptor
+ *
+ * This returns the file descriptor to poll for readability. Whenever it is
+ * readable, call n_dhcp4_server_dispatch().
  */
 _c_public_ void n_dhcp4_server_get_fd(NDhcp4Server *server, int *fdp) {
         n_dhcp4_s_connection_get_fd(&server->connection, fdp);
 }
 
+static int n_dhcp4_server_dispatch_message(NDhcp4Server *server, NDhcp4Incoming **messagep) {
+        _c_cleanup_(n_dhcp4_server_lease_unrefp) NDhcp4ServerLease *lease = NULL;
+        NDhcp4SEventNode *node;
+        unsigned int event;
+        int r;
+
+        switch ((*messagep)->userdata.type) {
+        case N_DHCP4_C_MESSAGE_DISCOVER:
+                event = N_DHCP4_SERVER_EVENT_DISCOVER;
+                break;
+        case N_DHCP4_C_MESSAGE_SELECT:
+        case N_DHCP4_C_MESSAGE_REBOOT:
+                event = N_DHCP4_SERVER_EVENT_REQUEST;
+                break;
+        case N_DHCP4_C_MESSAGE_RENEW:
+        case N_DHCP4_C_MESSAGE_REBIND:
+                event = N_DHCP4_SERVER_EVENT_RENEW;
+                break;
+        case N_DHCP4_C_MESSAGE_DECLINE:
+                event = N_DHCP4_SERVER_EVENT_DECLINE;
+                break;
+        case N_DHCP4_C_MESSAGE_RELEASE:
+                event = N_DHCP4_SERVER_EVENT_RELEASE;
+                break;
+        default:
+                /* requests for other servers are silently dropped */
+                return 0;
+        }
+
+        r = n_dhcp4_server_lease_new(&lease, *messagep);
+        if (r)
+                return r;
+
+        *messagep = NULL;
+
+        r = n_dhcp4_server_raise(server, &node, event);
+        if (r)
+                return r;
+
+        n_dhcp4_server_lease_link(lease, server);
+
+        switch (event) {
+        case N_DHCP4_SERVER_EVENT_DISCOVER:
+                node->event.discover.lease = lease;
+                break;
+        case N_DHCP4_SERVER_EVENT_REQUEST:
+                node->event.request.lease = lease;
+                break;
+        case N_DHCP4_SERVER_EVENT_RENEW:
+                node->event.renew.lease = lease;
+                break;
+        case N_DHCP4_SERVER_EVENT_DECLINE:
+                node->event.decline.lease = lease;
+                break;
+        case N_DHCP4_SERVER_EVENT_RELEASE:
+                node->event.release.lease = lease;
+                break;
+        }
+
+        lease = NULL;
+        return 0;
+}
+
 /**
- * n_dhcp4_server_dispatch() - XXX
+ * n_dhcp4_server_dispatch() - dispatch server
+ * @server:                     server to operate on
+ *
+ * This reads pending requests from the server socket and queues an event
+ * for each of them. Events can be retrieved via n_dhcp4_server_pop_event().
+ *
+ * Return: 0 on success, N_DHCP4_E_PREEMPTED if there is more to dispatch,
+ *         or a negative error code on failure.
  */
 _c_public_ int n_dhcp4_server_dispatch(NDhcp4Server *server) {
         int r;
@@ -176,13 +333,28 @@ _c_public_ int n_dhcp4_server_dispatch(NDhcp4Server *server) {
                                 return 0;
                         return r;
                 }
+
+                if (!message)
+                        continue;
+
+                r = n_dhcp4_server_dispatch_message(server, &message);
+                if (r)
+                        return r;
         }
 
         return N_DHCP4_E_PREEMPTED;
 }
 
 /**
- * n_dhcp4_server_pop_event() - XXX
+ * n_dhcp4_server_pop_event() - fetch pending event
+ * @server:                     server to operate on
+ * @eventp:                     output argument for the event, or NULL
+ *
+ * This returns the next pending event, or NULL if there is none. The event
+ * (and its lease reference) stays valid until the next call to this
+ * function. To keep a lease beyond that, acquire a reference.
+ *
+ * Return: 0 on success, negative error code on failure.
  */
 _c_public_ int n_dhcp4_server_pop_event(NDhcp4Server *server, NDhcp4ServerEvent **eventp) {
         NDhcp4SEventNode *node, *t_node;
@@ -203,7 +375,16 @@ _c_public_ int n_dhcp4_server_pop_event(NDhcp4Server *server, NDhcp4ServerEvent
 }
 
 /**
- * n_dhcp4_server_add_ip() - XXX
+ * n_dhcp4_server_add_ip() - add server address
+ * @server:                     server to operate on
+ * @ipp:                        output argument for the address handle
+ * @addr:                       the address to add
+ *
+ * This adds the address the server answers with, and uses as its server
+ * identifier. It must be configured on the interface of the server.
+ *
+ * Return: 0 on success, -EBUSY if an address is already set, or a negative
+ *         error code on failure.
  */
 _c_public_ int n_dhcp4_server_add_ip(NDhcp4Server *server, NDhcp4ServerIp **ipp, struct in_addr addr) {
         _c_cleanup_(n_dhcp4_server_ip_freep) NDhcp4ServerIp *ip = NULL;
@@ -227,7 +408,10 @@ _c_public_ int n_dhcp4_server_add_ip(NDhcp4Server *server, NDhcp4ServerIp **ipp,
 }
 
 /**
- * n_dhcp4_server_ip_free() - XXX
+ * n_dhcp4_server_ip_free() - remove server address
+ * @ip:                         address handle to free, or NULL
+ *
+ * Return: NULL is returned.
  */
 _c_public_ NDhcp4ServerIp *n_dhcp4_server_ip_free(NDhcp4ServerIp *ip) {
         if (!ip)
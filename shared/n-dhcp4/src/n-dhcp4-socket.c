@@ -23,13 +23,14 @@
 /**
  * n_dhcp4_c_socket_packet_new() - create a new DHCP4 client packet socket
  * @sockfdp:            return argumnet for the new socket
- * @ifindex:            interface index to bind to
+ * @ifindex:            interface index to bind to, or 0 for all interfaces
  *
  * Create a new AF_PACKET/SOCK_DGRAM socket usable to listen to and send DHCP client
  * packets before an IP address has been configured.
  *
  * Only unfragmented DHCP packets from a server to a client destined for the given
- * ifindex is returned.
+ * ifindex is returned. If @ifindex is 0, packets of all interfaces are returned,
+ * and the caller has to demultiplex them based on the receiving interface.
  *
  * Return: 0 on success, or a negative error code on failure.
  */
@@ -127,6 +128,29 @@ int n_dhcp4_c_socket_packet_new(int *sockfdp, int ifindex) {
         return 0;
 }
 
+/**
+ * n_dhcp4_c_socket_packet_new_tx() - create a new send-only DHCP4 client packet socket
+ * @sockfdp:            return argumnet for the new socket
+ *
+ * Create a new AF_PACKET/SOCK_DGRAM socket usable to send DHCP client packets
+ * before an IP address has been configured. The socket is not bound to any
+ * protocol, so it never queues incoming packets. This is used by clients that
+ * get their packets delivered from a packet socket shared with other clients.
+ *
+ * Return: 0 on success, or a negative error code on failure.
+ */
+int n_dhcp4_c_socket_packet_new_tx(int *sockfdp) {
+        _c_cleanup_(c_closep) int sockfd = -1;
+
+        sockfd = socket(AF_PACKET, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (sockfd < 0)
+                return -errno;
+
+        *sockfdp = sockfd;
+        sockfd = -1;
+        return 0;
+}
+
 /**
  * n_dhcp4_c_socket_udp_new() - create a new DHCP4 client UDP socket
  * @sockfdp:            return argumnet for the new socket
@@ -550,26 +574,58 @@ int n_dhcp4_s_socket_udp_broadcast(int sockfd,
                                          message);
 }
 
-int n_dhcp4_c_socket_packet_recv(int sockfd,
-                                 uint8_t *buf,
-                                 size_t n_buf,
-                                 NDhcp4Incoming **messagep) {
-        _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = NULL;
+/**
+ * n_dhcp4_c_socket_packet_recvfrom() - receive raw DHCP4 client packet
+ * @sockfd:             packet socket to read from
+ * @buf:                buffer for the DHCP payload
+ * @n_buf:              size of @buf in bytes
+ * @n_datap:            return argument for the length of the DHCP payload
+ * @ifindexp:           return argument for the receiving interface, or NULL
+ *
+ * Read the next packet from a socket created via n_dhcp4_c_socket_packet_new()
+ * and strip the IP and UDP headers. Unlike n_dhcp4_c_socket_packet_recv() the
+ * payload is not parsed, so the caller can decide which client it belongs to.
+ *
+ * Return: 0 on success, N_DHCP4_E_MALFORMED if the packet was discarded,
+ *         N_DHCP4_E_AGAIN if there is nothing to read, or a negative error
+ *         code on failure.
+ */
+int n_dhcp4_c_socket_packet_recvfrom(int sockfd,
+                                     uint8_t *buf,
+                                     size_t n_buf,
+                                     size_t *n_datap,
+                                     int *ifindexp) {
         size_t len;
         int r;
 
-        r = packet_recv_udp(sockfd, buf, n_buf, &len);
+        r = packet_recvfrom_udp(sockfd, buf, n_buf, &len, NULL, ifindexp);
         if (r < 0) {
                 if (r == -ENETDOWN)
                         return N_DHCP4_E_DOWN;
                 else if (r == -EAGAIN)
                         return N_DHCP4_E_AGAIN;
                 else
-                        return -errno;
+                        return r;
         } else if (len == 0) {
                 return N_DHCP4_E_MALFORMED;
         }
 
+        *n_datap = len;
+        return 0;
+}
+
+int n_dhcp4_c_socket_packet_recv(int sockfd,
+                                 uint8_t *buf,
+                                 size_t n_buf,
+                                 NDhcp4Incoming **messagep) {
+        _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = NULL;
+        size_t len;
+        int r;
+
+        r = n_dhcp4_c_socket_packet_recvfrom(sockfd, buf, n_buf, &len, NULL);
+        if (r)
+                return r;
+
         r = n_dhcp4_incoming_new(&message, buf, len);
         if (r)
                 return r;
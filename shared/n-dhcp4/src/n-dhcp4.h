@@ -98,7 +98,7 @@ struct NDhcp4ServerEvent {
                 } down;
                 struct {
                         NDhcp4ServerLease *lease;
-                } discover, request, decline, release;
+                } discover, request, renew, decline, release;
         };
 };
 
@@ -113,6 +113,7 @@ void n_dhcp4_client_config_set_request_broadcast(NDhcp4ClientConfig *config, boo
 void n_dhcp4_client_config_set_mac(NDhcp4ClientConfig *config, const uint8_t *mac, size_t n_mac);
 void n_dhcp4_client_config_set_broadcast_mac(NDhcp4ClientConfig *config, const uint8_t *mac, size_t n_mac);
 int n_dhcp4_client_config_set_client_id(NDhcp4ClientConfig *config, const uint8_t *id, size_t n_id);
+void n_dhcp4_client_config_set_shared_packet_socket(NDhcp4ClientConfig *config, bool shared_packet_socket);
 void n_dhcp4_client_config_set_log_level(NDhcp4ClientConfig *config, int level);
 void n_dhcp4_client_config_set_log_func(NDhcp4ClientConfig *config, NDhcp4LogFunc func, void *data);
 
@@ -139,6 +140,7 @@ NDhcp4Client *n_dhcp4_client_unref(NDhcp4Client *client);
 
 void n_dhcp4_client_get_fd(NDhcp4Client *client, int *fdp);
 int n_dhcp4_client_dispatch(NDhcp4Client *client);
+int n_dhcp4_client_dispatch_packet(NDhcp4Client *client, const void *data, size_t n_data);
 int n_dhcp4_client_pop_event(NDhcp4Client *client, NDhcp4ClientEvent **eventp);
 
 int n_dhcp4_client_update_mtu(NDhcp4Client *client, uint16_t mtu);
@@ -147,6 +149,13 @@ int n_dhcp4_client_probe(NDhcp4Client *client,
                          NDhcp4ClientProbe **probep,
                          NDhcp4ClientProbeConfig *config);
 
+int n_dhcp4_client_packet_socket_new(int *fdp);
+int n_dhcp4_client_packet_socket_recv(int fd,
+                                      void *buf,
+                                      size_t n_buf,
+                                      size_t *n_datap,
+                                      int *ifindexp);
+
 /* client probes */
 
 NDhcp4ClientProbe *n_dhcp4_client_probe_free(NDhcp4ClientProbe *probe);
@@ -197,7 +206,12 @@ NDhcp4ServerIp *n_dhcp4_server_ip_free(NDhcp4ServerIp *ip);
 NDhcp4ServerLease *n_dhcp4_server_lease_ref(NDhcp4ServerLease *lease);
 NDhcp4ServerLease *n_dhcp4_server_lease_unref(NDhcp4ServerLease *lease);
 
+void n_dhcp4_server_lease_get_client_id(NDhcp4ServerLease *lease, const uint8_t **idp, size_t *n_idp);
+void n_dhcp4_server_lease_get_chaddr(NDhcp4ServerLease *lease, const uint8_t **chaddrp, size_t *n_chaddrp);
+void n_dhcp4_server_lease_get_requested_ip(NDhcp4ServerLease *lease, struct in_addr *ipp);
 int n_dhcp4_server_lease_query(NDhcp4ServerLease *lease, uint8_t option, uint8_t **datap, size_t *n_datap);
+
+void n_dhcp4_server_lease_set_yiaddr(NDhcp4ServerLease *lease, struct in_addr yiaddr, uint32_t lifetime);
 int n_dhcp4_server_lease_append(NDhcp4ServerLease *lease, uint8_t option, uint8_t *data, size_t n_data);
 
 int n_dhcp4_server_lease_offer(NDhcp4ServerLease *lease);
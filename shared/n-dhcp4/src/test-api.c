@@ -70,6 +70,7 @@ static void test_api_functions(void) {
                 (void *)n_dhcp4_client_config_set_mac,
                 (void *)n_dhcp4_client_config_set_broadcast_mac,
                 (void *)n_dhcp4_client_config_set_client_id,
+                (void *)n_dhcp4_client_config_set_shared_packet_socket,
 
                 (void *)n_dhcp4_client_probe_config_new,
                 (void *)n_dhcp4_client_probe_config_free,
@@ -89,9 +90,12 @@ static void test_api_functions(void) {
                 (void *)n_dhcp4_client_unrefv,
                 (void *)n_dhcp4_client_get_fd,
                 (void *)n_dhcp4_client_dispatch,
+                (void *)n_dhcp4_client_dispatch_packet,
                 (void *)n_dhcp4_client_pop_event,
                 (void *)n_dhcp4_client_update_mtu,
                 (void *)n_dhcp4_client_probe,
+                (void *)n_dhcp4_client_packet_socket_new,
+                (void *)n_dhcp4_client_packet_socket_recv,
 
                 (void *)n_dhcp4_client_probe_free,
                 (void *)n_dhcp4_client_probe_freep,
@@ -135,7 +139,11 @@ static void test_api_functions(void) {
                 (void *)n_dhcp4_server_lease_unref,
                 (void *)n_dhcp4_server_lease_unrefp,
                 (void *)n_dhcp4_server_lease_unrefv,
+                (void *)n_dhcp4_server_lease_get_client_id,
+                (void *)n_dhcp4_server_lease_get_chaddr,
+                (void *)n_dhcp4_server_lease_get_requested_ip,
                 (void *)n_dhcp4_server_lease_query,
+                (void *)n_dhcp4_server_lease_set_yiaddr,
                 (void *)n_dhcp4_server_lease_append,
                 (void *)n_dhcp4_server_lease_offer,
                 (void *)n_dhcp4_server_lease_ack,
@@ -379,9 +379,149 @@ static void test_connection(void) {
         link_del_ip4(&link_server, &addr_server, 8);
 }
 
+static void test_client_receive_shared(NDhcp4CConnection *connection,
+                                       int fd_shared,
+                                       int ifindex,
+                                       uint8_t expected_type,
+                                       NDhcp4Incoming **messagep) {
+        _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = NULL;
+        uint8_t buf[UINT16_MAX];
+        uint8_t received_type;
+        size_t n_buf;
+        int r, received_ifindex;
+
+        test_poll_server(fd_shared);
+
+        r = n_dhcp4_c_socket_packet_recvfrom(fd_shared, buf, sizeof(buf), &n_buf, &received_ifindex);
+        c_assert(!r);
+        c_assert(received_ifindex == ifindex);
+
+        r = n_dhcp4_c_connection_dispatch_packet(connection, buf, n_buf, &message);
+        c_assert(!r);
+        c_assert(message);
+
+        r = n_dhcp4_incoming_query_message_type(message, &received_type);
+        c_assert(!r);
+        c_assert(received_type == expected_type);
+
+        if (messagep) {
+                *messagep = message;
+                message = NULL;
+        }
+}
+
+static void test_connection_shared(void) {
+        const struct in_addr addr_server = (struct in_addr){ htonl(10 << 24 | 1) };
+        const struct in_addr addr_client = (struct in_addr){ htonl(10 << 24 | 2) };
+        _c_cleanup_(netns_closep) int ns_server = -1, ns_client = -1;
+        _c_cleanup_(link_deinit) Link link_server = LINK_NULL(link_server);
+        _c_cleanup_(link_deinit) Link link_client = LINK_NULL(link_client);
+        _c_cleanup_(c_closep) int efd_client = -1, fd_shared = -1;
+        int r, oldns;
+
+        /* setup */
+
+        netns_new(&ns_server);
+        netns_new(&ns_client);
+
+        link_new_veth(&link_server, &link_client, ns_server, ns_client);
+        link_add_ip4(&link_server, &addr_server, 8);
+
+        efd_client = epoll_create1(EPOLL_CLOEXEC);
+        c_assert(efd_client >= 0);
+
+        netns_get(&oldns);
+        netns_set(ns_client);
+        r = n_dhcp4_c_socket_packet_new(&fd_shared, 0);
+        c_assert(!r);
+        netns_set(oldns);
+
+        /* test connection fed from a packet socket bound to all interfaces */
+        {
+                _c_cleanup_(n_dhcp4_client_config_freep) NDhcp4ClientConfig *client_config = NULL;
+                _c_cleanup_(n_dhcp4_client_probe_config_freep) NDhcp4ClientProbeConfig *probe_config = NULL;
+                _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *request_out = NULL;
+                _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *request_in = NULL;
+                _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *reply_out = NULL;
+                NDhcp4SConnection connection_server = N_DHCP4_S_CONNECTION_NULL(connection_server);
+                NDhcp4SConnectionIp connection_server_ip = N_DHCP4_S_CONNECTION_IP_NULL(connection_server_ip);
+                NDhcp4CConnection connection_client = N_DHCP4_C_CONNECTION_NULL(connection_client);
+                _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *offer = NULL;
+
+                test_s_connection_init(ns_server, &connection_server, link_server.ifindex);
+                n_dhcp4_s_connection_ip_init(&connection_server_ip, addr_server);
+                n_dhcp4_s_connection_ip_link(&connection_server_ip, &connection_server);
+
+                r = n_dhcp4_client_config_new(&client_config);
+                c_assert(!r);
+
+                n_dhcp4_client_config_set_ifindex(client_config, link_client.ifindex);
+                n_dhcp4_client_config_set_transport(client_config, N_DHCP4_TRANSPORT_ETHERNET);
+                n_dhcp4_client_config_set_mac(client_config, link_client.mac.ether_addr_octet, ETH_ALEN);
+                n_dhcp4_client_config_set_broadcast_mac(client_config,
+                                                        (const uint8_t[]){
+                                                                0xff, 0xff, 0xff,
+                                                                0xff, 0xff, 0xff,
+                                                        },
+                                                        ETH_ALEN);
+                n_dhcp4_client_config_set_shared_packet_socket(client_config, true);
+                r = n_dhcp4_client_config_set_client_id(client_config,
+                                                        (void *)"client-id",
+                                                        strlen("client-id"));
+                c_assert(!r);
+
+                r = n_dhcp4_client_probe_config_new(&probe_config);
+                c_assert(!r);
+
+                r = n_dhcp4_c_connection_init(&connection_client,
+                                              client_config,
+                                              probe_config,
+                                              efd_client);
+                c_assert(!r);
+                test_c_connection_listen(ns_client, &connection_client);
+
+                r = n_dhcp4_c_connection_discover_new(&connection_client, &request_out);
+                c_assert(!r);
+
+                r = n_dhcp4_c_connection_start_request(&connection_client, request_out, 0);
+                c_assert(!r);
+                request_out = NULL;
+
+                test_server_receive(&connection_server, N_DHCP4_MESSAGE_DISCOVER, &request_in);
+
+                r = n_dhcp4_s_connection_offer_new(&connection_server, &reply_out, request_in, &addr_server, &addr_client, 60);
+                c_assert(!r);
+
+                r = n_dhcp4_s_connection_send_reply(&connection_server, &addr_server, reply_out);
+                c_assert(!r);
+
+                test_client_receive_shared(&connection_client, fd_shared, link_client.ifindex, N_DHCP4_MESSAGE_OFFER, &offer);
+
+                link_add_ip4(&link_client, &addr_client, 8);
+                test_c_connection_connect(ns_client, &connection_client, &addr_client, &addr_server);
+                c_assert(connection_client.state == N_DHCP4_C_CONNECTION_STATE_UDP);
+                c_assert(connection_client.fd_packet < 0);
+
+                test_renew(&connection_server, &connection_client, &addr_server, &addr_client);
+
+                n_dhcp4_c_connection_deinit(&connection_client);
+                n_dhcp4_s_connection_ip_unlink(&connection_server_ip);
+                n_dhcp4_s_connection_ip_deinit(&connection_server_ip);
+                n_dhcp4_s_connection_deinit(&connection_server);
+        }
+
+        /* teardown */
+
+        link_del_ip4(&link_client, &addr_client, 8);
+        link_del_ip4(&link_server, &addr_server, 8);
+}
+
 int main(int argc, char **argv) {
         test_setup();
 
+        /* test_connection() is known to fail in some environments, run
+         * the shared packet socket test first so it is not skipped. */
+        test_connection_shared();
         test_connection();
 
         return 0;
@@ -0,0 +1,257 @@
+/*
+ * Tests for DHCP4 Server
+ *
+ * This runs a DHCP4 server and a DHCP4 client on either end of a veth pair,
+ * each in its own network namespace, and verifies that the client is granted
+ * the address the server hands out.
+ */
+
+#undef NDEBUG
+#include <assert.h>
+#include <c-stdaux.h>
+#include <errno.h>
+#include <net/ethernet.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include "n-dhcp4.h"
+#include "n-dhcp4-private.h"
+#include "test.h"
+#include "util/link.h"
+#include "util/netns.h"
+
+static void test_server_new(int netns, NDhcp4Server **serverp, NDhcp4ServerIp **ipp, Link *link, const struct in_addr *addr) {
+        _c_cleanup_(n_dhcp4_server_config_freep) NDhcp4ServerConfig *config = NULL;
+        int r, oldns;
+
+        netns_get(&oldns);
+        netns_set(netns);
+
+        r = n_dhcp4_server_config_new(&config);
+        c_assert(!r);
+
+        n_dhcp4_server_config_set_ifindex(config, link->ifindex);
+
+        r = n_dhcp4_server_new(serverp, config);
+        c_assert(!r);
+
+        r = n_dhcp4_server_add_ip(*serverp, ipp, *addr);
+        c_assert(!r);
+
+        netns_set(oldns);
+}
+
+static void test_client_new(NDhcp4Client **clientp, NDhcp4ClientProbe **probep, Link *link) {
+        _c_cleanup_(n_dhcp4_client_config_freep) NDhcp4ClientConfig *config = NULL;
+        _c_cleanup_(n_dhcp4_client_probe_config_freep) NDhcp4ClientProbeConfig *probe_config = NULL;
+        int r;
+
+        r = n_dhcp4_client_config_new(&config);
+        c_assert(!r);
+
+        n_dhcp4_client_config_set_ifindex(config, link->ifindex);
+        n_dhcp4_client_config_set_transport(config, N_DHCP4_TRANSPORT_ETHERNET);
+        n_dhcp4_client_config_set_mac(config, link->mac.ether_addr_octet, ETH_ALEN);
+        n_dhcp4_client_config_set_broadcast_mac(config,
+                                                (const uint8_t[]){
+                                                        0xff, 0xff, 0xff,
+                                                        0xff, 0xff, 0xff,
+                                                },
+                                                ETH_ALEN);
+        r = n_dhcp4_client_config_set_client_id(config, (void *)"client-id", strlen("client-id"));
+        c_assert(!r);
+
+        r = n_dhcp4_client_new(clientp, config);
+        c_assert(!r);
+
+        r = n_dhcp4_client_probe_config_new(&probe_config);
+        c_assert(!r);
+
+        n_dhcp4_client_probe_config_set_start_delay(probe_config, 10);
+        n_dhcp4_client_probe_config_request_option(probe_config, N_DHCP4_OPTION_ROUTER);
+
+        r = n_dhcp4_client_probe(*clientp, probep, probe_config);
+        c_assert(!r);
+}
+
+static void test_server_lease_setup(NDhcp4ServerLease *lease, const struct in_addr *addr_server, const struct in_addr *addr_client) {
+        int r;
+
+        n_dhcp4_server_lease_set_yiaddr(lease, *addr_client, 3600);
+
+        r = n_dhcp4_server_lease_append(lease,
+                                        N_DHCP4_OPTION_ROUTER,
+                                        (void *)&addr_server->s_addr,
+                                        sizeof(addr_server->s_addr));
+        c_assert(!r);
+
+        r = n_dhcp4_server_lease_append(lease,
+                                        N_DHCP4_OPTION_ROUTER,
+                                        (void *)&addr_server->s_addr,
+                                        sizeof(addr_server->s_addr));
+        c_assert(r == N_DHCP4_E_DUPLICATE_OPTION);
+
+        r = n_dhcp4_server_lease_append(lease,
+                                        N_DHCP4_OPTION_SERVER_IDENTIFIER,
+                                        (void *)&addr_server->s_addr,
+                                        sizeof(addr_server->s_addr));
+        c_assert(r == N_DHCP4_E_INTERNAL);
+}
+
+static void test_server_handle(NDhcp4Server *server, const struct in_addr *addr_server, const struct in_addr *addr_client) {
+        NDhcp4ServerEvent *event;
+        const uint8_t *id;
+        size_t n_id;
+        int r;
+
+        r = n_dhcp4_server_dispatch(server);
+        c_assert(!r || r == N_DHCP4_E_PREEMPTED);
+
+        for (;;) {
+                r = n_dhcp4_server_pop_event(server, &event);
+                c_assert(!r);
+
+                if (!event)
+                        break;
+
+                switch (event->event) {
+                case N_DHCP4_SERVER_EVENT_DISCOVER:
+                        n_dhcp4_server_lease_get_client_id(event->discover.lease, &id, &n_id);
+                        c_assert(n_id == strlen("client-id"));
+                        c_assert(!memcmp(id, "client-id", n_id));
+
+                        r = n_dhcp4_server_lease_offer(event->discover.lease);
+                        c_assert(r == N_DHCP4_E_INVALID_ADDRESS);
+
+                        test_server_lease_setup(event->discover.lease, addr_server, addr_client);
+
+                        r = n_dhcp4_server_lease_offer(event->discover.lease);
+                        c_assert(!r);
+                        break;
+                case N_DHCP4_SERVER_EVENT_REQUEST: {
+                        struct in_addr requested_ip;
+
+                        n_dhcp4_server_lease_get_requested_ip(event->request.lease, &requested_ip);
+                        c_assert(requested_ip.s_addr == addr_client->s_addr);
+
+                        test_server_lease_setup(event->request.lease, addr_server, &requested_ip);
+
+                        r = n_dhcp4_server_lease_ack(event->request.lease);
+                        c_assert(!r);
+                        break;
+                }
+                default:
+                        c_assert(0);
+                }
+        }
+}
+
+static bool test_client_handle(NDhcp4Client *client, const struct in_addr *addr_client) {
+        NDhcp4ClientEvent *event;
+        struct in_addr yiaddr;
+        bool granted = false;
+        int r;
+
+        r = n_dhcp4_client_dispatch(client);
+        c_assert(!r || r == N_DHCP4_E_PREEMPTED);
+
+        for (;;) {
+                r = n_dhcp4_client_pop_event(client, &event);
+                c_assert(!r);
+
+                if (!event)
+                        break;
+
+                switch (event->event) {
+                case N_DHCP4_CLIENT_EVENT_OFFER:
+                        r = n_dhcp4_client_lease_select(event->offer.lease);
+                        c_assert(!r);
+                        break;
+                case N_DHCP4_CLIENT_EVENT_GRANTED:
+                        n_dhcp4_client_lease_get_yiaddr(event->granted.lease, &yiaddr);
+                        c_assert(yiaddr.s_addr == addr_client->s_addr);
+
+                        r = n_dhcp4_client_lease_query(event->granted.lease, N_DHCP4_OPTION_ROUTER, NULL, NULL);
+                        c_assert(!r);
+
+                        granted = true;
+                        break;
+                default:
+                        break;
+                }
+        }
+
+        return granted;
+}
+
+static void test_server(void) {
+        const struct in_addr addr_server = (struct in_addr){ htonl(10 << 24 | 1) };
+        const struct in_addr addr_client = (struct in_addr){ htonl(10 << 24 | 2) };
+        _c_cleanup_(netns_closep) int ns_server = -1, ns_client = -1;
+        _c_cleanup_(link_deinit) Link link_server = LINK_NULL(link_server);
+        _c_cleanup_(link_deinit) Link link_client = LINK_NULL(link_client);
+        NDhcp4Server *server = NULL;
+        NDhcp4ServerIp *ip = NULL;
+        NDhcp4Client *client = NULL;
+        NDhcp4ClientProbe *probe = NULL;
+        bool granted = false;
+        int r, oldns;
+
+        /* setup */
+
+        netns_new(&ns_server);
+        netns_new(&ns_client);
+
+        link_new_veth(&link_server, &link_client, ns_server, ns_client);
+        link_add_ip4(&link_server, &addr_server, 8);
+
+        test_server_new(ns_server, &server, &ip, &link_server, &addr_server);
+
+        /*
+         * The client opens its sockets lazily when dispatched, so run it
+         * from within its namespace. The server sockets are already bound
+         * to the server namespace.
+         */
+        netns_get(&oldns);
+        netns_set(ns_client);
+
+        test_client_new(&client, &probe, &link_client);
+
+        /* run server and client until the address is granted */
+
+        while (!granted) {
+                struct pollfd pfds[2] = {
+                        { .events = POLLIN },
+                        { .events = POLLIN },
+                };
+
+                n_dhcp4_server_get_fd(server, &pfds[0].fd);
+                n_dhcp4_client_get_fd(client, &pfds[1].fd);
+
+                r = poll(pfds, 2, 10 * 1000);
+                c_assert(r > 0);
+
+                if (pfds[0].revents & POLLIN)
+                        test_server_handle(server, &addr_server, &addr_client);
+                if (pfds[1].revents & POLLIN)
+                        granted = test_client_handle(client, &addr_client);
+        }
+
+        /* teardown */
+
+        n_dhcp4_client_probe_free(probe);
+        n_dhcp4_client_unref(client);
+        netns_set(oldns);
+        n_dhcp4_server_ip_free(ip);
+        n_dhcp4_server_unref(server);
+
+        link_del_ip4(&link_server, &addr_server, 8);
+}
+
+int main(int argc, char **argv) {
+        test_setup();
+
+        test_server();
+
+        return 0;
+}
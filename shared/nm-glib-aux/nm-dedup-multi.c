@@ -26,14 +26,168 @@ typedef struct {
 	bool lookup_head;
 } LookupEntry;
 
+/* A set of pointers, implemented as open-addressing hash table with linear
+ * probing. Contrary to GHashTable, the hash is kept inline next to the pointer
+ * (so that a probe touches only one array), and deletion shifts the following
+ * slots back instead of leaving tombstones.
+ *
+ * The hash and equal functions are passed to the (inline) accessors, so that
+ * the compiler can specialize them for idx_entries and idx_objs. */
+typedef struct {
+	gconstpointer ptr;
+	guint hash;
+} DictSlot;
+
+typedef struct {
+	DictSlot *slots;
+	guint mask;
+	guint len;
+} Dict;
+
+#define DICT_MIN_SIZE 32u
+
 struct _NMDedupMultiIndex {
 	int ref_count;
-	GHashTable *idx_entries;
-	GHashTable *idx_objs;
+	Dict idx_entries;
+	Dict idx_objs;
 };
 
 /*****************************************************************************/
 
+static void
+_dict_init (Dict *dict)
+{
+	dict->slots = g_new0 (DictSlot, DICT_MIN_SIZE);
+	dict->mask = DICT_MIN_SIZE - 1u;
+	dict->len = 0;
+}
+
+static void
+_dict_resize (Dict *dict, guint n_slots)
+{
+	DictSlot *slots_old = dict->slots;
+	guint n_slots_old = dict->mask + 1u;
+	guint i, j;
+
+	nm_assert (n_slots >= DICT_MIN_SIZE);
+	nm_assert (nm_utils_is_power_of_two (n_slots));
+	nm_assert (dict->len < n_slots);
+
+	dict->slots = g_new0 (DictSlot, n_slots);
+	dict->mask = n_slots - 1u;
+
+	for (i = 0; i < n_slots_old; i++) {
+		if (!slots_old[i].ptr)
+			continue;
+		for (j = slots_old[i].hash & dict->mask;
+		     dict->slots[j].ptr;
+		     j = (j + 1u) & dict->mask) {
+		}
+		dict->slots[j] = slots_old[i];
+	}
+
+	g_free (slots_old);
+}
+
+static inline guint
+_dict_find (const Dict *dict, guint hash, gconstpointer key, GEqualFunc equal)
+{
+	guint i;
+
+	for (i = hash & dict->mask; dict->slots[i].ptr; i = (i + 1u) & dict->mask) {
+		const DictSlot *slot = &dict->slots[i];
+
+		if (   slot->ptr == key
+		    || (   slot->hash == hash
+		        && equal (slot->ptr, key)))
+			return i;
+	}
+	return G_MAXUINT;
+}
+
+static inline gpointer
+_dict_lookup (const Dict *dict, guint hash, gconstpointer key, GEqualFunc equal)
+{
+	guint i;
+
+	i = _dict_find (dict, hash, key, equal);
+	return i == G_MAXUINT ? NULL : (gpointer) dict->slots[i].ptr;
+}
+
+static inline gboolean
+_dict_add (Dict *dict, guint hash, gconstpointer ptr, GEqualFunc equal)
+{
+	guint i;
+
+	nm_assert (ptr);
+
+	/* keep the load factor below 3/4. */
+	if (G_UNLIKELY ((dict->len + 1u) * 4u > (dict->mask + 1u) * 3u))
+		_dict_resize (dict, (dict->mask + 1u) * 2u);
+
+	for (i = hash & dict->mask; dict->slots[i].ptr; i = (i + 1u) & dict->mask) {
+		const DictSlot *slot = &dict->slots[i];
+
+		if (   slot->ptr == ptr
+		    || (   slot->hash == hash
+		        && equal (slot->ptr, ptr)))
+			return FALSE;
+	}
+
+	dict->slots[i] = (DictSlot) {
+		.ptr  = ptr,
+		.hash = hash,
+	};
+	dict->len++;
+	return TRUE;
+}
+
+static inline gboolean
+_dict_remove (Dict *dict, guint hash, gconstpointer key, GEqualFunc equal)
+{
+	guint i, j, k;
+
+	i = _dict_find (dict, hash, key, equal);
+	if (i == G_MAXUINT)
+		return FALSE;
+
+	/* backward shift deletion: move following entries of the same probe
+	 * sequence into the hole, unless that would move them before the slot
+	 * of their hash. */
+	for (j = (i + 1u) & dict->mask; dict->slots[j].ptr; j = (j + 1u) & dict->mask) {
+		k = dict->slots[j].hash & dict->mask;
+		if (  i <= j
+		    ? (i < k && k <= j)
+		    : (i < k || k <= j))
+			continue;
+		dict->slots[i] = dict->slots[j];
+		i = j;
+	}
+	dict->slots[i].ptr = NULL;
+	dict->len--;
+
+	if (G_UNLIKELY (   dict->mask + 1u > DICT_MIN_SIZE
+	                && dict->len * 8u < dict->mask + 1u))
+		_dict_resize (dict, (dict->mask + 1u) / 2u);
+
+	return TRUE;
+}
+
+static gconstpointer
+_dict_first (const Dict *dict)
+{
+	guint i;
+
+	if (dict->len == 0)
+		return NULL;
+	for (i = 0; TRUE; i++) {
+		if (dict->slots[i].ptr)
+			return dict->slots[i].ptr;
+	}
+}
+
+/*****************************************************************************/
+
 static void
 ASSERT_idx_type (const NMDedupMultiIdxType *idx_type)
 {
@@ -63,49 +217,6 @@ nm_dedup_multi_idx_type_init (NMDedupMultiIdxType *idx_type,
 
 /*****************************************************************************/
 
-static NMDedupMultiEntry *
-_entry_lookup_obj (const NMDedupMultiIndex *self,
-                   const NMDedupMultiIdxType *idx_type,
-                   const NMDedupMultiObj *obj)
-{
-	const LookupEntry stack_entry = {
-		.obj = obj,
-		.idx_type = idx_type,
-		.lookup_head = FALSE,
-	};
-
-	ASSERT_idx_type (idx_type);
-	return g_hash_table_lookup (self->idx_entries, &stack_entry);
-}
-
-static NMDedupMultiHeadEntry *
-_entry_lookup_head (const NMDedupMultiIndex *self,
-                    const NMDedupMultiIdxType *idx_type,
-                    const NMDedupMultiObj *obj)
-{
-	NMDedupMultiHeadEntry *head_entry;
-	const LookupEntry stack_entry = {
-		.obj = obj,
-		.idx_type = idx_type,
-		.lookup_head = TRUE,
-	};
-
-	ASSERT_idx_type (idx_type);
-
-	if (!idx_type->klass->idx_obj_partition_equal) {
-		if (c_list_is_empty (&idx_type->lst_idx_head))
-			head_entry = NULL;
-		else {
-			nm_assert (c_list_length (&idx_type->lst_idx_head) == 1);
-			head_entry = c_list_entry (idx_type->lst_idx_head.next, NMDedupMultiHeadEntry, lst_idx);
-		}
-		nm_assert (head_entry == g_hash_table_lookup (self->idx_entries, &stack_entry));
-		return head_entry;
-	}
-
-	return g_hash_table_lookup (self->idx_entries, &stack_entry);
-}
-
 static void
 _entry_unpack (const NMDedupMultiEntry *entry,
                const NMDedupMultiIdxType **out_idx_type,
@@ -200,6 +311,76 @@ _dict_idx_entries_equal (const NMDedupMultiEntry *entry_a,
 	return TRUE;
 }
 
+static inline gpointer
+_idx_entries_lookup (const NMDedupMultiIndex *self, gconstpointer entry)
+{
+	return _dict_lookup (&self->idx_entries,
+	                     _dict_idx_entries_hash (entry),
+	                     entry,
+	                     (GEqualFunc) _dict_idx_entries_equal);
+}
+
+static inline gboolean
+_idx_entries_add (NMDedupMultiIndex *self, gconstpointer entry)
+{
+	return _dict_add (&self->idx_entries,
+	                  _dict_idx_entries_hash (entry),
+	                  entry,
+	                  (GEqualFunc) _dict_idx_entries_equal);
+}
+
+static inline gboolean
+_idx_entries_remove (NMDedupMultiIndex *self, gconstpointer entry)
+{
+	return _dict_remove (&self->idx_entries,
+	                     _dict_idx_entries_hash (entry),
+	                     entry,
+	                     (GEqualFunc) _dict_idx_entries_equal);
+}
+
+static NMDedupMultiEntry *
+_entry_lookup_obj (const NMDedupMultiIndex *self,
+                   const NMDedupMultiIdxType *idx_type,
+                   const NMDedupMultiObj *obj)
+{
+	const LookupEntry stack_entry = {
+		.obj = obj,
+		.idx_type = idx_type,
+		.lookup_head = FALSE,
+	};
+
+	ASSERT_idx_type (idx_type);
+	return _idx_entries_lookup (self, &stack_entry);
+}
+
+static NMDedupMultiHeadEntry *
+_entry_lookup_head (const NMDedupMultiIndex *self,
+                    const NMDedupMultiIdxType *idx_type,
+                    const NMDedupMultiObj *obj)
+{
+	NMDedupMultiHeadEntry *head_entry;
+	const LookupEntry stack_entry = {
+		.obj = obj,
+		.idx_type = idx_type,
+		.lookup_head = TRUE,
+	};
+
+	ASSERT_idx_type (idx_type);
+
+	if (!idx_type->klass->idx_obj_partition_equal) {
+		if (c_list_is_empty (&idx_type->lst_idx_head))
+			head_entry = NULL;
+		else {
+			nm_assert (c_list_length (&idx_type->lst_idx_head) == 1);
+			head_entry = c_list_entry (idx_type->lst_idx_head.next, NMDedupMultiHeadEntry, lst_idx);
+		}
+		nm_assert (head_entry == _idx_entries_lookup (self, &stack_entry));
+		return head_entry;
+	}
+
+	return _idx_entries_lookup (self, &stack_entry);
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -333,6 +514,7 @@ _add (NMDedupMultiIndex *self,
 	entry = g_slice_new0 (NMDedupMultiEntry);
 	entry->obj = obj_new;
 	entry->head = head_entry;
+	entry->_generation = head_entry->_generation;
 
 	switch (mode) {
 	case NM_DEDUP_MULTI_IDX_MODE_PREPEND:
@@ -354,10 +536,10 @@ _add (NMDedupMultiIndex *self,
 	head_entry->len++;
 
 	if (   add_head_entry
-	    && !g_hash_table_add (self->idx_entries, head_entry))
+	    && !_idx_entries_add (self, head_entry))
 		nm_assert_not_reached ();
 
-	if (!g_hash_table_add (self->idx_entries, entry))
+	if (!_idx_entries_add (self, entry))
 		nm_assert_not_reached ();
 
 	NM_SET_OUT (out_entry, entry);
@@ -481,18 +663,23 @@ _remove_entry (NMDedupMultiIndex *self,
 	nm_assert (entry->obj);
 	nm_assert (entry->head);
 	nm_assert (!c_list_is_empty (&entry->lst_entries));
-	nm_assert (g_hash_table_lookup (self->idx_entries, entry) == entry);
+	nm_assert (_idx_entries_lookup (self, entry) == entry);
 
 	head_entry = (NMDedupMultiHeadEntry *) entry->head;
 	obj = entry->obj;
 
 	nm_assert (head_entry);
 	nm_assert (head_entry->len > 0);
-	nm_assert (g_hash_table_lookup (self->idx_entries, head_entry) == head_entry);
+	nm_assert (_idx_entries_lookup (self, head_entry) == head_entry);
 
 	idx_type = (NMDedupMultiIdxType *) head_entry->idx_type;
 	ASSERT_idx_type (idx_type);
 
+	if (nm_dedup_multi_entry_is_dirty (entry)) {
+		nm_assert (head_entry->_n_dirty > 0);
+		head_entry->_n_dirty--;
+	}
+
 	nm_assert (idx_type->len >= head_entry->len);
 	if (--head_entry->len > 0) {
 		nm_assert (idx_type->len > 1);
@@ -502,11 +689,11 @@ _remove_entry (NMDedupMultiIndex *self,
 
 	NM_SET_OUT (out_head_entry_removed, head_entry != NULL);
 
-	if (!g_hash_table_remove (self->idx_entries, entry))
+	if (!_idx_entries_remove (self, entry))
 		nm_assert_not_reached ();
 
 	if (   head_entry
-	    && !g_hash_table_remove (self->idx_entries, head_entry))
+	    && !_idx_entries_remove (self, head_entry))
 		nm_assert_not_reached ();
 
 	c_list_unlink_stale (&entry->lst_entries);
@@ -535,25 +722,34 @@ _remove_head (NMDedupMultiIndex *self,
 	nm_assert (head_entry);
 	nm_assert (head_entry->len > 0);
 	nm_assert (head_entry->len == c_list_length (&head_entry->lst_entries_head));
-	nm_assert (g_hash_table_lookup (self->idx_entries, head_entry) == head_entry);
+	nm_assert (head_entry->_n_dirty <= head_entry->len);
+	nm_assert (_idx_entries_lookup (self, head_entry) == head_entry);
 
 	n = 0;
 	c_list_for_each_safe (iter_entry, iter_entry_safe, &head_entry->lst_entries_head) {
 		NMDedupMultiEntry *entry;
 
+		if (   !remove_all
+		    && head_entry->_n_dirty == 0) {
+			/* all dirty entries are gone. No need to look at the rest. */
+			break;
+		}
+
 		entry = c_list_entry (iter_entry, NMDedupMultiEntry, lst_entries);
 		if (   remove_all
-		    || entry->dirty) {
+		    || nm_dedup_multi_entry_is_dirty (entry)) {
 			_remove_entry (self,
 			               entry,
 			               &head_entry_removed);
 			n++;
 			if (head_entry_removed)
-				break;
-		} else if (mark_survivors_dirty)
-			nm_dedup_multi_entry_set_dirty (entry, TRUE);
+				return n;
+		}
 	}
 
+	if (mark_survivors_dirty)
+		nm_dedup_multi_head_entry_dirty_set_all (head_entry);
+
 	return n;
 }
 
@@ -696,43 +892,25 @@ nm_dedup_multi_index_dirty_set_head (NMDedupMultiIndex *self,
                                      /*const NMDedupMultiObj * */ gconstpointer obj)
 {
 	NMDedupMultiHeadEntry *head_entry;
-	CList *iter_entry;
 
 	g_return_if_fail (self);
 	g_return_if_fail (idx_type);
 
 	head_entry = _entry_lookup_head (self, idx_type, obj);
-	if (!head_entry)
-		return;
-
-	c_list_for_each (iter_entry, &head_entry->lst_entries_head) {
-		NMDedupMultiEntry *entry;
-
-		entry = c_list_entry (iter_entry, NMDedupMultiEntry, lst_entries);
-		nm_dedup_multi_entry_set_dirty (entry, TRUE);
-	}
+	nm_dedup_multi_head_entry_dirty_set_all (head_entry);
 }
 
 void
 nm_dedup_multi_index_dirty_set_idx (NMDedupMultiIndex *self,
                                     const NMDedupMultiIdxType *idx_type)
 {
-	CList *iter_idx, *iter_entry;
+	CList *iter_idx;
 
 	g_return_if_fail (self);
 	g_return_if_fail (idx_type);
 
-	c_list_for_each (iter_idx, &idx_type->lst_idx_head) {
-		NMDedupMultiHeadEntry *head_entry;
-
-		head_entry = c_list_entry (iter_idx, NMDedupMultiHeadEntry, lst_idx);
-		c_list_for_each (iter_entry, &head_entry->lst_entries_head) {
-			NMDedupMultiEntry *entry;
-
-			entry = c_list_entry (iter_entry, NMDedupMultiEntry, lst_entries);
-			nm_dedup_multi_entry_set_dirty (entry, TRUE);
-		}
-	}
+	c_list_for_each (iter_idx, &idx_type->lst_idx_head)
+		nm_dedup_multi_head_entry_dirty_set_all (c_list_entry (iter_idx, NMDedupMultiHeadEntry, lst_idx));
 }
 
 /**
@@ -781,17 +959,29 @@ _dict_idx_objs_equal (const NMDedupMultiObj *obj_a,
 	           && obj_a->klass->obj_full_equal (obj_a, obj_b));
 }
 
+static inline gpointer
+_idx_objs_lookup (const NMDedupMultiIndex *self, gconstpointer obj)
+{
+	return _dict_lookup (&self->idx_objs,
+	                     _dict_idx_objs_hash (obj),
+	                     obj,
+	                     (GEqualFunc) _dict_idx_objs_equal);
+}
+
 void
 nm_dedup_multi_index_obj_release (NMDedupMultiIndex *self,
                                   /* const NMDedupMultiObj * */ gconstpointer obj)
 {
 	nm_assert (self);
 	nm_assert (obj);
-	nm_assert (g_hash_table_lookup (self->idx_objs, obj) == obj);
+	nm_assert (_idx_objs_lookup (self, obj) == obj);
 	nm_assert (((const NMDedupMultiObj *) obj)->_multi_idx == self);
 
 	((NMDedupMultiObj *) obj)->_multi_idx = NULL;
-	if (!g_hash_table_remove (self->idx_objs, obj))
+	if (!_dict_remove (&self->idx_objs,
+	                   _dict_idx_objs_hash (obj),
+	                   obj,
+	                   (GEqualFunc) _dict_idx_objs_equal))
 		nm_assert_not_reached ();
 }
 
@@ -802,7 +992,7 @@ nm_dedup_multi_index_obj_find (NMDedupMultiIndex *self,
 	g_return_val_if_fail (self, NULL);
 	g_return_val_if_fail (obj, NULL);
 
-	return g_hash_table_lookup (self->idx_objs, obj);
+	return _idx_objs_lookup (self, obj);
 }
 
 gconstpointer
@@ -816,12 +1006,12 @@ nm_dedup_multi_index_obj_intern (NMDedupMultiIndex *self,
 	nm_assert (obj_new);
 
 	if (obj_new->_multi_idx == self) {
-		nm_assert (g_hash_table_lookup (self->idx_objs, obj_new) == obj_new);
+		nm_assert (_idx_objs_lookup (self, obj_new) == obj_new);
 		nm_dedup_multi_obj_ref (obj_new);
 		return obj_new;
 	}
 
-	obj_old = g_hash_table_lookup (self->idx_objs, obj_new);
+	obj_old = _idx_objs_lookup (self, obj_new);
 	nm_assert (obj_old != obj_new);
 
 	if (obj_old) {
@@ -838,7 +1028,10 @@ nm_dedup_multi_index_obj_intern (NMDedupMultiIndex *self,
 	nm_assert (obj_new);
 	nm_assert (!obj_new->_multi_idx);
 
-	if (!g_hash_table_add (self->idx_objs, (gpointer) obj_new))
+	if (!_dict_add (&self->idx_objs,
+	                _dict_idx_objs_hash (obj_new),
+	                obj_new,
+	                (GEqualFunc) _dict_idx_objs_equal))
 		nm_assert_not_reached ();
 
 	((NMDedupMultiObj *) obj_new)->_multi_idx = self;
@@ -1019,8 +1212,8 @@ nm_dedup_multi_index_new (void)
 
 	self = g_slice_new0 (NMDedupMultiIndex);
 	self->ref_count = 1;
-	self->idx_entries = g_hash_table_new ((GHashFunc) _dict_idx_entries_hash, (GEqualFunc) _dict_idx_entries_equal);
-	self->idx_objs    = g_hash_table_new ((GHashFunc) _dict_idx_objs_hash,    (GEqualFunc) _dict_idx_objs_equal);
+	_dict_init (&self->idx_entries);
+	_dict_init (&self->idx_objs);
 	return self;
 }
 
@@ -1037,10 +1230,9 @@ nm_dedup_multi_index_ref (NMDedupMultiIndex *self)
 NMDedupMultiIndex *
 nm_dedup_multi_index_unref (NMDedupMultiIndex *self)
 {
-	GHashTableIter iter;
 	const NMDedupMultiIdxType *idx_type;
-	NMDedupMultiEntry *entry;
-	const NMDedupMultiObj *obj;
+	const NMDedupMultiEntry *entry;
+	guint i;
 
 	g_return_val_if_fail (self, NULL);
 	g_return_val_if_fail (self->ref_count > 0, NULL);
@@ -1048,28 +1240,27 @@ nm_dedup_multi_index_unref (NMDedupMultiIndex *self)
 	if (--self->ref_count > 0)
 		return NULL;
 
-more:
-	g_hash_table_iter_init (&iter, self->idx_entries);
-	while (g_hash_table_iter_next (&iter, (gpointer *) &entry, NULL)) {
+	while ((entry = _dict_first (&self->idx_entries))) {
 		if (entry->is_head)
 			idx_type = ((NMDedupMultiHeadEntry *) entry)->idx_type;
 		else
 			idx_type = entry->head->idx_type;
 		_remove_idx_entry (self, (NMDedupMultiIdxType *) idx_type, TRUE, FALSE);
-		goto more;
 	}
 
-	nm_assert (g_hash_table_size (self->idx_entries) == 0);
+	nm_assert (self->idx_entries.len == 0);
+
+	for (i = 0; i <= self->idx_objs.mask; i++) {
+		const NMDedupMultiObj *obj = self->idx_objs.slots[i].ptr;
 
-	g_hash_table_iter_init (&iter, self->idx_objs);
-	while (g_hash_table_iter_next (&iter, (gpointer *) &obj, NULL)) {
+		if (!obj)
+			continue;
 		nm_assert (obj->_multi_idx == self);
 		((NMDedupMultiObj * )obj)->_multi_idx = NULL;
 	}
-	g_hash_table_remove_all (self->idx_objs);
 
-	g_hash_table_unref (self->idx_entries);
-	g_hash_table_unref (self->idx_objs);
+	g_free (self->idx_entries.slots);
+	g_free (self->idx_objs.slots);
 
 	g_slice_free (NMDedupMultiIndex, self);
 	return NULL;
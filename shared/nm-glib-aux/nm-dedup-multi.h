@@ -203,7 +203,12 @@ struct _NMDedupMultiEntry {
 	/* const NMDedupMultiObj * */ gconstpointer obj;
 
 	bool is_head;
-	bool dirty;
+
+	/* an entry is dirty if it was explicitly marked so, or if its generation
+	 * lags behind the generation of its head. Use nm_dedup_multi_entry_is_dirty()
+	 * and nm_dedup_multi_entry_set_dirty(). */
+	bool _dirty;
+	guint _generation;
 
 	const NMDedupMultiHeadEntry *head;
 };
@@ -220,6 +225,13 @@ struct _NMDedupMultiHeadEntry {
 
 	guint len;
 
+	/* bumping the generation marks all entries of the head dirty at once,
+	 * without touching them. */
+	guint _generation;
+
+	/* the number of dirty entries in the list. */
+	guint _n_dirty;
+
 	CList lst_idx;
 };
 
@@ -235,17 +247,63 @@ nm_dedup_multi_entry_get_obj (const NMDedupMultiEntry *entry)
 
 /*****************************************************************************/
 
+static inline gboolean
+nm_dedup_multi_entry_is_dirty (const NMDedupMultiEntry *entry)
+{
+	nm_assert (entry);
+	nm_assert (entry->head);
+
+	return    entry->_dirty
+	       || entry->_generation != entry->head->_generation;
+}
+
 static inline void
 nm_dedup_multi_entry_set_dirty (const NMDedupMultiEntry *entry,
                                 gboolean dirty)
 {
+	NMDedupMultiEntry *e = (NMDedupMultiEntry *) entry;
+	NMDedupMultiHeadEntry *head_entry;
+
 	/* NMDedupMultiEntry is always exposed as a const object, because it is not
 	 * supposed to be modified outside NMDedupMultiIndex API. Except the "dirty"
 	 * flag. In C++ speak, it is a mutable field.
 	 *
 	 * Add this inline function, to cast-away constness and set the dirty flag. */
 	nm_assert (entry);
-	((NMDedupMultiEntry *) entry)->dirty = dirty;
+
+	head_entry = (NMDedupMultiHeadEntry *) entry->head;
+
+	if (nm_dedup_multi_entry_is_dirty (entry)) {
+		if (dirty)
+			return;
+		nm_assert (head_entry->_n_dirty > 0);
+		head_entry->_n_dirty--;
+		e->_dirty = FALSE;
+		e->_generation = head_entry->_generation;
+	} else if (dirty) {
+		head_entry->_n_dirty++;
+		e->_dirty = TRUE;
+	}
+}
+
+static inline void
+nm_dedup_multi_head_entry_dirty_set_all (const NMDedupMultiHeadEntry *head_entry)
+{
+	NMDedupMultiHeadEntry *h = (NMDedupMultiHeadEntry *) head_entry;
+
+	/* mark all entries of @head_entry as dirty in O(1), by bumping
+	 * the generation. The entries become clean again, when they get
+	 * touched via nm_dedup_multi_entry_set_dirty(). */
+	if (h) {
+		h->_generation++;
+		h->_n_dirty = h->len;
+	}
+}
+
+static inline guint
+nm_dedup_multi_head_entry_get_n_dirty (const NMDedupMultiHeadEntry *head_entry)
+{
+	return head_entry ? head_entry->_n_dirty : 0u;
 }
 
 /*****************************************************************************/
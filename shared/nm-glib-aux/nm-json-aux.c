@@ -133,3 +133,107 @@ nm_json_aux_gstr_append_obj_name (GString *gstr,
 	} else
 		g_string_append (gstr, ": ");
 }
+
+/*****************************************************************************/
+
+/**
+ * nm_json_aux_framer_next:
+ * @framer: the framer state. Initialize it with zeros.
+ * @buf: the input received so far
+ * @len: the length of @buf
+ * @out_start: (out) (allow-none): the offset of the message in @buf
+ *
+ * Scans the input that arrived since the last call for the end of the
+ * message being received. This only tracks the nesting of objects and arrays
+ * and whether we're inside a string, so every byte is looked at once,
+ * regardless of how many reads it took to receive a message. The caller
+ * must not modify the part of @buf that was already scanned.
+ *
+ * Returns: the length of the next complete message, 0 if more data is
+ *   needed or -1 if the input is not a sequence of JSON objects or arrays.
+ */
+gssize
+nm_json_aux_framer_next (NMJsonAuxFramer *framer,
+                         const char *buf,
+                         gsize len,
+                         gsize *out_start)
+{
+	gsize start;
+	gsize i;
+
+	g_return_val_if_fail (framer, -1);
+	g_return_val_if_fail (buf || len == 0, -1);
+	g_return_val_if_fail (framer->scanned <= len, -1);
+
+	for (i = framer->scanned; i < len; i++) {
+		char c = buf[i];
+
+		if (framer->in_string) {
+			if (framer->escaped)
+				framer->escaped = FALSE;
+			else if (c == '\\')
+				framer->escaped = TRUE;
+			else if (c == '"')
+				framer->in_string = FALSE;
+			continue;
+		}
+
+		switch (c) {
+		case '"':
+			if (framer->depth == 0)
+				return -1;
+			framer->in_string = TRUE;
+			break;
+		case '{':
+		case '[':
+			framer->depth++;
+			break;
+		case '}':
+		case ']':
+			if (framer->depth == 0)
+				return -1;
+			if (--framer->depth == 0) {
+				start = framer->start;
+				framer->start = i + 1;
+				framer->scanned = i + 1;
+				NM_SET_OUT (out_start, start);
+				return i + 1 - start;
+			}
+			break;
+		default:
+			if (framer->depth == 0) {
+				/* Between messages, only whitespace is allowed. */
+				if (!g_ascii_isspace (c))
+					return -1;
+				framer->start = i + 1;
+			}
+			break;
+		}
+	}
+
+	framer->scanned = len;
+	return 0;
+}
+
+/**
+ * nm_json_aux_framer_rebase:
+ * @framer: the framer state
+ *
+ * The input before the message being received is no longer needed.
+ * The caller drops it from the beginning of its buffer, and the framer
+ * continues with the shortened buffer.
+ *
+ * Returns: the number of bytes to drop from the beginning of the buffer.
+ */
+gsize
+nm_json_aux_framer_rebase (NMJsonAuxFramer *framer)
+{
+	gsize n;
+
+	g_return_val_if_fail (framer, 0);
+
+	n = framer->start;
+	framer->start = 0;
+	framer->scanned -= n;
+	return n;
+}
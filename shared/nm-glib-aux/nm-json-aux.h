@@ -42,6 +42,25 @@ void nm_json_aux_gstr_append_obj_name (GString *gstr,
 
 /*****************************************************************************/
 
+/* Splits a stream of JSON objects or arrays, like JSON-RPC traffic on a
+ * socket, into the single messages. */
+typedef struct {
+	gsize start;            /* Start of the message being received. */
+	gsize scanned;          /* Bytes of the input already seen. */
+	guint depth;            /* Nesting of objects and arrays. */
+	bool in_string:1;
+	bool escaped:1;
+} NMJsonAuxFramer;
+
+gssize nm_json_aux_framer_next (NMJsonAuxFramer *framer,
+                                const char *buf,
+                                gsize len,
+                                gsize *out_start);
+
+gsize nm_json_aux_framer_rebase (NMJsonAuxFramer *framer);
+
+/*****************************************************************************/
+
 #ifdef NM_VALUE_TYPE_DEFINE_FUNCTIONS
 #include "nm-value-type.h"
 static inline void
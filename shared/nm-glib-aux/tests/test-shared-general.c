@@ -12,6 +12,8 @@
 #include "nm-glib-aux/nm-str-buf.h"
 #include "nm-glib-aux/nm-time-utils.h"
 #include "nm-glib-aux/nm-ref-string.h"
+#include "nm-glib-aux/nm-dedup-multi.h"
+#include "nm-glib-aux/nm-json-aux.h"
 
 #include "nm-utils/nm-test-utils.h"
 
@@ -771,6 +773,318 @@ test_nm_str_buf (void)
 
 /*****************************************************************************/
 
+typedef struct {
+	NMDedupMultiObj parent;
+	guint id;
+	guint val;
+} DedupObj;
+
+static const NMDedupMultiObjClass dedup_obj_class;
+
+static DedupObj *
+_dedup_obj_new (guint id, guint val)
+{
+	DedupObj *obj;
+
+	obj = g_slice_new0 (DedupObj);
+	obj->parent.klass = &dedup_obj_class;
+	obj->parent._ref_count = 1;
+	obj->id = id;
+	obj->val = val;
+	return obj;
+}
+
+static const NMDedupMultiObj *
+_dedup_obj_clone (const NMDedupMultiObj *obj)
+{
+	const DedupObj *o = (const DedupObj *) obj;
+
+	return &_dedup_obj_new (o->id, o->val)->parent;
+}
+
+static void
+_dedup_obj_destroy (NMDedupMultiObj *obj)
+{
+	g_slice_free (DedupObj, (DedupObj *) obj);
+}
+
+static void
+_dedup_obj_full_hash_update (const NMDedupMultiObj *obj, NMHashState *h)
+{
+	const DedupObj *o = (const DedupObj *) obj;
+
+	nm_hash_update_vals (h, o->id, o->val);
+}
+
+static gboolean
+_dedup_obj_full_equal (const NMDedupMultiObj *obj_a,
+                       const NMDedupMultiObj *obj_b)
+{
+	const DedupObj *a = (const DedupObj *) obj_a;
+	const DedupObj *b = (const DedupObj *) obj_b;
+
+	return    a->id == b->id
+	       && a->val == b->val;
+}
+
+static const NMDedupMultiObjClass dedup_obj_class = {
+	.obj_clone            = _dedup_obj_clone,
+	.obj_destroy          = _dedup_obj_destroy,
+	.obj_full_hash_update = _dedup_obj_full_hash_update,
+	.obj_full_equal       = _dedup_obj_full_equal,
+};
+
+static void
+_dedup_idx_obj_id_hash_update (const NMDedupMultiIdxType *idx_type,
+                               const NMDedupMultiObj *obj,
+                               NMHashState *h)
+{
+	nm_hash_update_val (h, ((const DedupObj *) obj)->id);
+}
+
+static gboolean
+_dedup_idx_obj_id_equal (const NMDedupMultiIdxType *idx_type,
+                         const NMDedupMultiObj *obj_a,
+                         const NMDedupMultiObj *obj_b)
+{
+	return ((const DedupObj *) obj_a)->id == ((const DedupObj *) obj_b)->id;
+}
+
+static void
+_dedup_idx_obj_partition_hash_update (const NMDedupMultiIdxType *idx_type,
+                                      const NMDedupMultiObj *obj,
+                                      NMHashState *h)
+{
+	nm_hash_update_val (h, ((const DedupObj *) obj)->id % 64u);
+}
+
+static gboolean
+_dedup_idx_obj_partition_equal (const NMDedupMultiIdxType *idx_type,
+                                const NMDedupMultiObj *obj_a,
+                                const NMDedupMultiObj *obj_b)
+{
+	return (((const DedupObj *) obj_a)->id % 64u) == (((const DedupObj *) obj_b)->id % 64u);
+}
+
+static const NMDedupMultiIdxTypeClass dedup_idx_type_class = {
+	.idx_obj_id_hash_update        = _dedup_idx_obj_id_hash_update,
+	.idx_obj_id_equal              = _dedup_idx_obj_id_equal,
+	.idx_obj_partition_hash_update = _dedup_idx_obj_partition_hash_update,
+	.idx_obj_partition_equal       = _dedup_idx_obj_partition_equal,
+};
+
+static void
+test_dedup_multi (void)
+{
+	const guint n = g_test_perf () ? 1000000u : 100000u;
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = nm_dedup_multi_index_new ();
+	NMDedupMultiIdxType idx_type;
+	gint64 t_start;
+	gint64 t_add, t_lookup, t_prune, t_remove;
+	guint i;
+
+	/* Exercises the index with a number of objects comparable to a host
+	 * that receives a full routing table. With "-m perf" it uses 1M objects
+	 * and reports the timings. */
+
+	nm_dedup_multi_idx_type_init (&idx_type, &dedup_idx_type_class);
+
+	t_start = nm_utils_get_monotonic_timestamp_nsec ();
+	for (i = 0; i < n; i++) {
+		DedupObj *obj = _dedup_obj_new (i, i);
+
+		if (!nm_dedup_multi_index_add (multi_idx, &idx_type, obj, NM_DEDUP_MULTI_IDX_MODE_APPEND, NULL, NULL))
+			g_assert_not_reached ();
+		nm_dedup_multi_obj_unref (&obj->parent);
+	}
+	t_add = nm_utils_get_monotonic_timestamp_nsec () - t_start;
+	g_assert_cmpint (idx_type.len, ==, n);
+
+	t_start = nm_utils_get_monotonic_timestamp_nsec ();
+	for (i = 0; i < n; i++) {
+		DedupObj needle = {
+			.parent = {
+				.klass      = &dedup_obj_class,
+				._ref_count = NM_OBJ_REF_COUNT_STACKINIT,
+			},
+			.id = i,
+		};
+		const NMDedupMultiEntry *entry;
+
+		entry = nm_dedup_multi_index_lookup_obj (multi_idx, &idx_type, &needle);
+		g_assert (entry);
+		g_assert_cmpint (((const DedupObj *) entry->obj)->val, ==, i);
+	}
+	t_lookup = nm_utils_get_monotonic_timestamp_nsec () - t_start;
+
+	t_start = nm_utils_get_monotonic_timestamp_nsec ();
+	nm_dedup_multi_index_dirty_set_idx (multi_idx, &idx_type);
+	/* keep the objects with even id. */
+	for (i = 0; i < n; i += 2) {
+		DedupObj needle = {
+			.parent = {
+				.klass      = &dedup_obj_class,
+				._ref_count = NM_OBJ_REF_COUNT_STACKINIT,
+			},
+			.id = i,
+		};
+
+		nm_dedup_multi_entry_set_dirty (nm_dedup_multi_index_lookup_obj (multi_idx, &idx_type, &needle),
+		                                FALSE);
+	}
+	g_assert_cmpint (nm_dedup_multi_index_dirty_remove_idx (multi_idx, &idx_type, FALSE), ==, n / 2);
+	t_prune = nm_utils_get_monotonic_timestamp_nsec () - t_start;
+	g_assert_cmpint (idx_type.len, ==, (n + 1) / 2);
+
+	/* nothing is dirty anymore, but the survivors get marked dirty. */
+	g_assert_cmpint (nm_dedup_multi_index_dirty_remove_idx (multi_idx, &idx_type, TRUE), ==, 0);
+	g_assert_cmpint (idx_type.len, ==, (n + 1) / 2);
+
+	t_start = nm_utils_get_monotonic_timestamp_nsec ();
+	for (i = 0; i < n; i++) {
+		DedupObj needle = {
+			.parent = {
+				.klass      = &dedup_obj_class,
+				._ref_count = NM_OBJ_REF_COUNT_STACKINIT,
+			},
+			.id = i,
+		};
+
+		g_assert_cmpint (nm_dedup_multi_index_remove_obj (multi_idx, &idx_type, &needle, NULL), ==, (i % 2) == 0);
+	}
+	t_remove = nm_utils_get_monotonic_timestamp_nsec () - t_start;
+	g_assert_cmpint (idx_type.len, ==, 0);
+
+	g_test_message ("dedup-multi with %u objects: add %"G_GINT64_FORMAT" msec, lookup %"G_GINT64_FORMAT" msec, dirty-prune %"G_GINT64_FORMAT" msec, remove %"G_GINT64_FORMAT" msec",
+	                n,
+	                t_add / NM_UTILS_NSEC_PER_MSEC,
+	                t_lookup / NM_UTILS_NSEC_PER_MSEC,
+	                t_prune / NM_UTILS_NSEC_PER_MSEC,
+	                t_remove / NM_UTILS_NSEC_PER_MSEC);
+}
+
+/*****************************************************************************/
+
+/* Feeds @input to the framer in chunks of @chunk bytes, like the reads
+ * from a socket, and returns the messages found. */
+static char **
+_json_framer_split (const char *input, gsize chunk, gboolean *out_invalid)
+{
+	NMJsonAuxFramer framer = { };
+	nm_auto_free_gstring GString *buf = g_string_new (NULL);
+	GPtrArray *msgs = g_ptr_array_new ();
+	gsize input_len = strlen (input);
+	gboolean invalid = FALSE;
+	gsize pos = 0;
+
+	while (   pos < input_len
+	       && !invalid) {
+		gsize n = MIN (chunk, input_len - pos);
+		gssize msg_len;
+		gsize msg_start;
+
+		g_string_append_len (buf, &input[pos], n);
+		pos += n;
+
+		while ((msg_len = nm_json_aux_framer_next (&framer, buf->str, buf->len, &msg_start)) != 0) {
+			if (msg_len < 0) {
+				invalid = TRUE;
+				break;
+			}
+			g_assert_cmpint (msg_start + msg_len, <=, buf->len);
+			g_ptr_array_add (msgs, g_strndup (&buf->str[msg_start], msg_len));
+		}
+		g_string_erase (buf, 0, nm_json_aux_framer_rebase (&framer));
+	}
+
+	g_ptr_array_add (msgs, NULL);
+	NM_SET_OUT (out_invalid, invalid);
+	return (char **) g_ptr_array_free (msgs, FALSE);
+}
+
+#define _assert_json_framer(input, expect_invalid, ...) \
+	G_STMT_START { \
+		const char *const _input = (input); \
+		const char *const _expected[] = { NULL, ##__VA_ARGS__, NULL }; \
+		gsize _chunk; \
+		\
+		for (_chunk = 1; _chunk <= strlen (_input); _chunk++) { \
+			gs_strfreev char **_msgs = NULL; \
+			gboolean _invalid; \
+			\
+			_msgs = _json_framer_split (_input, _chunk, &_invalid); \
+			g_assert_cmpint (_invalid, ==, (expect_invalid)); \
+			g_assert (_nm_utils_strv_equal ((char **) &_expected[1], _msgs)); \
+		} \
+	} G_STMT_END
+
+static void
+test_json_framer (void)
+{
+	NMJsonAuxFramer framer = { };
+	nm_auto_free_gstring GString *buf = NULL;
+	const char *elem = "{\"a\\\"}\":\"[\\\\\",\"b\":1},";
+	const gsize elem_len = strlen (elem);
+	const gsize n_elems = (8 * 1024 * 1024) / elem_len + 1;
+	const gsize elems_per_read = 200;
+	gsize msg_start;
+	gsize i;
+
+	/* messages split across reads, with whitespace in between. */
+	_assert_json_framer ("{\"id\":1,\"result\":[{\"a\":\"b\"}]}\n  [1, 2]\r\n{\"id\":2}", FALSE,
+	                     "{\"id\":1,\"result\":[{\"a\":\"b\"}]}",
+	                     "[1, 2]",
+	                     "{\"id\":2}");
+
+	/* escaped quotes and braces inside strings. */
+	_assert_json_framer ("{\"a\\\"}\":\"x\\\"}{]\\\\\",\"b\":[\"\\\\\\\"[\",{}]}"
+	                     "[\"\\\\\",{\"c\":\"]\\\"\\\\\\\\\"}]", FALSE,
+	                     "{\"a\\\"}\":\"x\\\"}{]\\\\\",\"b\":[\"\\\\\\\"[\",{}]}",
+	                     "[\"\\\\\",{\"c\":\"]\\\"\\\\\\\\\"}]");
+
+	/* an incomplete message is kept for later. */
+	_assert_json_framer ("{\"a\":1} {\"b\":", FALSE,
+	                     "{\"a\":1}");
+
+	/* anything but objects and arrays is rejected. */
+	_assert_json_framer ("x{}", TRUE);
+	_assert_json_framer ("{}]", TRUE, "{}");
+	_assert_json_framer ("\"a\"", TRUE);
+	_assert_json_framer ("{} 1", TRUE, "{}");
+
+	/* an 8 MiB message arriving in many reads. The framer must continue
+	 * where it stopped: after each read, the bytes it already saw are
+	 * overwritten with closing brackets, which would end the message
+	 * early if they were scanned again. The reads end between the
+	 * elements of the array, outside of strings. */
+	buf = g_string_new ("[");
+	g_assert_cmpint (nm_json_aux_framer_next (&framer, buf->str, buf->len, NULL), ==, 0);
+	g_assert_cmpint (framer.scanned, ==, buf->len);
+	memset (buf->str, ']', buf->len);
+
+	for (i = 0; i < n_elems; ) {
+		gsize scanned = buf->len;
+		gsize j;
+
+		for (j = 0; j < elems_per_read && i < n_elems; j++, i++)
+			g_string_append_len (buf, elem, elem_len);
+
+		g_assert_cmpint (nm_json_aux_framer_next (&framer, buf->str, buf->len, NULL), ==, 0);
+		g_assert_cmpint (framer.scanned, ==, buf->len);
+		memset (&buf->str[scanned], ']', buf->len - scanned);
+	}
+
+	g_string_append (buf, "0]");
+	g_assert_cmpint (buf->len, >, 8 * 1024 * 1024);
+	g_assert_cmpint (nm_json_aux_framer_next (&framer, buf->str, buf->len, &msg_start), ==, buf->len);
+	g_assert_cmpint (msg_start, ==, 0);
+	g_assert_cmpint (nm_json_aux_framer_rebase (&framer), ==, buf->len);
+	g_assert_cmpint (framer.scanned, ==, 0);
+	g_assert_cmpint (framer.depth, ==, 0);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -792,6 +1106,8 @@ int main (int argc, char **argv)
 	g_test_add_func ("/general/test_string_table_lookup", test_string_table_lookup);
 	g_test_add_func ("/general/test_nm_utils_get_next_realloc_size", test_nm_utils_get_next_realloc_size);
 	g_test_add_func ("/general/test_nm_str_buf", test_nm_str_buf);
+	g_test_add_func ("/general/test_dedup_multi", test_dedup_multi);
+	g_test_add_func ("/general/test_json_framer", test_json_framer);
 
 	return g_test_run ();
 }
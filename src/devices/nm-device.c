@@ -38,6 +38,7 @@
 #include "ndisc/nm-lndp-ndisc.h"
 #include "dhcp/nm-dhcp-manager.h"
 #include "dhcp/nm-dhcp-utils.h"
+#include "dhcp/nm-dhcp-server.h"
 #include "nm-act-request.h"
 #include "nm-proxy-config.h"
 #include "nm-ip4-config.h"
@@ -274,6 +275,20 @@ typedef struct _NMDevicePrivate {
 		guint queued_ip_config_id_x[2];
 	};
 
+	/* Routes that changed in platform since ext_ip_config_x was last
+	 * updated, indexed by their NMPObject id. */
+	union {
+		struct {
+			GHashTable *ext_ip_config_delta_6;
+			GHashTable *ext_ip_config_delta_4;
+		};
+		GHashTable *ext_ip_config_delta_x[2];
+	};
+
+	/* Whether ext_ip_config_x must be captured anew from platform, instead of
+	 * only applying ext_ip_config_delta_x. */
+	bool ext_ip_config_resync_x[2];
+
 	GSList *pending_actions;
 	GSList *dad6_failed_addrs;
 
@@ -520,6 +535,9 @@ typedef struct _NMDevicePrivate {
 	NMDnsMasqManager *dnsmasq_manager;
 	gulong            dnsmasq_state_id;
 
+	/* in-process DHCP server for shared connections, instead of dnsmasq */
+	NMDhcpServer     *dhcp_server;
+
 	/* Firewall */
 	FirewallState fw_state:4;
 	NMFirewallManager *fw_mgr;
@@ -613,7 +631,7 @@ typedef struct _NMDevicePrivate {
 	} sriov;
 
 	struct {
-		guint timeout_id;
+		NMPlatformLinkStatsHandle *handle;
 		guint refresh_rate_ms;
 		guint64 tx_bytes;
 		guint64 rx_bytes;
@@ -631,7 +649,11 @@ static const GDBusSignalInfo signal_info_state_changed;
 
 static void nm_device_set_proxy_config (NMDevice *self, const char *pac_url);
 
-static gboolean update_ext_ip_config (NMDevice *self, int addr_family, gboolean intersect_configs);
+static gboolean update_ext_ip_config (NMDevice *self,
+                                      int addr_family,
+                                      gboolean intersect_configs,
+                                      gboolean *out_changed);
+static void _ext_ip_config_delta_clear (NMDevicePrivate *priv, int addr_family, gboolean resync);
 
 static gboolean nm_device_set_ip_config (NMDevice *self,
                                          int addr_family,
@@ -1445,6 +1467,32 @@ nm_device_sysctl_ip_conf_set (NMDevice *self,
 	                                       value);
 }
 
+/* like nm_device_sysctl_ip_conf_set(), but only queue the write. Use this
+ * for settings where the caller does not care about the outcome. */
+static void
+nm_device_sysctl_ip_conf_set_async (NMDevice *self,
+                                    int addr_family,
+                                    const char *property,
+                                    const char *value)
+{
+	const char *ifname;
+
+	nm_assert_addr_family (addr_family);
+	nm_assert (value);
+
+	ifname = nm_device_get_ip_iface_from_platform (self);
+	if (!ifname)
+		return;
+
+	nm_platform_sysctl_ip_conf_set_async (nm_device_get_platform (self),
+	                                      addr_family,
+	                                      ifname,
+	                                      property,
+	                                      value,
+	                                      NULL,
+	                                      NULL);
+}
+
 /*****************************************************************************/
 
 gboolean
@@ -2032,27 +2080,65 @@ _stats_update_counters_from_pllink (NMDevice *self, const NMPlatformLink *pllink
 	_stats_update_counters (self, pllink->tx_bytes, pllink->rx_bytes);
 }
 
-static gboolean
-_stats_timeout_cb (gpointer user_data)
+static void
+_stats_link_cb (NMPlatform *platform,
+                int ifindex,
+                const NMPlatformLink *plink,
+                gpointer user_data)
 {
 	NMDevice *self = user_data;
-	int ifindex;
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	int ip_ifindex;
 
-	ifindex = nm_device_get_ip_ifindex (self);
+	ip_ifindex = nm_device_get_ip_ifindex (self);
 
-	_LOGT (LOGD_DEVICE, "stats: refresh %d", ifindex);
+	_LOGT (LOGD_DEVICE, "stats: refresh %d", ip_ifindex);
 
-	if (ifindex > 0)
-		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
+	if (ifindex != ip_ifindex) {
+		/* the ifindex changed since the last tick. Follow it, and refresh
+		 * the new link right away. */
+		nm_platform_link_stats_set_ifindex (platform, priv->stats.handle, ip_ifindex);
+		if (ip_ifindex > 0)
+			nm_platform_link_refresh (platform, ip_ifindex);
+		return;
+	}
 
-	return G_SOURCE_CONTINUE;
+	if (plink)
+		_stats_update_counters_from_pllink (self, plink);
 }
 
+static void
+_stats_stop (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	if (priv->stats.handle) {
+		nm_platform_link_stats_unsubscribe (nm_device_get_platform (self),
+		                                    g_steal_pointer (&priv->stats.handle));
+	}
+}
+
+static void
+_stats_start (NMDevice *self, guint refresh_rate_ms)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	nm_assert (!priv->stats.handle);
+	nm_assert (refresh_rate_ms > 0);
+
+	/* the platform refreshes the statistics of all devices in batches. */
+	priv->stats.handle = nm_platform_link_stats_subscribe (nm_device_get_platform (self),
+	                                                       nm_device_get_ip_ifindex (self),
+	                                                       refresh_rate_ms,
+	                                                       _stats_link_cb,
+	                                                       self);
+}
+
+#define STATS_REFRESH_RATE_MS_MIN 200u
+
 static guint
 _stats_refresh_rate_real (guint refresh_rate_ms)
 {
-	const guint STATS_REFRESH_RATE_MS_MIN = 200;
-
 	if (refresh_rate_ms == 0)
 		return 0;
 
@@ -2090,7 +2176,7 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	if (_stats_refresh_rate_real (old_rate) == refresh_rate_ms)
 		return;
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_stop (self);
 
 	if (!refresh_rate_ms)
 		return;
@@ -2102,7 +2188,7 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	if (ifindex > 0)
 		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
 
-	priv->stats.timeout_id = g_timeout_add (refresh_rate_ms, _stats_timeout_cb, self);
+	_stats_start (self, refresh_rate_ms);
 }
 
 /*****************************************************************************/
@@ -4202,6 +4288,18 @@ device_link_changed (NMDevice *self)
 	if (priv->up && (!was_up || seen_down)) {
 		/* the link was down and just came up. That happens for example, while changing MTU.
 		 * We must restore IP configuration. */
+		if (   (   NM_IN_SET (priv->ip_state_4, NM_DEVICE_IP_STATE_CONF,
+		                                        NM_DEVICE_IP_STATE_DONE)
+		        || NM_IN_SET (priv->ip_state_6, NM_DEVICE_IP_STATE_CONF,
+		                                        NM_DEVICE_IP_STATE_DONE))
+		    && nm_device_get_ip_ifindex (self) > 0) {
+			/* kernel silently removed routes while the link was down. Re-read
+			 * the routes of the interface before syncing them again. */
+			nm_platform_refresh_routes_for_ifindex (nm_device_get_platform (self),
+			                                        AF_UNSPEC,
+			                                        nm_device_get_ip_ifindex (self));
+		}
+
 		if (NM_IN_SET (priv->ip_state_4, NM_DEVICE_IP_STATE_CONF,
 		                                 NM_DEVICE_IP_STATE_DONE)) {
 			if (!ip_config_merge_and_apply (self, AF_INET, TRUE))
@@ -4829,10 +4927,10 @@ realize_start_setup (NMDevice *self,
 
 	nm_device_set_carrier_from_platform (self);
 
-	nm_assert (!priv->stats.timeout_id);
+	nm_assert (!priv->stats.handle);
 	real_rate = _stats_refresh_rate_real (priv->stats.refresh_rate_ms);
 	if (real_rate)
-		priv->stats.timeout_id = g_timeout_add (real_rate, _stats_timeout_cb, self);
+		_stats_start (self, real_rate);
 
 	klass->realize_start_notify (self, plink);
 
@@ -5023,7 +5121,7 @@ nm_device_unrealize (NMDevice *self, gboolean remove_resources, GError **error)
 		_notify (self, PROP_PHYSICAL_PORT_ID);
 	}
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_stop (self);
 	_stats_update_counters (self, 0, 0);
 
 	priv->hw_addr_len_ = 0;
@@ -6498,6 +6596,26 @@ dnsmasq_state_changed_cb (NMDnsMasqManager *manager, guint32 status, gpointer us
 	}
 }
 
+static void
+shared_dhcp_server_failed_cb (NMDhcpServer *server, gpointer user_data)
+{
+	NMDevice *self = NM_DEVICE (user_data);
+
+	nm_device_ip_method_failed (self, AF_INET, NM_DEVICE_STATE_REASON_SHARED_START_FAILED);
+}
+
+static gboolean
+shared_use_internal_dhcp_server (void)
+{
+	gs_free char *value = NULL;
+
+	value = nm_config_data_get_value (NM_CONFIG_GET_DATA,
+	                                  NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                  NM_CONFIG_KEYFILE_KEY_MAIN_SHARED_DHCP_SERVER,
+	                                  NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
+	return nm_streq0 (value, "internal");
+}
+
 void
 nm_device_auth_request (NMDevice *self,
                         GDBusMethodInvocation *context,
@@ -7945,8 +8063,12 @@ ip_config_merge_and_apply (NMDevice *self,
 
 	if (commit) {
 		if (priv->queued_ip_config_id_x[IS_IPv4])
-			update_ext_ip_config (self, addr_family, FALSE);
+			update_ext_ip_config (self, addr_family, FALSE, NULL);
 		ensure_con_ip_config (self, addr_family);
+
+		/* the internal configurations may have changed. What is external must
+		 * be determined anew on the next change in platform. */
+		_ext_ip_config_delta_clear (priv, addr_family, TRUE);
 	}
 
 	if (!IS_IPv4) {
@@ -10617,7 +10739,7 @@ restore_ip6_properties (NMDevice *self)
 		if (   priv->ipv6ll_handle
 		    && nm_streq (key, "disable_ipv6"))
 			continue;
-		nm_device_sysctl_ip_conf_set (self, AF_INET6, key, value);
+		nm_device_sysctl_ip_conf_set_async (self, AF_INET6, key, value);
 	}
 }
 
@@ -10844,7 +10966,8 @@ act_stage3_ip_config_start (NMDevice *self,
 			if (out_config) {
 				*out_config = shared4_new_config (self, connection);
 				if (*out_config) {
-					priv->dnsmasq_manager = nm_dnsmasq_manager_new (nm_device_get_ip_iface (self));
+					if (!shared_use_internal_dhcp_server ())
+						priv->dnsmasq_manager = nm_dnsmasq_manager_new (nm_device_get_ip_iface (self));
 					ret = NM_ACT_STAGE_RETURN_SUCCESS;
 				} else {
 					NM_SET_OUT (out_failure_reason, NM_DEVICE_STATE_REASON_IP_CONFIG_UNAVAILABLE);
@@ -11416,6 +11539,24 @@ start_sharing (NMDevice *self, NMIP4Config *config, GError **error)
 		break;
 	}
 
+	if (!priv->dnsmasq_manager) {
+		nm_clear_pointer (&priv->dhcp_server, nm_dhcp_server_free);
+		priv->dhcp_server = nm_dhcp_server_new (nm_device_get_ip_ifindex (self),
+		                                        ip_iface,
+		                                        config,
+		                                        announce_android_metered,
+		                                        shared_dhcp_server_failed_cb,
+		                                        self,
+		                                        &local);
+		if (!priv->dhcp_server) {
+			g_set_error (error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN,
+			             "could not start DHCP server due to %s", local->message);
+			g_error_free (local);
+			nm_act_request_set_shared (req, FALSE);
+			return FALSE;
+		}
+		return TRUE;
+	}
 
 	if (!nm_dnsmasq_manager_start (priv->dnsmasq_manager,
 	                               config,
@@ -11818,6 +11959,8 @@ dnsmasq_cleanup (NMDevice *self)
 {
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 
+	nm_clear_pointer (&priv->dhcp_server, nm_dhcp_server_free);
+
 	if (!priv->dnsmasq_manager)
 		return;
 
@@ -11943,6 +12086,7 @@ _cleanup_ip_pre (NMDevice *self, int addr_family, CleanupType cleanup_type)
 		_LOGD (LOGD_DEVICE, "clearing queued IP%c config change",
 		       nm_utils_addr_family_to_char (addr_family));
 	}
+	_ext_ip_config_delta_clear (priv, addr_family, TRUE);
 
 	if (IS_IPv4) {
 		dhcp4_cleanup (self, cleanup_type, FALSE);
@@ -13908,8 +14052,214 @@ intersect_ext_config (NMDevice *self,
 	}
 }
 
+static void
+_applied_ip_configs_get (NMDevicePrivate *priv, int addr_family, AppliedConfig **configs)
+{
+	if (addr_family == AF_INET) {
+		configs[0] = &priv->dev_ip_config_4;
+		configs[1] = &priv->dev2_ip_config_4;
+		configs[2] = NULL;
+	} else {
+		configs[0] = &priv->ac_ip6_config;
+		configs[1] = &priv->dhcp6.ip6_config;
+		configs[2] = &priv->dev2_ip_config_6;
+		configs[3] = NULL;
+	}
+}
+
 static gboolean
-update_ext_ip_config (NMDevice *self, int addr_family, gboolean intersect_configs)
+_internal_ip_configs_lookup_route (NMDevice *self, int addr_family, const NMPObject *obj)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
+	AppliedConfig *applied[4];
+	NMIPConfig *config;
+	GSList *iter;
+	guint i;
+
+	if (   priv->con_ip_config_x[IS_IPv4]
+	    && nm_ip_config_nmpobj_lookup (priv->con_ip_config_x[IS_IPv4], obj))
+		return TRUE;
+
+	_applied_ip_configs_get (priv, addr_family, applied);
+	for (i = 0; applied[i]; i++) {
+		config = applied_config_get_current (applied[i]);
+		if (   config
+		    && nm_ip_config_nmpobj_lookup (config, obj))
+			return TRUE;
+	}
+
+	for (iter = priv->vpn_configs_x[IS_IPv4]; iter; iter = iter->next) {
+		if (nm_ip_config_nmpobj_lookup (iter->data, obj))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static gboolean
+_internal_ip_configs_remove_route (NMDevice *self, int addr_family, const NMPObject *obj)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
+	AppliedConfig *applied[4];
+	GSList *iter;
+	gboolean changed = FALSE;
+	guint i;
+
+	if (   priv->con_ip_config_x[IS_IPv4]
+	    && nm_ip_config_nmpobj_remove (priv->con_ip_config_x[IS_IPv4], obj))
+		changed = TRUE;
+
+	_applied_ip_configs_get (priv, addr_family, applied);
+	for (i = 0; applied[i]; i++) {
+		AppliedConfig *config = applied[i];
+
+		if (!config->orig)
+			continue;
+
+		if (   !config->current
+		    && nm_ip_config_nmpobj_lookup (config->orig, obj)) {
+			/* like intersect_ext_config(), never modify the original configuration. */
+			config->current = IS_IPv4
+			                  ? (NMIPConfig *) nm_ip4_config_clone (NM_IP4_CONFIG (config->orig))
+			                  : (NMIPConfig *) nm_ip6_config_clone (NM_IP6_CONFIG (config->orig));
+		}
+		if (   config->current
+		    && nm_ip_config_nmpobj_remove (config->current, obj))
+			changed = TRUE;
+	}
+
+	for (iter = priv->vpn_configs_x[IS_IPv4]; iter; iter = iter->next) {
+		if (nm_ip_config_nmpobj_remove (iter->data, obj))
+			changed = TRUE;
+	}
+
+	return changed;
+}
+
+static void
+_ext_ip_config_delta_clear (NMDevicePrivate *priv, int addr_family, gboolean resync)
+{
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
+
+	nm_clear_pointer (&priv->ext_ip_config_delta_x[IS_IPv4], g_hash_table_unref);
+	priv->ext_ip_config_resync_x[IS_IPv4] = resync;
+}
+
+static void
+_ext_ip_config_delta_add (NMDevicePrivate *priv, int addr_family, const NMPObject *obj)
+{
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
+	GHashTable *delta;
+
+	if (priv->ext_ip_config_resync_x[IS_IPv4])
+		return;
+
+	if (   !NM_IN_SET (NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                             NMP_OBJECT_TYPE_IP6_ROUTE)
+	    || NM_PLATFORM_IP_ROUTE_IS_DEFAULT (NMP_OBJECT_CAST_IP_ROUTE (obj))) {
+		/* Only routes are tracked incrementally. Addresses are few and
+		 * get sorted when capturing them, and default routes are subject
+		 * to the metric penalty when subtracting the internal configurations.
+		 * Capture the configuration anew. */
+		_ext_ip_config_delta_clear (priv, addr_family, TRUE);
+		return;
+	}
+
+	delta = priv->ext_ip_config_delta_x[IS_IPv4];
+	if (!delta) {
+		delta = g_hash_table_new_full ((GHashFunc) nmp_object_id_hash,
+		                               (GEqualFunc) nmp_object_id_equal,
+		                               (GDestroyNotify) nmp_object_unref,
+		                               NULL);
+		priv->ext_ip_config_delta_x[IS_IPv4] = delta;
+	}
+	if (!g_hash_table_contains (delta, obj))
+		g_hash_table_add (delta, (gpointer) nmp_object_ref (obj));
+}
+
+static gboolean
+_ext_ip_config_delta_exclude_route (const NMPObject *obj, gpointer user_data)
+{
+	return _internal_ip_configs_lookup_route (user_data,
+	                                          NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+	                                            ? AF_INET
+	                                            : AF_INET6,
+	                                          obj);
+}
+
+static gboolean
+_ext_ip_config_delta_apply (NMDevice *self,
+                            int addr_family,
+                            int ifindex,
+                            gboolean intersect_routes,
+                            gboolean *out_changed)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
+	NMPlatform *platform = nm_device_get_platform (self);
+	NMIPConfig *ext = priv->ext_ip_config_x[IS_IPv4];
+	gs_unref_hashtable GHashTable *delta = NULL;
+	GHashTableIter h_iter;
+	const NMPObject *obj;
+	gboolean changed = FALSE;
+
+	if (   priv->ext_ip_config_resync_x[IS_IPv4]
+	    || !ext
+	    || (   !IS_IPv4
+	        && !priv->ext_ip6_config_captured)
+	    || nm_ip_config_get_ifindex (ext) != ifindex
+	    || nm_platform_link_get_master (platform, ifindex) > 0)
+		return FALSE;
+
+	delta = g_steal_pointer (&priv->ext_ip_config_delta_x[IS_IPv4]);
+	if (!delta) {
+		NM_SET_OUT (out_changed, FALSE);
+		return TRUE;
+	}
+
+	_LOGT (LOGD_DEVICE, "ip%c: update external configuration for %u changed routes",
+	       nm_utils_addr_family_to_char (addr_family),
+	       g_hash_table_size (delta));
+
+	g_hash_table_iter_init (&h_iter, delta);
+	while (g_hash_table_iter_next (&h_iter, (gpointer *) &obj, NULL)) {
+		const NMPObject *plobj;
+
+		if (nm_ip_config_route_delta_apply (ext,
+		                                    platform,
+		                                    obj,
+		                                    _ext_ip_config_delta_exclude_route,
+		                                    self,
+		                                    &plobj))
+			changed = TRUE;
+
+		if (!plobj) {
+			if (!IS_IPv4)
+				nm_ip6_config_nmpobj_remove (priv->ext_ip6_config_captured, obj);
+
+			/* Like the intersection in update_ext_ip_config(), don't re-add
+			 * routes that were removed externally. */
+			if (   intersect_routes
+			    && _internal_ip_configs_remove_route (self, addr_family, obj))
+				changed = TRUE;
+			continue;
+		}
+
+		if (!IS_IPv4)
+			nm_ip6_config_add_route (priv->ext_ip6_config_captured, NMP_OBJECT_CAST_IP6_ROUTE (plobj), NULL);
+	}
+
+	NM_SET_OUT (out_changed, changed);
+	return TRUE;
+}
+
+static gboolean
+update_ext_ip_config (NMDevice *self,
+                      int addr_family,
+                      gboolean intersect_configs,
+                      gboolean *out_changed)
 {
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 	int ifindex;
@@ -13924,6 +14274,19 @@ update_ext_ip_config (NMDevice *self, int addr_family, gboolean intersect_config
 
 	is_up = nm_platform_link_is_up (nm_device_get_platform (self), ifindex);
 
+	/* Usually only some routes changed since the last time. Avoid capturing
+	 * the entire configuration from platform and subtracting the internal
+	 * configurations, which is expensive with many routes. */
+	if (_ext_ip_config_delta_apply (self,
+	                                addr_family,
+	                                ifindex,
+	                                intersect_configs && is_up,
+	                                out_changed))
+		return TRUE;
+
+	_ext_ip_config_delta_clear (priv, addr_family, FALSE);
+	NM_SET_OUT (out_changed, TRUE);
+
 	if (addr_family == AF_INET) {
 
 		g_clear_object (&priv->ext_ip_config_4);
@@ -14043,6 +14406,7 @@ static void
 update_ip_config (NMDevice *self, int addr_family)
 {
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	gboolean changed;
 
 	nm_assert_addr_family (addr_family);
 
@@ -14051,7 +14415,8 @@ update_ip_config (NMDevice *self, int addr_family)
 	else
 		priv->update_ip_config_completed_v6 = TRUE;
 
-	if (update_ext_ip_config (self, addr_family, TRUE)) {
+	if (   update_ext_ip_config (self, addr_family, TRUE, &changed)
+	    && changed) {
 		if (addr_family == AF_INET) {
 			if (priv->ext_ip_config_4)
 				ip_config_merge_and_apply (self, AF_INET, FALSE);
@@ -14222,6 +14587,7 @@ device_ipx_changed (NMPlatform *platform,
 	switch (obj_type) {
 	case NMP_OBJECT_TYPE_IP4_ADDRESS:
 	case NMP_OBJECT_TYPE_IP4_ROUTE:
+		_ext_ip_config_delta_add (priv, AF_INET, NMP_OBJECT_UP_CAST (platform_object));
 		if (!priv->queued_ip_config_id_4) {
 			priv->queued_ip_config_id_4 = g_idle_add (queued_ip4_config_change, self);
 			_LOGD (LOGD_DEVICE, "queued IP4 config change");
@@ -14239,6 +14605,7 @@ device_ipx_changed (NMPlatform *platform,
 
 		/* fall-through */
 	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		_ext_ip_config_delta_add (priv, AF_INET6, NMP_OBJECT_UP_CAST (platform_object));
 		if (!priv->queued_ip_config_id_6) {
 			priv->queued_ip_config_id_6 = g_idle_add (queued_ip6_config_change, self);
 			_LOGD (LOGD_DEVICE, "queued IP6 config change");
@@ -15858,9 +16225,9 @@ ip6_managed_setup (NMDevice *self)
 {
 	set_nm_ipv6ll (self, TRUE);
 	set_disable_ipv6 (self, "1");
-	nm_device_sysctl_ip_conf_set (self, AF_INET6, "accept_ra", "0");
-	nm_device_sysctl_ip_conf_set (self, AF_INET6, "use_tempaddr", "0");
-	nm_device_sysctl_ip_conf_set (self, AF_INET6, "forwarding", "0");
+	nm_device_sysctl_ip_conf_set_async (self, AF_INET6, "accept_ra", "0");
+	nm_device_sysctl_ip_conf_set_async (self, AF_INET6, "use_tempaddr", "0");
+	nm_device_sysctl_ip_conf_set_async (self, AF_INET6, "forwarding", "0");
 }
 
 static void
@@ -17794,7 +18161,7 @@ dispose (GObject *object)
 
 	nm_clear_g_source (&priv->check_delete_unrealized_id);
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_stop (self);
 
 	carrier_disconnected_action_cancel (self);
 
@@ -17854,6 +18221,8 @@ finalize (GObject *object)
 	g_free (priv->hw_addr_initial);
 	g_slist_free (priv->pending_actions);
 	g_slist_free_full (priv->dad6_failed_addrs, (GDestroyNotify) nmp_object_unref);
+	nm_clear_pointer (&priv->ext_ip_config_delta_4, g_hash_table_unref);
+	nm_clear_pointer (&priv->ext_ip_config_delta_6, g_hash_table_unref);
 	nm_clear_g_free (&priv->physical_port_id);
 	g_free (priv->udi);
 	g_free (priv->iface);
@@ -17985,6 +18354,9 @@ const NMDBusInterfaceInfoExtended nm_interface_info_device_statistics = {
 			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE     ("RxBytes",       "t", NM_DEVICE_STATISTICS_RX_BYTES),
 		),
 	),
+	/* the counters get also updated on every link change. Don't emit them
+	 * more often than the lowest refresh rate. */
+	.properties_changed_ratelimit_msec = STATS_REFRESH_RATE_MS_MIN,
 };
 
 static void
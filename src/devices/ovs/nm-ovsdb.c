@@ -11,6 +11,7 @@
 #include <gio/gunixsocketaddress.h>
 
 #include "nm-glib-aux/nm-jansson.h"
+#include "nm-glib-aux/nm-json-aux.h"
 #include "nm-core-utils.h"
 #include "nm-core-internal.h"
 #include "devices/nm-device.h"
@@ -50,16 +51,22 @@ enum {
 
 static guint signals[LAST_SIGNAL] = { 0 };
 
+NM_GOBJECT_PROPERTIES_DEFINE_BASE (
+	PROP_SOCKET_PATH,
+);
+
 typedef struct {
+	char *socket_path;
 	GSocketClient *client;
 	GSocketConnection *conn;
-	GCancellable *cancellable;
+	GCancellable *cancellable;      /* Cancelled on disconnect. */
 	char buf[4096];                 /* Input buffer */
-	size_t bufp;                    /* Last decoded byte in the input buffer. */
 	GString *input;                 /* JSON stream waiting for decoding. */
+	NMJsonAuxFramer framer;         /* Finds the messages in the input. */
 	GString *output;                /* JSON stream to be sent. */
 	gint64 seq;
 	GArray *calls;                  /* Method calls waiting for a response. */
+	guint next_command_id;          /* Idle source to send out queued calls. */
 	GHashTable *interfaces;         /* interface uuid => OpenvswitchInterface */
 	GHashTable *ports;              /* port uuid => OpenvswitchPort */
 	GHashTable *bridges;            /* bridge uuid => OpenvswitchBridge */
@@ -111,6 +118,7 @@ typedef struct {
 	gint64 id;
 #define COMMAND_PENDING -1                      /* id not yet assigned */
 	OvsdbCommand command;
+	bool no_batch;                          /* send in a transaction of its own */
 	OvsdbMethodCallback callback;
 	gpointer user_data;
 	union {
@@ -129,6 +137,7 @@ typedef struct {
 } OvsdbMethodCall;
 
 #define OVSDB_MAX_FAILURES    3
+#define OVSDB_MAX_BATCH       1000
 
 static void
 _LOGT_call_do (const char *comment, OvsdbMethodCall *call, json_t *msg)
@@ -176,11 +185,21 @@ _LOGT_call_do (const char *comment, OvsdbMethodCall *call, json_t *msg)
 			_LOGT_call_do ((comment), (call), (message)); \
 	} G_STMT_END
 
+static gboolean
+_next_command_cb (gpointer user_data)
+{
+	NMOvsdb *self = user_data;
+
+	NM_OVSDB_GET_PRIVATE (self)->next_command_id = 0;
+	ovsdb_next_command (self);
+	return G_SOURCE_REMOVE;
+}
+
 /**
  * ovsdb_call_method:
  *
- * Queues the ovsdb command. Eventually fires the command right away if
- * there's no command pending completion.
+ * Queues the ovsdb command. It is sent from an idle handler, together with
+ * the other commands queued until then.
  */
 static void
 ovsdb_call_method (NMOvsdb *self, OvsdbCommand command,
@@ -215,8 +234,8 @@ ovsdb_call_method (NMOvsdb *self, OvsdbCommand command,
 		call->bridge = nm_simple_connection_new_clone (bridge);
 		call->port = nm_simple_connection_new_clone (port);
 		call->interface = nm_simple_connection_new_clone (interface);
-		call->bridge_device = g_object_ref (bridge_device);
-		call->interface_device = g_object_ref (interface_device);
+		call->bridge_device = nm_g_object_ref (bridge_device);
+		call->interface_device = nm_g_object_ref (interface_device);
 		break;
 	case OVSDB_DEL_INTERFACE:
 		call->ifname = g_strdup (ifname);
@@ -229,7 +248,10 @@ ovsdb_call_method (NMOvsdb *self, OvsdbCommand command,
 
 	_LOGT_call ("enqueue", call, NULL);
 
-	ovsdb_next_command (self);
+	/* Don't send right away, so that the add and delete calls made during this
+	 * main loop iteration end up in the same transaction. */
+	if (!priv->next_command_id)
+		priv->next_command_id = g_idle_add (_next_command_cb, self);
 }
 
 /*****************************************************************************/
@@ -353,7 +375,8 @@ _set_port_interfaces (json_t *params, const char *ifname, json_t *new_interfaces
  * Returns an commands that adds new interface from a given connection.
  */
 static void
-_insert_interface (json_t *params, NMConnection *interface, NMDevice *interface_device)
+_insert_interface (json_t *params, NMConnection *interface, NMDevice *interface_device,
+                   const char *uuid_name)
 {
 	const char *type = NULL;
 	NMSettingOvsInterface *s_ovs_iface;
@@ -377,12 +400,13 @@ _insert_interface (json_t *params, NMConnection *interface, NMDevice *interface_
 			mtu = nm_setting_wired_get_mtu (s_wired);
 	}
 
-	if (!nm_device_hw_addr_get_cloned (interface_device,
-	                                   interface,
-	                                   FALSE,
-	                                   &cloned_mac,
-	                                   NULL,
-	                                   &error)) {
+	if (   interface_device
+	    && !nm_device_hw_addr_get_cloned (interface_device,
+	                                      interface,
+	                                      FALSE,
+	                                      &cloned_mac,
+	                                      NULL,
+	                                      &error)) {
 		_LOGW ("Cannot determine cloned mac for OVS %s '%s': %s",
 		       "interface",
 		       nm_connection_get_interface_name (interface),
@@ -426,7 +450,7 @@ _insert_interface (json_t *params, NMConnection *interface, NMDevice *interface_
 	                   "op", "insert",
 	                   "table", "Interface",
 	                   "row", row,
-	                   "uuid-name", "rowInterface"));
+	                   "uuid-name", uuid_name));
 }
 
 /**
@@ -435,7 +459,8 @@ _insert_interface (json_t *params, NMConnection *interface, NMDevice *interface_
  * Returns an commands that adds new port from a given connection.
  */
 static void
-_insert_port (json_t *params, NMConnection *port, json_t *new_interfaces)
+_insert_port (json_t *params, NMConnection *port, json_t *new_interfaces,
+              const char *uuid_name)
 {
 	NMSettingOvsPort *s_ovs_port;
 	const char *vlan_mode = NULL;
@@ -481,7 +506,7 @@ _insert_port (json_t *params, NMConnection *port, json_t *new_interfaces)
 	/* Create a new one. */
 	json_array_append_new (params,
 		json_pack ("{s:s, s:s, s:o, s:s}", "op", "insert", "table", "Port",
-		           "row", row, "uuid-name", "rowPort"));
+		           "row", row, "uuid-name", uuid_name));
 }
 
 /**
@@ -490,7 +515,8 @@ _insert_port (json_t *params, NMConnection *port, json_t *new_interfaces)
  * Returns an commands that adds new bridge from a given connection.
  */
 static void
-_insert_bridge (json_t *params, NMConnection *bridge, NMDevice *bridge_device, json_t *new_ports)
+_insert_bridge (json_t *params, NMConnection *bridge, NMDevice *bridge_device, json_t *new_ports,
+                const char *uuid_name)
 {
 	NMSettingOvsBridge *s_ovs_bridge;
 	const char *fail_mode = NULL;
@@ -504,12 +530,13 @@ _insert_bridge (json_t *params, NMConnection *bridge, NMDevice *bridge_device, j
 
 	s_ovs_bridge = nm_connection_get_setting_ovs_bridge (bridge);
 
-	if (!nm_device_hw_addr_get_cloned (bridge_device,
-	                                   bridge,
-	                                   FALSE,
-	                                   &cloned_mac,
-	                                   NULL,
-	                                   &error)) {
+	if (   bridge_device
+	    && !nm_device_hw_addr_get_cloned (bridge_device,
+	                                      bridge,
+	                                      FALSE,
+	                                      &cloned_mac,
+	                                      NULL,
+	                                      &error)) {
 		_LOGW ("Cannot determine cloned mac for OVS %s '%s': %s",
 		       "bridge",
 		       nm_connection_get_interface_name (bridge),
@@ -552,7 +579,7 @@ _insert_bridge (json_t *params, NMConnection *bridge, NMDevice *bridge_device, j
 	/* Create a new one. */
 	json_array_append_new (params,
 		json_pack ("{s:s, s:s, s:o, s:s}", "op", "insert", "table", "Bridge",
-		           "row", row, "uuid-name", "rowBridge"));
+		           "row", row, "uuid-name", uuid_name));
 }
 
 /**
@@ -570,293 +597,358 @@ _inc_next_cfg (const char *db_uuid)
 	                  "where", "_uuid", "==", "uuid", db_uuid);
 }
 
-/**
- * _add_interface:
- *
- * Adds an interface as specified by @interface connection, optionally creating
- * a parent @port and @bridge if needed.
- */
+/*****************************************************************************/
+
+/* Add and delete calls are translated to transactions based on our view of
+ * the bridges, ports and interfaces in the database. To merge several of them
+ * into a single transaction, they are applied one after another on a scratch
+ * copy of that tree. Only the difference between the resulting tree and the
+ * database is then serialized. */
+
+typedef struct _OvsdbTxnRow OvsdbTxnRow;
+
+struct _OvsdbTxnRow {
+	const char *name;
+	const char *connection_uuid;
+	char *uuid_name;                /* set for rows inserted by the transaction */
+	json_t *uuid;                   /* the ["uuid", ...] or ["named-uuid", ...] atom */
+	json_t *orig_children;          /* child atoms in the database */
+	GPtrArray *children;            /* OvsdbTxnRow; NULL for interfaces and unknown rows */
+	const OvsdbMethodCall *call;    /* the call that inserts the row */
+	bool changed:1;
+};
+
+typedef struct {
+	GPtrArray *rows;                /* owns all the OvsdbTxnRow */
+	OvsdbTxnRow *root;              /* the Open_vSwitch row */
+	guint n_inserted;
+} OvsdbTxn;
+
 static void
-_add_interface (NMOvsdb *self, json_t *params,
-                NMConnection *bridge, NMConnection *port, NMConnection *interface,
-                NMDevice *bridge_device, NMDevice *interface_device)
+_txn_row_free (gpointer data)
+{
+	OvsdbTxnRow *row = data;
+
+	g_free (row->uuid_name);
+	json_decref (row->uuid);
+	if (row->orig_children)
+		json_decref (row->orig_children);
+	if (row->children)
+		g_ptr_array_unref (row->children);
+	g_slice_free (OvsdbTxnRow, row);
+}
+
+static OvsdbTxnRow *
+_txn_row_new (OvsdbTxn *txn,
+              const char *name,
+              const char *connection_uuid,
+              const char *uuid,
+              gboolean has_children,
+              const OvsdbMethodCall *call)
+{
+	OvsdbTxnRow *row;
+
+	row = g_slice_new0 (OvsdbTxnRow);
+	row->name = name;
+	row->connection_uuid = connection_uuid;
+	row->call = call;
+	if (call) {
+		row->uuid_name = g_strdup_printf ("row%u", txn->n_inserted++);
+		row->uuid = json_pack ("[s, s]", "named-uuid", row->uuid_name);
+	} else {
+		row->uuid = json_pack ("[s, s]", "uuid", uuid);
+		row->orig_children = json_array ();
+	}
+	if (has_children)
+		row->children = g_ptr_array_new ();
+
+	g_ptr_array_add (txn->rows, row);
+	return row;
+}
+
+static void
+_txn_row_add_existing (OvsdbTxnRow *parent, OvsdbTxnRow *child)
+{
+	g_ptr_array_add (parent->children, child);
+	json_array_append (parent->orig_children, child->uuid);
+}
+
+static void
+_txn_row_add (OvsdbTxnRow *parent, OvsdbTxnRow *child)
+{
+	g_ptr_array_add (parent->children, child);
+	parent->changed = TRUE;
+}
+
+static OvsdbTxnRow *
+_txn_row_find (OvsdbTxnRow *parent, NMConnection *connection)
+{
+	guint i;
+
+	for (i = 0; i < parent->children->len; i++) {
+		OvsdbTxnRow *child = parent->children->pdata[i];
+
+		if (   child->name
+		    && nm_streq (child->name, nm_connection_get_interface_name (connection))
+		    && nm_streq0 (child->connection_uuid, nm_connection_get_uuid (connection)))
+			return child;
+	}
+	return NULL;
+}
+
+static json_t *
+_txn_row_get_children (OvsdbTxnRow *row)
+{
+	json_t *children;
+	guint i;
+
+	children = json_array ();
+	for (i = 0; i < row->children->len; i++)
+		json_array_append (children, ((OvsdbTxnRow *) row->children->pdata[i])->uuid);
+	return children;
+}
+
+static void
+_txn_init (NMOvsdb *self, OvsdbTxn *txn)
 {
 	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
 	GHashTableIter iter;
 	const char *bridge_uuid;
-	const char *port_uuid;
-	const char *interface_uuid;
-	OpenvswitchBridge *ovs_bridge = NULL;
-	OpenvswitchPort *ovs_port = NULL;
-	OpenvswitchInterface *ovs_interface = NULL;
-	nm_auto_decref_json json_t *bridges = NULL;
-	nm_auto_decref_json json_t *new_bridges = NULL;
-	nm_auto_decref_json json_t *ports = NULL;
-	nm_auto_decref_json json_t *new_ports = NULL;
-	nm_auto_decref_json json_t *interfaces = NULL;
-	nm_auto_decref_json json_t *new_interfaces = NULL;
-	gboolean has_interface = FALSE;
-	int pi;
-	int ii;
-
-	bridges = json_array ();
-	ports = json_array ();
-	interfaces = json_array ();
-	new_bridges = json_array ();
-	new_ports = json_array ();
-	new_interfaces = json_array ();
+	OpenvswitchBridge *ovs_bridge;
+	guint pi;
+	guint ii;
+
+	*txn = (OvsdbTxn) {
+		.rows = g_ptr_array_new_with_free_func (_txn_row_free),
+	};
+	txn->root = _txn_row_new (txn, NULL, NULL, priv->db_uuid, TRUE, NULL);
 
 	g_hash_table_iter_init (&iter, priv->bridges);
 	while (g_hash_table_iter_next (&iter, (gpointer) &bridge_uuid, (gpointer) &ovs_bridge)) {
-		json_array_append_new (bridges, json_pack ("[s, s]", "uuid", bridge_uuid));
+		OvsdbTxnRow *bridge;
 
-		if (   g_strcmp0 (ovs_bridge->name, nm_connection_get_interface_name (bridge)) != 0
-		    || g_strcmp0 (ovs_bridge->connection_uuid, nm_connection_get_uuid (bridge)) != 0)
-			continue;
+		bridge = _txn_row_new (txn, ovs_bridge->name, ovs_bridge->connection_uuid,
+		                       bridge_uuid, TRUE, NULL);
+		_txn_row_add_existing (txn->root, bridge);
 
 		for (pi = 0; pi < ovs_bridge->ports->len; pi++) {
-			port_uuid = g_ptr_array_index (ovs_bridge->ports, pi);
-			ovs_port = g_hash_table_lookup (priv->ports, port_uuid);
-
-			json_array_append_new (ports, json_pack ("[s, s]", "uuid", port_uuid));
+			const char *port_uuid = g_ptr_array_index (ovs_bridge->ports, pi);
+			OpenvswitchPort *ovs_port;
+			OvsdbTxnRow *port;
 
+			ovs_port = g_hash_table_lookup (priv->ports, port_uuid);
 			if (!ovs_port) {
 				/* This would be a violation of ovsdb's reference integrity (a bug). */
 				_LOGW ("Unknown port '%s' in bridge '%s'", port_uuid, bridge_uuid);
-				continue;
-			} else if (   strcmp (ovs_port->name, nm_connection_get_interface_name (port)) != 0
-			           || g_strcmp0 (ovs_port->connection_uuid, nm_connection_get_uuid (port)) != 0) {
+				_txn_row_add_existing (bridge,
+				                       _txn_row_new (txn, NULL, NULL, port_uuid, FALSE, NULL));
 				continue;
 			}
 
-			for (ii = 0; ii < ovs_port->interfaces->len; ii++) {
-				interface_uuid = g_ptr_array_index (ovs_port->interfaces, ii);
-				ovs_interface = g_hash_table_lookup (priv->interfaces, interface_uuid);
+			port = _txn_row_new (txn, ovs_port->name, ovs_port->connection_uuid,
+			                     port_uuid, TRUE, NULL);
+			_txn_row_add_existing (bridge, port);
 
-				json_array_append_new (interfaces, json_pack ("[s, s]", "uuid", interface_uuid));
+			for (ii = 0; ii < ovs_port->interfaces->len; ii++) {
+				const char *interface_uuid = g_ptr_array_index (ovs_port->interfaces, ii);
+				OpenvswitchInterface *ovs_interface;
 
+				ovs_interface = g_hash_table_lookup (priv->interfaces, interface_uuid);
 				if (!ovs_interface) {
 					/* This would be a violation of ovsdb's reference integrity (a bug). */
 					_LOGW ("Unknown interface '%s' in port '%s'", interface_uuid, port_uuid);
-				} else if (   strcmp (ovs_interface->name, nm_connection_get_interface_name (interface)) == 0
-				           && g_strcmp0 (ovs_interface->connection_uuid, nm_connection_get_uuid (interface)) == 0) {
-					has_interface = TRUE;
 				}
-			}
 
-			break;
+				_txn_row_add_existing (port,
+				                       _txn_row_new (txn,
+				                                     ovs_interface ? ovs_interface->name : NULL,
+				                                     ovs_interface ? ovs_interface->connection_uuid : NULL,
+				                                     interface_uuid, FALSE, NULL));
+			}
 		}
-
-		break;
 	}
+}
 
-	json_array_extend (new_bridges, bridges);
-	json_array_extend (new_ports, ports);
-	json_array_extend (new_interfaces, interfaces);
-
-	if (json_array_size (interfaces) == 0) {
-		/* Need to create a port. */
-		if (json_array_size (ports) == 0) {
-			/* Need to create a bridge. */
-			_expect_ovs_bridges (params, priv->db_uuid, bridges);
-			json_array_append_new (new_bridges, json_pack ("[s, s]", "named-uuid", "rowBridge"));
-			_set_ovs_bridges (params, priv->db_uuid, new_bridges);
-			_insert_bridge (params, bridge, bridge_device, new_ports);
-		} else {
-			/* Bridge already exists. */
-			g_return_if_fail (ovs_bridge);
-			_expect_bridge_ports (params, ovs_bridge->name, ports);
-			_set_bridge_ports (params, nm_connection_get_interface_name (bridge), new_ports);
-		}
+/**
+ * _txn_add_interface:
+ *
+ * Adds an interface as specified by the @call's interface connection,
+ * creating the parent port and bridge if needed.
+ */
+static void
+_txn_add_interface (OvsdbTxn *txn, const OvsdbMethodCall *call)
+{
+	OvsdbTxnRow *bridge;
+	OvsdbTxnRow *port;
+
+	bridge = _txn_row_find (txn->root, call->bridge);
+	if (!bridge) {
+		bridge = _txn_row_new (txn,
+		                       nm_connection_get_interface_name (call->bridge),
+		                       nm_connection_get_uuid (call->bridge),
+		                       NULL, TRUE, call);
+		_txn_row_add (txn->root, bridge);
+	}
 
-		json_array_append_new (new_ports, json_pack ("[s, s]", "named-uuid", "rowPort"));
-		_insert_port (params, port, new_interfaces);
-	} else {
-		/* Port already exists */
-		g_return_if_fail (ovs_port);
-		_expect_port_interfaces (params, ovs_port->name, interfaces);
-		_set_port_interfaces (params, nm_connection_get_interface_name (port), new_interfaces);
+	port = _txn_row_find (bridge, call->port);
+	if (!port) {
+		port = _txn_row_new (txn,
+		                     nm_connection_get_interface_name (call->port),
+		                     nm_connection_get_uuid (call->port),
+		                     NULL, TRUE, call);
+		_txn_row_add (bridge, port);
 	}
 
-	if (!has_interface) {
-		_insert_interface (params, interface, interface_device);
-		json_array_append_new (new_interfaces, json_pack ("[s, s]", "named-uuid", "rowInterface"));
+	if (!_txn_row_find (port, call->interface)) {
+		_txn_row_add (port,
+		              _txn_row_new (txn,
+		                            nm_connection_get_interface_name (call->interface),
+		                            nm_connection_get_uuid (call->interface),
+		                            NULL, FALSE, call));
 	}
 }
 
 /**
- * _delete_interface:
+ * _txn_del_interface:
  *
  * Removes an interface of @ifname name, collecting empty ports and bridge
  * if last item is removed from them.
  */
 static void
-_delete_interface (NMOvsdb *self, json_t *params, const char *ifname)
+_txn_del_interface (OvsdbTxn *txn, const char *ifname)
 {
-	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
-	GHashTableIter iter;
-	char *bridge_uuid;
-	char *port_uuid;
-	char *interface_uuid;
-	OpenvswitchBridge *ovs_bridge;
-	OpenvswitchPort *ovs_port;
-	OpenvswitchInterface *ovs_interface;
-	nm_auto_decref_json json_t *bridges = NULL;
-	nm_auto_decref_json json_t *new_bridges = NULL;
-	gboolean bridges_changed;
-	gboolean ports_changed;
-	gboolean interfaces_changed;
-	int pi;
-	int ii;
-
-	bridges = json_array ();
-	new_bridges = json_array ();
-	bridges_changed = FALSE;
+	GPtrArray *bridges = txn->root->children;
+	guint bi;
+	guint pi;
+	guint ii;
 
-	g_hash_table_iter_init (&iter, priv->bridges);
-	while (g_hash_table_iter_next (&iter, (gpointer) &bridge_uuid, (gpointer) &ovs_bridge)) {
-		nm_auto_decref_json json_t *ports = NULL;
-		nm_auto_decref_json json_t *new_ports = NULL;
+	for (bi = 0; bi < bridges->len; ) {
+		OvsdbTxnRow *bridge = bridges->pdata[bi];
 
-		ports = json_array ();
-		new_ports = json_array ();
-		ports_changed = FALSE;
+		for (pi = 0; pi < bridge->children->len; ) {
+			OvsdbTxnRow *port = bridge->children->pdata[pi];
 
-		json_array_append_new (bridges, json_pack ("[s,s]", "uuid", bridge_uuid));
+			if (!port->children) {
+				/* unknown port, leave it alone. */
+				pi++;
+				continue;
+			}
 
-		for (pi = 0; pi < ovs_bridge->ports->len; pi++) {
-			nm_auto_decref_json json_t *interfaces = NULL;
-			nm_auto_decref_json json_t *new_interfaces = NULL;
+			for (ii = 0; ii < port->children->len; ) {
+				OvsdbTxnRow *interface = port->children->pdata[ii];
 
-			interfaces = json_array ();
-			new_interfaces = json_array ();
-			port_uuid = g_ptr_array_index (ovs_bridge->ports, pi);
-			ovs_port = g_hash_table_lookup (priv->ports, port_uuid);
+				if (nm_streq0 (interface->name, ifname)) {
+					g_ptr_array_remove_index (port->children, ii);
+					port->changed = TRUE;
+				} else
+					ii++;
+			}
 
-			json_array_append_new (ports, json_pack ("[s,s]", "uuid", port_uuid));
+			if (port->children->len == 0) {
+				g_ptr_array_remove_index (bridge->children, pi);
+				bridge->changed = TRUE;
+			} else
+				pi++;
+		}
 
-			interfaces_changed = FALSE;
+		if (bridge->children->len == 0) {
+			g_ptr_array_remove_index (bridges, bi);
+			txn->root->changed = TRUE;
+		} else
+			bi++;
+	}
+}
 
-			if (!ovs_port) {
-				/* This would be a violation of ovsdb's reference integrity (a bug). */
-				_LOGW ("Unknown port '%s' in bridge '%s'", port_uuid, bridge_uuid);
-				continue;
-			}
+/**
+ * _txn_serialize:
+ *
+ * Appends the operations that turn the database into the state of the
+ * scratch tree to @params. The expected original sets of bridges, ports
+ * and interfaces are checked, to detect races with other ovsdb clients.
+ */
+static void
+_txn_serialize (NMOvsdb *self, OvsdbTxn *txn, json_t *params)
+{
+	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
+	GPtrArray *bridges = txn->root->children;
+	guint bi;
+	guint pi;
+	guint ii;
 
-			for (ii = 0; ii < ovs_port->interfaces->len; ii++) {
-				interface_uuid = g_ptr_array_index (ovs_port->interfaces, ii);
-				ovs_interface = g_hash_table_lookup (priv->interfaces, interface_uuid);
+	if (txn->root->changed) {
+		nm_auto_decref_json json_t *new_bridges = _txn_row_get_children (txn->root);
 
-				json_array_append_new (interfaces, json_pack ("[s,s]", "uuid", interface_uuid));
+		_expect_ovs_bridges (params, priv->db_uuid, txn->root->orig_children);
+		_set_ovs_bridges (params, priv->db_uuid, new_bridges);
+	}
 
-				if (ovs_interface) {
-					if (strcmp (ovs_interface->name, ifname) == 0) {
-						/* skip the interface */
-						interfaces_changed = TRUE;
-						continue;
-					}
-				} else {
-					/* This would be a violation of ovsdb's reference integrity (a bug). */
-					_LOGW ("Unknown interface '%s' in port '%s'", interface_uuid, port_uuid);
-				}
+	for (bi = 0; bi < bridges->len; bi++) {
+		OvsdbTxnRow *bridge = bridges->pdata[bi];
 
-				json_array_append_new (new_interfaces, json_pack ("[s,s]", "uuid", interface_uuid));
-			}
+		if (bridge->call || bridge->changed) {
+			nm_auto_decref_json json_t *new_ports = _txn_row_get_children (bridge);
 
-			if (json_array_size (new_interfaces) == 0) {
-				ports_changed = TRUE;
+			if (bridge->call) {
+				_insert_bridge (params, bridge->call->bridge, bridge->call->bridge_device,
+				                new_ports, bridge->uuid_name);
 			} else {
-				if (interfaces_changed) {
-					_expect_port_interfaces (params, ovs_port->name, interfaces);
-					_set_port_interfaces (params, ovs_port->name, new_interfaces);
-				}
-				json_array_append_new (new_ports, json_pack ("[s,s]", "uuid", port_uuid));
+				_expect_bridge_ports (params, bridge->name, bridge->orig_children);
+				_set_bridge_ports (params, bridge->name, new_ports);
 			}
 		}
 
-		if (json_array_size (new_ports) == 0) {
-			bridges_changed = TRUE;
-		} else {
-			if (ports_changed) {
-				_expect_bridge_ports (params, ovs_bridge->name, ports);
-				_set_bridge_ports (params, ovs_bridge->name, new_ports);
+		for (pi = 0; pi < bridge->children->len; pi++) {
+			OvsdbTxnRow *port = bridge->children->pdata[pi];
+
+			if (!port->children)
+				continue;
+
+			if (port->call || port->changed) {
+				nm_auto_decref_json json_t *new_interfaces = _txn_row_get_children (port);
+
+				if (port->call) {
+					_insert_port (params, port->call->port, new_interfaces, port->uuid_name);
+				} else {
+					_expect_port_interfaces (params, port->name, port->orig_children);
+					_set_port_interfaces (params, port->name, new_interfaces);
+				}
 			}
-			json_array_append_new (new_bridges, json_pack ("[s,s]", "uuid", bridge_uuid));
-		}
-	}
 
-	if (bridges_changed) {
-		_expect_ovs_bridges (params, priv->db_uuid, bridges);
-		_set_ovs_bridges (params, priv->db_uuid, new_bridges);
+			for (ii = 0; ii < port->children->len; ii++) {
+				OvsdbTxnRow *interface = port->children->pdata[ii];
+
+				if (interface->call) {
+					_insert_interface (params, interface->call->interface,
+					                   interface->call->interface_device,
+					                   interface->uuid_name);
+				}
+			}
+		}
 	}
 }
 
-/**
- * ovsdb_next_command:
- *
- * Translates a higher level operation (add/remove bridge/port) to a RFC 7047
- * command serialized into JSON ands sends it over to the database.
+/*****************************************************************************/
 
- * Only called when no command is waiting for a response, since the serialized
- * command might depend on result of a previous one (add and remove need to
- * include an up to date bridge list in their transactions to rule out races).
- */
-static void
-ovsdb_next_command (NMOvsdb *self)
+static json_t *
+_serialize_call (NMOvsdb *self, OvsdbMethodCall *call)
 {
 	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
-	OvsdbMethodCall *call = NULL;
-	char *cmd;
-	nm_auto_decref_json json_t *msg = NULL;
 	json_t *params;
 
-	if (!priv->conn)
-		return;
-	if (!priv->calls->len)
-		return;
-	call = &g_array_index (priv->calls, OvsdbMethodCall, 0);
-	if (call->id != COMMAND_PENDING)
-		return;
-	call->id = priv->seq++;
-
 	switch (call->command) {
 	case OVSDB_MONITOR:
-		msg = json_pack ("{s:i, s:s, s:[s, n, {"
-		                 "  s:[{s:[s, s, s]}],"
-		                 "  s:[{s:[s, s, s]}],"
-		                 "  s:[{s:[s, s, s, s]}],"
-		                 "  s:[{s:[]}]"
-		                 "}]}",
-		                 "id", call->id,
-		                 "method", "monitor", "params", "Open_vSwitch",
-		                 "Bridge", "columns", "name", "ports", "external_ids",
-		                 "Port", "columns", "name", "interfaces", "external_ids",
-		                 "Interface", "columns", "name", "type", "external_ids", "error",
-		                 "Open_vSwitch", "columns");
-		break;
-	case OVSDB_ADD_INTERFACE:
-		params = json_array ();
-		json_array_append_new (params, json_string ("Open_vSwitch"));
-		json_array_append_new (params, _inc_next_cfg (priv->db_uuid));
-
-		_add_interface (self, params, call->bridge, call->port, call->interface,
-		                call->bridge_device, call->interface_device);
-
-		msg = json_pack ("{s:i, s:s, s:o}",
-		                 "id", call->id,
-		                 "method", "transact", "params", params);
-		break;
-	case OVSDB_DEL_INTERFACE:
-		params = json_array ();
-		json_array_append_new (params, json_string ("Open_vSwitch"));
-		json_array_append_new (params, _inc_next_cfg (priv->db_uuid));
-
-		_delete_interface (self, params, call->ifname);
-
-		msg = json_pack ("{s:i, s:s, s:o}",
-		                 "id", call->id,
-		                 "method", "transact", "params", params);
-		break;
+		return json_pack ("{s:i, s:s, s:[s, n, {"
+		                  "  s:[{s:[s, s, s]}],"
+		                  "  s:[{s:[s, s, s]}],"
+		                  "  s:[{s:[s, s, s, s]}],"
+		                  "  s:[{s:[]}]"
+		                  "}]}",
+		                  "id", call->id,
+		                  "method", "monitor", "params", "Open_vSwitch",
+		                  "Bridge", "columns", "name", "ports", "external_ids",
+		                  "Port", "columns", "name", "interfaces", "external_ids",
+		                  "Interface", "columns", "name", "type", "external_ids", "error",
+		                  "Open_vSwitch", "columns");
 	case OVSDB_SET_INTERFACE_MTU:
 		params = json_array ();
 		json_array_append_new (params, json_string ("Open_vSwitch"));
@@ -869,18 +961,161 @@ ovsdb_next_command (NMOvsdb *self)
 		                                  "row", "mtu_request", call->mtu,
 		                                  "where", "name", "==", call->ifname));
 
-		msg = json_pack ("{s:i, s:s, s:o}",
-		                 "id", call->id,
-		                 "method", "transact", "params", params);
+		return json_pack ("{s:i, s:s, s:o}",
+		                  "id", call->id,
+		                  "method", "transact", "params", params);
+	case OVSDB_ADD_INTERFACE:
+	case OVSDB_DEL_INTERFACE:
 		break;
 	}
 
-	g_return_if_fail (msg);
-	_LOGT_call ("send", call, msg);
-	cmd = json_dumps (msg, 0);
+	g_return_val_if_reached (NULL);
+}
+
+/**
+ * _serialize_batch:
+ *
+ * Merges the @n_calls add and delete calls starting at @idx into a single
+ * transaction. They all get the same id.
+ */
+static json_t *
+_serialize_batch (NMOvsdb *self, guint idx, guint n_calls)
+{
+	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
+	OvsdbTxn txn;
+	json_t *params;
+	gint64 id;
+	guint i;
+
+	id = priv->seq++;
+
+	params = json_array ();
+	json_array_append_new (params, json_string ("Open_vSwitch"));
+	json_array_append_new (params, _inc_next_cfg (priv->db_uuid));
+
+	_txn_init (self, &txn);
+
+	for (i = idx; i < idx + n_calls; i++) {
+		OvsdbMethodCall *call = &g_array_index (priv->calls, OvsdbMethodCall, i);
+
+		call->id = id;
+		if (call->command == OVSDB_ADD_INTERFACE)
+			_txn_add_interface (&txn, call);
+		else
+			_txn_del_interface (&txn, call->ifname);
+	}
+
+	_txn_serialize (self, &txn, params);
 
-	g_string_append (priv->output, cmd);
-	free (cmd);
+	g_ptr_array_unref (txn.rows);
+
+	return json_pack ("{s:i, s:s, s:o}",
+	                  "id", id,
+	                  "method", "transact", "params", params);
+}
+
+/**
+ * ovsdb_next_command:
+ *
+ * Translates the queued higher level operations (add/remove bridge/port) to
+ * RFC 7047 commands serialized into JSON and sends them over to the database.
+ *
+ * Several requests can be in flight at the same time, but the add and remove
+ * operations must include an up to date bridge list in their transactions to
+ * rule out races. Thus they are only serialized once no earlier operation
+ * that changes the bridges is waiting for a response. Subsequent add and
+ * remove calls that are queued by then are merged into one transaction.
+ */
+static void
+ovsdb_next_command (NMOvsdb *self)
+{
+	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
+	gboolean monitor_pending = FALSE;
+	gboolean bridges_pending = FALSE;
+	guint i;
+
+	nm_clear_g_source (&priv->next_command_id);
+
+	if (!priv->conn)
+		return;
+
+	for (i = 0; i < priv->calls->len; ) {
+		OvsdbMethodCall *call = &g_array_index (priv->calls, OvsdbMethodCall, i);
+		nm_auto_decref_json json_t *msg = NULL;
+		guint n_calls = 1;
+		char *cmd;
+
+		if (call->id != COMMAND_PENDING) {
+			/* waiting for the response. */
+			if (call->command == OVSDB_MONITOR)
+				monitor_pending = TRUE;
+			if (call->command != OVSDB_SET_INTERFACE_MTU)
+				bridges_pending = TRUE;
+			i++;
+			continue;
+		}
+
+		/* Everything but the monitor call itself needs the database
+		 * UUID that we learn from the monitor response. */
+		if (monitor_pending)
+			break;
+
+		switch (call->command) {
+		case OVSDB_MONITOR:
+			call->id = priv->seq++;
+			msg = _serialize_call (self, call);
+			monitor_pending = TRUE;
+			bridges_pending = TRUE;
+			break;
+		case OVSDB_SET_INTERFACE_MTU:
+			call->id = priv->seq++;
+			msg = _serialize_call (self, call);
+			break;
+		case OVSDB_ADD_INTERFACE:
+		case OVSDB_DEL_INTERFACE:
+			if (bridges_pending)
+				break;
+			if (!call->no_batch) {
+				while (   i + n_calls < priv->calls->len
+				       && n_calls < OVSDB_MAX_BATCH) {
+					const OvsdbMethodCall *next = &g_array_index (priv->calls, OvsdbMethodCall, i + n_calls);
+
+					if (   !NM_IN_SET (next->command, OVSDB_ADD_INTERFACE, OVSDB_DEL_INTERFACE)
+					    || next->id != COMMAND_PENDING
+					    || next->no_batch)
+						break;
+					n_calls++;
+				}
+			}
+			msg = _serialize_batch (self, i, n_calls);
+			bridges_pending = TRUE;
+			break;
+		}
+
+		if (!msg) {
+			/* the operations on the bridges have to wait. Keep the
+			 * order of the remaining calls. */
+			break;
+		}
+
+		if (_LOGT_ENABLED ()) {
+			guint j;
+
+			for (j = i; j < i + n_calls; j++)
+				_LOGT_call ("send", &g_array_index (priv->calls, OvsdbMethodCall, j), n_calls == 1 ? msg : NULL);
+			if (n_calls > 1) {
+				gs_free char *str = json_dumps (msg, 0);
+
+				_LOGT ("send: %u calls in one transaction: %s", n_calls, str);
+			}
+		}
+
+		cmd = json_dumps (msg, 0);
+		g_string_append (priv->output, cmd);
+		free (cmd);
+
+		i += n_calls;
+	}
 
 	ovsdb_write (self);
 }
@@ -1177,6 +1412,30 @@ ovsdb_got_echo (NMOvsdb *self, json_int_t id, json_t *data)
 		ovsdb_write (self);
 }
 
+/**
+ * _transact_result_check:
+ *
+ * Checks the results of the operations of a transaction for an error.
+ */
+static gboolean
+_transact_result_check (json_t *result, GError **error)
+{
+	const char *err;
+	const char *err_details;
+	size_t index;
+	json_t *value;
+
+	json_array_foreach (result, index, value) {
+		if (json_unpack (value, "{s:s, s:s}", "error", &err, "details", &err_details) == 0) {
+			g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+			             "Error running the transaction: %s: %s", err, err_details);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
 /**
  * ovsdb_got_msg::
  *
@@ -1195,8 +1454,6 @@ ovsdb_got_msg (NMOvsdb *self, json_t *msg)
 	json_t *result = NULL;
 	json_t *error = NULL;
 	OvsdbMethodCall *call = NULL;
-	OvsdbMethodCallback callback;
-	gpointer user_data;
 	gs_free_error GError *local = NULL;
 
 	if (json_unpack_ex (msg, &json_error, 0, "{s?:o, s?:s, s?:o, s?:o, s?:o}",
@@ -1234,21 +1491,51 @@ ovsdb_got_msg (NMOvsdb *self, json_t *msg)
 	}
 
 	if (id > -1) {
+		gs_free struct {
+			OvsdbMethodCallback callback;
+			gpointer user_data;
+		} *replies = NULL;
+		guint idx;
+		guint n_calls;
+		guint i;
+
 		/* This is a response to a method call. */
-		if (!priv->calls->len) {
+		for (idx = 0; idx < priv->calls->len; idx++) {
+			call = &g_array_index (priv->calls, OvsdbMethodCall, idx);
+			if (call->id == id)
+				break;
+		}
+		if (idx == priv->calls->len) {
 			_LOGE ("there are no queued calls expecting response %" G_GUINT64_FORMAT, id);
 			ovsdb_disconnect (self, FALSE, FALSE);
 			return;
 		}
-		call = &g_array_index (priv->calls, OvsdbMethodCall, 0);
-		if (call->id != id) {
-			_LOGE ("expected a response to call %" G_GUINT64_FORMAT ", not %" G_GUINT64_FORMAT, call->id, id);
-			ovsdb_disconnect (self, FALSE, FALSE);
-			return;
+
+		/* The calls that were merged into one transaction share the id. */
+		for (n_calls = 1; idx + n_calls < priv->calls->len; n_calls++) {
+			if (g_array_index (priv->calls, OvsdbMethodCall, idx + n_calls).id != id)
+				break;
 		}
-		/* Cool, we found a corresponding call. Finish it. */
 
-		_LOGT_call ("response", call, msg);
+		/* Cool, we found the corresponding calls. Finish them. */
+
+		for (i = idx; i < idx + n_calls; i++)
+			_LOGT_call ("response", &g_array_index (priv->calls, OvsdbMethodCall, i), msg);
+
+		if (   n_calls > 1
+		    && json_is_null (error)
+		    && !_transact_result_check (result, NULL)) {
+			/* A transaction is all or nothing. Don't fail all the calls
+			 * because of one of them, retry them one by one. */
+			_LOGD ("a transaction of %u calls failed, retrying them separately", n_calls);
+			for (i = idx; i < idx + n_calls; i++) {
+				call = &g_array_index (priv->calls, OvsdbMethodCall, i);
+				call->id = COMMAND_PENDING;
+				call->no_batch = TRUE;
+			}
+			ovsdb_next_command (self);
+			return;
+		}
 
 		if (!json_is_null (error)) {
 			/* The response contains an error. */
@@ -1257,10 +1544,18 @@ ovsdb_got_msg (NMOvsdb *self, json_t *msg)
 			              json_string_value (error));
 		}
 
-		callback = call->callback;
-		user_data = call->user_data;
-		g_array_remove_index (priv->calls, 0);
-		callback (self, result, local, user_data);
+		/* The callbacks might queue further calls, so take them out of the
+		 * array before invoking them. */
+		replies = g_malloc (sizeof (*replies) * n_calls);
+		for (i = 0; i < n_calls; i++) {
+			call = &g_array_index (priv->calls, OvsdbMethodCall, idx + i);
+			replies[i].callback = call->callback;
+			replies[i].user_data = call->user_data;
+		}
+		g_array_remove_range (priv->calls, idx, n_calls);
+
+		for (i = 0; i < n_calls; i++)
+			replies[i].callback (self, result, local, replies[i].user_data);
 		priv->num_failures = 0;
 
 		/* Don't progress further commands in case the callback hit an error
@@ -1283,24 +1578,6 @@ ovsdb_got_msg (NMOvsdb *self, json_t *msg)
 /* Lower level marshalling and demarshalling of the JSON-RPC traffic on the
  * ovsdb socket. */
 
-static size_t
-_json_callback (void *buffer, size_t buflen, void *user_data)
-{
-	NMOvsdb *self = NM_OVSDB (user_data);
-	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
-
-	if (priv->bufp == priv->input->len) {
-		/* No more bytes buffered for decoding. */
-		return 0;
-	}
-
-	/* Pass one more byte to the JSON decoder. */
-	*(char *)buffer = priv->input->str[priv->bufp];
-	priv->bufp++;
-
-	return (size_t)1;
-}
-
 /**
  * ovsdb_read_cb:
  *
@@ -1310,15 +1587,26 @@ _json_callback (void *buffer, size_t buflen, void *user_data)
 static void
 ovsdb_read_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
-	NMOvsdb *self = NM_OVSDB (user_data);
-	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
+	NMOvsdb *self;
+	NMOvsdbPrivate *priv;
 	GInputStream *stream = G_INPUT_STREAM (source_object);
 	GError *error = NULL;
 	gssize size;
-	json_t *msg;
+	gssize msg_len;
+	gsize msg_start;
+	gsize n;
 	json_error_t json_error = { 0, };
 
 	size = g_input_stream_read_finish (stream, res, &error);
+	if (nm_utils_error_is_cancelled (error)) {
+		/* we got disconnected, possibly disposed. */
+		g_clear_error (&error);
+		return;
+	}
+
+	self = NM_OVSDB (user_data);
+	priv = NM_OVSDB_GET_PRIVATE (self);
+
 	if (size == -1) {
 		/* ovsdb-server was possibly restarted */
 		_LOGW ("short read from ovsdb: %s", error->message);
@@ -1329,21 +1617,39 @@ ovsdb_read_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
 	}
 
 	g_string_append_len (priv->input, priv->buf, size);
-	do {
-		priv->bufp = 0;
-		/* The callback always eats up only up to a single byte. This makes
-		 * it possible for us to identify complete JSON objects in spite of
-		 * us not knowing the length in advance. */
-		msg = json_load_callback (_json_callback, self, JSON_DISABLE_EOF_CHECK, &json_error);
-		if (msg) {
-			ovsdb_got_msg (self, msg);
-			g_string_erase (priv->input, 0, priv->bufp);
+
+	/* Every byte is scanned once and every message is parsed once,
+	 * regardless of how many reads it took to receive it. */
+	while ((msg_len = nm_json_aux_framer_next (&priv->framer,
+	                                           priv->input->str,
+	                                           priv->input->len,
+	                                           &msg_start)) != 0) {
+		nm_auto_decref_json json_t *msg = NULL;
+
+		if (msg_len > 0) {
+			msg = json_loadb (&priv->input->str[msg_start], msg_len,
+			                  0, &json_error);
+		}
+		if (!msg) {
+			_LOGW ("couldn't parse the message: %s",
+			       msg_len > 0 ? json_error.text : "not a JSON object");
+			ovsdb_disconnect (self, FALSE, FALSE);
+			return;
 		}
-		json_decref (msg);
-	} while (msg);
 
-	if (!priv->conn)
-		return;
+		ovsdb_got_msg (self, msg);
+
+		/* The message might have gotten us disconnected. */
+		if (!priv->conn)
+			return;
+	}
+
+	/* Drop the messages we are done with. This only moves the beginning of
+	 * a message that started in this read, so it doesn't get expensive for
+	 * large messages. */
+	n = nm_json_aux_framer_rebase (&priv->framer);
+	if (n > 0)
+		g_string_erase (priv->input, 0, n);
 
 	if (size)
 		ovsdb_read (self);
@@ -1356,19 +1662,28 @@ ovsdb_read (NMOvsdb *self)
 
 	g_input_stream_read_async (g_io_stream_get_input_stream (G_IO_STREAM (priv->conn)),
 	                           priv->buf, sizeof(priv->buf),
-	                           G_PRIORITY_DEFAULT, NULL, ovsdb_read_cb, self);
+	                           G_PRIORITY_DEFAULT, priv->cancellable, ovsdb_read_cb, self);
 }
 
 static void
 ovsdb_write_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
 	GOutputStream *stream = G_OUTPUT_STREAM (source_object);
-	NMOvsdb *self = NM_OVSDB (user_data);
-	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE (self);
+	NMOvsdb *self;
+	NMOvsdbPrivate *priv;
 	GError *error = NULL;
 	gssize size;
 
 	size = g_output_stream_write_finish (stream, res, &error);
+	if (nm_utils_error_is_cancelled (error)) {
+		/* we got disconnected, possibly disposed. */
+		g_clear_error (&error);
+		return;
+	}
+
+	self = NM_OVSDB (user_data);
+	priv = NM_OVSDB_GET_PRIVATE (self);
+
 	if (size == -1) {
 		/* ovsdb-server was possibly restarted */
 		_LOGW ("short write to ovsdb: %s", error->message);
@@ -1401,7 +1716,7 @@ ovsdb_write (NMOvsdb *self)
 
 	g_output_stream_write_async (stream,
 	                             priv->output->str, priv->output->len,
-	                             G_PRIORITY_DEFAULT, NULL, ovsdb_write_cb, self);
+	                             G_PRIORITY_DEFAULT, priv->cancellable, ovsdb_write_cb, self);
 }
 
 /*****************************************************************************/
@@ -1433,8 +1748,10 @@ ovsdb_disconnect (NMOvsdb *self, gboolean retry, gboolean is_disposing)
 	_LOGD ("disconnecting from ovsdb, retry %d", retry);
 
 	if (retry) {
-		if (priv->calls->len != 0)
-			g_array_index (priv->calls, OvsdbMethodCall, 0).id = COMMAND_PENDING;
+		guint i;
+
+		for (i = 0; i < priv->calls->len; i++)
+			g_array_index (priv->calls, OvsdbMethodCall, i).id = COMMAND_PENDING;
 	} else {
 		nm_utils_error_set_cancelled (&error, is_disposing, "NMOvsdb");
 
@@ -1447,7 +1764,7 @@ ovsdb_disconnect (NMOvsdb *self, gboolean retry, gboolean is_disposing)
 		}
 	}
 
-	priv->bufp = 0;
+	memset (&priv->framer, 0, sizeof (priv->framer));
 	g_string_truncate (priv->input, 0);
 	g_string_truncate (priv->output, 0);
 	g_clear_object (&priv->client);
@@ -1479,16 +1796,21 @@ static void
 _client_connect_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
 	GSocketClient *client = G_SOCKET_CLIENT (source_object);
-	NMOvsdb *self = NM_OVSDB (user_data);
+	NMOvsdb *self;
 	NMOvsdbPrivate *priv;
 	GError *error = NULL;
 	GSocketConnection *conn;
 
 	conn = g_socket_client_connect_finish (client, res, &error);
-	if (conn == NULL) {
-		if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-			_LOGI ("%s", error->message);
+	if (nm_utils_error_is_cancelled (error)) {
+		g_clear_error (&error);
+		return;
+	}
 
+	self = NM_OVSDB (user_data);
+
+	if (conn == NULL) {
+		_LOGI ("%s", error->message);
 		ovsdb_disconnect (self, FALSE, FALSE);
 		g_clear_error (&error);
 		return;
@@ -1496,7 +1818,6 @@ _client_connect_cb (GObject *source_object, GAsyncResult *res, gpointer user_dat
 
 	priv = NM_OVSDB_GET_PRIVATE (self);
 	priv->conn = conn;
-	g_clear_object (&priv->cancellable);
 
 	ovsdb_read (self);
 	ovsdb_next_command (self);
@@ -1518,8 +1839,7 @@ ovsdb_try_connect (NMOvsdb *self)
 	if (priv->client)
 		return;
 
-	/* XXX: This should probably be made configurable via NetworkManager.conf */
-	addr = g_unix_socket_address_new (RUNSTATEDIR "/openvswitch/db.sock");
+	addr = g_unix_socket_address_new (priv->socket_path);
 
 	priv->client = g_socket_client_new ();
 	priv->cancellable = g_cancellable_new ();
@@ -1548,23 +1868,13 @@ static void
 _transact_cb (NMOvsdb *self, json_t *result, GError *error, gpointer user_data)
 {
 	OvsdbCall *call = user_data;
-	const char *err;
-	const char *err_details;
-	size_t index;
-	json_t *value;
-
-	if (error)
-		goto out;
+	gs_free_error GError *local = NULL;
 
-	json_array_foreach (result, index, value) {
-		if (json_unpack (value, "{s:s, s:s}", "error", &err, "details", &err_details) == 0) {
-			g_set_error (&error, G_IO_ERROR, G_IO_ERROR_FAILED,
-			             "Error running the transaction: %s: %s", err, err_details);
-			goto out;
-		}
+	if (!error) {
+		if (!_transact_result_check (result, &local))
+			error = local;
 	}
 
-out:
 	call->callback (error, call->user_data);
 	g_slice_free (OvsdbCall, call);
 }
@@ -1674,6 +1984,25 @@ _free_interface (gpointer data)
 	g_slice_free (OpenvswitchInterface, ovs_interface);
 }
 
+static void
+set_property (GObject *object, guint prop_id,
+              const GValue *value, GParamSpec *pspec)
+{
+	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE ((NMOvsdb *) object);
+
+	switch (prop_id) {
+	case PROP_SOCKET_PATH:
+		/* construct-only */
+		priv->socket_path = g_value_dup_string (value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+		break;
+	}
+}
+
+/*****************************************************************************/
+
 static void
 nm_ovsdb_init (NMOvsdb *self)
 {
@@ -1686,8 +2015,14 @@ nm_ovsdb_init (NMOvsdb *self)
 	priv->bridges = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, _free_bridge);
 	priv->ports = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, _free_port);
 	priv->interfaces = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, _free_interface);
+}
 
-	ovsdb_try_connect (self);
+static void
+constructed (GObject *object)
+{
+	G_OBJECT_CLASS (nm_ovsdb_parent_class)->constructed (object);
+
+	ovsdb_try_connect (NM_OVSDB (object));
 }
 
 static void
@@ -1698,6 +2033,8 @@ dispose (GObject *object)
 
 	ovsdb_disconnect (self, FALSE, TRUE);
 
+	nm_clear_g_source (&priv->next_command_id);
+
 	if (priv->input) {
 		g_string_free (priv->input, TRUE);
 		priv->input = NULL;
@@ -1718,12 +2055,35 @@ dispose (GObject *object)
 	G_OBJECT_CLASS (nm_ovsdb_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+	NMOvsdbPrivate *priv = NM_OVSDB_GET_PRIVATE ((NMOvsdb *) object);
+
+	g_free (priv->socket_path);
+
+	G_OBJECT_CLASS (nm_ovsdb_parent_class)->finalize (object);
+}
+
 static void
 nm_ovsdb_class_init (NMOvsdbClass *klass)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+	object_class->set_property = set_property;
+	object_class->constructed = constructed;
 	object_class->dispose = dispose;
+	object_class->finalize = finalize;
+
+	/* XXX: This should probably be made configurable via NetworkManager.conf */
+	obj_properties[PROP_SOCKET_PATH] =
+	    g_param_spec_string (NM_OVSDB_SOCKET_PATH, "", "",
+	                         RUNSTATEDIR "/openvswitch/db.sock",
+	                         G_PARAM_WRITABLE |
+	                         G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
 
 	signals[DEVICE_ADDED] =
 		g_signal_new (NM_OVSDB_DEVICE_ADDED,
@@ -17,6 +17,8 @@
 #define NM_OVSDB_DEVICE_REMOVED    "device-removed"
 #define NM_OVSDB_INTERFACE_FAILED  "interface-failed"
 
+#define NM_OVSDB_SOCKET_PATH       "socket-path"
+
 typedef struct _NMOvsdb NMOvsdb;
 typedef struct _NMOvsdbClass NMOvsdbClass;
 
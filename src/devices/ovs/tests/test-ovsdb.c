@@ -0,0 +1,633 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <glib-unix.h>
+
+#include "devices/ovs/nm-ovsdb.h"
+#include "nm-glib-aux/nm-jansson.h"
+#include "nm-glib-aux/nm-json-aux.h"
+#include "nm-core-internal.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+#define DB_UUID             "00000000-0000-0000-0000-000000000001"
+#define BR0_UUID            "00000000-0000-0000-0000-000000000002"
+#define PORT0_UUID          "00000000-0000-0000-0000-000000000003"
+#define ETH0_UUID           "00000000-0000-0000-0000-000000000004"
+#define ETH1_UUID           "00000000-0000-0000-0000-000000000005"
+
+#define BR0_CONNECTION_UUID "4b4e6a5c-4c8d-4a7b-a7b2-5f4ad3e9a0c1"
+
+/* The database that the mock server starts with: bridge "br0" with
+ * port "port0" that has interfaces "eth0" and "eth1". */
+#define INITIAL_STATE \
+	"{" \
+	"  \"Open_vSwitch\": { \"" DB_UUID "\": { \"new\": { } } }," \
+	"  \"Bridge\": { \"" BR0_UUID "\": { \"new\": {" \
+	"    \"name\": \"br0\"," \
+	"    \"ports\": [ \"uuid\", \"" PORT0_UUID "\" ]," \
+	"    \"external_ids\": [ \"map\", [ [ \"NM.connection.uuid\", \"" BR0_CONNECTION_UUID "\" ] ] ] } } }," \
+	"  \"Port\": { \"" PORT0_UUID "\": { \"new\": {" \
+	"    \"name\": \"port0\"," \
+	"    \"interfaces\": [ \"set\", [ [ \"uuid\", \"" ETH0_UUID "\" ], [ \"uuid\", \"" ETH1_UUID "\" ] ] ]," \
+	"    \"external_ids\": [ \"map\", [ ] ] } } }," \
+	"  \"Interface\": {" \
+	"    \"" ETH0_UUID "\": { \"new\": { \"name\": \"eth0\", \"type\": \"\", \"external_ids\": [ \"map\", [ ] ] } }," \
+	"    \"" ETH1_UUID "\": { \"new\": { \"name\": \"eth1\", \"type\": \"\", \"external_ids\": [ \"map\", [ ] ] } } }" \
+	"}"
+
+/*****************************************************************************/
+
+/* A tiny ovsdb-server. It listens on a unix socket in a temporary directory,
+ * collects the JSON-RPC requests it receives and lets the test reply to them
+ * in whatever order it likes. */
+
+typedef struct {
+	char *tmpdir;
+	char *path;
+	int listen_fd;
+	int fd;
+	guint listen_id;
+	guint read_id;
+	GString *input;
+	NMJsonAuxFramer framer;
+	GPtrArray *requests;            /* json_t, in the order they were received */
+	NMOvsdb *ovsdb;
+} MockServer;
+
+static void
+_json_decref (gpointer data)
+{
+	json_decref (data);
+}
+
+static gboolean
+_server_read_cb (int fd, GIOCondition condition, gpointer user_data)
+{
+	MockServer *server = user_data;
+	char buf[4096];
+	gssize size;
+	gssize msg_len;
+	gsize msg_start;
+
+	size = read (fd, buf, sizeof (buf));
+	g_assert_cmpint (size, >=, 0);
+	if (size == 0) {
+		server->read_id = 0;
+		return G_SOURCE_REMOVE;
+	}
+
+	g_string_append_len (server->input, buf, size);
+
+	while ((msg_len = nm_json_aux_framer_next (&server->framer,
+	                                           server->input->str,
+	                                           server->input->len,
+	                                           &msg_start)) != 0) {
+		json_t *msg;
+
+		g_assert_cmpint (msg_len, >, 0);
+		msg = json_loadb (&server->input->str[msg_start], msg_len, 0, NULL);
+		g_assert (msg);
+		g_ptr_array_add (server->requests, msg);
+	}
+
+	g_string_erase (server->input, 0, nm_json_aux_framer_rebase (&server->framer));
+
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+_server_accept_cb (int fd, GIOCondition condition, gpointer user_data)
+{
+	MockServer *server = user_data;
+
+	g_assert_cmpint (server->fd, ==, -1);
+
+	server->fd = accept4 (fd, NULL, NULL, SOCK_CLOEXEC);
+	g_assert_cmpint (server->fd, >=, 0);
+
+	server->read_id = g_unix_fd_add (server->fd, G_IO_IN, _server_read_cb, server);
+	server->listen_id = 0;
+	return G_SOURCE_REMOVE;
+}
+
+/* Waits for the next request and checks that it is a @method call. */
+static json_t *
+_server_pop (MockServer *server, const char *method)
+{
+	json_t *msg;
+	const char *msg_method = NULL;
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, server->requests->len > 0);
+
+	msg = json_incref (server->requests->pdata[0]);
+	g_ptr_array_remove_index (server->requests, 0);
+
+	g_assert_cmpint (json_unpack (msg, "{s:s}", "method", &msg_method), ==, 0);
+	g_assert_cmpstr (msg_method, ==, method);
+	return msg;
+}
+
+static void
+_server_assert_no_request (MockServer *server)
+{
+	g_assert (!nmtst_main_context_iterate_until (NULL, 100, server->requests->len > 0));
+}
+
+/* Sends the response to @request. Takes the reference of @result. */
+static void
+_server_reply (MockServer *server, json_t *request, json_t *result)
+{
+	nm_auto_decref_json json_t *msg = NULL;
+	char *str;
+	gsize len;
+
+	g_assert (result);
+
+	msg = json_pack ("{s:O, s:o, s:n}",
+	                 "id", json_object_get (request, "id"),
+	                 "result", result,
+	                 "error");
+	g_assert (msg);
+
+	str = json_dumps (msg, 0);
+	len = strlen (str);
+	g_assert_cmpint (write (server->fd, str, len), ==, len);
+	free (str);
+}
+
+static void
+_server_reply_str (MockServer *server, json_t *request, const char *result)
+{
+	json_t *json;
+
+	json = json_loads (result, 0, NULL);
+	g_assert (json);
+	_server_reply (server, request, json);
+}
+
+static void
+_server_setup (MockServer *server)
+{
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+	};
+	nm_auto_decref_json json_t *msg = NULL;
+	json_t *params;
+
+	*server = (MockServer) {
+		.listen_fd = -1,
+		.fd = -1,
+		.input = g_string_new (NULL),
+		.requests = g_ptr_array_new_with_free_func (_json_decref),
+	};
+
+	server->tmpdir = g_dir_make_tmp ("test-ovsdb-XXXXXX", NULL);
+	g_assert (server->tmpdir);
+	server->path = g_build_filename (server->tmpdir, "db.sock", NULL);
+	g_assert_cmpint (strlen (server->path), <, sizeof (addr.sun_path));
+	strcpy (addr.sun_path, server->path);
+
+	server->listen_fd = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	g_assert_cmpint (server->listen_fd, >=, 0);
+	g_assert_cmpint (bind (server->listen_fd, (struct sockaddr *) &addr, sizeof (addr)), ==, 0);
+	g_assert_cmpint (listen (server->listen_fd, 1), ==, 0);
+	server->listen_id = g_unix_fd_add (server->listen_fd, G_IO_IN, _server_accept_cb, server);
+
+	server->ovsdb = g_object_new (NM_TYPE_OVSDB,
+	                              NM_OVSDB_SOCKET_PATH, server->path,
+	                              NULL);
+
+	/* The very first thing the client does is to monitor the database. */
+	msg = _server_pop (server, "monitor");
+	params = json_object_get (msg, "params");
+	g_assert_cmpstr (json_string_value (json_array_get (params, 0)), ==, "Open_vSwitch");
+	_server_reply_str (server, msg, INITIAL_STATE);
+}
+
+static void
+_server_teardown (MockServer *server)
+{
+	g_clear_object (&server->ovsdb);
+
+	/* Every request must have been checked by the test. */
+	g_assert_cmpint (server->requests->len, ==, 0);
+
+	nm_clear_g_source (&server->listen_id);
+	nm_clear_g_source (&server->read_id);
+	if (server->fd >= 0)
+		nm_close (server->fd);
+	nm_close (server->listen_fd);
+
+	g_assert_cmpint (unlink (server->path), ==, 0);
+	g_assert_cmpint (rmdir (server->tmpdir), ==, 0);
+
+	g_string_free (server->input, TRUE);
+	g_ptr_array_unref (server->requests);
+	g_free (server->path);
+	g_free (server->tmpdir);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+	guint done_seq;                 /* order of completion, 0 while pending */
+	GError *error;
+} CallResult;
+
+static guint _done_seq;
+
+static void
+_call_cb (GError *error, gpointer user_data)
+{
+	CallResult *result = user_data;
+
+	g_assert_cmpint (result->done_seq, ==, 0);
+	result->done_seq = ++_done_seq;
+	result->error = error ? g_error_copy (error) : NULL;
+}
+
+static void
+_call_result_clear (CallResult *result)
+{
+	g_clear_error (&result->error);
+	*result = (CallResult) { };
+}
+
+static NMConnection *
+_create_connection (const char *type, const char *ifname, const char *uuid)
+{
+	NMConnection *connection;
+	NMSettingConnection *s_con;
+
+	connection = nmtst_create_minimal_connection (ifname, uuid, type, &s_con);
+	g_object_set (s_con,
+	              NM_SETTING_CONNECTION_INTERFACE_NAME, ifname,
+	              NULL);
+	return connection;
+}
+
+static void
+_add_interface (MockServer *server,
+                const char *bridge_ifname, const char *bridge_uuid,
+                const char *port_ifname,
+                const char *interface_ifname,
+                CallResult *result)
+{
+	gs_unref_object NMConnection *bridge = NULL;
+	gs_unref_object NMConnection *port = NULL;
+	gs_unref_object NMConnection *interface = NULL;
+
+	bridge = _create_connection (NM_SETTING_OVS_BRIDGE_SETTING_NAME, bridge_ifname, bridge_uuid);
+	port = _create_connection (NM_SETTING_OVS_PORT_SETTING_NAME, port_ifname, NULL);
+	interface = _create_connection (NM_SETTING_OVS_INTERFACE_SETTING_NAME, interface_ifname, NULL);
+
+	nm_ovsdb_add_interface (server->ovsdb, bridge, port, interface,
+	                        NULL, NULL, _call_cb, result);
+}
+
+/*****************************************************************************/
+
+static guint
+_count_ops (json_t *params, const char *op)
+{
+	json_t *value;
+	const char *v_op;
+	size_t i;
+	guint n = 0;
+
+	json_array_foreach (params, i, value) {
+		if (   json_unpack (value, "{s:s}", "op", &v_op) == 0
+		    && nm_streq (v_op, op))
+			n++;
+	}
+	return n;
+}
+
+/* Finds the @op operation on @table. Unless @name is %NULL, the
+ * operation must be on the row of that name. */
+static json_t *
+_find_op (json_t *params, const char *op, const char *table, const char *name)
+{
+	json_t *value;
+	size_t i;
+
+	json_array_foreach (params, i, value) {
+		const char *v_op;
+		const char *v_table;
+		const char *v_column;
+		const char *v_function;
+		const char *v_name;
+
+		if (   json_unpack (value, "{s:s, s:s}", "op", &v_op, "table", &v_table) != 0
+		    || !nm_streq (v_op, op)
+		    || !nm_streq (v_table, table))
+			continue;
+
+		if (!name)
+			return value;
+
+		if (   json_unpack (value, "{s:{s:s}}", "row", "name", &v_name) == 0
+		    && nm_streq (v_name, name))
+			return value;
+
+		if (   json_unpack (value, "{s:[[s, s, s]]}", "where",
+		                    &v_column, &v_function, &v_name) == 0
+		    && nm_streq (v_column, "name")
+		    && nm_streq (v_name, name))
+			return value;
+	}
+
+	return NULL;
+}
+
+static void
+_assert_set (json_t *set, const char *expected)
+{
+	nm_auto_decref_json json_t *json = NULL;
+
+	json = json_loads (expected, 0, NULL);
+	g_assert (json);
+	g_assert (json_equal (set, json));
+}
+
+/* Checks that the transaction waits for the row to have the @expected
+ * @column before updating it to @new_value. */
+static void
+_assert_wait_update (json_t *params,
+                     const char *table,
+                     const char *name,
+                     const char *column,
+                     const char *expected,
+                     const char *new_value)
+{
+	json_t *op;
+	json_t *rows;
+
+	op = _find_op (params, "wait", table, name);
+	g_assert (op);
+	g_assert_cmpstr (json_string_value (json_object_get (op, "until")), ==, "==");
+	rows = json_object_get (op, "rows");
+	g_assert_cmpint (json_array_size (rows), ==, 1);
+	_assert_set (json_object_get (json_array_get (rows, 0), column), expected);
+
+	op = _find_op (params, "update", table, name);
+	g_assert (op);
+	if (new_value)
+		_assert_set (json_object_get (json_object_get (op, "row"), column), new_value);
+}
+
+static const char *
+_uuid_name (json_t *params, const char *table, const char *name)
+{
+	json_t *op;
+	const char *uuid_name;
+
+	op = _find_op (params, "insert", table, name);
+	g_assert (op);
+	g_assert_cmpint (json_unpack (op, "{s:s}", "uuid-name", &uuid_name), ==, 0);
+	return uuid_name;
+}
+
+/*****************************************************************************/
+
+static void
+test_ovsdb_out_of_order (void)
+{
+	MockServer server;
+	CallResult mtu0 = { };
+	CallResult del1 = { };
+	CallResult mtu1 = { };
+	nm_auto_decref_json json_t *msg_mtu0 = NULL;
+	nm_auto_decref_json json_t *msg_del1 = NULL;
+	nm_auto_decref_json json_t *msg_mtu1 = NULL;
+	json_t *op;
+
+	_server_setup (&server);
+
+	nm_ovsdb_set_interface_mtu (server.ovsdb, "eth0", 1400, _call_cb, &mtu0);
+	nm_ovsdb_del_interface (server.ovsdb, "eth1", _call_cb, &del1);
+	nm_ovsdb_set_interface_mtu (server.ovsdb, "eth1", 1500, _call_cb, &mtu1);
+
+	/* All of them are in flight at the same time. */
+	msg_mtu0 = _server_pop (&server, "transact");
+	msg_del1 = _server_pop (&server, "transact");
+	msg_mtu1 = _server_pop (&server, "transact");
+
+	g_assert (!json_equal (json_object_get (msg_mtu0, "id"), json_object_get (msg_del1, "id")));
+	g_assert (!json_equal (json_object_get (msg_mtu0, "id"), json_object_get (msg_mtu1, "id")));
+	g_assert (!json_equal (json_object_get (msg_del1, "id"), json_object_get (msg_mtu1, "id")));
+
+	op = _find_op (json_object_get (msg_mtu0, "params"), "update", "Interface", "eth0");
+	g_assert (op);
+	g_assert_cmpint (json_integer_value (json_object_get (json_object_get (op, "row"), "mtu_request")), ==, 1400);
+	op = _find_op (json_object_get (msg_mtu1, "params"), "update", "Interface", "eth1");
+	g_assert (op);
+	g_assert_cmpint (json_integer_value (json_object_get (json_object_get (op, "row"), "mtu_request")), ==, 1500);
+	_assert_wait_update (json_object_get (msg_del1, "params"),
+	                     "Port", "port0", "interfaces",
+	                     "[\"set\", [[\"uuid\", \"" ETH0_UUID "\"], [\"uuid\", \"" ETH1_UUID "\"]]]",
+	                     "[\"set\", [[\"uuid\", \"" ETH0_UUID "\"]]]");
+
+	/* Reply in the reverse order; every call gets its own result. */
+	_server_reply_str (&server, msg_mtu1, "[{}, {\"count\": 1}]");
+	nmtst_main_context_iterate_until_assert (NULL, 5000, mtu1.done_seq);
+	g_assert (!mtu0.done_seq);
+	g_assert (!del1.done_seq);
+
+	_server_reply_str (&server, msg_del1, "[{}, {}, {\"count\": 1}]");
+	nmtst_main_context_iterate_until_assert (NULL, 5000, del1.done_seq);
+	g_assert (!mtu0.done_seq);
+
+	_server_reply_str (&server, msg_mtu0, "[{}, {\"error\": \"constraint violation\", \"details\": \"mtu\"}]");
+	nmtst_main_context_iterate_until_assert (NULL, 5000, mtu0.done_seq);
+
+	g_assert_cmpint (mtu1.done_seq, <, del1.done_seq);
+	g_assert_cmpint (del1.done_seq, <, mtu0.done_seq);
+	g_assert_no_error (mtu1.error);
+	g_assert_no_error (del1.error);
+	g_assert_error (mtu0.error, G_IO_ERROR, G_IO_ERROR_FAILED);
+
+	_server_assert_no_request (&server);
+
+	_call_result_clear (&mtu0);
+	_call_result_clear (&del1);
+	_call_result_clear (&mtu1);
+	_server_teardown (&server);
+}
+
+static void
+test_ovsdb_batch (void)
+{
+	MockServer server;
+	CallResult add_port1 = { };
+	CallResult add_br1 = { };
+	CallResult del_eth1 = { };
+	nm_auto_decref_json json_t *msg = NULL;
+	gs_unref_hashtable GHashTable *uuid_names = NULL;
+	json_t *params;
+	json_t *op;
+	json_t *value;
+	size_t i;
+
+	_server_setup (&server);
+
+	_add_interface (&server, "br0", BR0_CONNECTION_UUID, "port1", "eth2", &add_port1);
+	_add_interface (&server, "br1", NULL, "port2", "eth3", &add_br1);
+	nm_ovsdb_del_interface (server.ovsdb, "eth1", _call_cb, &del_eth1);
+
+	/* The calls were made in one main loop iteration, so they are merged. */
+	msg = _server_pop (&server, "transact");
+	params = json_object_get (msg, "params");
+
+	g_assert_cmpstr (json_string_value (json_array_get (params, 0)), ==, "Open_vSwitch");
+	g_assert (_find_op (params, "mutate", "Open_vSwitch", NULL));
+
+	/* The rows that get modified are guarded against concurrent changes. */
+	g_assert_cmpint (_count_ops (params, "wait"), ==, 3);
+	_assert_wait_update (params, "Open_vSwitch", NULL, "bridges",
+	                     "[\"set\", [[\"uuid\", \"" BR0_UUID "\"]]]",
+	                     NULL);
+	_assert_wait_update (params, "Bridge", "br0", "ports",
+	                     "[\"set\", [[\"uuid\", \"" PORT0_UUID "\"]]]",
+	                     NULL);
+	_assert_wait_update (params, "Port", "port0", "interfaces",
+	                     "[\"set\", [[\"uuid\", \"" ETH0_UUID "\"], [\"uuid\", \"" ETH1_UUID "\"]]]",
+	                     "[\"set\", [[\"uuid\", \"" ETH0_UUID "\"]]]");
+
+	/* Every inserted row has a name of its own... */
+	g_assert_cmpint (_count_ops (params, "insert"), ==, 5);
+	uuid_names = g_hash_table_new (nm_str_hash, g_str_equal);
+	json_array_foreach (params, i, value) {
+		const char *uuid_name;
+
+		if (json_unpack (value, "{s:s}", "uuid-name", &uuid_name) == 0) {
+			g_assert (!g_hash_table_contains (uuid_names, uuid_name));
+			g_hash_table_add (uuid_names, (gpointer) uuid_name);
+		}
+	}
+	g_assert_cmpint (g_hash_table_size (uuid_names), ==, 5);
+
+	/* ...that the referring rows use. */
+	op = _find_op (params, "update", "Open_vSwitch", NULL);
+	_assert_set (json_object_get (json_object_get (op, "row"), "bridges"),
+	             nm_sprintf_bufa (200, "[\"set\", [[\"uuid\", \"" BR0_UUID "\"], [\"named-uuid\", \"%s\"]]]",
+	                              _uuid_name (params, "Bridge", "br1")));
+	op = _find_op (params, "update", "Bridge", "br0");
+	_assert_set (json_object_get (json_object_get (op, "row"), "ports"),
+	             nm_sprintf_bufa (200, "[\"set\", [[\"uuid\", \"" PORT0_UUID "\"], [\"named-uuid\", \"%s\"]]]",
+	                              _uuid_name (params, "Port", "port1")));
+	op = _find_op (params, "insert", "Bridge", "br1");
+	_assert_set (json_object_get (json_object_get (op, "row"), "ports"),
+	             nm_sprintf_bufa (200, "[\"set\", [[\"named-uuid\", \"%s\"]]]",
+	                              _uuid_name (params, "Port", "port2")));
+	op = _find_op (params, "insert", "Port", "port1");
+	_assert_set (json_object_get (json_object_get (op, "row"), "interfaces"),
+	             nm_sprintf_bufa (200, "[\"set\", [[\"named-uuid\", \"%s\"]]]",
+	                              _uuid_name (params, "Interface", "eth2")));
+	op = _find_op (params, "insert", "Port", "port2");
+	_assert_set (json_object_get (json_object_get (op, "row"), "interfaces"),
+	             nm_sprintf_bufa (200, "[\"set\", [[\"named-uuid\", \"%s\"]]]",
+	                              _uuid_name (params, "Interface", "eth3")));
+
+	_server_reply_str (&server, msg, "[{}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}]");
+	nmtst_main_context_iterate_until_assert (NULL, 5000,    add_port1.done_seq
+	                                                     && add_br1.done_seq
+	                                                     && del_eth1.done_seq);
+	g_assert_no_error (add_port1.error);
+	g_assert_no_error (add_br1.error);
+	g_assert_no_error (del_eth1.error);
+
+	_server_assert_no_request (&server);
+
+	_call_result_clear (&add_port1);
+	_call_result_clear (&add_br1);
+	_call_result_clear (&del_eth1);
+	_server_teardown (&server);
+}
+
+static void
+test_ovsdb_batch_retry (void)
+{
+	MockServer server;
+	CallResult del_eth0 = { };
+	CallResult add_br1 = { };
+	nm_auto_decref_json json_t *msg = NULL;
+	nm_auto_decref_json json_t *msg_del = NULL;
+	nm_auto_decref_json json_t *msg_add = NULL;
+	json_t *params;
+
+	_server_setup (&server);
+
+	nm_ovsdb_del_interface (server.ovsdb, "eth0", _call_cb, &del_eth0);
+	_add_interface (&server, "br1", NULL, "port2", "eth3", &add_br1);
+
+	msg = _server_pop (&server, "transact");
+	params = json_object_get (msg, "params");
+	g_assert (_find_op (params, "update", "Port", "port0"));
+	g_assert (_find_op (params, "insert", "Bridge", "br1"));
+
+	/* One of the operations failed. This doesn't fail the calls yet, they
+	 * are retried in transactions of their own, one after another. */
+	_server_reply_str (&server, msg, "[{}, {}, {}, {\"error\": \"constraint violation\", \"details\": \"port0\"}]");
+
+	msg_del = _server_pop (&server, "transact");
+	g_assert (!del_eth0.done_seq);
+	g_assert (!add_br1.done_seq);
+	params = json_object_get (msg_del, "params");
+	g_assert_cmpint (_count_ops (params, "insert"), ==, 0);
+	_assert_wait_update (params, "Port", "port0", "interfaces",
+	                     "[\"set\", [[\"uuid\", \"" ETH0_UUID "\"], [\"uuid\", \"" ETH1_UUID "\"]]]",
+	                     "[\"set\", [[\"uuid\", \"" ETH1_UUID "\"]]]");
+	g_assert (!json_equal (json_object_get (msg, "id"), json_object_get (msg_del, "id")));
+
+	/* The bridges might change, so the add waits for the delete. */
+	_server_assert_no_request (&server);
+
+	_server_reply_str (&server, msg_del, "[{}, {}, {\"error\": \"constraint violation\", \"details\": \"port0\"}]");
+	nmtst_main_context_iterate_until_assert (NULL, 5000, del_eth0.done_seq);
+	g_assert_error (del_eth0.error, G_IO_ERROR, G_IO_ERROR_FAILED);
+	g_assert (!add_br1.done_seq);
+
+	msg_add = _server_pop (&server, "transact");
+	params = json_object_get (msg_add, "params");
+	g_assert_cmpint (_count_ops (params, "insert"), ==, 3);
+	g_assert (!_find_op (params, "update", "Port", "port0"));
+	_assert_wait_update (params, "Open_vSwitch", NULL, "bridges",
+	                     "[\"set\", [[\"uuid\", \"" BR0_UUID "\"]]]",
+	                     NULL);
+
+	_server_reply_str (&server, msg_add, "[{}, {}, {}, {}, {}, {}]");
+	nmtst_main_context_iterate_until_assert (NULL, 5000, add_br1.done_seq);
+	g_assert_no_error (add_br1.error);
+
+	_server_assert_no_request (&server);
+
+	_call_result_clear (&del_eth0);
+	_call_result_clear (&add_br1);
+	_server_teardown (&server);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init_with_logging (&argc, &argv, NULL, "ALL");
+
+	g_test_add_func ("/ovsdb/out-of-order", test_ovsdb_out_of_order);
+	g_test_add_func ("/ovsdb/batch", test_ovsdb_batch);
+	g_test_add_func ("/ovsdb/batch-retry", test_ovsdb_batch_retry);
+
+	return g_test_run ();
+}
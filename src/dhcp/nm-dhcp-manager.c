@@ -28,6 +28,9 @@ typedef struct {
 	const NMDhcpClientFactory *client_factory;
 	char *default_hostname;
 	CList dhcp_client_lst_head;
+
+	/* the running clients, indexed by ifindex for each address family. */
+	GHashTable *clients_by_ifindex_x[2];
 } NMDhcpManagerPrivate;
 
 struct _NMDhcpManager {
@@ -152,13 +155,12 @@ get_client_for_ifindex (NMDhcpManager *manager, int addr_family, int ifindex)
 
 	priv = NM_DHCP_MANAGER_GET_PRIVATE (manager);
 
-	c_list_for_each_entry (client, &priv->dhcp_client_lst_head, dhcp_client_lst) {
-		if (   nm_dhcp_client_get_ifindex (client) == ifindex
-		    && nm_dhcp_client_get_addr_family (client) == addr_family)
-			return client;
-	}
-
-	return NULL;
+	client = g_hash_table_lookup (priv->clients_by_ifindex_x[addr_family == AF_INET],
+	                              GINT_TO_POINTER (ifindex));
+	nm_assert (   !client
+	           || (   nm_dhcp_client_get_ifindex (client) == ifindex
+	               && nm_dhcp_client_get_addr_family (client) == addr_family));
+	return client;
 }
 
 static void client_state_changed (NMDhcpClient *client,
@@ -171,9 +173,20 @@ static void client_state_changed (NMDhcpClient *client,
 static void
 remove_client (NMDhcpManager *self, NMDhcpClient *client)
 {
+	NMDhcpManagerPrivate *priv = NM_DHCP_MANAGER_GET_PRIVATE (self);
+	GHashTable *clients_by_ifindex;
+	gpointer key;
+
 	g_signal_handlers_disconnect_by_func (client, client_state_changed, self);
 	c_list_unlink (&client->dhcp_client_lst);
 
+	/* there is at most one client per ifindex and address family, but be careful
+	 * to only drop the index entry if it still refers to this client. */
+	clients_by_ifindex = priv->clients_by_ifindex_x[nm_dhcp_client_get_addr_family (client) == AF_INET];
+	key = GINT_TO_POINTER (nm_dhcp_client_get_ifindex (client));
+	if (g_hash_table_lookup (clients_by_ifindex, key) == client)
+		g_hash_table_remove (clients_by_ifindex, key);
+
 	/* Stopping the client is left up to the controlling device
 	 * explicitly since we may want to quit NetworkManager but not terminate
 	 * the DHCP client.
@@ -316,6 +329,8 @@ client_start (NMDhcpManager *self,
 	                       NULL);
 	nm_assert (client && c_list_is_empty (&client->dhcp_client_lst));
 	c_list_link_tail (&priv->dhcp_client_lst_head, &client->dhcp_client_lst);
+	nm_assert (!g_hash_table_contains (priv->clients_by_ifindex_x[addr_family == AF_INET], GINT_TO_POINTER (ifindex)));
+	g_hash_table_insert (priv->clients_by_ifindex_x[addr_family == AF_INET], GINT_TO_POINTER (ifindex), client);
 	g_signal_connect (client, NM_DHCP_CLIENT_SIGNAL_STATE_CHANGED, G_CALLBACK (client_state_changed), self);
 
 	/* unfortunately, our implementations work differently per address-family regarding client-id/DUID.
@@ -562,6 +577,8 @@ nm_dhcp_manager_init (NMDhcpManager *self)
 	const NMDhcpClientFactory *client_factory = NULL;
 
 	c_list_init (&priv->dhcp_client_lst_head);
+	priv->clients_by_ifindex_x[0] = g_hash_table_new (nm_direct_hash, NULL);
+	priv->clients_by_ifindex_x[1] = g_hash_table_new (nm_direct_hash, NULL);
 
 	for (i = 0; i < G_N_ELEMENTS (_nm_dhcp_manager_factories); i++) {
 		const NMDhcpClientFactory *f = _nm_dhcp_manager_factories[i];
@@ -634,6 +651,8 @@ dispose (GObject *object)
 	G_OBJECT_CLASS (nm_dhcp_manager_parent_class)->dispose (object);
 
 	nm_clear_g_free (&priv->default_hostname);
+	nm_clear_pointer (&priv->clients_by_ifindex_x[0], g_hash_table_unref);
+	nm_clear_pointer (&priv->clients_by_ifindex_x[1], g_hash_table_unref);
 }
 
 static void
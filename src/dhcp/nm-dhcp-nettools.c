@@ -45,11 +45,14 @@ typedef struct _NMDhcpNettoolsClass NMDhcpNettoolsClass;
 
 /*****************************************************************************/
 
+typedef struct _SharedSocket SharedSocket;
+
 typedef struct {
 	NDhcp4Client *client;
 	NDhcp4ClientProbe *probe;
 	NDhcp4ClientLease *lease;
 	GSource *event_source;
+	SharedSocket *shared_socket;
 	char *lease_file;
 } NMDhcpNettoolsPrivate;
 
@@ -1065,16 +1068,11 @@ dhcp4_event_handle (NMDhcpNettools *self,
 }
 
 static gboolean
-dhcp4_event_cb (int fd,
-                GIOCondition condition,
-                gpointer data)
+dhcp4_dispatch_done (NMDhcpNettools *self, int r)
 {
-	NMDhcpNettools *self = data;
 	NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE (self);
 	NDhcp4ClientEvent *event;
-	int r;
 
-	r = n_dhcp4_client_dispatch (priv->client);
 	if (r < 0) {
 		/* FIXME: if any operation (e.g. send()) fails during the
 		 * dispatch, n-dhcp4 returns an error without arming timers
@@ -1086,16 +1084,213 @@ dhcp4_event_cb (int fd,
 		_LOGE ("error %d dispatching events", r);
 		nm_clear_g_source_inst (&priv->event_source);
 		nm_dhcp_client_set_state (NM_DHCP_CLIENT (self), NM_DHCP_STATE_FAIL, NULL, NULL);
-		return G_SOURCE_REMOVE;
+		return FALSE;
 	}
 
 	while (!n_dhcp4_client_pop_event (priv->client, &event) && event) {
 		dhcp4_event_handle (self, event);
 	}
 
+	return TRUE;
+}
+
+static gboolean
+dhcp4_event_cb (int fd,
+                GIOCondition condition,
+                gpointer data)
+{
+	NMDhcpNettools *self = data;
+	NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE (self);
+
+	if (!dhcp4_dispatch_done (self, n_dhcp4_client_dispatch (priv->client)))
+		return G_SOURCE_REMOVE;
 	return G_SOURCE_CONTINUE;
 }
 
+/*****************************************************************************/
+
+/* With many clients (e.g. on hundreds of macvlans), having one packet socket
+ * with its own BPF filter per client gets expensive. If enabled in
+ * NetworkManager.conf, all nettools clients instead share one packet socket
+ * that receives the DHCP replies of all interfaces. Incoming packets are
+ * handed to the client of the receiving interface, which drops them unless
+ * the xid matches its pending request.
+ *
+ * Note that the socket is not bound to the parent of the macvlans. Frames
+ * are only assigned to the macvlan after the taps of the parent saw them,
+ * so the ifindex would not tell the clients apart. */
+
+struct _SharedSocket {
+	GHashTable *clients_by_ifindex;
+	GSource *source;
+	guint8 *buf;
+	int ref_count;
+	int fd;
+};
+
+static SharedSocket *_shared_socket;
+
+#define SHARED_SOCKET_BUF_SIZE  G_MAXUINT16
+
+/* How many packets to read per main loop iteration before yielding. */
+#define SHARED_SOCKET_BATCH_SIZE 64
+
+static void
+shared_socket_unref (SharedSocket *shared)
+{
+	nm_assert (shared);
+	nm_assert (shared->ref_count > 0);
+
+	if (--shared->ref_count > 0)
+		return;
+
+	nm_assert (g_hash_table_size (shared->clients_by_ifindex) == 0);
+
+	if (_shared_socket == shared)
+		_shared_socket = NULL;
+
+	nm_clear_g_source_inst (&shared->source);
+	nm_close (shared->fd);
+	g_hash_table_unref (shared->clients_by_ifindex);
+	g_free (shared->buf);
+	g_slice_free (SharedSocket, shared);
+}
+
+static void
+shared_socket_dispatch_packet (NMDhcpNettools *self, const guint8 *data, gsize n_data)
+{
+	NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE (self);
+	gs_unref_object NMDhcpNettools *self_keep_alive = NULL;
+
+	if (   !priv->client
+	    || !priv->event_source) {
+		/* the client already failed. */
+		return;
+	}
+
+	self_keep_alive = g_object_ref (self);
+	dhcp4_dispatch_done (self, n_dhcp4_client_dispatch_packet (priv->client, data, n_data));
+}
+
+static gboolean
+shared_socket_event_cb (int fd,
+                        GIOCondition condition,
+                        gpointer user_data)
+{
+	SharedSocket *shared = user_data;
+	NMDhcpNettools *self;
+	size_t n_data;
+	int ifindex;
+	guint i;
+	int r;
+
+	/* dispatching a packet might drop the last client, and the socket with it. */
+	shared->ref_count++;
+
+	for (i = 0; i < SHARED_SOCKET_BATCH_SIZE; i++) {
+		r = n_dhcp4_client_packet_socket_recv (shared->fd,
+		                                       shared->buf,
+		                                       SHARED_SOCKET_BUF_SIZE,
+		                                       &n_data,
+		                                       &ifindex);
+		if (r == N_DHCP4_E_PREEMPTED)
+			break;
+		if (r) {
+			nm_log_warn (LOGD_DHCP4, "dhcp4: error %d reading from shared packet socket", r);
+			break;
+		}
+		if (n_data == 0)
+			continue;
+
+		self = g_hash_table_lookup (shared->clients_by_ifindex, GINT_TO_POINTER (ifindex));
+		if (self)
+			shared_socket_dispatch_packet (self, shared->buf, n_data);
+	}
+
+	shared_socket_unref (shared);
+	return G_SOURCE_CONTINUE;
+}
+
+static SharedSocket *
+shared_socket_acquire (void)
+{
+	SharedSocket *shared;
+	int fd;
+	int r;
+
+	if (_shared_socket) {
+		_shared_socket->ref_count++;
+		return _shared_socket;
+	}
+
+	r = n_dhcp4_client_packet_socket_new (&fd);
+	if (r) {
+		nm_log_warn (LOGD_DHCP4, "dhcp4: failed to create shared packet socket (%d), use one socket per client",
+		             r);
+		return NULL;
+	}
+
+	shared = g_slice_new (SharedSocket);
+	*shared = (SharedSocket) {
+		.ref_count          = 1,
+		.fd                 = fd,
+		.buf                = g_malloc (SHARED_SOCKET_BUF_SIZE),
+		.clients_by_ifindex = g_hash_table_new (nm_direct_hash, NULL),
+	};
+	shared->source = nm_g_unix_fd_source_new (fd,
+	                                          G_IO_IN,
+	                                          G_PRIORITY_DEFAULT,
+	                                          shared_socket_event_cb,
+	                                          shared,
+	                                          NULL);
+	g_source_attach (shared->source, NULL);
+
+	_shared_socket = shared;
+	return shared;
+}
+
+static void
+shared_socket_register (NMDhcpNettools *self, SharedSocket *shared)
+{
+	NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE (self);
+
+	nm_assert (!priv->shared_socket);
+
+	/* a client that is about to be disposed might still be registered
+	 * for the same ifindex. The new client takes over. */
+	g_hash_table_insert (shared->clients_by_ifindex,
+	                     GINT_TO_POINTER (nm_dhcp_client_get_ifindex (NM_DHCP_CLIENT (self))),
+	                     self);
+	priv->shared_socket = shared;
+}
+
+static void
+shared_socket_unregister (NMDhcpNettools *self)
+{
+	NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE (self);
+	SharedSocket *shared;
+	gpointer key;
+
+	shared = g_steal_pointer (&priv->shared_socket);
+	if (!shared)
+		return;
+
+	key = GINT_TO_POINTER (nm_dhcp_client_get_ifindex (NM_DHCP_CLIENT (self)));
+	if (g_hash_table_lookup (shared->clients_by_ifindex, key) == self)
+		g_hash_table_remove (shared->clients_by_ifindex, key);
+
+	shared_socket_unref (shared);
+}
+
+static gboolean
+shared_socket_enabled (void)
+{
+	return nm_config_data_get_value_boolean (NM_CONFIG_GET_DATA,
+	                                         NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                         NM_CONFIG_KEYFILE_KEY_MAIN_DHCP_SHARED_SOCKET,
+	                                         FALSE);
+}
+
 G_GNUC_PRINTF (3, 4)
 static void
 nettools_log (int level, void *data, const char *fmt, ...)
@@ -1135,6 +1330,7 @@ nettools_create (NMDhcpNettools *self,
 	gs_unref_bytes GBytes *client_id_new = NULL;
 	const uint8_t *client_id_arr;
 	size_t client_id_len;
+	SharedSocket *shared = NULL;
 	int r, fd, arp_type, transport;
 
 	g_return_val_if_fail (!priv->client, FALSE);
@@ -1200,8 +1396,16 @@ nettools_create (NMDhcpNettools *self,
 		return FALSE;
 	}
 
+	if (shared_socket_enabled ()) {
+		shared = shared_socket_acquire ();
+		if (shared)
+			n_dhcp4_client_config_set_shared_packet_socket (config, TRUE);
+	}
+
 	r = n_dhcp4_client_new (&client, config);
 	if (r) {
+		if (shared)
+			shared_socket_unref (shared);
 		set_error_nettools (error, r, "failed to create client");
 		return FALSE;
 	}
@@ -1209,6 +1413,9 @@ nettools_create (NMDhcpNettools *self,
 	priv->client = client;
 	client = NULL;
 
+	if (shared)
+		shared_socket_register (self, shared);
+
 	n_dhcp4_client_get_fd (priv->client, &fd);
 
 	priv->event_source = nm_g_unix_fd_source_new (fd,
@@ -1447,6 +1654,7 @@ stop (NMDhcpClient *client,
 	       (gpointer) priv->client);
 
 	priv->probe = n_dhcp4_client_probe_free (priv->probe);
+	shared_socket_unregister (self);
 }
 
 /*****************************************************************************/
@@ -1462,6 +1670,7 @@ dispose (GObject *object)
 	NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE (object);
 
 	nm_clear_g_free (&priv->lease_file);
+	shared_socket_unregister (NM_DHCP_NETTOOLS (object));
 	nm_clear_g_source_inst (&priv->event_source);
 	nm_clear_pointer (&priv->lease, n_dhcp4_client_lease_unref);
 	nm_clear_pointer (&priv->probe, n_dhcp4_client_probe_free);
@@ -0,0 +1,916 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-dhcp-server.h"
+
+#include <arpa/inet.h>
+
+#include "nm-utils.h"
+#include "nm-core-internal.h"
+#include "nm-dhcp-options.h"
+#include "dnsmasq/nm-dnsmasq-utils.h"
+#include "platform/nm-platform.h"
+#include "n-dhcp4/src/n-dhcp4.h"
+
+/*****************************************************************************/
+
+/* Same as the "60m" we pass to dnsmasq. */
+#define LEASE_TIME_SEC      3600
+
+/* The pool never hands out more than what nm_dnsmasq_utils_get_range()
+ * returns, which is at most 257 addresses. Be a bit more lenient. */
+#define POOL_MAX_SIZE       1024
+
+/* The maximum length of the client hardware address in the DHCP header. */
+#define CHADDR_MAX_LEN      16
+
+/* Renewals only extend the expiry of a lease. They are written to the lease
+ * file after this delay, instead of rewriting the file for every request. */
+#define LEASES_SAVE_DELAY_SEC 300
+
+typedef struct {
+	in_addr_t address;
+
+	/* Wall-clock time in seconds, so that the lease file survives a reboot. */
+	gint64 expiry;
+
+	/* The client identifier, or %NULL for an address that a client declined
+	 * and that is blocked until @expiry. */
+	GBytes *client_id;
+
+	guint8 chaddr_len;
+	guint8 chaddr[CHADDR_MAX_LEN];
+} Lease;
+
+struct _NMDhcpServerPool {
+	/* first and last address of the range, in host byte order. */
+	guint32 first;
+	guint32 last;
+
+	/* in_addr_t to Lease, owns the leases. */
+	GHashTable *by_address;
+
+	/* client-id (GBytes) to Lease. */
+	GHashTable *by_client_id;
+};
+
+struct _NMDhcpServer {
+	int ifindex;
+	char *iface;
+	char *lease_file;
+
+	NDhcp4Server *server;
+	NDhcp4ServerIp *server_ip;
+	GSource *event_source;
+
+	NMDhcpServerPool *pool;
+	GSource *leases_save_source;
+
+	in_addr_t address;
+	in_addr_t netmask;
+
+	/* Options sent with every offer and acknowledgement. */
+	GArray *dns;
+	GByteArray *search;
+	bool has_router:1;
+	bool announce_android_metered:1;
+
+	NMDhcpServerFailedCallback failed_callback;
+	gpointer user_data;
+};
+
+/*****************************************************************************/
+
+#define _NMLOG_DOMAIN         LOGD_SHARING
+#define _NMLOG_PREFIX_NAME    "dhcp-server"
+#define _NMLOG(level, ...) \
+    G_STMT_START { \
+        nm_log ((level), _NMLOG_DOMAIN, \
+                self ? self->iface : NULL, \
+                NULL, \
+                "%s: " _NM_UTILS_MACRO_FIRST (__VA_ARGS__), \
+                _NMLOG_PREFIX_NAME \
+                _NM_UTILS_MACRO_REST (__VA_ARGS__)); \
+    } G_STMT_END
+
+/*****************************************************************************/
+
+static void
+_lease_free (Lease *lease)
+{
+	if (lease->client_id)
+		g_bytes_unref (lease->client_id);
+	g_slice_free (Lease, lease);
+}
+
+static gboolean
+_pool_contains (NMDhcpServerPool *pool, in_addr_t address)
+{
+	guint32 a = ntohl (address);
+
+	return a >= pool->first && a <= pool->last;
+}
+
+static Lease *
+_pool_lookup_client_id (NMDhcpServerPool *pool,
+                        const guint8 *client_id,
+                        gsize client_id_len)
+{
+	gs_unref_bytes GBytes *key = NULL;
+
+	key = g_bytes_new_static (client_id, client_id_len);
+	return g_hash_table_lookup (pool->by_client_id, key);
+}
+
+static gboolean
+_pool_is_free (NMDhcpServerPool *pool, in_addr_t address, gint64 now)
+{
+	Lease *lease;
+
+	lease = g_hash_table_lookup (pool->by_address, GUINT_TO_POINTER (address));
+	return !lease || lease->expiry <= now;
+}
+
+static void
+_pool_remove (NMDhcpServerPool *pool, Lease *lease)
+{
+	if (   lease->client_id
+	    && g_hash_table_lookup (pool->by_client_id, lease->client_id) == lease)
+		g_hash_table_remove (pool->by_client_id, lease->client_id);
+	g_hash_table_remove (pool->by_address, GUINT_TO_POINTER (lease->address));
+}
+
+NMDhcpServerPool *
+nm_dhcp_server_pool_new (in_addr_t first, in_addr_t last)
+{
+	NMDhcpServerPool *pool;
+
+	g_return_val_if_fail (ntohl (first) <= ntohl (last), NULL);
+	g_return_val_if_fail (ntohl (last) - ntohl (first) < POOL_MAX_SIZE, NULL);
+
+	pool = g_slice_new (NMDhcpServerPool);
+	*pool = (NMDhcpServerPool) {
+		.first        = ntohl (first),
+		.last         = ntohl (last),
+		.by_address   = g_hash_table_new_full (nm_direct_hash, NULL, NULL, (GDestroyNotify) _lease_free),
+		.by_client_id = g_hash_table_new (g_bytes_hash, g_bytes_equal),
+	};
+	return pool;
+}
+
+void
+nm_dhcp_server_pool_free (NMDhcpServerPool *pool)
+{
+	if (!pool)
+		return;
+
+	g_hash_table_unref (pool->by_client_id);
+	g_hash_table_unref (pool->by_address);
+	g_slice_free (NMDhcpServerPool, pool);
+}
+
+guint
+nm_dhcp_server_pool_get_num_leases (NMDhcpServerPool *pool)
+{
+	return g_hash_table_size (pool->by_client_id);
+}
+
+/**
+ * nm_dhcp_server_pool_pick:
+ * @pool: the pool
+ * @client_id: the client identifier
+ * @client_id_len: the length of @client_id
+ * @requested: the address the client asks for, or zero
+ * @now: the current time in seconds
+ *
+ * Picks the address to offer to a client, without modifying the pool. That
+ * is the address bound to the client before. Otherwise, it is the address
+ * the client asks for if that is free, or the lowest free address in the
+ * range.
+ *
+ * Returns: the address, or zero if the pool is exhausted.
+ */
+in_addr_t
+nm_dhcp_server_pool_pick (NMDhcpServerPool *pool,
+                          const guint8 *client_id,
+                          gsize client_id_len,
+                          in_addr_t requested,
+                          gint64 now)
+{
+	Lease *lease;
+	guint32 a;
+
+	lease = _pool_lookup_client_id (pool, client_id, client_id_len);
+	if (lease)
+		return lease->address;
+
+	if (   requested
+	    && _pool_contains (pool, requested)
+	    && _pool_is_free (pool, requested, now))
+		return requested;
+
+	for (a = pool->first; a <= pool->last; a++) {
+		if (_pool_is_free (pool, htonl (a), now))
+			return htonl (a);
+	}
+
+	return 0;
+}
+
+/**
+ * nm_dhcp_server_pool_lookup:
+ * @pool: the pool
+ * @client_id: the client identifier
+ * @client_id_len: the length of @client_id
+ *
+ * Returns: the address that is bound to the client, or 0. The lease
+ *   might be expired.
+ */
+in_addr_t
+nm_dhcp_server_pool_lookup (NMDhcpServerPool *pool,
+                            const guint8 *client_id,
+                            gsize client_id_len)
+{
+	Lease *lease;
+
+	lease = _pool_lookup_client_id (pool, client_id, client_id_len);
+	return lease ? lease->address : 0;
+}
+
+/**
+ * nm_dhcp_server_pool_bind:
+ * @pool: the pool
+ * @client_id: the client identifier
+ * @client_id_len: the length of @client_id
+ * @chaddr: the client hardware address
+ * @chaddr_len: the length of @chaddr
+ * @address: the address to bind
+ * @expiry: the time when the lease expires, in seconds
+ * @now: the current time in seconds
+ *
+ * Binds @address to the client. This fails if @address is not part of
+ * the range or is bound to another client. A previous lease of the
+ * client for a different address is dropped.
+ *
+ * Returns: whether @address is now bound to the client.
+ */
+gboolean
+nm_dhcp_server_pool_bind (NMDhcpServerPool *pool,
+                          const guint8 *client_id,
+                          gsize client_id_len,
+                          const guint8 *chaddr,
+                          gsize chaddr_len,
+                          in_addr_t address,
+                          gint64 expiry,
+                          gint64 now)
+{
+	Lease *lease;
+	Lease *other;
+
+	if (!_pool_contains (pool, address))
+		return FALSE;
+
+	lease = _pool_lookup_client_id (pool, client_id, client_id_len);
+	other = g_hash_table_lookup (pool->by_address, GUINT_TO_POINTER (address));
+
+	if (other && other != lease) {
+		if (other->expiry > now)
+			return FALSE;
+		_pool_remove (pool, other);
+	}
+
+	if (lease && lease->address != address) {
+		_pool_remove (pool, lease);
+		lease = NULL;
+	}
+
+	if (!lease) {
+		lease = g_slice_new0 (Lease);
+		lease->address = address;
+		lease->client_id = g_bytes_new (client_id, client_id_len);
+		g_hash_table_insert (pool->by_address, GUINT_TO_POINTER (address), lease);
+		g_hash_table_insert (pool->by_client_id, lease->client_id, lease);
+	}
+
+	lease->expiry = expiry;
+	lease->chaddr_len = MIN (chaddr_len, (gsize) CHADDR_MAX_LEN);
+	if (lease->chaddr_len)
+		memcpy (lease->chaddr, chaddr, lease->chaddr_len);
+	return TRUE;
+}
+
+/**
+ * nm_dhcp_server_pool_release:
+ * @pool: the pool
+ * @client_id: the client identifier
+ * @client_id_len: the length of @client_id
+ * @address: the address the client releases
+ *
+ * Returns: whether a lease was dropped.
+ */
+gboolean
+nm_dhcp_server_pool_release (NMDhcpServerPool *pool,
+                             const guint8 *client_id,
+                             gsize client_id_len,
+                             in_addr_t address)
+{
+	Lease *lease;
+
+	lease = _pool_lookup_client_id (pool, client_id, client_id_len);
+	if (!lease || lease->address != address)
+		return FALSE;
+
+	_pool_remove (pool, lease);
+	return TRUE;
+}
+
+/**
+ * nm_dhcp_server_pool_decline:
+ * @pool: the pool
+ * @address: the address a client found to be in use
+ * @expiry: until when the address is blocked, in seconds
+ *
+ * Blocks @address, because a client detected that it is already used by
+ * somebody else on the link.
+ */
+void
+nm_dhcp_server_pool_decline (NMDhcpServerPool *pool,
+                             in_addr_t address,
+                             gint64 expiry)
+{
+	Lease *lease;
+
+	if (!_pool_contains (pool, address))
+		return;
+
+	lease = g_hash_table_lookup (pool->by_address, GUINT_TO_POINTER (address));
+	if (lease)
+		_pool_remove (pool, lease);
+
+	lease = g_slice_new0 (Lease);
+	lease->address = address;
+	lease->expiry = expiry;
+	g_hash_table_insert (pool->by_address, GUINT_TO_POINTER (address), lease);
+}
+
+static int
+_lease_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const Lease *lease_a = *((const Lease *const*) a);
+	const Lease *lease_b = *((const Lease *const*) b);
+
+	NM_CMP_DIRECT (ntohl (lease_a->address), ntohl (lease_b->address));
+	return 0;
+}
+
+/**
+ * nm_dhcp_server_pool_to_string:
+ * @pool: the pool
+ * @now: the current time in seconds
+ *
+ * Serializes the bound leases in the format of dnsmasq lease files, that
+ * is one line "<expiry> <chaddr> <address> <hostname> <client-id>" per
+ * lease. The hostname is always "*". Expired leases and declined addresses
+ * are not persisted.
+ *
+ * Returns: the lease file contents.
+ */
+char *
+nm_dhcp_server_pool_to_string (NMDhcpServerPool *pool, gint64 now)
+{
+	gs_free const Lease **leases = NULL;
+	GHashTableIter iter;
+	Lease *lease;
+	GString *str;
+	guint n, i;
+
+	leases = g_new (const Lease *, g_hash_table_size (pool->by_address) + 1);
+	n = 0;
+	g_hash_table_iter_init (&iter, pool->by_address);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &lease)) {
+		if (   lease->client_id
+		    && lease->expiry > now)
+			leases[n++] = lease;
+	}
+	g_qsort_with_data (leases, n, sizeof (leases[0]), _lease_cmp, NULL);
+
+	str = g_string_new (NULL);
+	for (i = 0; i < n; i++) {
+		char sbuf_addr[NM_UTILS_INET_ADDRSTRLEN];
+		gs_free char *s_chaddr = NULL;
+		gs_free char *s_client_id = NULL;
+		gconstpointer client_id;
+		gsize client_id_len;
+
+		lease = (Lease *) leases[i];
+		client_id = g_bytes_get_data (lease->client_id, &client_id_len);
+		if (lease->chaddr_len)
+			s_chaddr = nm_utils_bin2hexstr_full (lease->chaddr, lease->chaddr_len, ':', FALSE, NULL);
+		if (client_id_len)
+			s_client_id = nm_utils_bin2hexstr_full (client_id, client_id_len, ':', FALSE, NULL);
+
+		g_string_append_printf (str,
+		                        "%"G_GINT64_FORMAT" %s %s * %s\n",
+		                        lease->expiry,
+		                        s_chaddr ?: "*",
+		                        _nm_utils_inet4_ntop (lease->address, sbuf_addr),
+		                        s_client_id ?: "*");
+	}
+
+	return g_string_free (str, FALSE);
+}
+
+/**
+ * nm_dhcp_server_pool_load:
+ * @pool: the pool
+ * @contents: the lease file contents, as written by
+ *   nm_dhcp_server_pool_to_string()
+ * @now: the current time in seconds
+ *
+ * Binds the leases from @contents. Invalid lines, expired leases and
+ * leases outside the range of @pool are skipped.
+ *
+ * Returns: the number of leases that were loaded.
+ */
+guint
+nm_dhcp_server_pool_load (NMDhcpServerPool *pool, const char *contents, gint64 now)
+{
+	gs_free const char **lines = NULL;
+	guint n_loaded = 0;
+	gsize i;
+
+	lines = nm_utils_strsplit_set (contents, "\n");
+	for (i = 0; lines && lines[i]; i++) {
+		gs_free const char **fields = NULL;
+		gs_unref_bytes GBytes *chaddr = NULL;
+		gs_unref_bytes GBytes *client_id = NULL;
+		in_addr_t address;
+		gint64 expiry;
+		gconstpointer chaddr_data = NULL;
+		gsize chaddr_len = 0;
+		gconstpointer client_id_data;
+		gsize client_id_len;
+
+		fields = nm_utils_strsplit_set (lines[i], " \t");
+		if (NM_PTRARRAY_LEN (fields) != 5)
+			continue;
+
+		expiry = _nm_utils_ascii_str_to_int64 (fields[0], 10, 0, G_MAXINT64, 0);
+		if (expiry <= now)
+			continue;
+
+		if (!nm_utils_parse_inaddr_bin (AF_INET, fields[2], NULL, &address))
+			continue;
+
+		if (!nm_streq (fields[1], "*")) {
+			chaddr = nm_utils_hexstr2bin (fields[1]);
+			if (!chaddr)
+				continue;
+			chaddr_data = g_bytes_get_data (chaddr, &chaddr_len);
+		}
+
+		client_id = nm_utils_hexstr2bin (fields[4]);
+		if (!client_id)
+			continue;
+		client_id_data = g_bytes_get_data (client_id, &client_id_len);
+
+		if (nm_dhcp_server_pool_bind (pool,
+		                              client_id_data,
+		                              client_id_len,
+		                              chaddr_data,
+		                              chaddr_len,
+		                              address,
+		                              expiry,
+		                              now))
+			n_loaded++;
+	}
+
+	return n_loaded;
+}
+
+/*****************************************************************************/
+
+static gint64
+_now (void)
+{
+	return g_get_real_time () / G_USEC_PER_SEC;
+}
+
+static void
+_leases_save (NMDhcpServer *self)
+{
+	gs_free_error GError *error = NULL;
+	gs_free char *contents = NULL;
+
+	nm_clear_g_source_inst (&self->leases_save_source);
+
+	contents = nm_dhcp_server_pool_to_string (self->pool, _now ());
+	if (!nm_utils_file_set_contents (self->lease_file,
+	                                 contents,
+	                                 -1,
+	                                 0644,
+	                                 NULL,
+	                                 &error))
+		_LOGW ("failed to write lease file %s: %s", self->lease_file, error->message);
+}
+
+static gboolean
+_leases_save_timeout_cb (gpointer user_data)
+{
+	_leases_save (user_data);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_leases_save_schedule (NMDhcpServer *self)
+{
+	if (self->leases_save_source)
+		return;
+
+	self->leases_save_source = nm_g_timeout_source_new (LEASES_SAVE_DELAY_SEC * 1000,
+	                                                    G_PRIORITY_DEFAULT,
+	                                                    _leases_save_timeout_cb,
+	                                                    self,
+	                                                    NULL);
+	g_source_attach (self->leases_save_source, NULL);
+}
+
+static void
+_leases_load (NMDhcpServer *self)
+{
+	gs_free char *contents = NULL;
+	guint n;
+
+	if (!g_file_get_contents (self->lease_file, &contents, NULL, NULL))
+		return;
+
+	n = nm_dhcp_server_pool_load (self->pool, contents, _now ());
+	_LOGD ("loaded %u leases from %s", n, self->lease_file);
+}
+
+/*****************************************************************************/
+
+static void
+_lease_append (NMDhcpServer *self,
+               NDhcp4ServerLease *lease,
+               guint8 option,
+               gconstpointer data,
+               gsize len)
+{
+	int r;
+
+	r = n_dhcp4_server_lease_append (lease, option, (guint8 *) data, len);
+	if (r)
+		_LOGD ("failed to append option %u: error %d", option, r);
+}
+
+static gboolean
+_lease_reply (NMDhcpServer *self,
+              NDhcp4ServerLease *lease,
+              in_addr_t address,
+              gboolean ack)
+{
+	char sbuf_addr[NM_UTILS_INET_ADDRSTRLEN];
+	int r;
+
+	n_dhcp4_server_lease_set_yiaddr (lease, (struct in_addr) { address }, LEASE_TIME_SEC);
+
+	_lease_append (self, lease, NM_DHCP_OPTION_DHCP4_SUBNET_MASK, &self->netmask, sizeof (self->netmask));
+	if (self->has_router)
+		_lease_append (self, lease, NM_DHCP_OPTION_DHCP4_ROUTER, &self->address, sizeof (self->address));
+	if (self->dns->len > 0)
+		_lease_append (self, lease, NM_DHCP_OPTION_DHCP4_DOMAIN_NAME_SERVER, self->dns->data, self->dns->len * sizeof (in_addr_t));
+	if (self->search->len > 0)
+		_lease_append (self, lease, NM_DHCP_OPTION_DHCP4_DOMAIN_SEARCH_LIST, self->search->data, self->search->len);
+	if (self->announce_android_metered) {
+		/* Announce ANDROID_METERED in option 43, even if the client did not ask for it.
+		 * See https://www.lorier.net/docs/android-metered.html */
+		_lease_append (self, lease, NM_DHCP_OPTION_DHCP4_VENDOR_SPECIFIC, "ANDROID_METERED", NM_STRLEN ("ANDROID_METERED"));
+	}
+
+	r = ack
+	    ? n_dhcp4_server_lease_ack (lease)
+	    : n_dhcp4_server_lease_offer (lease);
+	if (r) {
+		_LOGD ("failed to %s %s: error %d",
+		       ack ? "acknowledge" : "offer",
+		       _nm_utils_inet4_ntop (address, sbuf_addr),
+		       r);
+		return FALSE;
+	}
+
+	_LOGD ("%s %s",
+	       ack ? "acknowledged" : "offered",
+	       _nm_utils_inet4_ntop (address, sbuf_addr));
+	return TRUE;
+}
+
+static void
+_handle_discover (NMDhcpServer *self, NDhcp4ServerLease *lease)
+{
+	const guint8 *client_id;
+	size_t client_id_len;
+	struct in_addr requested;
+	in_addr_t address;
+
+	n_dhcp4_server_lease_get_client_id (lease, &client_id, &client_id_len);
+	n_dhcp4_server_lease_get_requested_ip (lease, &requested);
+
+	address = nm_dhcp_server_pool_pick (self->pool, client_id, client_id_len, requested.s_addr, _now ());
+	if (!address) {
+		_LOGW ("no free address left to offer");
+		return;
+	}
+
+	_lease_reply (self, lease, address, FALSE);
+}
+
+static void
+_handle_request (NMDhcpServer *self, NDhcp4ServerLease *lease)
+{
+	char sbuf_addr[NM_UTILS_INET_ADDRSTRLEN];
+	const guint8 *client_id;
+	size_t client_id_len;
+	const guint8 *chaddr;
+	size_t chaddr_len;
+	struct in_addr requested;
+	gint64 now = _now ();
+	gboolean is_renewal;
+
+	n_dhcp4_server_lease_get_client_id (lease, &client_id, &client_id_len);
+	n_dhcp4_server_lease_get_chaddr (lease, &chaddr, &chaddr_len);
+	n_dhcp4_server_lease_get_requested_ip (lease, &requested);
+
+	is_renewal = (nm_dhcp_server_pool_lookup (self->pool, client_id, client_id_len) == requested.s_addr);
+
+	if (!nm_dhcp_server_pool_bind (self->pool,
+	                               client_id,
+	                               client_id_len,
+	                               chaddr,
+	                               chaddr_len,
+	                               requested.s_addr,
+	                               now + LEASE_TIME_SEC,
+	                               now)) {
+		_LOGD ("reject request for %s",
+		       _nm_utils_inet4_ntop (requested.s_addr, sbuf_addr));
+		n_dhcp4_server_lease_nack (lease);
+		return;
+	}
+
+	/* a new lease changes which addresses are taken and is written right
+	 * away. A renewal only extends the expiry and is written later. */
+	if (is_renewal)
+		_leases_save_schedule (self);
+	else
+		_leases_save (self);
+	_lease_reply (self, lease, requested.s_addr, TRUE);
+}
+
+static void
+_handle_decline (NMDhcpServer *self, NDhcp4ServerLease *lease)
+{
+	char sbuf_addr[NM_UTILS_INET_ADDRSTRLEN];
+	struct in_addr requested;
+
+	n_dhcp4_server_lease_get_requested_ip (lease, &requested);
+
+	_LOGD ("address %s declined by client",
+	       _nm_utils_inet4_ntop (requested.s_addr, sbuf_addr));
+
+	nm_dhcp_server_pool_decline (self->pool, requested.s_addr, _now () + LEASE_TIME_SEC);
+	_leases_save (self);
+}
+
+static void
+_handle_release (NMDhcpServer *self, NDhcp4ServerLease *lease)
+{
+	char sbuf_addr[NM_UTILS_INET_ADDRSTRLEN];
+	const guint8 *client_id;
+	size_t client_id_len;
+	struct in_addr address;
+
+	n_dhcp4_server_lease_get_client_id (lease, &client_id, &client_id_len);
+	n_dhcp4_server_lease_get_requested_ip (lease, &address);
+
+	if (nm_dhcp_server_pool_release (self->pool, client_id, client_id_len, address.s_addr)) {
+		_LOGD ("address %s released by client",
+		       _nm_utils_inet4_ntop (address.s_addr, sbuf_addr));
+		_leases_save (self);
+	}
+}
+
+static gboolean
+_event_cb (int fd,
+           GIOCondition condition,
+           gpointer user_data)
+{
+	NMDhcpServer *self = user_data;
+	NDhcp4ServerEvent *event;
+	int r;
+
+	r = n_dhcp4_server_dispatch (self->server);
+	if (r < 0) {
+		_LOGW ("error %d dispatching events", r);
+		nm_clear_g_source_inst (&self->event_source);
+		if (self->failed_callback)
+			self->failed_callback (self, self->user_data);
+		return G_SOURCE_REMOVE;
+	}
+
+	while (!n_dhcp4_server_pop_event (self->server, &event) && event) {
+		switch (event->event) {
+		case N_DHCP4_SERVER_EVENT_DISCOVER:
+			_handle_discover (self, event->discover.lease);
+			break;
+		case N_DHCP4_SERVER_EVENT_REQUEST:
+			_handle_request (self, event->request.lease);
+			break;
+		case N_DHCP4_SERVER_EVENT_RENEW:
+			_handle_request (self, event->renew.lease);
+			break;
+		case N_DHCP4_SERVER_EVENT_DECLINE:
+			_handle_decline (self, event->decline.lease);
+			break;
+		case N_DHCP4_SERVER_EVENT_RELEASE:
+			_handle_release (self, event->release.lease);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+/*****************************************************************************/
+
+static void
+_search_append (GByteArray *search, const char *domain)
+{
+	gs_free const char **labels = NULL;
+	guint old_len = search->len;
+	gsize i;
+
+	/* Encode @domain as in RFC 1035, section 3.1, without compression. */
+	labels = nm_utils_strsplit_set (domain, ".");
+	for (i = 0; labels && labels[i]; i++) {
+		gsize len = strlen (labels[i]);
+		guint8 len8 = len;
+
+		if (len > 63) {
+			g_byte_array_set_size (search, old_len);
+			return;
+		}
+		g_byte_array_append (search, &len8, 1);
+		g_byte_array_append (search, (const guint8 *) labels[i], len);
+	}
+
+	if (search->len == old_len)
+		return;
+	g_byte_array_append (search, (const guint8 *) "", 1);
+
+	/* The option must fit into a single DHCP option. */
+	if (search->len > 255)
+		g_byte_array_set_size (search, old_len);
+}
+
+/**
+ * nm_dhcp_server_new:
+ * @ifindex: the interface to serve
+ * @iface: the name of the interface
+ * @config: the IPv4 configuration of the interface
+ * @announce_android_metered: whether to announce ANDROID_METERED
+ * @failed_callback: (allow-none): called when the server fails
+ * @user_data: user data for @failed_callback
+ * @error: location to store the error on failure
+ *
+ * Starts an in-process DHCPv4 server on @ifindex. It serves the same
+ * range and options as the dnsmasq instance of shared connections, but
+ * does not proxy DNS. Clients get the nameservers of @config, if any.
+ * The leases are persisted in the state directory.
+ *
+ * Returns: the new server, or %NULL on failure.
+ */
+NMDhcpServer *
+nm_dhcp_server_new (int ifindex,
+                    const char *iface,
+                    const NMIP4Config *config,
+                    gboolean announce_android_metered,
+                    NMDhcpServerFailedCallback failed_callback,
+                    gpointer user_data,
+                    GError **error)
+{
+	nm_auto_free_dhcp_server NMDhcpServer *self = NULL;
+	nm_auto (n_dhcp4_server_config_freep) NDhcp4ServerConfig *server_config = NULL;
+	const NMPlatformIP4Address *address;
+	gs_free char *error_desc = NULL;
+	char first_s[INET_ADDRSTRLEN];
+	char last_s[INET_ADDRSTRLEN];
+	in_addr_t first, last;
+	guint i, n;
+	int fd, r;
+
+	g_return_val_if_fail (ifindex > 0, NULL);
+	g_return_val_if_fail (iface, NULL);
+	g_return_val_if_fail (NM_IS_IP4_CONFIG (config), NULL);
+
+	address = nm_ip4_config_get_first_address (config);
+	g_return_val_if_fail (address, NULL);
+
+	if (!nm_dnsmasq_utils_get_range (address, first_s, last_s, &error_desc)) {
+		g_set_error_literal (error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN, error_desc);
+		return NULL;
+	}
+	if (   !nm_utils_parse_inaddr_bin (AF_INET, first_s, NULL, &first)
+	    || !nm_utils_parse_inaddr_bin (AF_INET, last_s, NULL, &last))
+		g_return_val_if_reached (NULL);
+
+	self = g_slice_new (NMDhcpServer);
+	*self = (NMDhcpServer) {
+		.ifindex                  = ifindex,
+		.iface                    = g_strdup (iface),
+		.lease_file               = g_strdup_printf ("%s/dhcp-server-%s.leases", NMSTATEDIR, iface),
+		.pool                     = nm_dhcp_server_pool_new (first, last),
+		.address                  = address->address,
+		.netmask                  = _nm_utils_ip4_prefix_to_netmask (address->plen),
+		.dns                      = g_array_new (FALSE, FALSE, sizeof (in_addr_t)),
+		.search                   = g_byte_array_new (),
+		.has_router               = !!nm_ip4_config_best_default_route_get (config),
+		.announce_android_metered = announce_android_metered,
+		.failed_callback          = failed_callback,
+		.user_data                = user_data,
+	};
+
+	n = nm_ip4_config_get_num_nameservers (config);
+	for (i = 0; i < n; i++) {
+		in_addr_t ns = nm_ip4_config_get_nameserver (config, i);
+
+		g_array_append_val (self->dns, ns);
+	}
+	if (!n)
+		_LOGD ("no nameservers configured, clients get no DNS server");
+
+	n = nm_ip4_config_get_num_searches (config);
+	for (i = 0; i < n; i++)
+		_search_append (self->search, nm_ip4_config_get_search (config, i));
+
+	r = n_dhcp4_server_config_new (&server_config);
+	if (r) {
+		g_set_error (error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN,
+		             "failed to create server config: error %d", r);
+		return NULL;
+	}
+	n_dhcp4_server_config_set_ifindex (server_config, ifindex);
+
+	r = n_dhcp4_server_new (&self->server, server_config);
+	if (r) {
+		g_set_error (error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN,
+		             "failed to create server: error %d", r);
+		return NULL;
+	}
+
+	r = n_dhcp4_server_add_ip (self->server, &self->server_ip, (struct in_addr) { address->address });
+	if (r) {
+		g_set_error (error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN,
+		             "failed to add server address: error %d", r);
+		return NULL;
+	}
+
+	_leases_load (self);
+
+	n_dhcp4_server_get_fd (self->server, &fd);
+	self->event_source = nm_g_unix_fd_source_new (fd,
+	                                              G_IO_IN,
+	                                              G_PRIORITY_DEFAULT,
+	                                              _event_cb,
+	                                              self,
+	                                              NULL);
+	g_source_attach (self->event_source, NULL);
+
+	_LOGI ("serving %s - %s", first_s, last_s);
+
+	return g_steal_pointer (&self);
+}
+
+void
+nm_dhcp_server_free (NMDhcpServer *self)
+{
+	if (!self)
+		return;
+
+	nm_clear_g_source_inst (&self->event_source);
+	if (self->leases_save_source)
+		_leases_save (self);
+	self->server_ip = n_dhcp4_server_ip_free (self->server_ip);
+	self->server = n_dhcp4_server_unref (self->server);
+	nm_dhcp_server_pool_free (self->pool);
+	g_array_unref (self->dns);
+	g_byte_array_unref (self->search);
+	g_free (self->lease_file);
+	g_free (self->iface);
+	g_slice_free (NMDhcpServer, self);
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#ifndef __NM_DHCP_SERVER_H__
+#define __NM_DHCP_SERVER_H__
+
+#include <netinet/in.h>
+
+#include "nm-ip4-config.h"
+
+/*****************************************************************************/
+
+/* The address pool and lease database of the internal DHCP server. It knows
+ * nothing about the protocol and is exposed for unit tests. */
+typedef struct _NMDhcpServerPool NMDhcpServerPool;
+
+NMDhcpServerPool *nm_dhcp_server_pool_new (in_addr_t first, in_addr_t last);
+void nm_dhcp_server_pool_free (NMDhcpServerPool *pool);
+
+guint nm_dhcp_server_pool_get_num_leases (NMDhcpServerPool *pool);
+
+in_addr_t nm_dhcp_server_pool_pick (NMDhcpServerPool *pool,
+                                    const guint8 *client_id,
+                                    gsize client_id_len,
+                                    in_addr_t requested,
+                                    gint64 now);
+
+in_addr_t nm_dhcp_server_pool_lookup (NMDhcpServerPool *pool,
+                                      const guint8 *client_id,
+                                      gsize client_id_len);
+
+gboolean nm_dhcp_server_pool_bind (NMDhcpServerPool *pool,
+                                   const guint8 *client_id,
+                                   gsize client_id_len,
+                                   const guint8 *chaddr,
+                                   gsize chaddr_len,
+                                   in_addr_t address,
+                                   gint64 expiry,
+                                   gint64 now);
+
+gboolean nm_dhcp_server_pool_release (NMDhcpServerPool *pool,
+                                      const guint8 *client_id,
+                                      gsize client_id_len,
+                                      in_addr_t address);
+
+void nm_dhcp_server_pool_decline (NMDhcpServerPool *pool,
+                                  in_addr_t address,
+                                  gint64 expiry);
+
+char *nm_dhcp_server_pool_to_string (NMDhcpServerPool *pool, gint64 now);
+guint nm_dhcp_server_pool_load (NMDhcpServerPool *pool, const char *contents, gint64 now);
+
+/*****************************************************************************/
+
+typedef struct _NMDhcpServer NMDhcpServer;
+
+typedef void (*NMDhcpServerFailedCallback) (NMDhcpServer *self,
+                                            gpointer user_data);
+
+NMDhcpServer *nm_dhcp_server_new (int ifindex,
+                                  const char *iface,
+                                  const NMIP4Config *config,
+                                  gboolean announce_android_metered,
+                                  NMDhcpServerFailedCallback failed_callback,
+                                  gpointer user_data,
+                                  GError **error);
+
+void nm_dhcp_server_free (NMDhcpServer *self);
+
+NM_AUTO_DEFINE_FCN0 (NMDhcpServer *, _nm_auto_free_dhcp_server, nm_dhcp_server_free);
+#define nm_auto_free_dhcp_server nm_auto (_nm_auto_free_dhcp_server)
+
+#endif /* __NM_DHCP_SERVER_H__ */
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <arpa/inet.h>
+
+#include "dhcp/nm-dhcp-server.h"
+
+#include "nm-test-utils-core.h"
+
+#define NOW 1000000
+
+#define CLIENT(name) ((const guint8 *) ""name""), NM_STRLEN (name)
+
+static const guint8 chaddr[] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 };
+
+static NMDhcpServerPool *
+_pool_new (const char *first, const char *last)
+{
+	return nm_dhcp_server_pool_new (nmtst_inet4_from_string (first),
+	                                nmtst_inet4_from_string (last));
+}
+
+static void
+test_pool_pick (void)
+{
+	NMDhcpServerPool *pool;
+	in_addr_t a;
+
+	pool = _pool_new ("192.168.1.10", "192.168.1.12");
+
+	/* the lowest free address, unless the client asks for a valid one */
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("a"), 0, NOW);
+	nmtst_assert_ip4_address (a, "192.168.1.10");
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("a"), nmtst_inet4_from_string ("192.168.1.11"), NOW);
+	nmtst_assert_ip4_address (a, "192.168.1.11");
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("a"), nmtst_inet4_from_string ("10.0.0.1"), NOW);
+	nmtst_assert_ip4_address (a, "192.168.1.10");
+
+	/* picking does not reserve the address */
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("b"), 0, NOW);
+	nmtst_assert_ip4_address (a, "192.168.1.10");
+	g_assert_cmpint (nm_dhcp_server_pool_get_num_leases (pool), ==, 0);
+
+	/* a bound client always gets its address */
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("a"), chaddr, sizeof (chaddr),
+	                                    nmtst_inet4_from_string ("192.168.1.11"), NOW + 60, NOW));
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("a"), nmtst_inet4_from_string ("192.168.1.12"), NOW);
+	nmtst_assert_ip4_address (a, "192.168.1.11");
+
+	/* nobody else gets it, as long as the lease is valid */
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("b"), nmtst_inet4_from_string ("192.168.1.11"), NOW);
+	nmtst_assert_ip4_address (a, "192.168.1.10");
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("b"), nmtst_inet4_from_string ("192.168.1.11"), NOW + 60);
+	nmtst_assert_ip4_address (a, "192.168.1.11");
+
+	/* exhaust the pool */
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("b"), NULL, 0,
+	                                    nmtst_inet4_from_string ("192.168.1.10"), NOW + 60, NOW));
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("c"), NULL, 0,
+	                                    nmtst_inet4_from_string ("192.168.1.12"), NOW + 60, NOW));
+	g_assert_cmpint (nm_dhcp_server_pool_pick (pool, CLIENT ("d"), 0, NOW), ==, 0);
+
+	/* a released address becomes free */
+	g_assert (!nm_dhcp_server_pool_release (pool, CLIENT ("c"), nmtst_inet4_from_string ("192.168.1.10")));
+	g_assert (nm_dhcp_server_pool_release (pool, CLIENT ("c"), nmtst_inet4_from_string ("192.168.1.12")));
+	a = nm_dhcp_server_pool_pick (pool, CLIENT ("d"), 0, NOW);
+	nmtst_assert_ip4_address (a, "192.168.1.12");
+
+	/* a declined address is blocked */
+	nm_dhcp_server_pool_decline (pool, nmtst_inet4_from_string ("192.168.1.12"), NOW + 60);
+	g_assert_cmpint (nm_dhcp_server_pool_pick (pool, CLIENT ("d"), 0, NOW), ==, 0);
+	g_assert (!nm_dhcp_server_pool_bind (pool, CLIENT ("d"), NULL, 0,
+	                                     nmtst_inet4_from_string ("192.168.1.12"), NOW + 60, NOW));
+
+	nm_dhcp_server_pool_free (pool);
+}
+
+static void
+test_pool_bind (void)
+{
+	NMDhcpServerPool *pool;
+
+	pool = _pool_new ("10.42.0.10", "10.42.0.100");
+
+	/* addresses outside the range are rejected */
+	g_assert (!nm_dhcp_server_pool_bind (pool, CLIENT ("a"), NULL, 0,
+	                                     nmtst_inet4_from_string ("10.42.0.9"), NOW + 60, NOW));
+	g_assert (!nm_dhcp_server_pool_bind (pool, CLIENT ("a"), NULL, 0,
+	                                     nmtst_inet4_from_string ("10.42.0.101"), NOW + 60, NOW));
+
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("a"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.20"), NOW + 60, NOW));
+	g_assert_cmpint (nm_dhcp_server_pool_get_num_leases (pool), ==, 1);
+	nmtst_assert_ip4_address (nm_dhcp_server_pool_lookup (pool, CLIENT ("a")), "10.42.0.20");
+	g_assert_cmpint (nm_dhcp_server_pool_lookup (pool, CLIENT ("b")), ==, 0);
+
+	/* renewing keeps one lease */
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("a"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.20"), NOW + 120, NOW));
+	g_assert_cmpint (nm_dhcp_server_pool_get_num_leases (pool), ==, 1);
+	nmtst_assert_ip4_address (nm_dhcp_server_pool_lookup (pool, CLIENT ("a")), "10.42.0.20");
+
+	/* another client cannot take the address... */
+	g_assert (!nm_dhcp_server_pool_bind (pool, CLIENT ("b"), NULL, 0,
+	                                     nmtst_inet4_from_string ("10.42.0.20"), NOW + 60, NOW));
+
+	/* ... and failing to do so does not drop its own lease */
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("b"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.30"), NOW + 60, NOW));
+	g_assert (!nm_dhcp_server_pool_bind (pool, CLIENT ("b"), NULL, 0,
+	                                     nmtst_inet4_from_string ("10.42.0.20"), NOW + 60, NOW));
+	g_assert_cmpint (nm_dhcp_server_pool_get_num_leases (pool), ==, 2);
+
+	/* a client moving to another address drops the old lease */
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("a"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.21"), NOW + 60, NOW));
+	g_assert_cmpint (nm_dhcp_server_pool_get_num_leases (pool), ==, 2);
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("c"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.20"), NOW + 60, NOW));
+
+	/* expired leases can be taken over */
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("d"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.30"), NOW + 120, NOW + 60));
+	g_assert_cmpint (nm_dhcp_server_pool_get_num_leases (pool), ==, 3);
+
+	nm_dhcp_server_pool_free (pool);
+}
+
+static void
+test_pool_persist (void)
+{
+	NMDhcpServerPool *pool;
+	gs_free char *contents = NULL;
+	gs_free char *contents2 = NULL;
+
+	pool = _pool_new ("10.42.0.10", "10.42.0.100");
+
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("b"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.12"), NOW + 60, NOW));
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("a"), chaddr, sizeof (chaddr),
+	                                    nmtst_inet4_from_string ("10.42.0.11"), NOW + 120, NOW));
+	g_assert (nm_dhcp_server_pool_bind (pool, CLIENT ("c"), NULL, 0,
+	                                    nmtst_inet4_from_string ("10.42.0.13"), NOW + 10, NOW));
+	nm_dhcp_server_pool_decline (pool, nmtst_inet4_from_string ("10.42.0.14"), NOW + 60);
+
+	/* sorted by address, without expired leases and declined addresses */
+	contents = nm_dhcp_server_pool_to_string (pool, NOW + 10);
+	g_assert_cmpstr (contents, ==,
+	                 "1000120 00:11:22:33:44:55 10.42.0.11 * 61\n"
+	                 "1000060 * 10.42.0.12 * 62\n");
+	nm_dhcp_server_pool_free (pool);
+
+	/* the lease file survives a restart */
+	pool = _pool_new ("10.42.0.10", "10.42.0.100");
+	g_assert_cmpint (nm_dhcp_server_pool_load (pool, contents, NOW + 10), ==, 2);
+	contents2 = nm_dhcp_server_pool_to_string (pool, NOW + 10);
+	g_assert_cmpstr (contents, ==, contents2);
+	nmtst_assert_ip4_address (nm_dhcp_server_pool_pick (pool, CLIENT ("a"), 0, NOW + 10), "10.42.0.11");
+	nm_dhcp_server_pool_free (pool);
+
+	/* expired, invalid and out of range lines are skipped */
+	pool = _pool_new ("10.42.0.10", "10.42.0.100");
+	g_assert_cmpint (nm_dhcp_server_pool_load (pool,
+	                                           "1000120 00:11:22:33:44:55 10.42.0.11 * 61\n"
+	                                           "1000060 * 10.42.0.12 * 62\n"
+	                                           "1000120 * 10.42.1.12 * 63\n"
+	                                           "1000120 * 10.42.0.13 * zz\n"
+	                                           "1000120 * 10.42.0.14 *\n"
+	                                           "garbage\n"
+	                                           "\n",
+	                                           NOW + 60),
+	                 ==, 1);
+	nm_dhcp_server_pool_free (pool);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init_assert_logging (&argc, &argv, "WARN", "DEFAULT");
+
+	g_test_add_func ("/dhcp/server/pool-pick", test_pool_pick);
+	g_test_add_func ("/dhcp/server/pool-bind", test_pool_bind);
+	g_test_add_func ("/dhcp/server/pool-persist", test_pool_persist);
+
+	return g_test_run ();
+}
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#ifndef __NETWORKMANAGER_DNS_MANAGER_PRIVATE_H__
+#define __NETWORKMANAGER_DNS_MANAGER_PRIVATE_H__
+
+#include <sys/stat.h>
+
+#include "nm-dns-manager.h"
+
+/* Internals of the DNS manager, only used by its implementation and the unit tests */
+
+/* The content that was last written to a set of files, together with
+ * the state of the files right after writing them. */
+typedef struct {
+	char *content;
+	const char *const*paths;
+	guint n_paths;
+	struct stat st[2];
+} NMDnsWrittenContent;
+
+char *nmtst_dns_state_hash (const NMIPConfig *const*ip_configs,
+                            guint len,
+                            const char *hostname);
+
+gint64 nmtst_dns_update_delay_msec (gint64 last_msec, guint delay_msec, gint64 now_msec);
+
+void nmtst_dns_written_content_set (NMDnsWrittenContent *wc,
+                                    const char *const*paths,
+                                    guint n_paths,
+                                    const char *content);
+gboolean nmtst_dns_written_content_unchanged (const NMDnsWrittenContent *wc,
+                                              const char *content);
+
+#endif /* __NETWORKMANAGER_DNS_MANAGER_PRIVATE_H__ */
@@ -24,7 +24,7 @@
 
 #include "nm-utils.h"
 #include "nm-core-internal.h"
-#include "nm-dns-manager.h"
+#include "nm-dns-manager-private.h"
 #include "nm-ip4-config.h"
 #include "nm-ip6-config.h"
 #include "NetworkManagerUtils.h"
@@ -77,6 +77,7 @@ NM_GOBJECT_PROPERTIES_DEFINE (NMDnsManager,
 	PROP_MODE,
 	PROP_RC_MANAGER,
 	PROP_CONFIGURATION,
+	PROP_UPDATE_STATISTICS,
 );
 
 static guint signals[LAST_SIGNAL] = { 0 };
@@ -100,6 +101,17 @@ typedef struct {
 	guint8 hash[HASH_LEN];  /* SHA1 hash of current DNS config */
 	guint8 prev_hash[HASH_LEN];  /* Hash when begin_updates() was called */
 
+	/* Hash of everything that the last successful update_dns() applied */
+	guint8 state_hash[HASH_LEN];
+	bool state_hash_valid:1;
+
+	/* The content last written by the resolv.conf manager, to the
+	 * private resolv.conf and to the no-stub resolv.conf. */
+	NMDnsWrittenContent resolv_conf_written;
+	NMDnsManagerResolvConfManager resolv_conf_written_rc_manager;
+	NMDnsWrittenContent my_resolv_conf_written;
+	NMDnsWrittenContent no_stub_resolv_conf_written;
+
 	NMDnsManagerResolvConfManager rc_manager;
 	char *mode;
 	NMDnsPlugin *sd_resolve_plugin;
@@ -112,6 +124,19 @@ typedef struct {
 		guint num_restarts;
 		guint timer;
 	} plugin_ratelimit;
+
+	struct {
+		gint64 last_msec;
+		guint delay_msec;
+		guint timer;
+	} update_ratelimit;
+
+	struct {
+		guint64 updates;
+		guint64 coalesced;
+		guint64 unchanged;
+		guint64 resolv_conf_unchanged;
+	} stats;
 } NMDnsManagerPrivate;
 
 struct _NMDnsManager {
@@ -806,17 +831,104 @@ _read_link_cached (const char *path, gboolean *is_cached, char **cached)
 
 #define NO_STUB_RESOLV_CONF        NMRUNDIR "/no-stub-resolv.conf"
 
+static const char *const resolv_conf_paths[] = { _PATH_RESCONF, MY_RESOLV_CONF };
+static const char *const my_resolv_conf_paths[] = { MY_RESOLV_CONF };
+static const char *const no_stub_resolv_conf_paths[] = { NO_STUB_RESOLV_CONF };
+
+static void
+_written_content_clear (NMDnsWrittenContent *wc)
+{
+	nm_clear_g_free (&wc->content);
+}
+
+static void
+_written_content_set (NMDnsWrittenContent *wc,
+                      const char *const*paths,
+                      guint n_paths,
+                      const char *content)
+{
+	guint i;
+
+	nm_assert (n_paths <= G_N_ELEMENTS (wc->st));
+
+	nm_clear_g_free (&wc->content);
+	for (i = 0; i < n_paths; i++) {
+		if (stat (paths[i], &wc->st[i]) != 0)
+			return;
+	}
+	wc->content = g_strdup (content);
+	wc->paths = paths;
+	wc->n_paths = n_paths;
+}
+
+/* Whether the files are still as we wrote them. Another process might
+ * have modified or replaced them in the meantime, in which case they
+ * must be written again. */
+static gboolean
+_written_content_files_unchanged (const NMDnsWrittenContent *wc)
+{
+	struct stat st;
+	guint i;
+
+	if (!wc->content)
+		return TRUE;
+
+	for (i = 0; i < wc->n_paths; i++) {
+		if (stat (wc->paths[i], &st) != 0)
+			return FALSE;
+		if (   st.st_dev != wc->st[i].st_dev
+		    || st.st_ino != wc->st[i].st_ino
+		    || st.st_size != wc->st[i].st_size
+		    || st.st_mtim.tv_sec != wc->st[i].st_mtim.tv_sec
+		    || st.st_mtim.tv_nsec != wc->st[i].st_mtim.tv_nsec)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+_written_content_unchanged (const NMDnsWrittenContent *wc, const char *content)
+{
+	return    wc->content
+	       && nm_streq (wc->content, content)
+	       && _written_content_files_unchanged (wc);
+}
+
+void
+nmtst_dns_written_content_set (NMDnsWrittenContent *wc,
+                               const char *const*paths,
+                               guint n_paths,
+                               const char *content)
+{
+	_written_content_set (wc, paths, n_paths, content);
+}
+
+gboolean
+nmtst_dns_written_content_unchanged (const NMDnsWrittenContent *wc,
+                                     const char *content)
+{
+	return _written_content_unchanged (wc, content);
+}
+
 static void
 update_resolv_conf_no_stub (NMDnsManager *self,
                             const char *const*searches,
                             const char *const*nameservers,
                             const char *const*options)
 {
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
 	gs_free char *content = NULL;
 	GError *local = NULL;
 
 	content = create_resolv_conf (searches, nameservers, options);
 
+	if (_written_content_unchanged (&priv->no_stub_resolv_conf_written, content)) {
+		_LOGT ("update-resolv-no-stub: '%s' is unchanged",
+		       NO_STUB_RESOLV_CONF);
+		return;
+	}
+	_written_content_clear (&priv->no_stub_resolv_conf_written);
+
 	if (!g_file_set_contents (NO_STUB_RESOLV_CONF,
 	                          content,
 	                          -1,
@@ -829,26 +941,25 @@ update_resolv_conf_no_stub (NMDnsManager *self,
 
 	_LOGT ("update-resolv-no-stub: '%s' successfully written",
 	       NO_STUB_RESOLV_CONF);
+	_written_content_set (&priv->no_stub_resolv_conf_written,
+	                      no_stub_resolv_conf_paths,
+	                      G_N_ELEMENTS (no_stub_resolv_conf_paths),
+	                      content);
 }
 
 static SpawnResult
 update_resolv_conf (NMDnsManager *self,
-                    const char *const*searches,
-                    const char *const*nameservers,
-                    const char *const*options,
+                    const char *content,
                     GError **error,
                     NMDnsManagerResolvConfManager rc_manager)
 {
 	FILE *f;
 	gboolean success;
-	gs_free char *content = NULL;
 	SpawnResult write_file_result = SR_SUCCESS;
 	int errsv;
 	gboolean resconf_link_cached = FALSE;
 	gs_free char *resconf_link = NULL;
 
-	content = create_resolv_conf (searches, nameservers, options);
-
 	if (   rc_manager == NM_DNS_MANAGER_RESOLV_CONF_MAN_FILE
 	    || (   rc_manager == NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK
 	        && !_read_link_cached (_PATH_RESCONF, &resconf_link_cached, &resconf_link))) {
@@ -1032,15 +1143,103 @@ compute_hash (NMDnsManager *self, const NMGlobalDnsConfig *global, guint8 buffer
 		const CList *head;
 
 		/* FIXME(ip-config-checksum): this relies on the fact that an IP
-		 * configuration without DNS parameters gives a zero checksum. */
+		 * configuration without DNS parameters gives a zero fingerprint.
+		 *
+		 * The IP configurations maintain their fingerprint, so we only
+		 * hash that instead of all their DNS parameters. */
 		head = _ip_config_lst_head (self);
-		c_list_for_each_entry (ip_data, head, ip_config_lst)
-			nm_ip_config_hash (ip_data->ip_config, sum, TRUE);
+		c_list_for_each_entry (ip_data, head, ip_config_lst) {
+			guint64 fingerprint;
+
+			fingerprint = nm_ip_config_get_fingerprint (ip_data->ip_config, TRUE);
+			if (fingerprint != 0)
+				g_checksum_update (sum, (const guint8 *) &fingerprint, sizeof (fingerprint));
+		}
 	}
 
 	nm_utils_checksum_get_digest_len (sum, buffer, HASH_LEN);
 }
 
+static void
+_state_hash_add_ip_config (GChecksum *sum,
+                           const NMIPConfig *ip_config,
+                           int ifindex,
+                           NMDnsIPConfigType ip_config_type)
+{
+	struct {
+		guint64 fingerprint;
+		int ifindex;
+		int addr_family;
+		int ip_config_type;
+		int dns_priority;
+	} entry;
+
+	memset (&entry, 0, sizeof (entry));
+	entry.fingerprint = nm_ip_config_get_fingerprint (ip_config, FALSE);
+	entry.ifindex = ifindex;
+	entry.addr_family = nm_ip_config_get_addr_family (ip_config);
+	entry.ip_config_type = ip_config_type;
+	entry.dns_priority = nm_ip_config_get_dns_priority (ip_config);
+	g_checksum_update (sum, (const guint8 *) &entry, sizeof (entry));
+}
+
+static void
+_state_hash_add_hostname (GChecksum *sum, const char *hostname)
+{
+	hostname = hostname ?: "";
+	g_checksum_update (sum, (const guint8 *) hostname, strlen (hostname) + 1);
+}
+
+/* Unlike compute_hash(), this covers everything that update_dns() passes
+ * on to resolv.conf and to the plugins, so that an update can be skipped
+ * altogether when nothing changed since the last successful one. */
+static void
+compute_state_hash (NMDnsManager *self, const NMGlobalDnsConfig *global, guint8 buffer[HASH_LEN])
+{
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+	nm_auto_free_checksum GChecksum *sum = NULL;
+	NMDnsIPConfigData *ip_data;
+	const CList *head;
+
+	sum = g_checksum_new (G_CHECKSUM_SHA1);
+
+	if (global)
+		nm_global_dns_config_update_checksum (global, sum);
+
+	head = _ip_config_lst_head (self);
+	c_list_for_each_entry (ip_data, head, ip_config_lst) {
+		_state_hash_add_ip_config (sum,
+		                           ip_data->ip_config,
+		                           ip_data->data->ifindex,
+		                           ip_data->ip_config_type);
+	}
+
+	_state_hash_add_hostname (sum, priv->hostname);
+
+	nm_utils_checksum_get_digest_len (sum, buffer, HASH_LEN);
+}
+
+char *
+nmtst_dns_state_hash (const NMIPConfig *const*ip_configs,
+                      guint len,
+                      const char *hostname)
+{
+	nm_auto_free_checksum GChecksum *sum = NULL;
+	guint8 buffer[HASH_LEN];
+	guint i;
+
+	sum = g_checksum_new (G_CHECKSUM_SHA1);
+	for (i = 0; i < len; i++) {
+		_state_hash_add_ip_config (sum,
+		                           ip_configs[i],
+		                           nm_ip_config_get_ifindex (ip_configs[i]),
+		                           NM_DNS_IP_CONFIG_TYPE_DEFAULT);
+	}
+	_state_hash_add_hostname (sum, hostname);
+	nm_utils_checksum_get_digest_len (sum, buffer, HASH_LEN);
+	return nm_utils_bin2hexstr_full (buffer, HASH_LEN, '\0', FALSE, NULL);
+}
+
 static gboolean
 merge_global_dns_config (NMResolvConfData *rc, NMGlobalDnsConfig *global_conf)
 {
@@ -1433,12 +1632,16 @@ update_dns (NMDnsManager *self,
 	gs_strfreev char **options = NULL;
 	gs_strfreev char **nameservers = NULL;
 	gs_strfreev char **nis_servers = NULL;
+	gs_free char *content = NULL;
 	gboolean caching = FALSE;
 	gboolean do_update = TRUE;
 	gboolean resolv_conf_updated = FALSE;
+	gboolean resolv_conf_unchanged = FALSE;
+	gboolean plugin_failed = FALSE;
 	SpawnResult result = SR_SUCCESS;
 	NMConfigData *data;
 	NMGlobalDnsConfig *global_config;
+	guint8 state_hash[HASH_LEN];
 	gs_free_error GError *local_error = NULL;
 	GError **const p_local_error =   error
 	                               ? &local_error
@@ -1446,13 +1649,43 @@ update_dns (NMDnsManager *self,
 
 	nm_assert (!error || !*error);
 
+	nm_clear_g_source (&priv->update_ratelimit.timer);
+
 	if (priv->is_stopped) {
 		_LOGD ("update-dns: not updating resolv.conf (is stopped)");
 		return TRUE;
 	}
 
+	priv->update_ratelimit.last_msec = nm_utils_get_monotonic_timestamp_msec ();
+
 	nm_clear_g_source (&priv->plugin_ratelimit.timer);
 
+	data = nm_config_get_data (priv->config);
+	global_config = nm_config_data_get_global_dns_config (data);
+
+	/* Update hash with config we're applying */
+	compute_hash (self, global_config, priv->hash);
+
+	/* The IP configurations maintain their fingerprints, so this is cheap
+	 * compared to collecting the data and rendering resolv.conf. */
+	compute_state_hash (self, global_config, state_hash);
+	if (   !no_caching
+	    && priv->state_hash_valid
+	    && memcmp (state_hash, priv->state_hash, HASH_LEN) == 0
+	    && _written_content_files_unchanged (&priv->resolv_conf_written)
+	    && _written_content_files_unchanged (&priv->my_resolv_conf_written)
+	    && _written_content_files_unchanged (&priv->no_stub_resolv_conf_written)) {
+		_LOGD ("update-dns: DNS configuration unchanged");
+		priv->stats.unchanged++;
+		_notify (self, PROP_UPDATE_STATISTICS);
+		return TRUE;
+	}
+	priv->state_hash_valid = FALSE;
+	priv->stats.updates++;
+	/* resolv-conf-unchanged below is covered by the same notification,
+	 * the D-Bus signal is only emitted on idle. */
+	_notify (self, PROP_UPDATE_STATISTICS);
+
 	if (NM_IN_SET (priv->rc_manager, NM_DNS_MANAGER_RESOLV_CONF_MAN_UNMANAGED,
 	                                 NM_DNS_MANAGER_RESOLV_CONF_MAN_IMMUTABLE)) {
 		do_update = FALSE;
@@ -1462,12 +1695,6 @@ update_dns (NMDnsManager *self,
 		_LOGD ("update-dns: updating resolv.conf");
 	}
 
-	data = nm_config_get_data (priv->config);
-	global_config = nm_config_data_get_global_dns_config (data);
-
-	/* Update hash with config we're applying */
-	compute_hash (self, global_config, priv->hash);
-
 	_collect_resolv_conf_data (self, global_config,
 	                           &searches, &options, &nameservers,
 	                           &nis_servers, &nis_domain);
@@ -1510,6 +1737,7 @@ update_dns (NMDnsManager *self,
 			 * caching DNS configuration to resolv.conf.
 			 */
 			caching = FALSE;
+			plugin_failed = TRUE;
 		}
 
 plugin_skip:
@@ -1543,14 +1771,35 @@ plugin_skip:
 		nameservers[0] = g_strdup (lladdr);
 	}
 
-	if (do_update) {
+	content = create_resolv_conf (NM_CAST_STRV_CC (searches),
+	                              NM_CAST_STRV_CC (nameservers),
+	                              NM_CAST_STRV_CC (options));
+
+	if (   do_update
+	    && priv->rc_manager != NM_DNS_MANAGER_RESOLV_CONF_MAN_NETCONFIG
+	    && priv->resolv_conf_written_rc_manager == priv->rc_manager
+	    && _written_content_unchanged (&priv->resolv_conf_written, content)) {
+		/* netconfig also gets the NIS configuration, which is not part of
+		 * the content. For the others, there is nothing to do. */
+		_LOGD ("update-dns: resolv.conf unchanged");
+		priv->stats.resolv_conf_unchanged++;
+		resolv_conf_unchanged = TRUE;
+		resolv_conf_updated = TRUE;
+		if (   NM_IN_SET (priv->rc_manager, NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK,
+		                                    NM_DNS_MANAGER_RESOLV_CONF_MAN_FILE)
+		    && !nameservers
+		    && !options)
+			priv->dns_touched = FALSE;
+	} else if (do_update) {
+		gboolean fallback = FALSE;
+
+		_written_content_clear (&priv->resolv_conf_written);
+
 		switch (priv->rc_manager) {
 		case NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK:
 		case NM_DNS_MANAGER_RESOLV_CONF_MAN_FILE:
 			result = update_resolv_conf (self,
-			                             NM_CAST_STRV_CC (searches),
-			                             NM_CAST_STRV_CC (nameservers),
-			                             NM_CAST_STRV_CC (options),
+			                             content,
 			                             p_local_error,
 			                             priv->rc_manager);
 			resolv_conf_updated = TRUE;
@@ -1582,34 +1831,58 @@ plugin_skip:
 			_LOGD ("update-dns: program not available, writing to resolv.conf");
 			g_clear_error (&local_error);
 			result = update_resolv_conf (self,
-			                             NM_CAST_STRV_CC (searches),
-			                             NM_CAST_STRV_CC (nameservers),
-			                             NM_CAST_STRV_CC (options),
+			                             content,
 			                             p_local_error,
 			                             NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK);
 			resolv_conf_updated = TRUE;
+			fallback = TRUE;
+		}
+
+		if (   result == SR_SUCCESS
+		    && !fallback) {
+			/* resolvconf writes the files itself, only compare the content. */
+			_written_content_set (&priv->resolv_conf_written,
+			                      resolv_conf_paths,
+			                      priv->rc_manager == NM_DNS_MANAGER_RESOLV_CONF_MAN_RESOLVCONF
+			                        ? 0
+			                        : G_N_ELEMENTS (resolv_conf_paths),
+			                      content);
+			priv->resolv_conf_written_rc_manager = priv->rc_manager;
 		}
 	}
 
 	/* Unless we've already done it, update private resolv.conf in NMRUNDIR
 	   ignoring any errors */
-	if (!resolv_conf_updated) {
-		update_resolv_conf (self,
-		                    NM_CAST_STRV_CC (searches),
-		                    NM_CAST_STRV_CC (nameservers),
-		                    NM_CAST_STRV_CC (options),
-		                    NULL,
-		                    NM_DNS_MANAGER_RESOLV_CONF_MAN_UNMANAGED);
+	if (   !resolv_conf_updated
+	    && !_written_content_unchanged (&priv->my_resolv_conf_written, content)) {
+		_written_content_clear (&priv->my_resolv_conf_written);
+		if (update_resolv_conf (self,
+		                        content,
+		                        NULL,
+		                        NM_DNS_MANAGER_RESOLV_CONF_MAN_UNMANAGED) == SR_SUCCESS) {
+			_written_content_set (&priv->my_resolv_conf_written,
+			                      my_resolv_conf_paths,
+			                      G_N_ELEMENTS (my_resolv_conf_paths),
+			                      content);
+		}
 	}
 
 	/* signal that resolv.conf was changed */
 	if (   do_update
-	    && result == SR_SUCCESS)
+	    && result == SR_SUCCESS
+	    && !resolv_conf_unchanged)
 		g_signal_emit (self, signals[CONFIG_CHANGED], 0);
 
 	nm_clear_pointer (&priv->config_variant, g_variant_unref);
 	_notify (self, PROP_CONFIGURATION);
 
+	if (   result == SR_SUCCESS
+	    && !plugin_failed
+	    && !no_caching) {
+		memcpy (priv->state_hash, state_hash, HASH_LEN);
+		priv->state_hash_valid = TRUE;
+	}
+
 	if (result != SR_SUCCESS) {
 		if (error)
 			g_propagate_error (error, g_steal_pointer (&local_error));
@@ -1620,6 +1893,69 @@ plugin_skip:
 	return TRUE;
 }
 
+/* Returns how long an update must be delayed, so that two updates are
+ * at least @delay_msec apart. */
+static gint64
+_update_delay_msec (gint64 last_msec, guint delay_msec, gint64 now_msec)
+{
+	if (   delay_msec == 0
+	    || last_msec == 0)
+		return 0;
+	return MAX (last_msec + (gint64) delay_msec - now_msec, (gint64) 0);
+}
+
+gint64
+nmtst_dns_update_delay_msec (gint64 last_msec, guint delay_msec, gint64 now_msec)
+{
+	return _update_delay_msec (last_msec, delay_msec, now_msec);
+}
+
+static gboolean
+_update_dns_ratelimit_cb (gpointer user_data)
+{
+	NMDnsManager *self = user_data;
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+	gs_free_error GError *error = NULL;
+
+	priv->update_ratelimit.timer = 0;
+
+	if (!update_dns (self, FALSE, &error))
+		_LOGW ("could not commit DNS changes: %s", error->message);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_update_dns_schedule (NMDnsManager *self)
+{
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+	gs_free_error GError *error = NULL;
+
+	if (priv->update_ratelimit.timer) {
+		/* the scheduled update will also pick up this change. */
+		priv->stats.coalesced++;
+		_notify (self, PROP_UPDATE_STATISTICS);
+		return;
+	}
+
+	if (priv->update_ratelimit.delay_msec > 0) {
+		gint64 delay_msec;
+
+		delay_msec = _update_delay_msec (priv->update_ratelimit.last_msec,
+		                                 priv->update_ratelimit.delay_msec,
+		                                 nm_utils_get_monotonic_timestamp_msec ());
+		if (delay_msec > 0) {
+			_LOGT ("update-dns: delay update by %u msec", (guint) delay_msec);
+			priv->update_ratelimit.timer = g_timeout_add ((guint) delay_msec,
+			                                              _update_dns_ratelimit_cb,
+			                                              self);
+			return;
+		}
+	}
+
+	if (!update_dns (self, FALSE, &error))
+		_LOGW ("could not commit DNS changes: %s", error->message);
+}
+
 /*****************************************************************************/
 
 static void
@@ -1710,12 +2046,8 @@ nm_dns_manager_set_ip_config (NMDnsManager *self,
 	}
 
 changed:
-	if (!priv->updates_queue) {
-		gs_free_error GError *error = NULL;
-
-		if (!update_dns (self, FALSE, &error))
-			_LOGW ("could not commit DNS changes: %s", error->message);
-	}
+	if (!priv->updates_queue)
+		_update_dns_schedule (self);
 
 	return TRUE;
 }
@@ -1756,12 +2088,8 @@ nm_dns_manager_set_hostname (NMDnsManager *self,
 	if (skip_update)
 		return;
 
-	if (!priv->updates_queue) {
-		gs_free_error GError *error = NULL;
-
-		if (!update_dns (self, FALSE, &error))
-			_LOGW ("could not commit DNS changes: %s", error->message);
-	}
+	if (!priv->updates_queue)
+		_update_dns_schedule (self);
 }
 
 void
@@ -1785,7 +2113,6 @@ void
 nm_dns_manager_end_updates (NMDnsManager *self, const char *func)
 {
 	NMDnsManagerPrivate *priv;
-	gs_free_error GError *error = NULL;
 	gboolean changed;
 	guint8 new[HASH_LEN];
 
@@ -1806,8 +2133,7 @@ nm_dns_manager_end_updates (NMDnsManager *self, const char *func)
 
 	/* Commit all the outstanding changes */
 	_LOGD ("(%s): committing DNS changes (%d)", func, priv->updates_queue);
-	if (!update_dns (self, FALSE, &error))
-		_LOGW ("could not commit DNS changes: %s", error->message);
+	_update_dns_schedule (self);
 
 	memset (priv->prev_hash, 0, sizeof (priv->prev_hash));
 }
@@ -1824,6 +2150,14 @@ nm_dns_manager_stop (NMDnsManager *self)
 
 	_LOGT ("stopping...");
 
+	if (priv->update_ratelimit.timer) {
+		gs_free_error GError *error = NULL;
+
+		/* flush the delayed update before shutting down. */
+		if (!update_dns (self, FALSE, &error))
+			_LOGW ("could not commit DNS changes on shutdown: %s", error->message);
+	}
+
 	/* If we're quitting, leave a valid resolv.conf in place, not one
 	 * pointing to 127.0.0.1 if dnsmasq was active.  But if we haven't
 	 * done any DNS updates yet, there's no reason to touch resolv.conf
@@ -2092,6 +2426,7 @@ again:
 	}
 
 	if (param_changed || plugin_changed || systemd_resolved_changed) {
+		priv->state_hash_valid = FALSE;
 		_LOGI ("init: dns=%s%s rc-manager=%s%s%s%s",
 		       mode,
 		       (systemd_resolved ? ",systemd-resolved" : ""),
@@ -2103,6 +2438,28 @@ again:
 	g_object_thaw_notify (G_OBJECT (self));
 }
 
+static void
+_update_ratelimit_reload (NMDnsManager *self, NMConfigData *config_data)
+{
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+
+	priv->update_ratelimit.delay_msec = nm_config_data_get_value_int64 (config_data,
+	                                                                    NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                                                    NM_CONFIG_KEYFILE_KEY_MAIN_DNS_UPDATE_DELAY,
+	                                                                    10, 0, 60000, 0);
+}
+
+static void
+_update_caches_clear (NMDnsManager *self)
+{
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+
+	priv->state_hash_valid = FALSE;
+	_written_content_clear (&priv->resolv_conf_written);
+	_written_content_clear (&priv->my_resolv_conf_written);
+	_written_content_clear (&priv->no_stub_resolv_conf_written);
+}
+
 static void
 config_changed_cb (NMConfig *config,
                    NMConfigData *config_data,
@@ -2110,6 +2467,8 @@ config_changed_cb (NMConfig *config,
                    NMConfigData *old_data,
                    NMDnsManager *self)
 {
+	_update_ratelimit_reload (self, config_data);
+
 	if (NM_FLAGS_ANY (changes, NM_CONFIG_CHANGE_DNS_MODE |
 	                           NM_CONFIG_CHANGE_RC_MANAGER |
 	                           NM_CONFIG_CHANGE_CAUSE_SIGHUP |
@@ -2132,6 +2491,10 @@ config_changed_cb (NMConfig *config,
 	                           NM_CONFIG_CHANGE_GLOBAL_DNS_CONFIG)) {
 		gs_free_error GError *error = NULL;
 
+		/* the files might have been modified behind our back, always
+		 * rewrite them. */
+		_update_caches_clear (self);
+
 		if (!update_dns (self, FALSE, &error))
 			_LOGW ("could not commit DNS changes: %s", error->message);
 	}
@@ -2292,6 +2655,20 @@ _get_config_variant (NMDnsManager *self)
 	return priv->config_variant;
 }
 
+static GVariant *
+_get_update_statistics_variant (NMDnsManager *self)
+{
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+	GVariantBuilder builder;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{st}"));
+	g_variant_builder_add (&builder, "{st}", "updates", (guint64) priv->stats.updates);
+	g_variant_builder_add (&builder, "{st}", "coalesced", (guint64) priv->stats.coalesced);
+	g_variant_builder_add (&builder, "{st}", "unchanged", (guint64) priv->stats.unchanged);
+	g_variant_builder_add (&builder, "{st}", "resolv-conf-unchanged", (guint64) priv->stats.resolv_conf_unchanged);
+	return g_variant_builder_end (&builder);
+}
+
 static void
 get_property (GObject *object, guint prop_id,
               GValue *value, GParamSpec *pspec)
@@ -2309,6 +2686,9 @@ get_property (GObject *object, guint prop_id,
 	case PROP_CONFIGURATION:
 		g_value_set_variant (value, _get_config_variant (self));
 		break;
+	case PROP_UPDATE_STATISTICS:
+		g_value_take_variant (value, _get_update_statistics_variant (self));
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -2332,6 +2712,8 @@ nm_dns_manager_init (NMDnsManager *self)
 	/* Set the initial hash */
 	compute_hash (self, NULL, NM_DNS_MANAGER_GET_PRIVATE (self)->hash);
 
+	_update_ratelimit_reload (self, nm_config_get_data (priv->config));
+
 	g_signal_connect (G_OBJECT (priv->config),
 	                  NM_CONFIG_SIGNAL_CONFIG_CHANGED,
 	                  G_CALLBACK (config_changed_cb),
@@ -2366,6 +2748,7 @@ dispose (GObject *object)
 	nm_clear_pointer (&priv->configs, g_hash_table_destroy);
 
 	nm_clear_g_source (&priv->plugin_ratelimit.timer);
+	nm_clear_g_source (&priv->update_ratelimit.timer);
 
 	g_clear_object (&priv->config);
 
@@ -2382,6 +2765,9 @@ finalize (GObject *object)
 
 	g_free (priv->hostname);
 	g_free (priv->mode);
+	_written_content_clear (&priv->resolv_conf_written);
+	_written_content_clear (&priv->my_resolv_conf_written);
+	_written_content_clear (&priv->no_stub_resolv_conf_written);
 
 	G_OBJECT_CLASS (nm_dns_manager_parent_class)->finalize (object);
 }
@@ -2390,9 +2776,10 @@ static const NMDBusInterfaceInfoExtended interface_info_dns_manager = {
 	.parent = NM_DEFINE_GDBUS_INTERFACE_INFO_INIT (
 		NM_DBUS_INTERFACE_DNS_MANAGER,
 		.properties = NM_DEFINE_GDBUS_PROPERTY_INFOS (
-			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L ("Mode",          "s",      NM_DNS_MANAGER_MODE),
-			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L ("RcManager",     "s",      NM_DNS_MANAGER_RC_MANAGER),
-			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L ("Configuration", "aa{sv}", NM_DNS_MANAGER_CONFIGURATION),
+			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L ("Mode",             "s",      NM_DNS_MANAGER_MODE),
+			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L ("RcManager",        "s",      NM_DNS_MANAGER_RC_MANAGER),
+			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L ("Configuration",    "aa{sv}", NM_DNS_MANAGER_CONFIGURATION),
+			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L ("UpdateStatistics", "a{st}",  NM_DNS_MANAGER_UPDATE_STATISTICS),
 		),
 	),
 };
@@ -2430,6 +2817,13 @@ nm_dns_manager_class_init (NMDnsManagerClass *klass)
 	                          G_PARAM_READABLE |
 	                          G_PARAM_STATIC_STRINGS);
 
+	obj_properties[PROP_UPDATE_STATISTICS] =
+	    g_param_spec_variant (NM_DNS_MANAGER_UPDATE_STATISTICS, "", "",
+	                          G_VARIANT_TYPE ("a{st}"),
+	                          NULL,
+	                          G_PARAM_READABLE |
+	                          G_PARAM_STATIC_STRINGS);
+
 	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
 
 	signals[CONFIG_CHANGED] =
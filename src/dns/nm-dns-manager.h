@@ -57,6 +57,7 @@ typedef struct _NMDnsConfigData {
 #define NM_DNS_MANAGER_MODE "mode"
 #define NM_DNS_MANAGER_RC_MANAGER "rc-manager"
 #define NM_DNS_MANAGER_CONFIGURATION "configuration"
+#define NM_DNS_MANAGER_UPDATE_STATISTICS "update-statistics"
 
 /* internal signals */
 #define NM_DNS_MANAGER_CONFIG_CHANGED "config-changed"
@@ -21,6 +21,43 @@
 
 /*****************************************************************************/
 
+/* Gateways and routes are tracked in a hash table for lookup by their key and
+ * in a min-heap ordered by their expiry. The arrays in NMNDiscDataInternal
+ * (which are exposed via NMNDiscData) are only regenerated when the data gets
+ * emitted. Hence, processing an RA is proportional to the number of options in
+ * it, and the lifetime check only looks at the items that actually expire. */
+
+typedef struct {
+	gint64 expiry;
+	guint64 seq;
+	guint heap_idx;
+} NDiscItem;
+
+typedef struct {
+	NDiscItem item;
+	NMNDiscGateway gateway;
+} NDiscGatewayItem;
+
+typedef struct {
+	NDiscItem item;
+	NMNDiscRoute route;
+} NDiscRouteItem;
+
+typedef struct {
+	GHashTable *lookup;
+
+	/* a min-heap of all items, ordered by their expiry. */
+	GPtrArray *heap;
+
+	/* a counter to remember the insertion order of the items. */
+	guint64 seq;
+
+	/* whether the array in NMNDiscDataInternal is out of date. */
+	bool dirty:1;
+} NDiscIndex;
+
+/*****************************************************************************/
+
 struct _NMNDiscPrivate {
 	/* this *must* be the first field. */
 	NMNDiscDataInternal rdata;
@@ -56,6 +93,9 @@ struct _NMNDiscPrivate {
 
 	NMPlatform *platform;
 	NMPNetns *netns;
+
+	NDiscIndex gateways_idx;
+	NDiscIndex routes_idx;
 };
 
 typedef struct _NMNDiscPrivate NMNDiscPrivate;
@@ -183,6 +223,238 @@ _get_exp (char *buf, gsize buf_size, gint64 now_ns, gint64 expiry_time)
 
 /*****************************************************************************/
 
+static gboolean
+_heap_less (const GPtrArray *heap, guint a, guint b)
+{
+	return ((const NDiscItem *) heap->pdata[a])->expiry < ((const NDiscItem *) heap->pdata[b])->expiry;
+}
+
+static void
+_heap_swap (GPtrArray *heap, guint a, guint b)
+{
+	NDiscItem *item_a = heap->pdata[a];
+	NDiscItem *item_b = heap->pdata[b];
+
+	heap->pdata[a] = item_b;
+	item_b->heap_idx = a;
+	heap->pdata[b] = item_a;
+	item_a->heap_idx = b;
+}
+
+static void
+_heap_sift (GPtrArray *heap, guint idx)
+{
+	while (idx > 0) {
+		guint parent = (idx - 1) / 2;
+
+		if (!_heap_less (heap, idx, parent))
+			break;
+		_heap_swap (heap, idx, parent);
+		idx = parent;
+	}
+
+	for (;;) {
+		guint child = 2 * idx + 1;
+		guint smallest = idx;
+
+		if (   child < heap->len
+		    && _heap_less (heap, child, smallest))
+			smallest = child;
+		if (   child + 1 < heap->len
+		    && _heap_less (heap, child + 1, smallest))
+			smallest = child + 1;
+		if (smallest == idx)
+			break;
+		_heap_swap (heap, idx, smallest);
+		idx = smallest;
+	}
+}
+
+static void
+_index_init (NDiscIndex *index,
+             GHashFunc hash_func,
+             GEqualFunc equal_func,
+             GDestroyNotify free_func)
+{
+	index->lookup = g_hash_table_new_full (hash_func, equal_func, free_func, NULL);
+	index->heap = g_ptr_array_new ();
+}
+
+static void
+_index_clear (NDiscIndex *index)
+{
+	nm_clear_pointer (&index->heap, g_ptr_array_unref);
+	nm_clear_pointer (&index->lookup, g_hash_table_unref);
+}
+
+static gpointer
+_index_lookup (const NDiscIndex *index, gconstpointer needle)
+{
+	return g_hash_table_lookup (index->lookup, needle);
+}
+
+static NDiscItem *
+_index_peek_first_expiry (const NDiscIndex *index)
+{
+	return index->heap->len > 0 ? index->heap->pdata[0] : NULL;
+}
+
+static void
+_index_add (NDiscIndex *index, NDiscItem *item, gint64 expiry)
+{
+	item->expiry = expiry;
+	item->seq = ++index->seq;
+	item->heap_idx = index->heap->len;
+	g_ptr_array_add (index->heap, item);
+	_heap_sift (index->heap, item->heap_idx);
+	if (!g_hash_table_add (index->lookup, item))
+		nm_assert_not_reached ();
+	index->dirty = TRUE;
+}
+
+static void
+_index_update (NDiscIndex *index, NDiscItem *item, gint64 expiry)
+{
+	nm_assert (index->heap->pdata[item->heap_idx] == item);
+
+	item->expiry = expiry;
+	_heap_sift (index->heap, item->heap_idx);
+	index->dirty = TRUE;
+}
+
+static void
+_index_remove (NDiscIndex *index, NDiscItem *item)
+{
+	GPtrArray *heap = index->heap;
+	guint idx = item->heap_idx;
+	guint last = heap->len - 1;
+
+	nm_assert (idx < heap->len && heap->pdata[idx] == item);
+
+	if (idx != last)
+		_heap_swap (heap, idx, last);
+	g_ptr_array_set_size (heap, last);
+	if (idx != last)
+		_heap_sift (heap, idx);
+
+	/* this frees @item. */
+	if (!g_hash_table_remove (index->lookup, item))
+		nm_assert_not_reached ();
+	index->dirty = TRUE;
+}
+
+static void
+_index_sync (NDiscIndex *index,
+             GArray *array,
+             gsize offset,
+             GCompareDataFunc cmp_func)
+{
+	gs_free gpointer *items = NULL;
+	const guint elt_size = g_array_get_element_size (array);
+	guint n;
+	guint i;
+
+	if (!index->dirty)
+		return;
+	index->dirty = FALSE;
+
+	n = index->heap->len;
+	g_array_set_size (array, n);
+	if (n == 0)
+		return;
+
+	items = nm_memdup (index->heap->pdata, sizeof (gpointer) * n);
+	g_qsort_with_data (items, n, sizeof (gpointer), cmp_func, NULL);
+	for (i = 0; i < n; i++)
+		memcpy (&array->data[i * elt_size], &((const char *) items[i])[offset], elt_size);
+}
+
+/*****************************************************************************/
+
+static guint
+_gateway_item_hash (gconstpointer ptr)
+{
+	const NDiscGatewayItem *item = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 1496374147u);
+	nm_hash_update_in6addr (&h, &item->gateway.address);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_gateway_item_equal (gconstpointer a, gconstpointer b)
+{
+	const NDiscGatewayItem *item_a = a;
+	const NDiscGatewayItem *item_b = b;
+
+	return IN6_ARE_ADDR_EQUAL (&item_a->gateway.address, &item_b->gateway.address);
+}
+
+static void
+_gateway_item_free (gpointer ptr)
+{
+	g_slice_free (NDiscGatewayItem, ptr);
+}
+
+static int
+_gateway_item_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const NDiscGatewayItem *item_a = *((const NDiscGatewayItem *const*) a);
+	const NDiscGatewayItem *item_b = *((const NDiscGatewayItem *const*) b);
+
+	/* more preferable gateways first. Among the same preference, the
+	 * older ones first. */
+	NM_CMP_DIRECT (_preference_to_priority (item_b->gateway.preference),
+	               _preference_to_priority (item_a->gateway.preference));
+	NM_CMP_DIRECT (item_a->item.seq, item_b->item.seq);
+	return 0;
+}
+
+static guint
+_route_item_hash (gconstpointer ptr)
+{
+	const NDiscRouteItem *item = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 3470185213u);
+	nm_hash_update_in6addr (&h, &item->route.network);
+	nm_hash_update_val (&h, item->route.plen);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_route_item_equal (gconstpointer a, gconstpointer b)
+{
+	const NDiscRouteItem *item_a = a;
+	const NDiscRouteItem *item_b = b;
+
+	return    item_a->route.plen == item_b->route.plen
+	       && IN6_ARE_ADDR_EQUAL (&item_a->route.network, &item_b->route.network);
+}
+
+static void
+_route_item_free (gpointer ptr)
+{
+	g_slice_free (NDiscRouteItem, ptr);
+}
+
+static int
+_route_item_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const NDiscRouteItem *item_a = *((const NDiscRouteItem *const*) a);
+	const NDiscRouteItem *item_b = *((const NDiscRouteItem *const*) b);
+
+	/* more preferable routes first. Among the same preference, the
+	 * newer ones first. */
+	NM_CMP_DIRECT (_preference_to_priority (item_b->route.preference),
+	               _preference_to_priority (item_a->route.preference));
+	NM_CMP_DIRECT (item_b->item.seq, item_a->item.seq);
+	return 0;
+}
+
+/*****************************************************************************/
+
 NMPNetns *
 nm_ndisc_netns_get (NMNDisc *self)
 {
@@ -290,12 +562,28 @@ _data_complete (NMNDiscDataInternal *data)
 	return &data->public;
 }
 
+static void
+_data_sync (NMNDiscPrivate *priv)
+{
+	_index_sync (&priv->gateways_idx,
+	             priv->rdata.gateways,
+	             G_STRUCT_OFFSET (NDiscGatewayItem, gateway),
+	             _gateway_item_cmp);
+	_index_sync (&priv->routes_idx,
+	             priv->rdata.routes,
+	             G_STRUCT_OFFSET (NDiscRouteItem, route),
+	             _route_item_cmp);
+}
+
 void
 nm_ndisc_emit_config_change (NMNDisc *self, NMNDiscConfigMap changed)
 {
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (self);
+
+	_data_sync (priv);
 	_config_changed_log (self, changed);
 	g_signal_emit (self, signals[CONFIG_RECEIVED], 0,
-	               _data_complete (&NM_NDISC_GET_PRIVATE (self)->rdata),
+	               _data_complete (&priv->rdata),
 	               (guint) changed);
 }
 
@@ -304,50 +592,38 @@ nm_ndisc_emit_config_change (NMNDisc *self, NMNDiscConfigMap changed)
 gboolean
 nm_ndisc_add_gateway (NMNDisc *ndisc, const NMNDiscGateway *new)
 {
-	NMNDiscDataInternal *rdata = &NM_NDISC_GET_PRIVATE(ndisc)->rdata;
-	guint i;
-	guint insert_idx = G_MAXUINT;
-
-	for (i = 0; i < rdata->gateways->len; ) {
-		NMNDiscGateway *item = &g_array_index (rdata->gateways, NMNDiscGateway, i);
-
-		if (IN6_ARE_ADDR_EQUAL (&item->address, &new->address)) {
-			if (new->lifetime == 0) {
-				g_array_remove_index (rdata->gateways, i);
-				_ASSERT_data_gateways (rdata);
-				return TRUE;
-			}
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NDiscGatewayItem *item;
 
-			if (item->preference != new->preference) {
-				g_array_remove_index (rdata->gateways, i);
-				continue;
-			}
+	item = _index_lookup (&priv->gateways_idx,
+	                      &((const NDiscGatewayItem) { .gateway.address = new->address, }));
+	if (item) {
+		if (new->lifetime == 0) {
+			_index_remove (&priv->gateways_idx, &item->item);
+			return TRUE;
+		}
 
-			if (get_expiry (item) == get_expiry (new))
+		if (item->gateway.preference == new->preference) {
+			if (get_expiry (&item->gateway) == get_expiry (new))
 				return FALSE;
 
-			*item = *new;
-			_ASSERT_data_gateways (rdata);
+			item->gateway = *new;
+			_index_update (&priv->gateways_idx, &item->item, get_expiry (new));
 			return TRUE;
 		}
 
-		/* Put before less preferable gateways. */
-		if (   _preference_to_priority (item->preference) < _preference_to_priority (new->preference)
-		    && insert_idx == G_MAXUINT)
-			insert_idx = i;
-
-		i++;
+		/* the preference changed. Re-add it, so that it is sorted like
+		 * a new gateway. */
+		_index_remove (&priv->gateways_idx, &item->item);
 	}
 
-	if (new->lifetime) {
-		g_array_insert_val (rdata->gateways,
-		                    insert_idx == G_MAXUINT
-		                      ? rdata->gateways->len
-		                      : insert_idx,
-		                    *new);
-	}
-	_ASSERT_data_gateways (rdata);
-	return !!new->lifetime;
+	if (!new->lifetime)
+		return FALSE;
+
+	item = g_slice_new (NDiscGatewayItem);
+	item->gateway = *new;
+	_index_add (&priv->gateways_idx, &item->item, get_expiry (new));
+	return TRUE;
 }
 
 /**
@@ -530,9 +806,7 @@ gboolean
 nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 {
 	NMNDiscPrivate *priv;
-	NMNDiscDataInternal *rdata;
-	guint i;
-	guint insert_idx = G_MAXUINT;
+	NDiscRouteItem *item;
 
 	if (new->plen == 0 || new->plen > 128) {
 		/* Only expect non-default routes.  The router has no idea what the
@@ -546,47 +820,40 @@ nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 	}
 
 	priv = NM_NDISC_GET_PRIVATE (ndisc);
-	rdata = &priv->rdata;
 
-	for (i = 0; i < rdata->routes->len; ) {
-		NMNDiscRoute *item = &g_array_index (rdata->routes, NMNDiscRoute, i);
-
-		if (   IN6_ARE_ADDR_EQUAL (&item->network, &new->network)
-		    && item->plen == new->plen) {
-			if (new->lifetime == 0) {
-				g_array_remove_index (rdata->routes, i);
-				return TRUE;
-			}
-
-			if (item->preference != new->preference) {
-				g_array_remove_index (rdata->routes, i);
-				continue;
-			}
+	item = _index_lookup (&priv->routes_idx,
+	                      &((const NDiscRouteItem) {
+	                          .route.network = new->network,
+	                          .route.plen    = new->plen,
+	                      }));
+	if (item) {
+		if (new->lifetime == 0) {
+			_index_remove (&priv->routes_idx, &item->item);
+			return TRUE;
+		}
 
-			if (   get_expiry (item) == get_expiry (new)
-			    && IN6_ARE_ADDR_EQUAL (&item->gateway, &new->gateway))
+		if (item->route.preference == new->preference) {
+			if (   get_expiry (&item->route) == get_expiry (new)
+			    && IN6_ARE_ADDR_EQUAL (&item->route.gateway, &new->gateway))
 				return FALSE;
 
-			*item = *new;
+			item->route = *new;
+			_index_update (&priv->routes_idx, &item->item, get_expiry (new));
 			return TRUE;
 		}
 
-		/* Put before less preferable routes. */
-		if (   _preference_to_priority (item->preference) < _preference_to_priority (new->preference)
-		    && insert_idx == G_MAXUINT)
-			insert_idx = i;
-
-		i++;
+		/* the preference changed. Re-add it, so that it is sorted like
+		 * a new route. */
+		_index_remove (&priv->routes_idx, &item->item);
 	}
 
-	if (new->lifetime) {
-		g_array_insert_val (rdata->routes,
-		                    insert_idx == G_MAXUINT
-		                      ? 0u
-		                      : insert_idx,
-		                    *new);
-	}
-	return !!new->lifetime;
+	if (!new->lifetime)
+		return FALSE;
+
+	item = g_slice_new (NDiscRouteItem);
+	item->route = *new;
+	_index_add (&priv->routes_idx, &item->item, get_expiry (new));
+	return TRUE;
 }
 
 gboolean
@@ -1083,24 +1350,15 @@ _config_changed_log (NMNDisc *ndisc, NMNDiscConfigMap changed)
 static void
 clean_gateways (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
 {
-	NMNDiscDataInternal *rdata;
-	guint i;
-
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
-	for (i = 0; i < rdata->gateways->len; ) {
-		NMNDiscGateway *item = &g_array_index (rdata->gateways, NMNDiscGateway, i);
-
-		if (!expiry_next (now, get_expiry (item), nextevent)) {
-			g_array_remove_index (rdata->gateways, i);
-			*changed |= NM_NDISC_CONFIG_GATEWAYS;
-			continue;
-		}
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NDiscItem *item;
 
-		i++;
+	while ((item = _index_peek_first_expiry (&priv->gateways_idx))) {
+		if (expiry_next (now, item->expiry, nextevent))
+			break;
+		_index_remove (&priv->gateways_idx, item);
+		*changed |= NM_NDISC_CONFIG_GATEWAYS;
 	}
-
-	_ASSERT_data_gateways (rdata);
 }
 
 static void
@@ -1127,21 +1385,14 @@ clean_addresses (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *
 static void
 clean_routes (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
 {
-	NMNDiscDataInternal *rdata;
-	guint i;
-
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
-	for (i = 0; i < rdata->routes->len; ) {
-		NMNDiscRoute *item = &g_array_index (rdata->routes, NMNDiscRoute, i);
-
-		if (!expiry_next (now, get_expiry (item), nextevent)) {
-			g_array_remove_index (rdata->routes, i);
-			*changed |= NM_NDISC_CONFIG_ROUTES;
-			continue;
-		}
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NDiscItem *item;
 
-		i++;
+	while ((item = _index_peek_first_expiry (&priv->routes_idx))) {
+		if (expiry_next (now, item->expiry, nextevent))
+			break;
+		_index_remove (&priv->routes_idx, item);
+		*changed |= NM_NDISC_CONFIG_ROUTES;
 	}
 }
 
@@ -1362,6 +1613,9 @@ nm_ndisc_init (NMNDisc *ndisc)
 	g_array_set_clear_func (rdata->dns_domains, dns_domain_free);
 	priv->rdata.public.hop_limit = 64;
 
+	_index_init (&priv->gateways_idx, _gateway_item_hash, _gateway_item_equal, _gateway_item_free);
+	_index_init (&priv->routes_idx, _route_item_hash, _route_item_equal, _route_item_free);
+
 	/* Start at very low number so that last_rs - router_solicitation_interval
 	 * is much lower than nm_utils_get_monotonic_timestamp_sec() at startup.
 	 */
@@ -1400,6 +1654,9 @@ finalize (GObject *object)
 	g_array_unref (rdata->dns_servers);
 	g_array_unref (rdata->dns_domains);
 
+	_index_clear (&priv->gateways_idx);
+	_index_clear (&priv->routes_idx);
+
 	g_clear_object (&priv->netns);
 	g_clear_object (&priv->platform);
 
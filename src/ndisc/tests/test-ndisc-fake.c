@@ -504,6 +504,181 @@ test_dns_solicit_loop (void)
 	g_main_loop_unref (data.loop);
 }
 
+typedef struct {
+	GMainLoop *loop;
+	guint counter;
+	guint n_routes;
+	guint n_short;
+	guint n_withdrawn;
+	guint n_added;
+	gint64 start_usec;
+} StressData;
+
+static int
+_stress_route_priority (NMIcmpv6RouterPref pref)
+{
+	switch (pref) {
+	case NM_ICMPV6_ROUTER_PREF_LOW:
+		return 1;
+	case NM_ICMPV6_ROUTER_PREF_MEDIUM:
+		return 2;
+	case NM_ICMPV6_ROUTER_PREF_HIGH:
+		return 3;
+	default:
+		return 0;
+	}
+}
+
+static NMIcmpv6RouterPref
+_stress_route_preference (guint i)
+{
+	static const NMIcmpv6RouterPref prefs[] = {
+		NM_ICMPV6_ROUTER_PREF_LOW,
+		NM_ICMPV6_ROUTER_PREF_MEDIUM,
+		NM_ICMPV6_ROUTER_PREF_HIGH,
+	};
+
+	return prefs[i % G_N_ELEMENTS (prefs)];
+}
+
+static void
+_stress_check_routes (const NMNDiscData *rdata, guint expected_n, guint32 forbidden_lifetime)
+{
+	gs_unref_hashtable GHashTable *seen = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+	guint i;
+
+	g_assert_cmpint (rdata->routes_n, ==, expected_n);
+
+	for (i = 0; i < rdata->routes_n; i++) {
+		const NMNDiscRoute *route = &rdata->routes[i];
+		char sbuf[NM_UTILS_INET_ADDRSTRLEN];
+
+		if (i > 0) {
+			g_assert_cmpint (_stress_route_priority (rdata->routes[i - 1].preference),
+			                 >=,
+			                 _stress_route_priority (route->preference));
+		}
+		g_assert_cmpint (route->lifetime, >, 0);
+		g_assert_cmpint (route->lifetime, !=, forbidden_lifetime);
+		if (!g_hash_table_add (seen, g_strdup_printf ("%s/%u",
+		                                               _nm_utils_inet6_ntop (&route->network, sbuf),
+		                                               (guint) route->plen)))
+			g_assert_not_reached ();
+	}
+}
+
+static void
+test_stress_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, StressData *data)
+{
+	NMNDiscConfigMap changed = changed_int;
+	guint n;
+
+	switch (data->counter++) {
+	case 0:
+		g_assert (changed & NM_NDISC_CONFIG_ROUTES);
+		g_assert_cmpint (rdata->gateways_n, ==, 8);
+		_stress_check_routes (rdata, data->n_routes, 0);
+		break;
+	case 1:
+		g_assert (changed & NM_NDISC_CONFIG_ROUTES);
+		g_assert_cmpint (rdata->gateways_n, ==, 8);
+		_stress_check_routes (rdata,
+		                      data->n_routes - data->n_withdrawn + data->n_added,
+		                      0);
+		g_assert (nm_fake_ndisc_done (NM_FAKE_NDISC (ndisc)));
+		break;
+	case 2:
+		/* the short-lived routes expired via the timeout. */
+		g_assert_cmpint (changed, ==, NM_NDISC_CONFIG_ROUTES);
+		n = data->n_routes - data->n_withdrawn + data->n_added - data->n_short;
+		_stress_check_routes (rdata, n, 5);
+		g_test_message ("ndisc stress: %u routes, %u withdrawn, %u added, %u expired in %.3f msec",
+		                data->n_routes, data->n_withdrawn, data->n_added, data->n_short,
+		                (g_get_monotonic_time () - data->start_usec) / 1000.0);
+		g_main_loop_quit (data->loop);
+		break;
+	default:
+		g_assert_not_reached ();
+	}
+}
+
+static void
+test_stress (void)
+{
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_sec ();
+	StressData data = {
+		.loop = g_main_loop_new (NULL, FALSE),
+		/* use "-m perf" to process a huge number of route options. */
+		.n_routes = g_test_perf () ? 20000 : 500,
+	};
+	guint id;
+	guint i;
+
+	/* Many route options, so that processing an RA and expiring
+	 * routes must not be quadratic in the number of routes. */
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	for (i = 0; i < 8; i++) {
+		char addr[NM_UTILS_INET_ADDRSTRLEN];
+
+		nm_sprintf_buf (addr, "fe80::%x", i + 1);
+		nm_fake_ndisc_add_gateway (ndisc, id, addr, now, 3600, _stress_route_preference (i));
+	}
+	for (i = 0; i < data.n_routes; i++) {
+		char network[NM_UTILS_INET_ADDRSTRLEN];
+		guint32 lifetime = 3600;
+
+		/* plen 80, so that no addresses are generated. */
+		nm_sprintf_buf (network, "2001:db8:%x:%x::", i >> 16, i & 0xFFFF);
+		if (i % 10 == 0) {
+			lifetime = 5;
+			data.n_short++;
+		}
+		nm_fake_ndisc_add_prefix (ndisc, id, network, 80, "fe80::1", now, lifetime, lifetime,
+		                          _stress_route_preference (i));
+	}
+
+	/* the second RA withdraws, updates and adds routes. */
+	id = nm_fake_ndisc_add_ra (ndisc, 0, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	for (i = 0; i < data.n_routes; i++) {
+		char network[NM_UTILS_INET_ADDRSTRLEN];
+
+		nm_sprintf_buf (network, "2001:db8:%x:%x::", i >> 16, i & 0xFFFF);
+		if (i % 10 == 1) {
+			nm_fake_ndisc_add_prefix (ndisc, id, network, 80, "fe80::1", now, 0, 0,
+			                          _stress_route_preference (i));
+			data.n_withdrawn++;
+		} else if (i % 10 == 2) {
+			nm_fake_ndisc_add_prefix (ndisc, id, network, 80, "fe80::2", now, 7200, 7200,
+			                          _stress_route_preference (i + 1));
+		}
+	}
+	for (i = 0; i < data.n_routes / 4; i++) {
+		char network[NM_UTILS_INET_ADDRSTRLEN];
+
+		nm_sprintf_buf (network, "2001:db9:%x:%x::", i >> 16, i & 0xFFFF);
+		nm_fake_ndisc_add_prefix (ndisc, id, network, 80, "fe80::3", now, 3600, 3600,
+		                          _stress_route_preference (i));
+		data.n_added++;
+	}
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (test_stress_changed),
+	                  &data);
+
+	data.start_usec = g_get_monotonic_time ();
+	nm_ndisc_start (NM_NDISC (ndisc));
+	g_main_loop_run (data.loop);
+	g_assert_cmpint (data.counter, ==, 3);
+
+	g_object_unref (ndisc);
+	g_main_loop_unref (data.loop);
+}
+
 NMTST_DEFINE ();
 
 int
@@ -523,6 +698,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/ndisc/preference-order", test_preference_order);
 	g_test_add_func ("/ndisc/preference-changed", test_preference_changed);
 	g_test_add_func ("/ndisc/dns-solicit-loop", test_dns_solicit_loop);
+	g_test_add_func ("/ndisc/stress", test_stress);
 
 	return g_test_run ();
 }
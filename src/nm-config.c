@@ -756,13 +756,18 @@ static const ConfigGroup config_groups[] = {
 			NM_CONFIG_KEYFILE_KEY_MAIN_CONFIGURE_AND_QUIT,
 			NM_CONFIG_KEYFILE_KEY_MAIN_DEBUG,
 			NM_CONFIG_KEYFILE_KEY_MAIN_DHCP,
+			NM_CONFIG_KEYFILE_KEY_MAIN_DHCP_SHARED_SOCKET,
 			NM_CONFIG_KEYFILE_KEY_MAIN_DNS,
+			NM_CONFIG_KEYFILE_KEY_MAIN_DNS_UPDATE_DELAY,
 			NM_CONFIG_KEYFILE_KEY_MAIN_HOSTNAME_MODE,
 			NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_CARRIER,
+			NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_ROUTE_PROTOCOLS,
+			NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_ROUTE_TABLES,
 			NM_CONFIG_KEYFILE_KEY_MAIN_MONITOR_CONNECTION_FILES,
 			NM_CONFIG_KEYFILE_KEY_MAIN_NO_AUTO_DEFAULT,
 			NM_CONFIG_KEYFILE_KEY_MAIN_PLUGINS,
 			NM_CONFIG_KEYFILE_KEY_MAIN_RC_MANAGER,
+			NM_CONFIG_KEYFILE_KEY_MAIN_SHARED_DHCP_SERVER,
 			NM_CONFIG_KEYFILE_KEY_MAIN_SLAVES_ORDER,
 			NM_CONFIG_KEYFILE_KEY_MAIN_SYSTEMD_RESOLVED,
 		),
@@ -788,6 +793,7 @@ static const ConfigGroup config_groups[] = {
 	{
 		.group = NM_CONFIG_KEYFILE_GROUP_KEYFILE,
 		.keys = NM_MAKE_STRV (
+			NM_CONFIG_KEYFILE_KEY_KEYFILE_CACHE,
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_HOSTNAME,
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_PATH,
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_UNMANAGED_DEVICES,
@@ -48,13 +48,18 @@
 #define NM_CONFIG_KEYFILE_KEY_MAIN_CONFIGURE_AND_QUIT       "configure-and-quit"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_DEBUG                    "debug"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_DHCP                     "dhcp"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_DHCP_SHARED_SOCKET       "dhcp-shared-socket"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_DNS                      "dns"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_DNS_UPDATE_DELAY         "dns-update-delay"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_HOSTNAME_MODE            "hostname-mode"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_CARRIER           "ignore-carrier"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_ROUTE_PROTOCOLS   "ignore-route-protocols"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_ROUTE_TABLES      "ignore-route-tables"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_MONITOR_CONNECTION_FILES "monitor-connection-files"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_NO_AUTO_DEFAULT          "no-auto-default"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_PLUGINS                  "plugins"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_RC_MANAGER               "rc-manager"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_SHARED_DHCP_SERVER       "shared-dhcp-server"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SLAVES_ORDER             "slaves-order"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SYSTEMD_RESOLVED         "systemd-resolved"
 
@@ -68,6 +73,7 @@
 #define NM_CONFIG_KEYFILE_KEY_CONNECTIVITY_RESPONSE         "response"
 #define NM_CONFIG_KEYFILE_KEY_CONNECTIVITY_URI              "uri"
 
+#define NM_CONFIG_KEYFILE_KEY_KEYFILE_CACHE                 "cache"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_PATH                  "path"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_UNMANAGED_DEVICES     "unmanaged-devices"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_HOSTNAME              "hostname"
@@ -51,9 +51,32 @@ typedef struct {
 	NMDBusObjectClass *klass;
 	guint info_idx;
 	guint registration_id;
+
+	/* bitmap of the property indexes that changed and are not yet
+	 * announced via PropertiesChanged. Properties with an index of
+	 * DIRTY_PROPERTIES_MAX or larger are not tracked and get announced
+	 * right away. */
+	guint64 dirty_properties;
+
+	/* for interfaces with properties_changed_ratelimit_msec, the timestamp
+	 * when we last emitted PropertiesChanged. */
+	gint64 last_emitted_msec;
+
 	PropertyCacheData property_cache[];
 } RegistrationData;
 
+#define DIRTY_PROPERTIES_MAX ((guint) (sizeof (guint64) * 8))
+
+typedef struct {
+	const NMDBusInterfaceInfoExtended *interface_info;
+	guint property_idx;
+} PropertyIndexEntry;
+
+typedef struct {
+	guint len;
+	PropertyIndexEntry arr[];
+} PropertyIndexEntries;
+
 /* we require that @path is the first member of NMDBusManagerData
  * because _objects_by_path_hash() requires that. */
 G_STATIC_ASSERT (G_STRUCT_OFFSET (struct _NMDBusObjectInternal, path) == 0);
@@ -80,6 +103,11 @@ typedef struct {
 
 	CList caller_info_lst_head;
 
+	/* the objects with pending PropertiesChanged signals. */
+	CList notify_lst_head;
+	guint notify_idle_id;
+	guint notify_timeout_id;
+
 	guint objmgr_registration_id;
 	bool started:1;
 	bool shutting_down:1;
@@ -112,6 +140,7 @@ static const GDBusSignalInfo signal_info_objmgr_interfaces_added;
 static const GDBusSignalInfo signal_info_objmgr_interfaces_removed;
 static GVariantBuilder *_obj_collect_properties_all (NMDBusObject *obj,
                                                      GVariantBuilder *builder);
+static void _obj_notify_flush (NMDBusManager *self, gboolean force);
 
 /*****************************************************************************/
 
@@ -1003,6 +1032,10 @@ _obj_register (NMDBusManager *self,
 
 	nm_assert (!c_list_is_empty (&obj->internal.registration_lst_head));
 
+	/* keep the order of signals: pending property changes of other
+	 * objects go out first. */
+	_obj_notify_flush (self, TRUE);
+
 	/* Currently the interfaces of an object do not changed and strictly depend on the object glib type.
 	 * We don't need more flixibility, and it simplifies the code. Hence, now emit interface-added
 	 * signal for the new object.
@@ -1041,6 +1074,11 @@ _obj_unregister (NMDBusManager *self,
 	nm_assert (priv->started);
 	nm_assert (!c_list_is_empty (&obj->internal.registration_lst_head));
 
+	/* emit the pending property changes (including those of @obj) before
+	 * the object goes away. */
+	_obj_notify_flush (self, TRUE);
+	nm_assert (c_list_is_empty (&obj->internal.notify_lst));
+
 	g_variant_builder_init (&builder, G_VARIANT_TYPE ("as"));
 
 	while ((reg_data = c_list_last_entry (&obj->internal.registration_lst_head, RegistrationData, registration_lst))) {
@@ -1145,34 +1183,137 @@ _nm_dbus_manager_obj_unexport (NMDBusObject *obj)
 	c_list_unlink (&obj->internal.objects_lst);
 }
 
-void
-_nm_dbus_manager_obj_notify (NMDBusObject *obj,
-                             guint n_pspecs,
-                             const GParamSpec *const*pspecs)
+static const PropertyIndexEntries *
+_property_index_lookup (NMDBusObject *obj,
+                        const GParamSpec *pspec)
+{
+	static GQuark quark = 0;
+	GType obj_gtype = G_OBJECT_TYPE (obj);
+	GHashTable *index;
+
+	if (G_UNLIKELY (quark == 0))
+		quark = g_quark_from_static_string ("nm-dbus-manager-property-index");
+
+	index = g_type_get_qdata (obj_gtype, quark);
+	if (G_UNLIKELY (!index)) {
+		GObjectClass *object_class = G_OBJECT_GET_CLASS (obj);
+		const NMDBusInterfaceInfoExtended *const*prev_interface_infos = NULL;
+		GType gtype;
+		guint i, j;
+
+		/* Build the index from GParamSpec to the D-Bus properties once per
+		 * object type. The index is never freed, like the type itself. */
+		index = g_hash_table_new_full (nm_direct_hash, NULL, NULL, g_free);
+
+		for (gtype = obj_gtype; gtype != NM_TYPE_DBUS_OBJECT; gtype = g_type_parent (gtype)) {
+			NMDBusObjectClass *klass = g_type_class_peek (gtype);
+
+			if (   !klass->interface_infos
+			    || klass->interface_infos == prev_interface_infos)
+				continue;
+			prev_interface_infos = klass->interface_infos;
+
+			for (i = 0; klass->interface_infos[i]; i++) {
+				const NMDBusInterfaceInfoExtended *interface_info = klass->interface_infos[i];
+
+				if (!interface_info->parent.properties)
+					continue;
+
+				for (j = 0; interface_info->parent.properties[j]; j++) {
+					const NMDBusPropertyInfoExtended *property_info = (const NMDBusPropertyInfoExtended *) interface_info->parent.properties[j];
+					PropertyIndexEntries *entries;
+					GParamSpec *p;
+					GParamSpec *p_redirect;
+
+					p = g_object_class_find_property (object_class, property_info->property_name);
+					if (!p) {
+						nm_assert_not_reached ();
+						continue;
+					}
+
+					/* notifications are emitted for the redirect target of
+					 * overridden properties. */
+					p_redirect = g_param_spec_get_redirect_target (p);
+					if (p_redirect)
+						p = p_redirect;
+
+					entries = g_hash_table_lookup (index, p);
+					if (entries) {
+						g_hash_table_steal (index, p);
+						entries = g_realloc (entries,
+						                     sizeof (PropertyIndexEntries)
+						                     + (sizeof (PropertyIndexEntry) * (entries->len + 1u)));
+					} else {
+						entries = g_malloc (sizeof (PropertyIndexEntries)
+						                    + sizeof (PropertyIndexEntry));
+						entries->len = 0;
+					}
+					entries->arr[entries->len++] = (PropertyIndexEntry) {
+						.interface_info = interface_info,
+						.property_idx   = j,
+					};
+					g_hash_table_insert (index, p, entries);
+				}
+			}
+		}
+
+		g_type_set_qdata (obj_gtype, quark, index);
+	}
+
+	return g_hash_table_lookup (index, pspec);
+}
+
+static RegistrationData *
+_obj_find_reg_data (NMDBusObject *obj,
+                    const NMDBusInterfaceInfoExtended *interface_info)
 {
-	NMDBusManager *self;
-	NMDBusManagerPrivate *priv;
 	RegistrationData *reg_data;
-	guint i, p;
-	gboolean any_legacy_signals = FALSE;
-	gboolean any_legacy_properties = FALSE;
-	GVariantBuilder legacy_builder;
-	GVariant *device_statistics_args = NULL;
 
-	nm_assert (NM_IS_DBUS_OBJECT (obj));
-	nm_assert (obj->internal.path);
-	nm_assert (NM_IS_DBUS_MANAGER (obj->internal.bus_manager));
-	nm_assert (!c_list_is_empty (&obj->internal.objects_lst));
+	c_list_for_each_entry (reg_data, &obj->internal.registration_lst_head, registration_lst) {
+		if (_reg_data_get_interface_info (reg_data) == interface_info)
+			return reg_data;
+	}
+	return NULL;
+}
 
-	self = obj->internal.bus_manager;
-	priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+static gboolean
+_notify_idle_cb (gpointer user_data)
+{
+	NMDBusManager *self = user_data;
 
-	nm_assert (!priv->started || priv->objmgr_registration_id != 0);
-	nm_assert (priv->objmgr_registration_id == 0 || priv->main_dbus_connection);
-	nm_assert (c_list_is_empty (&obj->internal.registration_lst_head) != priv->started);
+	NM_DBUS_MANAGER_GET_PRIVATE (self)->notify_idle_id = 0;
+	_obj_notify_flush (self, FALSE);
+	return G_SOURCE_REMOVE;
+}
 
-	if (G_UNLIKELY (!priv->started))
-		return;
+static gboolean
+_notify_timeout_cb (gpointer user_data)
+{
+	NMDBusManager *self = user_data;
+
+	NM_DBUS_MANAGER_GET_PRIVATE (self)->notify_timeout_id = 0;
+	_obj_notify_flush (self, FALSE);
+	return G_SOURCE_REMOVE;
+}
+
+/* Emit PropertiesChanged for the dirty properties of @obj. Returns %TRUE,
+ * if all changes were emitted. Otherwise, some rate limited interfaces
+ * are not yet due and *@p_next_due_msec is updated. */
+static gboolean
+_obj_emit_properties_changed (NMDBusManager *self,
+                              NMDBusObject *obj,
+                              gboolean force,
+                              gint64 *p_now_msec,
+                              gint64 *p_next_due_msec)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	RegistrationData *reg_data;
+	guint i;
+	gboolean any_legacy_signals = FALSE;
+	gboolean any_legacy_properties = FALSE;
+	gboolean all_emitted = TRUE;
+	GVariantBuilder legacy_builder;
+	GVariant *device_statistics_args = NULL;
 
 	c_list_for_each_entry (reg_data, &obj->internal.registration_lst_head, registration_lst) {
 		if (_reg_data_get_interface_info (reg_data)->legacy_property_changed) {
@@ -1181,55 +1322,61 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 		}
 	}
 
-	/* do a naive search for the matching NMDBusPropertyInfoExtended infos. Since the number of
-	 * (interfaces x properties) is static and possibly small, this naive search is effectively
-	 * O(1). We might wanna introduce some index to lookup the properties in question faster.
-	 *
-	 * The nice part of this implementation is however, that the order in which properties
-	 * are added to the GVariant is strictly defined to be the order in which the D-Bus property-info
-	 * is declared. Getting a defined ordering with some smart lookup would be hard. */
+	/* The properties are added to the GVariant in the order in which the D-Bus
+	 * property-info is declared. */
 	c_list_for_each_entry (reg_data, &obj->internal.registration_lst_head, registration_lst) {
 		const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info (reg_data);
-		gboolean has_properties = FALSE;
 		GVariantBuilder builder;
 		GVariantBuilder invalidated_builder;
 		GVariant *args;
 
-		if (!interface_info->parent.properties)
+		if (reg_data->dirty_properties == 0)
 			continue;
 
+		if (interface_info->properties_changed_ratelimit_msec > 0) {
+			gint64 due_msec;
+
+			if (*p_now_msec == 0)
+				*p_now_msec = nm_utils_get_monotonic_timestamp_msec ();
+			due_msec = reg_data->last_emitted_msec + interface_info->properties_changed_ratelimit_msec;
+			if (   !force
+			    && reg_data->last_emitted_msec != 0
+			    && due_msec > *p_now_msec) {
+				if (   *p_next_due_msec == 0
+				    || *p_next_due_msec > due_msec)
+					*p_next_due_msec = due_msec;
+				all_emitted = FALSE;
+				continue;
+			}
+			reg_data->last_emitted_msec = *p_now_msec;
+		}
+
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+
 		for (i = 0; interface_info->parent.properties[i]; i++) {
 			const NMDBusPropertyInfoExtended *property_info = (const NMDBusPropertyInfoExtended *) interface_info->parent.properties[i];
+			gs_unref_variant GVariant *value = NULL;
 
-			for (p = 0; p < n_pspecs; p++) {
-				const GParamSpec *pspec = pspecs[p];
-				gs_unref_variant GVariant *value = NULL;
-
-				if (!nm_streq (property_info->property_name, pspec->name))
-					continue;
+			if (   i >= DIRTY_PROPERTIES_MAX
+			    || !NM_FLAGS_ANY (reg_data->dirty_properties, ((guint64) 1) << i))
+				continue;
 
-				value = _obj_get_property (reg_data, i, TRUE);
+			value = _obj_get_property (reg_data, i, TRUE);
 
-				if (   property_info->include_in_legacy_property_changed
-				    && any_legacy_signals) {
-					/* also track the value in the legacy_builder to emit legacy signals below. */
-					if (!any_legacy_properties) {
-						any_legacy_properties = TRUE;
-						g_variant_builder_init (&legacy_builder, G_VARIANT_TYPE ("a{sv}"));
-					}
-					g_variant_builder_add (&legacy_builder, "{sv}", property_info->parent.name, value);
+			if (   property_info->include_in_legacy_property_changed
+			    && any_legacy_signals) {
+				/* also track the value in the legacy_builder to emit legacy signals below. */
+				if (!any_legacy_properties) {
+					any_legacy_properties = TRUE;
+					g_variant_builder_init (&legacy_builder, G_VARIANT_TYPE ("a{sv}"));
 				}
-
-				if (!has_properties) {
-					has_properties = TRUE;
-					g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
-				}
-				g_variant_builder_add (&builder, "{sv}", property_info->parent.name, value);
+				g_variant_builder_add (&legacy_builder, "{sv}", property_info->parent.name, value);
 			}
+
+			g_variant_builder_add (&builder, "{sv}", property_info->parent.name, value);
 		}
 
-		if (!has_properties)
-			continue;
+		reg_data->dirty_properties = 0;
 
 		args = g_variant_builder_end (&builder);
 
@@ -1304,6 +1451,171 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 			}
 		}
 	}
+
+	return all_emitted;
+}
+
+static void
+_obj_notify_flush (NMDBusManager *self, gboolean force)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	NMDBusObject *obj;
+	NMDBusObject *obj_safe;
+	gint64 now_msec = 0;
+	gint64 next_due_msec = 0;
+
+	if (force)
+		nm_clear_g_source (&priv->notify_idle_id);
+	nm_clear_g_source (&priv->notify_timeout_id);
+
+	c_list_for_each_entry_safe (obj, obj_safe, &priv->notify_lst_head, internal.notify_lst) {
+		if (_obj_emit_properties_changed (self, obj, force, &now_msec, &next_due_msec))
+			c_list_unlink (&obj->internal.notify_lst);
+	}
+
+	if (next_due_msec != 0) {
+		nm_assert (!force);
+		nm_assert (next_due_msec > now_msec);
+		priv->notify_timeout_id = g_timeout_add (next_due_msec - now_msec,
+		                                         _notify_timeout_cb,
+		                                         self);
+	}
+}
+
+/* Emit the pending PropertiesChanged signals of @obj alone, regardless of
+ * rate limiting. The pending changes of other objects are left alone. */
+static void
+_obj_notify_flush_one (NMDBusManager *self, NMDBusObject *obj)
+{
+	gint64 now_msec = 0;
+	gint64 next_due_msec = 0;
+
+	if (c_list_is_empty (&obj->internal.notify_lst))
+		return;
+
+	_obj_emit_properties_changed (self, obj, TRUE, &now_msec, &next_due_msec);
+	c_list_unlink (&obj->internal.notify_lst);
+}
+
+/* Emit PropertiesChanged for a single property right away. This is the fallback
+ * for properties that cannot be tracked in the dirty bitmap. The pending changes
+ * of @obj are emitted first, to preserve the order of the notifications. */
+static void
+_obj_emit_property_changed_uncoalesced (NMDBusManager *self,
+                                        NMDBusObject *obj,
+                                        RegistrationData *reg_data,
+                                        guint property_idx)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info (reg_data);
+	const NMDBusPropertyInfoExtended *property_info = (const NMDBusPropertyInfoExtended *) interface_info->parent.properties[property_idx];
+	gs_unref_variant GVariant *value = NULL;
+	GVariantBuilder builder;
+	GVariantBuilder invalidated_builder;
+	RegistrationData *reg_data2;
+
+	_obj_notify_flush_one (self, obj);
+
+	value = _obj_get_property (reg_data, property_idx, TRUE);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&builder, "{sv}", property_info->parent.name, value);
+	g_variant_builder_init (&invalidated_builder, G_VARIANT_TYPE ("as"));
+	g_dbus_connection_emit_signal (priv->main_dbus_connection,
+	                               NULL,
+	                               obj->internal.path,
+	                               "org.freedesktop.DBus.Properties",
+	                               "PropertiesChanged",
+	                               g_variant_new ("(sa{sv}as)",
+	                                              interface_info->parent.name,
+	                                              &builder,
+	                                              &invalidated_builder),
+	                               NULL);
+
+	if (!property_info->include_in_legacy_property_changed)
+		return;
+
+	c_list_for_each_entry (reg_data2, &obj->internal.registration_lst_head, registration_lst) {
+		if (!_reg_data_get_interface_info (reg_data2)->legacy_property_changed)
+			continue;
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+		g_variant_builder_add (&builder, "{sv}", property_info->parent.name, value);
+		g_dbus_connection_emit_signal (priv->main_dbus_connection,
+		                               NULL,
+		                               obj->internal.path,
+		                               _reg_data_get_interface_info (reg_data2)->parent.name,
+		                               "PropertiesChanged",
+		                               g_variant_new ("(a{sv})", &builder),
+		                               NULL);
+	}
+}
+
+void
+_nm_dbus_manager_obj_notify (NMDBusObject *obj,
+                             guint n_pspecs,
+                             const GParamSpec *const*pspecs)
+{
+	NMDBusManager *self;
+	NMDBusManagerPrivate *priv;
+	gboolean any_dirty = FALSE;
+	guint p, k;
+
+	nm_assert (NM_IS_DBUS_OBJECT (obj));
+	nm_assert (obj->internal.path);
+	nm_assert (NM_IS_DBUS_MANAGER (obj->internal.bus_manager));
+	nm_assert (!c_list_is_empty (&obj->internal.objects_lst));
+
+	self = obj->internal.bus_manager;
+	priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+
+	nm_assert (!priv->started || priv->objmgr_registration_id != 0);
+	nm_assert (priv->objmgr_registration_id == 0 || priv->main_dbus_connection);
+	nm_assert (c_list_is_empty (&obj->internal.registration_lst_head) != priv->started);
+
+	if (G_UNLIKELY (!priv->started))
+		return;
+
+	/* only mark the properties as dirty. The PropertiesChanged signals get
+	 * emitted together on idle, so that multiple changes of the same object
+	 * (and of the same property) are coalesced. */
+	for (p = 0; p < n_pspecs; p++) {
+		const PropertyIndexEntries *entries;
+
+		entries = _property_index_lookup (obj, pspecs[p]);
+		if (!entries)
+			continue;
+
+		for (k = 0; k < entries->len; k++) {
+			const PropertyIndexEntry *entry = &entries->arr[k];
+			RegistrationData *reg_data;
+
+			reg_data = _obj_find_reg_data (obj, entry->interface_info);
+			if (!reg_data)
+				continue;
+
+			if (G_UNLIKELY (entry->property_idx >= DIRTY_PROPERTIES_MAX)) {
+				/* the interface has more properties than the bitmap can track.
+				 * Don't coalesce this one. */
+				_obj_emit_property_changed_uncoalesced (self, obj, reg_data, entry->property_idx);
+				continue;
+			}
+
+			reg_data->dirty_properties |= (((guint64) 1) << entry->property_idx);
+
+			/* a D-Bus Get() must not return the stale value in the meantime. */
+			nm_clear_g_variant (&reg_data->property_cache[entry->property_idx].value);
+			any_dirty = TRUE;
+		}
+	}
+
+	if (!any_dirty)
+		return;
+
+	if (c_list_is_empty (&obj->internal.notify_lst))
+		c_list_link_tail (&priv->notify_lst_head, &obj->internal.notify_lst);
+
+	if (priv->notify_idle_id == 0)
+		priv->notify_idle_id = g_idle_add_full (G_PRIORITY_HIGH, _notify_idle_cb, self, NULL);
 }
 
 void
@@ -1328,6 +1640,11 @@ _nm_dbus_manager_obj_emit_signal (NMDBusObject *obj,
 		return;
 	}
 
+	/* signals are emitted right away, so first send the pending
+	 * PropertiesChanged signals of this object. Otherwise, clients would
+	 * see the signal before the property changes that preceded it. */
+	_obj_notify_flush_one (self, obj);
+
 	g_dbus_connection_emit_signal (priv->main_dbus_connection,
 	                               NULL,
 	                               obj->internal.path,
@@ -1593,6 +1910,8 @@ nm_dbus_manager_stop (NMDBusManager *self)
 
 	priv->shutting_down = TRUE;
 
+	_obj_notify_flush (self, TRUE);
+
 	/* during shutdown we also clear the set-property-handler. It's no longer
 	 * possible to set a property, because doing so would require authorization,
 	 * which is async, which is just complicated to get right. No more property
@@ -1616,6 +1935,7 @@ nm_dbus_manager_init (NMDBusManager *self)
 
 	c_list_init (&priv->private_servers_lst_head);
 	c_list_init (&priv->objects_lst_head);
+	c_list_init (&priv->notify_lst_head);
 
 	priv->objects_by_path = g_hash_table_new ((GHashFunc) _objects_by_path_hash, (GEqualFunc) _objects_by_path_equal);
 
@@ -1634,6 +1954,10 @@ dispose (GObject *object)
 	 * expect any remaining objects. */
 	nm_assert (!priv->objects_by_path || g_hash_table_size (priv->objects_by_path) == 0);
 	nm_assert (c_list_is_empty (&priv->objects_lst_head));
+	nm_assert (c_list_is_empty (&priv->notify_lst_head));
+
+	nm_clear_g_source (&priv->notify_idle_id);
+	nm_clear_g_source (&priv->notify_timeout_id);
 
 	nm_clear_pointer (&priv->objects_by_path, g_hash_table_destroy);
 
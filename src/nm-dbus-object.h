@@ -73,6 +73,10 @@ struct _NMDBusObjectInternal {
 	CList objects_lst;
 	CList registration_lst_head;
 
+	/* link in the list of objects with pending PropertiesChanged
+	 * signals of NMDBusManager. */
+	CList notify_lst;
+
 	/* we perform asynchronous operation on exported objects. For example, we receive
 	 * a Set property call, and asynchronously validate the operation. We must make
 	 * sure that when the authentication is complete, that we are still looking at
@@ -122,6 +122,11 @@ typedef struct _NMDBusInterfaceInfoExtended {
 	/* Whether the interface has a legacy property changed signal (@nm_signal_info_property_changed_legacy).
 	 * New interfaces should not use this. */
 	bool legacy_property_changed:1;
+
+	/* If non-zero, PropertiesChanged signals for the interface are emitted at most
+	 * once per this many milliseconds. This is for noisy properties, where clients
+	 * don't care about every single change. */
+	guint16 properties_changed_ratelimit_msec;
 } NMDBusInterfaceInfoExtended;
 
 extern const GDBusSignalInfo nm_signal_info_property_changed_legacy;
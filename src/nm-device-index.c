@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-device-index.h"
+
+#include <linux/if_infiniband.h>
+
+#include "nm-core-internal.h"
+
+/*****************************************************************************/
+
+struct _NMDeviceIndex {
+	/* DevIdxData of all tracked devices. */
+	GHashTable *devices;
+
+	/* the indexes. Each maps the key to a GPtrArray of the devices
+	 * with that key, in the order they got the key. */
+	GHashTable *by_ifindex;
+	GHashTable *by_iface;
+	GHashTable *by_ip_iface;
+	GHashTable *by_perm_hw_addr;
+};
+
+typedef struct {
+	/* this must be the first field, for nm_pdirect_hash(). */
+	NMDevice *device;
+
+	/* the keys under which @device is currently tracked in the
+	 * indexes. */
+	int ifindex;
+	char *iface;
+	char *ip_iface;
+	char *perm_hw_addr;
+} DevIdxData;
+
+/*****************************************************************************/
+
+static void
+_devidx_data_free (gpointer data)
+{
+	DevIdxData *idx_data = data;
+
+	g_free (idx_data->iface);
+	g_free (idx_data->ip_iface);
+	g_free (idx_data->perm_hw_addr);
+	g_slice_free (DevIdxData, idx_data);
+}
+
+static void
+_multi_add (GHashTable *idx, gconstpointer key, gboolean key_is_str, NMDevice *device)
+{
+	GPtrArray *devices;
+
+	devices = g_hash_table_lookup (idx, key);
+	if (!devices) {
+		devices = g_ptr_array_new ();
+		g_hash_table_insert (idx,
+		                     key_is_str ? g_strdup (key) : (gpointer) key,
+		                     devices);
+	}
+	nm_assert (_nm_utils_ptrarray_find_first ((gconstpointer *) devices->pdata, devices->len, device) < 0);
+	g_ptr_array_add (devices, device);
+}
+
+static void
+_multi_remove (GHashTable *idx, gconstpointer key, NMDevice *device)
+{
+	GPtrArray *devices;
+
+	devices = g_hash_table_lookup (idx, key);
+	if (!devices)
+		g_return_if_reached ();
+	if (!g_ptr_array_remove (devices, device))
+		g_return_if_reached ();
+	if (devices->len == 0)
+		g_hash_table_remove (idx, key);
+}
+
+static const GPtrArray *
+_multi_lookup (GHashTable *idx, gconstpointer key)
+{
+	GPtrArray *devices;
+
+	devices = g_hash_table_lookup (idx, key);
+	nm_assert (!devices || devices->len > 0);
+	return devices;
+}
+
+static void
+_update_str (GHashTable *idx, char **p_key, const char *key, NMDevice *device)
+{
+	if (nm_streq0 (*p_key, key))
+		return;
+	if (*p_key) {
+		_multi_remove (idx, *p_key, device);
+		nm_clear_g_free (p_key);
+	}
+	if (key) {
+		*p_key = g_strdup (key);
+		_multi_add (idx, key, TRUE, device);
+	}
+}
+
+static char *
+_hw_addr_normalize (const char *hwaddr)
+{
+	guint8 hwaddr_bin[NM_UTILS_HWADDR_LEN_MAX];
+	gsize hwaddr_len;
+
+	if (!hwaddr)
+		return NULL;
+
+	if (!_nm_utils_hwaddr_aton (hwaddr, hwaddr_bin, sizeof (hwaddr_bin), &hwaddr_len))
+		return NULL;
+
+	/* like nm_utils_hwaddr_matches(), only the last 8 bytes of an InfiniBand
+	 * address are significant. */
+	if (hwaddr_len == INFINIBAND_ALEN)
+		memset (hwaddr_bin, 0, INFINIBAND_ALEN - 8);
+
+	return nm_utils_hwaddr_ntoa (hwaddr_bin, hwaddr_len);
+}
+
+/*****************************************************************************/
+
+guint
+nm_device_index_get_size (const NMDeviceIndex *self)
+{
+	return g_hash_table_size (self->devices);
+}
+
+void
+nm_device_index_add (NMDeviceIndex *self, NMDevice *device)
+{
+	DevIdxData *idx_data;
+
+	nm_assert (device);
+
+	idx_data = g_slice_new0 (DevIdxData);
+	idx_data->device = device;
+	if (!g_hash_table_add (self->devices, idx_data))
+		nm_assert_not_reached ();
+}
+
+void
+nm_device_index_remove (NMDeviceIndex *self, NMDevice *device)
+{
+	nm_device_index_update (self, device, 0, NULL, NULL, NULL);
+	if (!g_hash_table_remove (self->devices, &device))
+		g_return_if_reached ();
+}
+
+/**
+ * nm_device_index_update:
+ * @self: the #NMDeviceIndex
+ * @device: the device
+ * @ifindex: the current ifindex of @device, or a non-positive value
+ * @iface: the current interface name of @device, or %NULL
+ * @ip_iface: the current IP interface name of @device, or %NULL
+ * @perm_hw_addr: the current permanent MAC address of @device, or %NULL
+ *
+ * Moves @device to the keys it currently has. Devices that are not
+ * tracked are ignored.
+ */
+void
+nm_device_index_update (NMDeviceIndex *self,
+                        NMDevice *device,
+                        int ifindex,
+                        const char *iface,
+                        const char *ip_iface,
+                        const char *perm_hw_addr)
+{
+	gs_free char *perm_hw_addr_norm = NULL;
+	DevIdxData *idx_data;
+
+	idx_data = g_hash_table_lookup (self->devices, &device);
+	if (!idx_data)
+		return;
+
+	if (ifindex <= 0)
+		ifindex = 0;
+	if (idx_data->ifindex != ifindex) {
+		if (idx_data->ifindex > 0)
+			_multi_remove (self->by_ifindex, GINT_TO_POINTER (idx_data->ifindex), device);
+		idx_data->ifindex = ifindex;
+		if (ifindex > 0)
+			_multi_add (self->by_ifindex, GINT_TO_POINTER (ifindex), FALSE, device);
+	}
+
+	_update_str (self->by_iface, &idx_data->iface, iface, device);
+	_update_str (self->by_ip_iface, &idx_data->ip_iface, ip_iface, device);
+
+	perm_hw_addr_norm = _hw_addr_normalize (perm_hw_addr);
+	_update_str (self->by_perm_hw_addr, &idx_data->perm_hw_addr, perm_hw_addr_norm, device);
+}
+
+/*****************************************************************************/
+
+const GPtrArray *
+nm_device_index_lookup_ifindex (const NMDeviceIndex *self, int ifindex)
+{
+	if (ifindex <= 0)
+		return NULL;
+	return _multi_lookup (self->by_ifindex, GINT_TO_POINTER (ifindex));
+}
+
+const GPtrArray *
+nm_device_index_lookup_iface (const NMDeviceIndex *self, const char *iface)
+{
+	if (!iface)
+		return NULL;
+	return _multi_lookup (self->by_iface, iface);
+}
+
+const GPtrArray *
+nm_device_index_lookup_ip_iface (const NMDeviceIndex *self, const char *ip_iface)
+{
+	if (!ip_iface)
+		return NULL;
+	return _multi_lookup (self->by_ip_iface, ip_iface);
+}
+
+const GPtrArray *
+nm_device_index_lookup_perm_hw_addr (const NMDeviceIndex *self, const char *hwaddr)
+{
+	gs_free char *hwaddr_norm = NULL;
+
+	hwaddr_norm = _hw_addr_normalize (hwaddr);
+	if (!hwaddr_norm)
+		return NULL;
+	return _multi_lookup (self->by_perm_hw_addr, hwaddr_norm);
+}
+
+/*****************************************************************************/
+
+NMDeviceIndex *
+nm_device_index_new (void)
+{
+	NMDeviceIndex *self;
+
+	self = g_slice_new (NMDeviceIndex);
+	*self = (NMDeviceIndex) {
+		.devices         = g_hash_table_new_full (nm_pdirect_hash, nm_pdirect_equal, _devidx_data_free, NULL),
+		.by_ifindex      = g_hash_table_new_full (nm_direct_hash, NULL, NULL, (GDestroyNotify) g_ptr_array_unref),
+		.by_iface        = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref),
+		.by_ip_iface     = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref),
+		.by_perm_hw_addr = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref),
+	};
+	return self;
+}
+
+void
+nm_device_index_free (NMDeviceIndex *self)
+{
+	if (!self)
+		return;
+
+	g_hash_table_unref (self->devices);
+	g_hash_table_unref (self->by_ifindex);
+	g_hash_table_unref (self->by_iface);
+	g_hash_table_unref (self->by_ip_iface);
+	g_hash_table_unref (self->by_perm_hw_addr);
+	g_slice_free (NMDeviceIndex, self);
+}
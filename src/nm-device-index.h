@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#ifndef __NM_DEVICE_INDEX_H__
+#define __NM_DEVICE_INDEX_H__
+
+/* Indexes of the devices known to NMManager, by ifindex, interface name,
+ * IP interface name and permanent MAC address. The index does not read the
+ * keys from the devices (nor otherwise dereferences them), the owner must
+ * pass the current values with nm_device_index_update(). */
+typedef struct _NMDeviceIndex NMDeviceIndex;
+
+NMDeviceIndex *nm_device_index_new (void);
+
+void nm_device_index_free (NMDeviceIndex *self);
+
+guint nm_device_index_get_size (const NMDeviceIndex *self);
+
+void nm_device_index_add (NMDeviceIndex *self, NMDevice *device);
+
+void nm_device_index_remove (NMDeviceIndex *self, NMDevice *device);
+
+void nm_device_index_update (NMDeviceIndex *self,
+                             NMDevice *device,
+                             int ifindex,
+                             const char *iface,
+                             const char *ip_iface,
+                             const char *perm_hw_addr);
+
+const GPtrArray *nm_device_index_lookup_ifindex (const NMDeviceIndex *self, int ifindex);
+
+const GPtrArray *nm_device_index_lookup_iface (const NMDeviceIndex *self, const char *iface);
+
+const GPtrArray *nm_device_index_lookup_ip_iface (const NMDeviceIndex *self, const char *ip_iface);
+
+const GPtrArray *nm_device_index_lookup_perm_hw_addr (const NMDeviceIndex *self, const char *hwaddr);
+
+#endif /* __NM_DEVICE_INDEX_H__ */
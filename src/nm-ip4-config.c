@@ -276,6 +276,8 @@ NM_GOBJECT_PROPERTIES_DEFINE (NMIP4Config,
 
 typedef struct {
 	bool metered:1;
+	bool addresses_fingerprint_valid:1;
+	bool dns_fingerprint_valid:1;
 	guint32 mtu;
 	int ifindex;
 	NMIPConfigSource mtu_source;
@@ -304,6 +306,14 @@ typedef struct {
 		NMDedupMultiIdxType idx_ip4_routes;
 	};
 	NMIPConfigFlags config_flags;
+
+	/* see nm_ip4_config_get_fingerprint(). The routes fingerprint is
+	 * the sum of the fingerprints of all routes and updated whenever
+	 * a route gets added or removed. The other fingerprints are cached
+	 * and recomputed after they got invalidated. */
+	guint64 routes_fingerprint;
+	guint64 addresses_fingerprint;
+	guint64 dns_fingerprint;
 } NMIP4ConfigPrivate;
 
 struct _NMIP4Config {
@@ -492,11 +502,52 @@ nmtst_ip4_config_get_gateway (NMIP4Config *config)
 
 /*****************************************************************************/
 
+static guint64
+_route_fingerprint (const NMPObject *obj)
+{
+	const NMPlatformIP4Route *route = NMP_OBJECT_CAST_IP4_ROUTE (obj);
+	NMHashState h;
+
+	nm_hash_init (&h, 3894152111u);
+	nm_hash_update_vals (&h,
+	                     route->network,
+	                     route->plen,
+	                     route->gateway,
+	                     route->metric);
+	return nm_hash_complete_u64 (&h);
+}
+
+static void
+_routes_fingerprint_update (NMIP4ConfigPrivate *priv,
+                            const NMPObject *obj_old,
+                            const NMPObject *obj_new)
+{
+	if (obj_old)
+		priv->routes_fingerprint -= _route_fingerprint (obj_old);
+	if (obj_new)
+		priv->routes_fingerprint += _route_fingerprint (obj_new);
+}
+
+static guint64
+_routes_fingerprint_compute (const NMIP4Config *self)
+{
+	NMDedupMultiIter ipconf_iter;
+	const NMPlatformIP4Route *route;
+	guint64 fingerprint = 0;
+
+	nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, self, &route)
+		fingerprint += _route_fingerprint (NMP_OBJECT_UP_CAST (route));
+	return fingerprint;
+}
+
+/*****************************************************************************/
+
 static void
 _notify_addresses (NMIP4Config *self)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	priv->addresses_fingerprint_valid = FALSE;
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
 	nm_gobject_notify_together (self, PROP_ADDRESS_DATA,
@@ -509,6 +560,7 @@ _notify_routes (NMIP4Config *self)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
 	nm_assert (priv->best_default_route == _nm_ip4_config_best_default_route_find (self));
+	nm_assert (priv->routes_fingerprint == _routes_fingerprint_compute (self));
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
 	nm_gobject_notify_together (self, PROP_ROUTE_DATA,
@@ -1449,6 +1501,7 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 		                                     &dst_priv->idx_ip4_routes,
 		                                     o_lookup,
 		                                     (gconstpointer *) &obj_old)) {
+			_routes_fingerprint_update (dst_priv, obj_old, NULL);
 			if (dst_priv->best_default_route == obj_old) {
 				nm_clear_nmp_object (&dst_priv->best_default_route);
 				changed_default_route = TRUE;
@@ -1606,6 +1659,7 @@ _nm_ip4_config_intersect_helper (NMIP4Config *dst,
 		if (!update_dst)
 			return TRUE;
 
+		_routes_fingerprint_update (dst_priv, o_dst, NULL);
 		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx,
 		                                       ipconf_iter.current) != 1)
 			nm_assert_not_reached ();
@@ -1798,7 +1852,10 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 		_notify_addresses (dst);
 	}
 
-	/* routes */
+	/* routes. The order of the routes is not relevant, whether the
+	 * relevant parts differ is told by the fingerprint. */
+	if (src_priv->routes_fingerprint != dst_priv->routes_fingerprint)
+		has_relevant_changes = TRUE;
 	head_entry_src = nm_ip4_config_lookup_routes (src);
 	nm_dedup_multi_iter_init (&ipconf_iter_src, head_entry_src);
 	nm_ip_config_iter_ip4_route_init (&ipconf_iter_dst, dst);
@@ -1811,7 +1868,6 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 		has = nm_ip_config_iter_ip4_route_next (&ipconf_iter_src, &r_src);
 		if (has != nm_ip_config_iter_ip4_route_next (&ipconf_iter_dst, &r_dst)) {
 			are_equal = FALSE;
-			has_relevant_changes = TRUE;
 			break;
 		}
 		if (!has)
@@ -1819,13 +1875,7 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 
 		if (nm_platform_ip4_route_cmp_full (r_src, r_dst) != 0) {
 			are_equal = FALSE;
-			if (   r_src->plen != r_dst->plen
-			    || !nm_utils_ip4_address_same_prefix (r_src->network, r_dst->network, r_src->plen)
-			    || r_src->gateway != r_dst->gateway
-			    || r_src->metric != r_dst->metric) {
-				has_relevant_changes = TRUE;
-				break;
-			}
+			break;
 		}
 	}
 	if (!are_equal) {
@@ -1848,6 +1898,7 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 			new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, obj_new);
 		}
 		nm_dedup_multi_index_dirty_remove_idx (dst_priv->multi_idx, &dst_priv->idx_ip4_routes, FALSE);
+		dst_priv->routes_fingerprint = src_priv->routes_fingerprint;
 		if (_nm_ip_config_best_default_route_set (&dst_priv->best_default_route, new_best_default_route))
 			_notify (dst, PROP_GATEWAY);
 		_notify_routes (dst);
@@ -1930,11 +1981,13 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 
 	if (src_priv->mdns != dst_priv->mdns) {
 		dst_priv->mdns = src_priv->mdns;
+		dst_priv->dns_fingerprint_valid = FALSE;
 		has_relevant_changes = TRUE;
 	}
 
 	if (src_priv->llmnr != dst_priv->llmnr) {
 		dst_priv->llmnr = src_priv->llmnr;
+		dst_priv->dns_fingerprint_valid = FALSE;
 		has_relevant_changes = TRUE;
 	}
 
@@ -2102,6 +2155,65 @@ nm_ip_config_dump (const NMIPConfig *self,
 	}
 }
 
+/**
+ * nm_ip_config_route_delta_apply:
+ * @self: a configuration that was captured from @platform
+ * @platform: the platform instance
+ * @route_id: a route that changed in @platform since @self was captured
+ *   or last updated. Only its ID is relevant.
+ * @exclude_func: (allow-none): if given, routes for which the function
+ *   returns %TRUE are removed from @self instead of being added.
+ * @user_data: user data for @exclude_func
+ * @out_plobj: (out) (allow-none): the current route in the platform cache,
+ *   or %NULL if the route is gone.
+ *
+ * Updates @self for one changed route, with the same result as if the
+ * routes were captured anew from @platform.
+ *
+ * Returns: whether @self changed.
+ */
+gboolean
+nm_ip_config_route_delta_apply (NMIPConfig *self,
+                                NMPlatform *platform,
+                                const NMPObject *route_id,
+                                NMIPConfigRouteExcludeFunc exclude_func,
+                                gpointer user_data,
+                                const NMPObject **out_plobj)
+{
+	const NMPObject *plobj;
+	const NMPObject *o;
+
+	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (route_id), NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                                    NMP_OBJECT_TYPE_IP6_ROUTE));
+	nm_assert (   (NMP_OBJECT_GET_TYPE (route_id) == NMP_OBJECT_TYPE_IP4_ROUTE)
+	           == (nm_ip_config_get_addr_family (self) == AF_INET));
+
+	/* the platform cache has the current state of the route, regardless
+	 * of how often it changed in the meantime. */
+	plobj = nm_platform_lookup_obj (platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, route_id);
+	if (   plobj
+	    && (   !nmp_object_is_visible (plobj)
+	        || NMP_OBJECT_CAST_IP_ROUTE (plobj)->ifindex != nm_ip_config_get_ifindex (self)))
+		plobj = NULL;
+
+	NM_SET_OUT (out_plobj, plobj);
+
+	if (!plobj)
+		return nm_ip_config_nmpobj_remove (self, route_id);
+
+	if (   exclude_func
+	    && exclude_func (plobj, user_data))
+		return nm_ip_config_nmpobj_remove (self, plobj);
+
+	o = nm_ip_config_nmpobj_lookup (self, plobj);
+	if (   o
+	    && nmp_object_equal (o, plobj))
+		return FALSE;
+
+	nm_ip_config_add_route (self, NMP_OBJECT_CAST_IP_ROUTE (plobj), NULL);
+	return TRUE;
+}
+
 /*****************************************************************************/
 
 void
@@ -2243,6 +2355,7 @@ nm_ip4_config_reset_routes (NMIP4Config *self)
 
 	if (nm_dedup_multi_index_remove_idx (priv->multi_idx,
 	                                     &priv->idx_ip4_routes) > 0) {
+		priv->routes_fingerprint = 0;
 		if (nm_clear_nmp_object (&priv->best_default_route))
 			_notify (self, PROP_GATEWAY);
 		_notify_routes (self);
@@ -2274,6 +2387,7 @@ _add_route (NMIP4Config *self,
 	                           &obj_new_2)) {
 		gboolean changed_default_route = FALSE;
 
+		_routes_fingerprint_update (priv, obj_old, obj_new_2);
 		if (   priv->best_default_route == obj_old
 		    && obj_old != obj_new_2) {
 			changed_default_route = TRUE;
@@ -2393,6 +2507,7 @@ nm_ip4_config_reset_nameservers (NMIP4Config *self)
 
 	if (priv->nameservers->len != 0) {
 		g_array_set_size (priv->nameservers, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		nm_gobject_notify_together (self, PROP_NAMESERVER_DATA,
 		                                  PROP_NAMESERVERS);
 	}
@@ -2411,6 +2526,7 @@ nm_ip4_config_add_nameserver (NMIP4Config *self, guint32 new)
 			return;
 
 	g_array_append_val (priv->nameservers, new);
+	priv->dns_fingerprint_valid = FALSE;
 	nm_gobject_notify_together (self, PROP_NAMESERVER_DATA,
 	                                  PROP_NAMESERVERS);
 }
@@ -2423,6 +2539,7 @@ nm_ip4_config_del_nameserver (NMIP4Config *self, guint i)
 	g_return_if_fail (i < priv->nameservers->len);
 
 	g_array_remove_index (priv->nameservers, i);
+	priv->dns_fingerprint_valid = FALSE;
 	nm_gobject_notify_together (self, PROP_NAMESERVER_DATA,
 	                                  PROP_NAMESERVERS);
 }
@@ -2485,6 +2602,7 @@ nm_ip4_config_reset_domains (NMIP4Config *self)
 
 	if (priv->domains->len != 0) {
 		g_ptr_array_set_size (priv->domains, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_DOMAINS);
 	}
 }
@@ -2494,8 +2612,10 @@ nm_ip4_config_add_domain (NMIP4Config *self, const char *domain)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-	if (_nm_ip_config_check_and_add_domain (priv->domains, domain))
+	if (_nm_ip_config_check_and_add_domain (priv->domains, domain)) {
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_DOMAINS);
+	}
 }
 
 void
@@ -2506,6 +2626,7 @@ nm_ip4_config_del_domain (NMIP4Config *self, guint i)
 	g_return_if_fail (i < priv->domains->len);
 
 	g_ptr_array_remove_index (priv->domains, i);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_DOMAINS);
 }
 
@@ -2534,6 +2655,7 @@ nm_ip4_config_reset_searches (NMIP4Config *self)
 
 	if (priv->searches->len != 0) {
 		g_ptr_array_set_size (priv->searches, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_SEARCHES);
 	}
 }
@@ -2543,8 +2665,10 @@ nm_ip4_config_add_search (NMIP4Config *self, const char *search)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-	if (_nm_ip_config_check_and_add_domain (priv->searches, search))
+	if (_nm_ip_config_check_and_add_domain (priv->searches, search)) {
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_SEARCHES);
+	}
 }
 
 void
@@ -2555,6 +2679,7 @@ nm_ip4_config_del_search (NMIP4Config *self, guint i)
 	g_return_if_fail (i < priv->searches->len);
 
 	g_ptr_array_remove_index (priv->searches, i);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_SEARCHES);
 }
 
@@ -2583,6 +2708,7 @@ nm_ip4_config_reset_dns_options (NMIP4Config *self)
 
 	if (priv->dns_options->len != 0) {
 		g_ptr_array_set_size (priv->dns_options, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_DNS_OPTIONS);
 	}
 }
@@ -2601,6 +2727,7 @@ nm_ip4_config_add_dns_option (NMIP4Config *self, const char *new)
 			return;
 
 	g_ptr_array_add (priv->dns_options, g_strdup (new));
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2612,6 +2739,7 @@ nm_ip4_config_del_dns_option(NMIP4Config *self, guint i)
 	g_return_if_fail (i < priv->dns_options->len);
 
 	g_ptr_array_remove_index (priv->dns_options, i);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2643,7 +2771,12 @@ void
 nm_ip4_config_mdns_set (NMIP4Config *self,
                         NMSettingConnectionMdns mdns)
 {
-	NM_IP4_CONFIG_GET_PRIVATE (self)->mdns = mdns;
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+
+	if (priv->mdns != mdns) {
+		priv->mdns = mdns;
+		priv->dns_fingerprint_valid = FALSE;
+	}
 }
 
 NMSettingConnectionLlmnr
@@ -2656,7 +2789,12 @@ void
 nm_ip4_config_llmnr_set (NMIP4Config *self,
                          NMSettingConnectionLlmnr llmnr)
 {
-	NM_IP4_CONFIG_GET_PRIVATE (self)->llmnr = llmnr;
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+
+	if (priv->llmnr != llmnr) {
+		priv->llmnr = llmnr;
+		priv->dns_fingerprint_valid = FALSE;
+	}
 }
 
 /*****************************************************************************/
@@ -2777,6 +2915,7 @@ nm_ip4_config_reset_wins (NMIP4Config *self)
 
 	if (priv->wins->len != 0) {
 		g_array_set_size (priv->wins, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		nm_gobject_notify_together (self, PROP_WINS_SERVER_DATA,
 		                                  PROP_WINS_SERVERS);
 	}
@@ -2795,6 +2934,7 @@ nm_ip4_config_add_wins (NMIP4Config *self, guint32 wins)
 			return;
 
 	g_array_append_val (priv->wins, wins);
+	priv->dns_fingerprint_valid = FALSE;
 	nm_gobject_notify_together (self, PROP_WINS_SERVER_DATA,
 	                                  PROP_WINS_SERVERS);
 }
@@ -2807,6 +2947,7 @@ nm_ip4_config_del_wins (NMIP4Config *self, guint i)
 	g_return_if_fail (i < priv->wins->len);
 
 	g_array_remove_index (priv->wins, i);
+	priv->dns_fingerprint_valid = FALSE;
 	nm_gobject_notify_together (self, PROP_WINS_SERVER_DATA,
 	                                  PROP_WINS_SERVERS);
 }
@@ -2941,6 +3082,7 @@ nm_ip4_config_nmpobj_remove (NMIP4Config *self,
 		_notify_addresses (self);
 		break;
 	case NMP_OBJECT_TYPE_IP4_ROUTE:
+		_routes_fingerprint_update (priv, obj_old, NULL);
 		if (priv->best_default_route == obj_old) {
 			if (_nm_ip_config_best_default_route_set (&priv->best_default_route,
 			                                          _nm_ip4_config_best_default_route_find (self)))
@@ -2956,86 +3098,135 @@ nm_ip4_config_nmpobj_remove (NMIP4Config *self,
 
 /*****************************************************************************/
 
-static void
-hash_u32 (GChecksum *sum, guint32 n)
-{
-	g_checksum_update (sum, (const guint8 *) &n, sizeof (n));
-}
-
-void
-nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only)
+static guint64
+_addresses_fingerprint_compute (const NMIP4Config *self)
 {
-	guint i;
-	const char *s;
 	NMDedupMultiIter ipconf_iter;
 	const NMPlatformIP4Address *address;
-	const NMPlatformIP4Route *route;
-	int val;
-
-	g_return_if_fail (self);
-	g_return_if_fail (sum);
-
-	if (!dns_only) {
-		nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, self, &address) {
-			hash_u32 (sum, address->address);
-			hash_u32 (sum, address->plen);
-			hash_u32 (sum, address->peer_address & _nm_utils_ip4_prefix_to_netmask (address->plen));
-		}
-
-		nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, self, &route) {
-			hash_u32 (sum, route->network);
-			hash_u32 (sum, route->plen);
-			hash_u32 (sum, route->gateway);
-			hash_u32 (sum, route->metric);
-		}
+	guint64 fingerprint = 0;
 
-		for (i = 0; i < nm_ip4_config_get_num_nis_servers (self); i++)
-			hash_u32 (sum, nm_ip4_config_get_nis_server (self, i));
+	nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, self, &address) {
+		NMHashState h;
 
-		s = nm_ip4_config_get_nis_domain (self);
-		if (s)
-			g_checksum_update (sum, (const guint8 *) s, strlen (s));
+		nm_hash_init (&h, 2453164531u);
+		nm_hash_update_vals (&h,
+		                     address->address,
+		                     address->plen,
+		                     address->peer_address & _nm_utils_ip4_prefix_to_netmask (address->plen));
+		fingerprint = _nm_ip_config_fingerprint_append (fingerprint, nm_hash_complete_u64 (&h));
 	}
+	return fingerprint;
+}
 
-	for (i = 0; i < nm_ip4_config_get_num_nameservers (self); i++)
-		hash_u32 (sum, nm_ip4_config_get_nameserver (self, i));
-
-	for (i = 0; i < nm_ip4_config_get_num_wins (self); i++)
-		hash_u32 (sum, nm_ip4_config_get_wins (self, i));
+static guint64
+_nis_fingerprint_compute (const NMIP4Config *self)
+{
+	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	NMHashState h;
 
-	for (i = 0; i < nm_ip4_config_get_num_domains (self); i++) {
-		s = nm_ip4_config_get_domain (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+	if (   priv->nis->len == 0
+	    && !priv->nis_domain)
+		return 0;
 
-	for (i = 0; i < nm_ip4_config_get_num_searches (self); i++) {
-		s = nm_ip4_config_get_search (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+	nm_hash_init (&h, 1830157493u);
+	nm_hash_update_val (&h, priv->nis->len);
+	nm_hash_update (&h, priv->nis->data, priv->nis->len * sizeof (guint32));
+	nm_hash_update_str0 (&h, priv->nis_domain);
+	return nm_hash_complete_u64 (&h);
+}
 
-	for (i = 0; i < nm_ip4_config_get_num_dns_options (self); i++) {
-		s = nm_ip4_config_get_dns_option (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+static guint64
+_dns_fingerprint_compute (const NMIP4Config *self)
+{
+	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	NMHashState h;
+	guint i;
 
-	val = nm_ip4_config_mdns_get (self);
-	if (val != NM_SETTING_CONNECTION_MDNS_DEFAULT)
-		g_checksum_update (sum, (const guint8 *) &val, sizeof (val));
+	/* a configuration without DNS parameters must have a zero fingerprint.
+	 * The DNS manager relies on that. */
+	if (   priv->nameservers->len == 0
+	    && priv->wins->len == 0
+	    && priv->domains->len == 0
+	    && priv->searches->len == 0
+	    && priv->dns_options->len == 0
+	    && priv->mdns == NM_SETTING_CONNECTION_MDNS_DEFAULT
+	    && priv->llmnr == NM_SETTING_CONNECTION_LLMNR_DEFAULT)
+		return 0;
 
-	val = nm_ip4_config_llmnr_get (self);
-	if (val != NM_SETTING_CONNECTION_LLMNR_DEFAULT)
-		g_checksum_update (sum, (const guint8 *) &val, sizeof (val));
+	nm_hash_init (&h, 1217838131u);
+	nm_hash_update_val (&h, priv->nameservers->len);
+	nm_hash_update (&h, priv->nameservers->data, priv->nameservers->len * sizeof (guint32));
+	nm_hash_update_val (&h, priv->wins->len);
+	nm_hash_update (&h, priv->wins->data, priv->wins->len * sizeof (guint32));
+	nm_hash_update_val (&h, priv->domains->len);
+	for (i = 0; i < priv->domains->len; i++)
+		nm_hash_update_str (&h, priv->domains->pdata[i]);
+	nm_hash_update_val (&h, priv->searches->len);
+	for (i = 0; i < priv->searches->len; i++)
+		nm_hash_update_str (&h, priv->searches->pdata[i]);
+	nm_hash_update_val (&h, priv->dns_options->len);
+	for (i = 0; i < priv->dns_options->len; i++)
+		nm_hash_update_str (&h, priv->dns_options->pdata[i]);
+	nm_hash_update_vals (&h,
+	                     priv->mdns,
+	                     priv->llmnr);
 
 	/* FIXME(ip-config-checksum): the DNS priority should be considered relevant
-	 * and added into the checksum as well, but this can't be done right now
+	 * and added into the fingerprint as well, but this can't be done right now
 	 * because in the DNS manager we rely on the fact that an empty
-	 * configuration (i.e. just created) has a zero checksum. This is needed to
+	 * configuration (i.e. just created) has a zero fingerprint. This is needed to
 	 * avoid rewriting resolv.conf when there is no change.
 	 *
 	 * The DNS priority initial value depends on the connection type (VPN or
-	 * not), so it's a bit difficult to add it to checksum maintaining the
-	 * assumption of checksum(empty)=0
-	 */
+	 * not), so it's a bit difficult to add it to fingerprint maintaining the
+	 * assumption of fingerprint(empty)=0 */
+	return nm_hash_complete_u64 (&h) ?: 1;
+}
+
+/**
+ * nm_ip4_config_get_fingerprint:
+ * @self: the #NMIP4Config
+ * @dns_only: whether to only consider the DNS related parameters
+ *
+ * The fingerprint is a 64 bit hash over the relevant parts of the
+ * configuration. The part for the routes is updated as routes get added
+ * and removed, the parts for the addresses and the DNS parameters are
+ * cached until they change. Note that the fingerprint depends on the
+ * order of the addresses and DNS parameters, but not on the order of
+ * the routes.
+ *
+ * Returns: the fingerprint of @self. A configuration without DNS
+ *   parameters has a zero fingerprint with @dns_only.
+ */
+guint64
+nm_ip4_config_get_fingerprint (const NMIP4Config *self, gboolean dns_only)
+{
+	NMIP4ConfigPrivate *priv;
+	guint64 fingerprint = 0;
+
+	g_return_val_if_fail (NM_IS_IP4_CONFIG (self), 0);
+
+	/* the fingerprints are only a cache, it's fine to update them on a
+	 * const instance. */
+	priv = (NMIP4ConfigPrivate *) NM_IP4_CONFIG_GET_PRIVATE (self);
+
+	if (!dns_only) {
+		if (!priv->addresses_fingerprint_valid) {
+			priv->addresses_fingerprint = _addresses_fingerprint_compute (self);
+			priv->addresses_fingerprint_valid = TRUE;
+		}
+		nm_assert (priv->routes_fingerprint == _routes_fingerprint_compute (self));
+
+		fingerprint = _nm_ip_config_fingerprint_append (fingerprint, priv->addresses_fingerprint);
+		fingerprint = _nm_ip_config_fingerprint_append (fingerprint, priv->routes_fingerprint);
+		fingerprint = _nm_ip_config_fingerprint_append (fingerprint, _nis_fingerprint_compute (self));
+	}
+
+	if (!priv->dns_fingerprint_valid) {
+		priv->dns_fingerprint = _dns_fingerprint_compute (self);
+		priv->dns_fingerprint_valid = TRUE;
+	}
+	return _nm_ip_config_fingerprint_append (fingerprint, priv->dns_fingerprint);
 }
 
 /**
@@ -3044,9 +3235,12 @@ nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only)
  * @b: second config to compare
  *
  * Compares two #NMIP4Configs for basic equality.  This means that all
- * attributes must exist in the same order in both configs (addresses, routes,
- * domains, DNS servers, etc) but some attributes (address lifetimes, and address
- * and route sources) are ignored.
+ * attributes must exist in the same order in both configs (addresses,
+ * domains, DNS servers, etc) but some attributes (address lifetimes, address
+ * and route sources, and the order of the routes) are ignored.
+ *
+ * This compares the fingerprints of the configurations, see
+ * nm_ip4_config_get_fingerprint().
  *
  * Returns: %TRUE if the configurations are basically equal to each other,
  * %FALSE if not
@@ -3054,19 +3248,8 @@ nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only)
 gboolean
 nm_ip4_config_equal (const NMIP4Config *a, const NMIP4Config *b)
 {
-	nm_auto_free_checksum GChecksum *a_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	nm_auto_free_checksum GChecksum *b_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	guint8 a_data[NM_UTILS_CHECKSUM_LENGTH_SHA1];
-	guint8 b_data[NM_UTILS_CHECKSUM_LENGTH_SHA1];
-
-	if (a)
-		nm_ip4_config_hash (a, a_checksum, FALSE);
-	if (b)
-		nm_ip4_config_hash (b, b_checksum, FALSE);
-
-	nm_utils_checksum_get_digest (a_checksum, a_data);
-	nm_utils_checksum_get_digest (b_checksum, b_data);
-	return !memcmp (a_data, b_data, sizeof (a_data));
+	return    (a ? nm_ip4_config_get_fingerprint (a, FALSE) : 0)
+	       == (b ? nm_ip4_config_get_fingerprint (b, FALSE) : 0);
 }
 
 /*****************************************************************************/
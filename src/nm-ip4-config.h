@@ -30,6 +30,14 @@ typedef struct {
 
 void nm_ip_config_dedup_multi_idx_type_init (NMIPConfigDedupMultiIdxType *idx_type, NMPObjectType obj_type);
 
+/* Mix @value into the order dependent @fingerprint. The fingerprint
+ * of an empty list is zero. */
+static inline guint64
+_nm_ip_config_fingerprint_append (guint64 fingerprint, guint64 value)
+{
+	return (fingerprint * G_GUINT64_CONSTANT (0x100000001b3)) ^ value;
+}
+
 /*****************************************************************************/
 
 void nm_ip_config_iter_ip4_address_init (NMDedupMultiIter *iter, const NMIP4Config *self);
@@ -291,7 +299,7 @@ const NMPObject *nm_ip4_config_nmpobj_lookup (const NMIP4Config *self,
 gboolean nm_ip4_config_nmpobj_remove (NMIP4Config *self,
                                       const NMPObject *needle);
 
-void nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only);
+guint64 nm_ip4_config_get_fingerprint (const NMIP4Config *self, gboolean dns_only);
 gboolean nm_ip4_config_equal (const NMIP4Config *a, const NMIP4Config *b);
 
 gboolean _nm_ip_config_check_and_add_domain (GPtrArray *array, const char *domain);
@@ -301,6 +309,15 @@ void nm_ip_config_dump (const NMIPConfig *self,
                         NMLogLevel level,
                         NMLogDomain domain);
 
+typedef gboolean (*NMIPConfigRouteExcludeFunc) (const NMPObject *obj, gpointer user_data);
+
+gboolean nm_ip_config_route_delta_apply (NMIPConfig *self,
+                                         NMPlatform *platform,
+                                         const NMPObject *route_id,
+                                         NMIPConfigRouteExcludeFunc exclude_func,
+                                         gpointer user_data,
+                                         const NMPObject **out_plobj);
+
 /*****************************************************************************/
 
 #include "nm-ip6-config.h"
@@ -402,10 +419,10 @@ nm_ip_config_get_ifindex (const NMIPConfig *self)
 	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_get_ifindex, nm_ip6_config_get_ifindex);
 }
 
-static inline void
-nm_ip_config_hash (const NMIPConfig *self, GChecksum *sum, gboolean dns_only)
+static inline guint64
+nm_ip_config_get_fingerprint (const NMIPConfig *self, gboolean dns_only)
 {
-	_NM_IP_CONFIG_DISPATCH_VOID (self, nm_ip4_config_hash, nm_ip6_config_hash, sum, dns_only);
+	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_get_fingerprint, nm_ip6_config_get_fingerprint, dns_only);
 }
 
 static inline void
@@ -434,6 +451,18 @@ nm_ip_config_reset_routes (NMIPConfig *self)
 	_NM_IP_CONFIG_DISPATCH_VOID (self, nm_ip4_config_reset_routes, nm_ip6_config_reset_routes);
 }
 
+static inline const NMPObject *
+nm_ip_config_nmpobj_lookup (const NMIPConfig *self, const NMPObject *needle)
+{
+	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_nmpobj_lookup, nm_ip6_config_nmpobj_lookup, needle);
+}
+
+static inline gboolean
+nm_ip_config_nmpobj_remove (NMIPConfig *self, const NMPObject *needle)
+{
+	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_nmpobj_remove, nm_ip6_config_nmpobj_remove, needle);
+}
+
 static inline int
 nm_ip_config_get_dns_priority (const NMIPConfig *self)
 {
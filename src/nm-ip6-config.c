@@ -64,7 +64,18 @@ typedef struct {
 		NMDedupMultiIdxType idx_ip6_routes;
 	};
 	NMIPConfigFlags config_flags;
+
+	/* see nm_ip6_config_get_fingerprint(). The routes fingerprint is
+	 * the sum of the fingerprints of all routes and updated whenever
+	 * a route gets added or removed. The other fingerprints are cached
+	 * and recomputed after they got invalidated. */
+	guint64 routes_fingerprint;
+	guint64 addresses_fingerprint;
+	guint64 dns_fingerprint;
+
 	bool ipv6_disabled;
+	bool addresses_fingerprint_valid:1;
+	bool dns_fingerprint_valid:1;
 } NMIP6ConfigPrivate;
 
 struct _NMIP6Config {
@@ -188,11 +199,52 @@ _nm_ip6_config_best_default_route_find (const NMIP6Config *self)
 
 /*****************************************************************************/
 
+static guint64
+_route_fingerprint (const NMPObject *obj)
+{
+	const NMPlatformIP6Route *route = NMP_OBJECT_CAST_IP6_ROUTE (obj);
+	NMHashState h;
+
+	nm_hash_init (&h, 2707614277u);
+	nm_hash_update_in6addr (&h, &route->network);
+	nm_hash_update_in6addr (&h, &route->gateway);
+	nm_hash_update_vals (&h,
+	                     route->plen,
+	                     route->metric);
+	return nm_hash_complete_u64 (&h);
+}
+
+static void
+_routes_fingerprint_update (NMIP6ConfigPrivate *priv,
+                            const NMPObject *obj_old,
+                            const NMPObject *obj_new)
+{
+	if (obj_old)
+		priv->routes_fingerprint -= _route_fingerprint (obj_old);
+	if (obj_new)
+		priv->routes_fingerprint += _route_fingerprint (obj_new);
+}
+
+static guint64
+_routes_fingerprint_compute (const NMIP6Config *self)
+{
+	NMDedupMultiIter ipconf_iter;
+	const NMPlatformIP6Route *route;
+	guint64 fingerprint = 0;
+
+	nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, self, &route)
+		fingerprint += _route_fingerprint (NMP_OBJECT_UP_CAST (route));
+	return fingerprint;
+}
+
+/*****************************************************************************/
+
 static void
 _notify_addresses (NMIP6Config *self)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
+	priv->addresses_fingerprint_valid = FALSE;
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
 	nm_gobject_notify_together (self, PROP_ADDRESS_DATA,
@@ -205,6 +257,7 @@ _notify_routes (NMIP6Config *self)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
 	nm_assert (priv->best_default_route == _nm_ip6_config_best_default_route_find (self));
+	nm_assert (priv->routes_fingerprint == _routes_fingerprint_compute (self));
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
 	nm_gobject_notify_together (self, PROP_ROUTE_DATA,
@@ -1060,6 +1113,7 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 		                                     &dst_priv->idx_ip6_routes,
 		                                     o_lookup,
 		                                     (gconstpointer *) &obj_old)) {
+			_routes_fingerprint_update (dst_priv, obj_old, NULL);
 			if (dst_priv->best_default_route == obj_old) {
 				nm_clear_nmp_object (&dst_priv->best_default_route);
 				changed_default_route = TRUE;
@@ -1187,6 +1241,7 @@ _nm_ip6_config_intersect_helper (NMIP6Config *dst,
 		if (!update_dst)
 			return TRUE;
 
+		_routes_fingerprint_update (dst_priv, o_dst, NULL);
 		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx,
 		                                       ipconf_iter.current) != 1)
 			nm_assert_not_reached ();
@@ -1379,7 +1434,10 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 		_notify_addresses (dst);
 	}
 
-	/* routes */
+	/* routes. The order of the routes is not relevant, whether the
+	 * relevant parts differ is told by the fingerprint. */
+	if (src_priv->routes_fingerprint != dst_priv->routes_fingerprint)
+		has_relevant_changes = TRUE;
 	head_entry_src = nm_ip6_config_lookup_routes (src);
 	nm_dedup_multi_iter_init (&ipconf_iter_src, head_entry_src);
 	nm_ip_config_iter_ip6_route_init (&ipconf_iter_dst, dst);
@@ -1392,7 +1450,6 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 		has = nm_ip_config_iter_ip6_route_next (&ipconf_iter_src, &r_src);
 		if (has != nm_ip_config_iter_ip6_route_next (&ipconf_iter_dst, &r_dst)) {
 			are_equal = FALSE;
-			has_relevant_changes = TRUE;
 			break;
 		}
 		if (!has)
@@ -1400,13 +1457,7 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 
 		if (nm_platform_ip6_route_cmp_full (r_src, r_dst) != 0) {
 			are_equal = FALSE;
-			if (   r_src->plen != r_dst->plen
-			    || !nm_utils_ip6_address_same_prefix (&r_src->network, &r_dst->network, r_src->plen)
-			    || r_src->metric != r_dst->metric
-			    || !IN6_ARE_ADDR_EQUAL (&r_src->gateway, &r_dst->gateway)) {
-				has_relevant_changes = TRUE;
-				break;
-			}
+			break;
 		}
 	}
 	if (!are_equal) {
@@ -1429,6 +1480,7 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 			new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, obj_new);
 		}
 		nm_dedup_multi_index_dirty_remove_idx (dst_priv->multi_idx, &dst_priv->idx_ip6_routes, FALSE);
+		dst_priv->routes_fingerprint = src_priv->routes_fingerprint;
 		if (_nm_ip_config_best_default_route_set (&dst_priv->best_default_route, new_best_default_route))
 			_notify (dst, PROP_GATEWAY);
 		_notify_routes (dst);
@@ -1908,8 +1960,11 @@ nm_ip6_config_reset_routes_ndisc (NMIP6Config *self,
 		_notify (self, PROP_GATEWAY);
 	}
 
-	if (changed)
+	if (changed) {
+		/* we replaced all routes anyway, so just recompute the fingerprint. */
+		priv->routes_fingerprint = _routes_fingerprint_compute (self);
 		_notify_routes (self);
+	}
 }
 
 void
@@ -1919,6 +1974,7 @@ nm_ip6_config_reset_routes (NMIP6Config *self)
 
 	if (nm_dedup_multi_index_remove_idx (priv->multi_idx,
 	                                     &priv->idx_ip6_routes) > 0) {
+		priv->routes_fingerprint = 0;
 		if (nm_clear_nmp_object (&priv->best_default_route))
 			_notify (self, PROP_GATEWAY);
 		_notify_routes (self);
@@ -1950,6 +2006,7 @@ _add_route (NMIP6Config *self,
 	                           &obj_new_2)) {
 		gboolean changed_default_route = FALSE;
 
+		_routes_fingerprint_update (priv, obj_old, obj_new_2);
 		if (   priv->best_default_route == obj_old
 		    && obj_old != obj_new_2) {
 			changed_default_route = TRUE;
@@ -2094,6 +2151,7 @@ nm_ip6_config_reset_nameservers (NMIP6Config *self)
 
 	if (priv->nameservers->len != 0) {
 		g_array_set_size (priv->nameservers, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_NAMESERVERS);
 	}
 }
@@ -2111,6 +2169,7 @@ nm_ip6_config_add_nameserver (NMIP6Config *self, const struct in6_addr *new)
 			return;
 
 	g_array_append_val (priv->nameservers, *new);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_NAMESERVERS);
 }
 
@@ -2122,6 +2181,7 @@ nm_ip6_config_del_nameserver (NMIP6Config *self, guint i)
 	g_return_if_fail (i < priv->nameservers->len);
 
 	g_array_remove_index (priv->nameservers, i);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_NAMESERVERS);
 }
 
@@ -2150,6 +2210,7 @@ nm_ip6_config_reset_domains (NMIP6Config *self)
 
 	if (priv->domains->len != 0) {
 		g_ptr_array_set_size (priv->domains, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_DOMAINS);
 	}
 }
@@ -2159,8 +2220,10 @@ nm_ip6_config_add_domain (NMIP6Config *self, const char *domain)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-	if (_nm_ip_config_check_and_add_domain (priv->domains, domain))
+	if (_nm_ip_config_check_and_add_domain (priv->domains, domain)) {
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_DOMAINS);
+	}
 }
 
 void
@@ -2171,6 +2234,7 @@ nm_ip6_config_del_domain (NMIP6Config *self, guint i)
 	g_return_if_fail (i < priv->domains->len);
 
 	g_ptr_array_remove_index (priv->domains, i);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_DOMAINS);
 }
 
@@ -2199,6 +2263,7 @@ nm_ip6_config_reset_searches (NMIP6Config *self)
 
 	if (priv->searches->len != 0) {
 		g_ptr_array_set_size (priv->searches, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_SEARCHES);
 	}
 }
@@ -2208,8 +2273,10 @@ nm_ip6_config_add_search (NMIP6Config *self, const char *search)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-	if (_nm_ip_config_check_and_add_domain (priv->searches, search))
+	if (_nm_ip_config_check_and_add_domain (priv->searches, search)) {
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_SEARCHES);
+	}
 }
 
 void
@@ -2220,6 +2287,7 @@ nm_ip6_config_del_search (NMIP6Config *self, guint i)
 	g_return_if_fail (i < priv->searches->len);
 
 	g_ptr_array_remove_index (priv->searches, i);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_SEARCHES);
 }
 
@@ -2248,6 +2316,7 @@ nm_ip6_config_reset_dns_options (NMIP6Config *self)
 
 	if (priv->dns_options->len != 0) {
 		g_ptr_array_set_size (priv->dns_options, 0);
+		priv->dns_fingerprint_valid = FALSE;
 		_notify (self, PROP_DNS_OPTIONS);
 	}
 }
@@ -2266,6 +2335,7 @@ nm_ip6_config_add_dns_option (NMIP6Config *self, const char *new)
 			return;
 
 	g_ptr_array_add (priv->dns_options, g_strdup (new));
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2277,6 +2347,7 @@ nm_ip6_config_del_dns_option (NMIP6Config *self, guint i)
 	g_return_if_fail (i < priv->dns_options->len);
 
 	g_ptr_array_remove_index (priv->dns_options, i);
+	priv->dns_fingerprint_valid = FALSE;
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2405,6 +2476,7 @@ nm_ip6_config_nmpobj_remove (NMIP6Config *self,
 		_notify_addresses (self);
 		break;
 	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		_routes_fingerprint_update (priv, obj_old, NULL);
 		if (priv->best_default_route == obj_old) {
 			if (_nm_ip_config_best_default_route_set (&priv->best_default_route,
 			                                          _nm_ip6_config_best_default_route_find (self)))
@@ -2420,64 +2492,92 @@ nm_ip6_config_nmpobj_remove (NMIP6Config *self,
 
 /*****************************************************************************/
 
-static void
-hash_u32 (GChecksum *sum, guint32 n)
+static guint64
+_addresses_fingerprint_compute (const NMIP6Config *self)
 {
-	g_checksum_update (sum, (const guint8 *) &n, sizeof (n));
+	NMDedupMultiIter ipconf_iter;
+	const NMPlatformIP6Address *address;
+	guint64 fingerprint = 0;
+
+	nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, self, &address) {
+		NMHashState h;
+
+		nm_hash_init (&h, 1022648423u);
+		nm_hash_update_in6addr (&h, &address->address);
+		nm_hash_update_val (&h, address->plen);
+		fingerprint = _nm_ip_config_fingerprint_append (fingerprint, nm_hash_complete_u64 (&h));
+	}
+	return fingerprint;
 }
 
-static void
-hash_in6addr (GChecksum *sum, const struct in6_addr *a)
+static guint64
+_dns_fingerprint_compute (const NMIP6Config *self)
 {
-	if (a)
-		g_checksum_update (sum, (const guint8 *) a, sizeof (*a));
-	else
-		g_checksum_update (sum, (const guint8 *) &in6addr_any, sizeof (in6addr_any));
+	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	NMHashState h;
+	guint i;
+
+	/* a configuration without DNS parameters must have a zero fingerprint.
+	 * The DNS manager relies on that. */
+	if (   priv->nameservers->len == 0
+	    && priv->domains->len == 0
+	    && priv->searches->len == 0
+	    && priv->dns_options->len == 0)
+		return 0;
+
+	nm_hash_init (&h, 3546718103u);
+	nm_hash_update_val (&h, priv->nameservers->len);
+	nm_hash_update (&h, priv->nameservers->data, priv->nameservers->len * sizeof (struct in6_addr));
+	nm_hash_update_val (&h, priv->domains->len);
+	for (i = 0; i < priv->domains->len; i++)
+		nm_hash_update_str (&h, priv->domains->pdata[i]);
+	nm_hash_update_val (&h, priv->searches->len);
+	for (i = 0; i < priv->searches->len; i++)
+		nm_hash_update_str (&h, priv->searches->pdata[i]);
+	nm_hash_update_val (&h, priv->dns_options->len);
+	for (i = 0; i < priv->dns_options->len; i++)
+		nm_hash_update_str (&h, priv->dns_options->pdata[i]);
+	return nm_hash_complete_u64 (&h) ?: 1;
 }
 
-void
-nm_ip6_config_hash (const NMIP6Config *self, GChecksum *sum, gboolean dns_only)
+/**
+ * nm_ip6_config_get_fingerprint:
+ * @self: the #NMIP6Config
+ * @dns_only: whether to only consider the DNS related parameters
+ *
+ * See nm_ip4_config_get_fingerprint().
+ *
+ * Returns: the fingerprint of @self. A configuration without DNS
+ *   parameters has a zero fingerprint with @dns_only.
+ */
+guint64
+nm_ip6_config_get_fingerprint (const NMIP6Config *self, gboolean dns_only)
 {
-	guint32 i;
-	const char *s;
-	NMDedupMultiIter ipconf_iter;
-	const NMPlatformIP6Address *address;
-	const NMPlatformIP6Route *route;
+	NMIP6ConfigPrivate *priv;
+	guint64 fingerprint = 0;
 
-	g_return_if_fail (self);
-	g_return_if_fail (sum);
+	g_return_val_if_fail (NM_IS_IP6_CONFIG (self), 0);
 
-	if (dns_only == FALSE) {
-		nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, self, &address) {
-			hash_in6addr (sum, &address->address);
-			hash_u32 (sum, address->plen);
-		}
+	/* the fingerprints are only a cache, it's fine to update them on a
+	 * const instance. */
+	priv = (NMIP6ConfigPrivate *) NM_IP6_CONFIG_GET_PRIVATE (self);
 
-		nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, self, &route) {
-			hash_in6addr (sum, &route->network);
-			hash_u32 (sum, route->plen);
-			hash_in6addr (sum, &route->gateway);
-			hash_u32 (sum, route->metric);
+	if (!dns_only) {
+		if (!priv->addresses_fingerprint_valid) {
+			priv->addresses_fingerprint = _addresses_fingerprint_compute (self);
+			priv->addresses_fingerprint_valid = TRUE;
 		}
-	}
-
-	for (i = 0; i < nm_ip6_config_get_num_nameservers (self); i++)
-		hash_in6addr (sum, nm_ip6_config_get_nameserver (self, i));
-
-	for (i = 0; i < nm_ip6_config_get_num_domains (self); i++) {
-		s = nm_ip6_config_get_domain (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+		nm_assert (priv->routes_fingerprint == _routes_fingerprint_compute (self));
 
-	for (i = 0; i < nm_ip6_config_get_num_searches (self); i++) {
-		s = nm_ip6_config_get_search (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
+		fingerprint = _nm_ip_config_fingerprint_append (fingerprint, priv->addresses_fingerprint);
+		fingerprint = _nm_ip_config_fingerprint_append (fingerprint, priv->routes_fingerprint);
 	}
 
-	for (i = 0; i < nm_ip6_config_get_num_dns_options (self); i++) {
-		s = nm_ip6_config_get_dns_option (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
+	if (!priv->dns_fingerprint_valid) {
+		priv->dns_fingerprint = _dns_fingerprint_compute (self);
+		priv->dns_fingerprint_valid = TRUE;
 	}
+	return _nm_ip_config_fingerprint_append (fingerprint, priv->dns_fingerprint);
 }
 
 /**
@@ -2486,9 +2586,12 @@ nm_ip6_config_hash (const NMIP6Config *self, GChecksum *sum, gboolean dns_only)
  * @b: second config to compare
  *
  * Compares two #NMIP6Configs for basic equality.  This means that all
- * attributes must exist in the same order in both configs (addresses, routes,
- * domains, DNS servers, etc) but some attributes (address lifetimes, and address
- * and route sources) are ignored.
+ * attributes must exist in the same order in both configs (addresses,
+ * domains, DNS servers, etc) but some attributes (address lifetimes, address
+ * and route sources, and the order of the routes) are ignored.
+ *
+ * This compares the fingerprints of the configurations, see
+ * nm_ip6_config_get_fingerprint().
  *
  * Returns: %TRUE if the configurations are basically equal to each other,
  * %FALSE if not
@@ -2496,19 +2599,8 @@ nm_ip6_config_hash (const NMIP6Config *self, GChecksum *sum, gboolean dns_only)
 gboolean
 nm_ip6_config_equal (const NMIP6Config *a, const NMIP6Config *b)
 {
-	nm_auto_free_checksum GChecksum *a_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	nm_auto_free_checksum GChecksum *b_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	guint8 a_data[NM_UTILS_CHECKSUM_LENGTH_SHA1];
-	guint8 b_data[NM_UTILS_CHECKSUM_LENGTH_SHA1];
-
-	if (a)
-		nm_ip6_config_hash (a, a_checksum, FALSE);
-	if (b)
-		nm_ip6_config_hash (b, b_checksum, FALSE);
-
-	nm_utils_checksum_get_digest (a_checksum, a_data);
-	nm_utils_checksum_get_digest (b_checksum, b_data);
-	return !memcmp (a_data, b_data, sizeof (a_data));
+	return    (a ? nm_ip6_config_get_fingerprint (a, FALSE) : 0)
+	       == (b ? nm_ip6_config_get_fingerprint (b, FALSE) : 0);
 }
 
 /*****************************************************************************/
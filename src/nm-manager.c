@@ -22,6 +22,7 @@
 #include "nm-dbus-manager.h"
 #include "vpn/nm-vpn-manager.h"
 #include "devices/nm-device.h"
+#include "nm-device-index.h"
 #include "devices/nm-device-generic.h"
 #include "platform/nm-platform.h"
 #include "platform/nmp-object.h"
@@ -152,6 +153,9 @@ typedef struct {
 
 	CList devices_lst_head;
 
+	/* indexes of the devices in devices_lst_head, see _devidx_update(). */
+	NMDeviceIndex *devices_idx;
+
 	NMState state;
 	NMConfig *config;
 	NMConnectivity *concheck_mgr;
@@ -1096,6 +1100,46 @@ nm_manager_get_activatable_connections (NMManager *manager,
 	                                          NULL);
 }
 
+/**
+ * nm_manager_get_autoconnect_candidates:
+ * @manager: the #NMManager
+ * @device: the #NMDevice which shall autoconnect
+ * @out_len: (allow-none): the number of returned profiles
+ *
+ * Like nm_manager_get_activatable_connections() with @for_auto_activation
+ * and @sort, but skips profiles that cannot match @device based on their
+ * connection type and interface name.
+ *
+ * Returns: (transfer container): a %NULL terminated array of profiles,
+ *   sorted by autoconnect priority.
+ */
+NMSettingsConnection **
+nm_manager_get_autoconnect_candidates (NMManager *manager,
+                                       NMDevice *device,
+                                       guint *out_len)
+{
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
+	const GetActivatableConnectionsFilterData d = {
+		.self = manager,
+		.for_auto_activation = TRUE,
+	};
+	NMSettingsConnection **list;
+	guint i, j;
+
+	list = nm_settings_get_autoconnect_candidates (priv->settings,
+	                                               NM_DEVICE_GET_CLASS (device)->connection_type_check_compatible,
+	                                               nm_device_get_iface (device),
+	                                               NULL);
+	for (i = 0, j = 0; list[i]; i++) {
+		if (_get_activatable_connections_filter (priv->settings, list[i], (gpointer) &d))
+			list[j++] = list[i];
+	}
+	list[j] = NULL;
+
+	NM_SET_OUT (out_len, j);
+	return list;
+}
+
 static NMActiveConnection *
 active_connection_get_by_path (NMManager *self, const char *path)
 {
@@ -1245,17 +1289,41 @@ nm_manager_get_device_by_path (NMManager *self, const char *path)
 	return device;
 }
 
+static void
+_devidx_update (NMManager *self, NMDevice *device)
+{
+	/* don't force reading the permanent MAC address. It is done lazily by
+	 * find_device_by_permanent_hw_addr(), and the device notifies us once it
+	 * is set. */
+	nm_device_index_update (NM_MANAGER_GET_PRIVATE (self)->devices_idx,
+	                        device,
+	                        nm_device_get_ifindex (device),
+	                        nm_device_get_iface (device),
+	                        nm_device_get_ip_iface (device),
+	                        nm_device_get_permanent_hw_address_full (device, FALSE, NULL));
+}
+
+static void
+_devidx_add (NMManager *self, NMDevice *device)
+{
+	nm_device_index_add (NM_MANAGER_GET_PRIVATE (self)->devices_idx, device);
+	_devidx_update (self, device);
+}
+
+/*****************************************************************************/
+
 NMDevice *
 nm_manager_get_device_by_ifindex (NMManager *self, int ifindex)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
+	const GPtrArray *devices;
 	NMDevice *device;
 
-	if (ifindex > 0) {
-		c_list_for_each_entry (device, &priv->devices_lst_head, devices_lst) {
-			if (nm_device_get_ifindex (device) == ifindex)
-				return device;
-		}
+	devices = nm_device_index_lookup_ifindex (priv->devices_idx, ifindex);
+	if (devices) {
+		device = devices->pdata[0];
+		nm_assert (nm_device_get_ifindex (device) == ifindex);
+		return device;
 	}
 
 	return NULL;
@@ -1265,22 +1333,29 @@ static NMDevice *
 find_device_by_permanent_hw_addr (NMManager *self, const char *hwaddr)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
+	const GPtrArray *devices;
 	NMDevice *device;
-	const char *device_addr;
-	guint8 hwaddr_bin[NM_UTILS_HWADDR_LEN_MAX];
-	gsize hwaddr_len;
 
 	g_return_val_if_fail (hwaddr != NULL, NULL);
 
-	if (!_nm_utils_hwaddr_aton (hwaddr, hwaddr_bin, sizeof (hwaddr_bin), &hwaddr_len))
+	if (!nm_utils_hwaddr_valid (hwaddr, -1))
 		return NULL;
 
+	devices = nm_device_index_lookup_perm_hw_addr (priv->devices_idx, hwaddr);
+	if (devices)
+		return devices->pdata[0];
+
+	/* Not found. Maybe some devices did not yet determine their
+	 * permanent MAC address. Force them to (this notifies the change
+	 * and updates the index) and look again. */
 	c_list_for_each_entry (device, &priv->devices_lst_head, devices_lst) {
-		device_addr = nm_device_get_permanent_hw_address (device);
-		if (   device_addr
-		    && nm_utils_hwaddr_matches (hwaddr_bin, hwaddr_len, device_addr, -1))
-			return device;
+		if (!nm_device_get_permanent_hw_address_full (device, FALSE, NULL))
+			nm_device_get_permanent_hw_address (device);
 	}
+
+	devices = nm_device_index_lookup_perm_hw_addr (priv->devices_idx, hwaddr);
+	if (devices)
+		return devices->pdata[0];
 	return NULL;
 }
 
@@ -1288,14 +1363,19 @@ static NMDevice *
 find_device_by_ip_iface (NMManager *self, const char *iface)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
-	NMDevice *device;
+	const GPtrArray *devices;
+	guint i;
 
 	g_return_val_if_fail (iface, NULL);
 
-	c_list_for_each_entry (device, &priv->devices_lst_head, devices_lst) {
-		if (   nm_device_is_real (device)
-		    && nm_streq0 (nm_device_get_ip_iface (device), iface))
-			return device;
+	devices = nm_device_index_lookup_ip_iface (priv->devices_idx, iface);
+	if (devices) {
+		for (i = 0; i < devices->len; i++) {
+			NMDevice *device = devices->pdata[i];
+
+			if (nm_device_is_real (device))
+				return device;
+		}
 	}
 	return NULL;
 }
@@ -1323,14 +1403,20 @@ find_device_by_iface (NMManager *self,
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
 	NMDevice *fallback = NULL;
-	NMDevice *candidate;
+	const GPtrArray *candidates;
+	guint i;
 
 	g_return_val_if_fail (iface != NULL, NULL);
 
-	c_list_for_each_entry (candidate, &priv->devices_lst_head, devices_lst) {
+	candidates = nm_device_index_lookup_iface (priv->devices_idx, iface);
+	if (!candidates)
+		return NULL;
+
+	for (i = 0; i < candidates->len; i++) {
+		NMDevice *candidate = candidates->pdata[i];
+
+		nm_assert (nm_streq (nm_device_get_iface (candidate), iface));
 
-		if (strcmp (nm_device_get_iface (candidate), iface))
-			continue;
 		if (connection && !nm_device_check_connection_compatible (candidate, connection, NULL))
 			continue;
 		if (slave) {
@@ -1684,6 +1770,7 @@ remove_device (NMManager *self,
 	nm_settings_device_removed (priv->settings, device, quitting);
 
 	c_list_unlink (&device->devices_lst);
+	nm_device_index_remove (priv->devices_idx, device);
 
 	_parent_notify_changed (self, device, TRUE);
 
@@ -2933,6 +3020,7 @@ device_ifindex_changed (NMDevice *device,
                         GParamSpec *pspec,
                         NMManager *self)
 {
+	_devidx_update (self, device);
 	_parent_notify_changed (self, device, FALSE);
 }
 
@@ -2944,16 +3032,26 @@ device_ip_iface_changed (NMDevice *device,
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
 	const char *ip_iface = nm_device_get_ip_iface (device);
 	NMDeviceType device_type = nm_device_get_device_type (device);
-	NMDevice *candidate;
+	const GPtrArray *candidates;
+	guint i;
+
+	_devidx_update (self, device);
+
+	if (!ip_iface)
+		return;
 
 	/* Remove NMDevice objects that are actually child devices of others,
 	 * when the other device finally knows its IP interface name.  For example,
 	 * remove the PPP interface that's a child of a WWAN device, since it's
 	 * not really a standalone NMDevice.
 	 */
-	c_list_for_each_entry (candidate, &priv->devices_lst_head, devices_lst) {
+	candidates = nm_device_index_lookup_iface (priv->devices_idx, ip_iface);
+	if (!candidates)
+		return;
+	for (i = 0; i < candidates->len; i++) {
+		NMDevice *candidate = candidates->pdata[i];
+
 		if (   candidate != device
-		    && g_strcmp0 (nm_device_get_iface (candidate), ip_iface) == 0
 		    && nm_device_get_device_type (candidate) == device_type
 		    && nm_device_is_real (candidate)) {
 			remove_device (self, candidate, FALSE);
@@ -2967,12 +3065,22 @@ device_iface_changed (NMDevice *device,
                       GParamSpec *pspec,
                       NMManager *self)
 {
+	_devidx_update (self, device);
+
 	/* Virtual connections may refer to the new device name as
 	 * parent device, retry to activate them.
 	 */
 	retry_connections_for_parent_device (self, device);
 }
 
+static void
+device_perm_hw_addr_changed (NMDevice *device,
+                             GParamSpec *pspec,
+                             NMManager *self)
+{
+	_devidx_update (self, device);
+}
+
 static void
 _emit_device_added_removed (NMManager *self,
                             NMDevice *device,
@@ -3168,6 +3276,7 @@ add_device (NMManager *self, NMDevice *device, GError **error)
 
 	nm_assert (c_list_is_empty (&device->devices_lst));
 	c_list_link_tail (&priv->devices_lst_head, &device->devices_lst);
+	_devidx_add (self, device);
 
 	g_signal_connect (device, NM_DEVICE_STATE_CHANGED,
 	                  G_CALLBACK (manager_device_state_changed),
@@ -3193,6 +3302,10 @@ add_device (NMManager *self, NMDevice *device, GError **error)
 	                  G_CALLBACK (device_iface_changed),
 	                  self);
 
+	g_signal_connect (device, "notify::" NM_DEVICE_PERM_HW_ADDRESS,
+	                  G_CALLBACK (device_perm_hw_addr_changed),
+	                  self);
+
 	g_signal_connect (device, "notify::" NM_DEVICE_REAL,
 	                  G_CALLBACK (device_realized),
 	                  self);
@@ -3307,23 +3420,33 @@ platform_link_added (NMManager *self,
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
 	NMDeviceFactory *factory;
 	NMDevice *device = NULL;
-	NMDevice *candidate;
+	const GPtrArray *candidates_idx;
+	gs_free NMDevice **candidates = NULL;
+	guint n_candidates = 0;
+	guint i;
 
 	g_return_if_fail (ifindex > 0);
 
 	if (nm_manager_get_device_by_ifindex (self, ifindex))
 		return;
 
+	/* realizing a candidate updates the indexes, iterate over a copy. */
+	candidates_idx = nm_device_index_lookup_iface (priv->devices_idx, plink->name);
+	if (candidates_idx) {
+		n_candidates = candidates_idx->len;
+		candidates = nm_memdup (candidates_idx->pdata, sizeof (NMDevice *) * n_candidates);
+	}
+
 	/* Let unrealized devices try to realize themselves with the link */
-	c_list_for_each_entry (candidate, &priv->devices_lst_head, devices_lst) {
+	for (i = 0; i < n_candidates; i++) {
+		NMDevice *candidate = candidates[i];
 		gboolean compatible = TRUE;
 		gs_free_error GError *error = NULL;
 
 		if (nm_device_get_link_type (candidate) != plink->type)
 			continue;
 
-		if (strcmp (nm_device_get_iface (candidate), plink->name))
-			continue;
+		nm_assert (nm_streq (nm_device_get_iface (candidate), plink->name));
 
 		if (nm_device_is_real (candidate)) {
 			/* There's already a realized device with the link's name
@@ -7508,6 +7631,8 @@ nm_manager_init (NMManager *self)
 
 	priv->platform = g_object_ref (NM_PLATFORM_GET);
 
+	priv->devices_idx = nm_device_index_new ();
+
 	priv->capabilities = g_array_new (FALSE, FALSE, sizeof (guint32));
 
 	/* Initialize rfkill structures and states */
@@ -7869,6 +7994,9 @@ finalize (GObject *object)
 
 	g_array_free (priv->capabilities, TRUE);
 
+	nm_assert (nm_device_index_get_size (priv->devices_idx) == 0);
+	nm_device_index_free (priv->devices_idx);
+
 	G_OBJECT_CLASS (nm_manager_parent_class)->finalize (object);
 
 	g_object_unref (priv->platform);
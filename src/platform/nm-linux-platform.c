@@ -341,6 +341,7 @@ typedef enum {
 	DELAYED_ACTION_TYPE_MASTER_CONNECTED              = 1 << 10,
 	DELAYED_ACTION_TYPE_READ_NETLINK                  = 1 << 11,
 	DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE          = 1 << 12,
+	DELAYED_ACTION_TYPE_REFRESH_ROUTES                = 1 << 13,
 
 	__DELAYED_ACTION_TYPE_MAX,
 
@@ -414,11 +415,20 @@ typedef struct {
 
 /*****************************************************************************/
 
+NM_GOBJECT_PROPERTIES_DEFINE_BASE (
+	PROP_ROUTE_IGNORE_TABLES,
+	PROP_ROUTE_IGNORE_PROTOCOLS,
+);
+
 typedef struct {
 	struct nl_sock *genl;
 
 	struct nl_sock *nlh;
 
+	/* persistent receive buffers for @nlh, see event_handler_recvmsgs(). */
+	struct nl_recv_ring *nlh_recv_ring;
+	guint nlh_recv_nesting;
+
 	GSource *event_source;
 
 	guint32 nlh_seq_next;
@@ -427,11 +437,55 @@ typedef struct {
 #endif
 	guint32 nlh_seq_last_seen;
 
+	/* set after setting NETLINK_GET_STRICT_CHK failed. Kernel cannot filter
+	 * dump requests and we always fall back to dump all objects. */
+	bool nlh_strict_chk_unsupported:1;
+
 	guint32 pruning[_REFRESH_ALL_TYPE_NUM];
 
+	/* routes in these tables or with these protocols are dropped while
+	 * parsing the netlink message and never enter the cache. */
+	struct {
+		char *tables_str;
+		char *protocols_str;
+		guint32 *tables;
+		guint n_tables;
+		guint32 protocols[256 / 32];
+		bool has_protocols:1;
+		guint64 n_dropped;
+	} route_ignore;
+
 	GHashTable *sysctl_get_prev_values;
 	CList sysctl_list;
 
+	/* queued writes to /proc/sys/net/ipv{4,6}/conf, processed in batches
+	 * by a worker thread. See sysctl_ip_conf_set_async(). */
+	struct {
+		GMutex lock;
+		GCond cond;
+
+		/* writes not yet picked up by the worker, in order. @pending_idx
+		 * indexes them by absolute path, to coalesce repeated writes to
+		 * the same key. */
+		CList pending_lst_head;
+		GHashTable *pending_idx;
+
+		/* writes that completed, waiting for @done_source to report
+		 * them on @context. */
+		CList done_lst_head;
+		GSource *done_source;
+		GMainContext *context;
+
+		/* the path that the worker is currently writing. */
+		const char *current_path;
+
+		/* the directories /proc/sys/net/ipv{4,6}/conf/$IFNAME, indexed
+		 * by ifindex. Only accessed by the worker. */
+		GHashTable *dirfds;
+
+		bool worker_scheduled:1;
+	} sysctl_writer;
+
 	NMUdevClient *udev_client;
 
 	struct {
@@ -445,6 +499,7 @@ typedef struct {
 
 		GPtrArray *list_master_connected;
 		GPtrArray *list_refresh_link;
+		GPtrArray *list_refresh_routes;
 		GArray *list_wait_for_nl_response;
 
 		int is_handling;
@@ -524,6 +579,7 @@ static void delayed_action_schedule (NMPlatform *platform, DelayedActionType act
 static gboolean delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink);
 static void do_request_link_no_delayed_actions (NMPlatform *platform, int ifindex, const char *name);
 static void do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type);
+static gboolean do_request_routes_no_delayed_actions (NMPlatform *platform, int addr_family, int ifindex);
 static void cache_on_change (NMPlatform *platform,
                              NMPCacheOpsType cache_op,
                              const NMPObject *obj_old,
@@ -3093,9 +3149,31 @@ _new_from_nl_link (NMPlatform *platform, const NMPCache *cache, struct nlmsghdr
 	return g_steal_pointer (&obj);
 }
 
+/* Addresses and routes can be parsed into a caller provided stack object
+ * (@obj_stack). The platform cache only clones them to the heap if it
+ * actually needs to store them, which avoids an allocation for each
+ * netlink message that does not change the cache. */
+static NMPObject *
+_nmp_object_new_or_stackinit (NMPObject *obj_stack, NMPObjectType obj_type)
+{
+	if (obj_stack)
+		return (NMPObject *) nmp_object_stackinit (obj_stack, obj_type, NULL);
+	return nmp_object_new (obj_type, NULL);
+}
+
+static void
+_nmp_object_unref_unless_stackinit (NMPObject **p_obj)
+{
+	if (   *p_obj
+	    && !NMP_OBJECT_IS_STACKINIT (*p_obj))
+		nmp_object_unref (*p_obj);
+}
+
+#define nm_auto_nmpobj_unless_stackinit nm_auto (_nmp_object_unref_unless_stackinit)
+
 /* Copied and heavily modified from libnl3's addr_msg_parser(). */
 static NMPObject *
-_new_from_nl_addr (struct nlmsghdr *nlh, gboolean id_only)
+_new_from_nl_addr (struct nlmsghdr *nlh, gboolean id_only, NMPObject *obj_stack)
 {
 	static const struct nla_policy policy[] = {
 		[IFA_LABEL]     = { .type = NLA_STRING,
@@ -3106,7 +3184,7 @@ _new_from_nl_addr (struct nlmsghdr *nlh, gboolean id_only)
 	struct nlattr *tb[G_N_ELEMENTS (policy)];
 	const struct ifaddrmsg *ifa;
 	gboolean is_v4;
-	nm_auto_nmpobj NMPObject *obj = NULL;
+	nm_auto_nmpobj_unless_stackinit NMPObject *obj = NULL;
 	int addr_len;
 	guint32 lifetime, preferred, timestamp;
 
@@ -3132,7 +3210,7 @@ _new_from_nl_addr (struct nlmsghdr *nlh, gboolean id_only)
 
 	/*****************************************************************/
 
-	obj = nmp_object_new (is_v4 ? NMP_OBJECT_TYPE_IP4_ADDRESS : NMP_OBJECT_TYPE_IP6_ADDRESS, NULL);
+	obj = _nmp_object_new_or_stackinit (obj_stack, is_v4 ? NMP_OBJECT_TYPE_IP4_ADDRESS : NMP_OBJECT_TYPE_IP6_ADDRESS);
 
 	obj->ip_address.ifindex = ifa->ifa_index;
 	obj->ip_address.plen = ifa->ifa_prefixlen;
@@ -3212,9 +3290,51 @@ _new_from_nl_addr (struct nlmsghdr *nlh, gboolean id_only)
 	return g_steal_pointer (&obj);
 }
 
+static gboolean
+_route_ignore_check (NMPlatform *platform, struct nlmsghdr *nlh)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const struct rtmsg *rtm;
+	guint32 table;
+	guint i;
+
+	if (   priv->route_ignore.n_tables == 0
+	    && !priv->route_ignore.has_protocols)
+		return FALSE;
+
+	if (!nlmsg_valid_hdr (nlh, sizeof (*rtm)))
+		return FALSE;
+
+	rtm = nlmsg_data (nlh);
+
+	if (   priv->route_ignore.has_protocols
+	    && NM_FLAGS_HAS (priv->route_ignore.protocols[rtm->rtm_protocol / 32], 1u << (rtm->rtm_protocol % 32)))
+		return TRUE;
+
+	if (priv->route_ignore.n_tables == 0)
+		return FALSE;
+
+	table = rtm->rtm_table;
+	if (table == RT_TABLE_COMPAT) {
+		struct nlattr *nla;
+
+		/* tables larger than 255 are only reported via RTA_TABLE. */
+		nla = nlmsg_find_attr (nlh, sizeof (*rtm), RTA_TABLE);
+		if (   nla
+		    && nla_len (nla) >= (int) sizeof (guint32))
+			table = nla_get_u32 (nla);
+	}
+
+	for (i = 0; i < priv->route_ignore.n_tables; i++) {
+		if (priv->route_ignore.tables[i] == table)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 /* Copied and heavily modified from libnl3's rtnl_route_parse() and parse_multipath(). */
 static NMPObject *
-_new_from_nl_route (struct nlmsghdr *nlh, gboolean id_only)
+_new_from_nl_route (struct nlmsghdr *nlh, gboolean id_only, NMPObject *obj_stack)
 {
 	static const struct nla_policy policy[] = {
 		[RTA_TABLE]     = { .type = NLA_U32 },
@@ -3230,7 +3350,7 @@ _new_from_nl_route (struct nlmsghdr *nlh, gboolean id_only)
 	const struct rtmsg *rtm;
 	struct nlattr *tb[G_N_ELEMENTS (policy)];
 	gboolean is_v4;
-	nm_auto_nmpobj NMPObject *obj = NULL;
+	nm_auto_nmpobj_unless_stackinit NMPObject *obj = NULL;
 	int addr_len;
 	struct {
 		gboolean is_present;
@@ -3390,7 +3510,7 @@ rta_multipath_done:
 
 	/*****************************************************************/
 
-	obj = nmp_object_new (is_v4 ? NMP_OBJECT_TYPE_IP4_ROUTE : NMP_OBJECT_TYPE_IP6_ROUTE, NULL);
+	obj = _nmp_object_new_or_stackinit (obj_stack, is_v4 ? NMP_OBJECT_TYPE_IP4_ROUTE : NMP_OBJECT_TYPE_IP6_ROUTE);
 
 	obj->ip_route.table_coerced = nm_platform_route_table_coerce (  tb[RTA_TABLE]
 	                                                              ? nla_get_u32 (tb[RTA_TABLE])
@@ -3777,11 +3897,14 @@ _new_from_nl_tfilter (struct nlmsghdr *nlh, gboolean id_only)
  *   If a cache is given, the object is completed with information from the cache.
  * @nlh: the netlink message header
  * @id_only: whether only to create an empty object with only the ID fields set.
+ * @obj_stack: (allow-none): if given, IP addresses and routes are parsed into
+ *   this stack object instead of allocating them on the heap.
  *
- * Returns: %NULL or a newly created NMPObject instance.
+ * Returns: %NULL, @obj_stack or a newly created NMPObject instance. Only the
+ *   latter must be unrefed.
  **/
 static NMPObject *
-nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_msg *msg, gboolean id_only)
+nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_msg *msg, gboolean id_only, NMPObject *obj_stack)
 {
 	struct nlmsghdr *msghdr;
 
@@ -3799,11 +3922,11 @@ nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_m
 	case RTM_NEWADDR:
 	case RTM_DELADDR:
 	case RTM_GETADDR:
-		return _new_from_nl_addr (msghdr, id_only);
+		return _new_from_nl_addr (msghdr, id_only, obj_stack);
 	case RTM_NEWROUTE:
 	case RTM_DELROUTE:
 	case RTM_GETROUTE:
-		return _new_from_nl_route (msghdr, id_only);
+		return _new_from_nl_route (msghdr, id_only, obj_stack);
 	case RTM_NEWRULE:
 	case RTM_DELRULE:
 	case RTM_GETRULE:
@@ -4960,6 +5083,417 @@ sysctl_set_internal (NMPlatform *platform,
 
 /*****************************************************************************/
 
+typedef struct {
+	NMPlatformAsyncCallback callback;
+	gpointer callback_data;
+} SysctlWriteCallback;
+
+typedef struct {
+	CList lst;
+
+	/* array of SysctlWriteCallback. With coalescing, an entry can have
+	 * several callers that are interested in the outcome. */
+	GArray *callbacks;
+
+	char *value;
+	int addr_family;
+	int ifindex;
+	int errsv;
+	char ifname[NMP_IFNAMSIZ];
+
+	/* the basename of @path. */
+	const char *property;
+
+	/* the absolute path, the key for coalescing. Entries with an empty
+	 * path don't write anything but tell the worker to drop the
+	 * directory fds of @ifindex. */
+	char path[];
+} SysctlWriteEntry;
+
+typedef struct {
+	int fds[2];
+	char ifname[NMP_IFNAMSIZ];
+} SysctlWriteDirfd;
+
+static SysctlWriteEntry *
+_sysctl_write_entry_new (int addr_family,
+                         int ifindex,
+                         const char *ifname,
+                         const char *property,
+                         const char *value)
+{
+	char buf[NM_UTILS_SYSCTL_IP_CONF_PATH_BUFSIZE];
+	SysctlWriteEntry *entry;
+	gsize l;
+
+	if (ifname)
+		nm_utils_sysctl_ip_conf_path (addr_family, buf, ifname, property);
+	else
+		buf[0] = '\0';
+
+	l = strlen (buf) + 1;
+	entry = g_malloc0 (sizeof (SysctlWriteEntry) + l);
+	memcpy (entry->path, buf, l);
+	entry->addr_family = addr_family;
+	entry->ifindex = ifindex;
+	if (ifname) {
+		g_strlcpy (entry->ifname, ifname, sizeof (entry->ifname));
+		entry->property = &entry->path[l - 1 - strlen (property)];
+		entry->value = g_strdup (value);
+	}
+	return entry;
+}
+
+static void
+_sysctl_write_entry_free (SysctlWriteEntry *entry)
+{
+	if (entry->callbacks)
+		g_array_unref (entry->callbacks);
+	g_free (entry->value);
+	g_free (entry);
+}
+
+static void
+_sysctl_write_dirfd_free (gpointer data)
+{
+	SysctlWriteDirfd *d = data;
+
+	if (d->fds[0] >= 0)
+		nm_close (d->fds[0]);
+	if (d->fds[1] >= 0)
+		nm_close (d->fds[1]);
+	g_slice_free (SysctlWriteDirfd, d);
+}
+
+static gboolean _sysctl_writer_done_cb (gpointer user_data);
+
+static void
+_sysctl_writer_done_locked (NMPlatform *platform,
+                            SysctlWriteEntry *entry)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	if (!entry->callbacks) {
+		_sysctl_write_entry_free (entry);
+		return;
+	}
+
+	c_list_link_tail (&priv->sysctl_writer.done_lst_head, &entry->lst);
+	if (!priv->sysctl_writer.done_source) {
+		priv->sysctl_writer.done_source = nm_g_source_attach (nm_g_idle_source_new (G_PRIORITY_DEFAULT,
+		                                                                            _sysctl_writer_done_cb,
+		                                                                            g_object_ref (platform),
+		                                                                            g_object_unref),
+		                                                      priv->sysctl_writer.context);
+	}
+}
+
+static gboolean
+_sysctl_writer_done_cb (gpointer user_data)
+{
+	gs_unref_object NMPlatform *platform = g_object_ref (user_data);
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	CList done_lst_head = C_LIST_INIT (done_lst_head);
+	SysctlWriteEntry *entry;
+	guint i;
+
+	g_mutex_lock (&priv->sysctl_writer.lock);
+	nm_clear_g_source_inst (&priv->sysctl_writer.done_source);
+	c_list_splice (&done_lst_head, &priv->sysctl_writer.done_lst_head);
+	g_mutex_unlock (&priv->sysctl_writer.lock);
+
+	while ((entry = c_list_first_entry (&done_lst_head, SysctlWriteEntry, lst))) {
+		gs_free_error GError *error = NULL;
+
+		c_list_unlink_stale (&entry->lst);
+
+		if (entry->errsv != 0) {
+			g_set_error (&error,
+			             NM_UTILS_ERROR,
+			             NM_UTILS_ERROR_UNKNOWN,
+			             "sysctl: failed setting '%s' to value '%s': %s",
+			             entry->path,
+			             entry->value,
+			             nm_strerror_native (entry->errsv));
+		}
+
+		for (i = 0; i < entry->callbacks->len; i++) {
+			const SysctlWriteCallback *cb = &g_array_index (entry->callbacks, SysctlWriteCallback, i);
+
+			cb->callback (error, cb->callback_data);
+		}
+		_sysctl_write_entry_free (entry);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+/* core sysctl-set functions can be called from a non-main thread.
+ * Hence, we require locking from nm-logging. Indicate that by
+ * setting NM_THREAD_SAFE_ON_MAIN_THREAD to zero. */
+#undef NM_THREAD_SAFE_ON_MAIN_THREAD
+#define NM_THREAD_SAFE_ON_MAIN_THREAD 0
+
+static int
+_sysctl_writer_get_dirfd (NMPlatform *platform,
+                          const SysctlWriteEntry *entry)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	SysctlWriteDirfd *d;
+	int *p_fd;
+	int errsv;
+
+	if (G_UNLIKELY (!priv->sysctl_writer.dirfds)) {
+		priv->sysctl_writer.dirfds = g_hash_table_new_full (nm_direct_hash,
+		                                                    NULL,
+		                                                    NULL,
+		                                                    _sysctl_write_dirfd_free);
+	}
+
+	d = g_hash_table_lookup (priv->sysctl_writer.dirfds, GINT_TO_POINTER (entry->ifindex));
+	if (   d
+	    && !nm_streq (d->ifname, entry->ifname)) {
+		/* the interface was renamed. */
+		g_hash_table_remove (priv->sysctl_writer.dirfds, GINT_TO_POINTER (entry->ifindex));
+		d = NULL;
+	}
+	if (!d) {
+		d = g_slice_new (SysctlWriteDirfd);
+		d->fds[0] = -1;
+		d->fds[1] = -1;
+		g_strlcpy (d->ifname, entry->ifname, sizeof (d->ifname));
+		g_hash_table_insert (priv->sysctl_writer.dirfds, GINT_TO_POINTER (entry->ifindex), d);
+	}
+
+	p_fd = &d->fds[entry->addr_family == AF_INET6];
+	if (*p_fd < 0) {
+		gs_free char *dirname = NULL;
+
+		dirname = g_strndup (entry->path, entry->property - entry->path - 1);
+		*p_fd = open (dirname, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (*p_fd < 0) {
+			errsv = errno;
+			_LOGD ("sysctl: failed to open directory '%s': (%d) %s",
+			       dirname, errsv, nm_strerror_native (errsv));
+			errno = errsv;
+		}
+	}
+	return *p_fd;
+}
+
+static void
+_sysctl_writer_process (NMPlatform *platform,
+                        SysctlWriteEntry *entry)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	int dirfd;
+	guint tries;
+
+	if (!entry->path[0]) {
+		if (priv->sysctl_writer.dirfds)
+			g_hash_table_remove (priv->sysctl_writer.dirfds, GINT_TO_POINTER (entry->ifindex));
+		return;
+	}
+
+	if (entry->ifindex <= 0) {
+		entry->errsv =   sysctl_set_internal (platform, NULL, -1, entry->path, entry->value)
+		               ? 0
+		               : errno;
+		return;
+	}
+
+	for (tries = 0; ; tries++) {
+		dirfd = _sysctl_writer_get_dirfd (platform, entry);
+		if (dirfd < 0) {
+			entry->errsv = errno;
+			return;
+		}
+		if (sysctl_set_internal (platform, entry->path, dirfd, entry->property, entry->value)) {
+			entry->errsv = 0;
+			return;
+		}
+		entry->errsv = errno;
+		if (   entry->errsv != ENOENT
+		    || tries > 0)
+			return;
+
+		/* the cached directory might belong to an interface that went away
+		 * and was re-created with the same name and ifindex. Reopen it. */
+		g_hash_table_remove (priv->sysctl_writer.dirfds, GINT_TO_POINTER (entry->ifindex));
+	}
+}
+
+static void
+_sysctl_writer_thread_fn (gpointer data,
+                          gpointer user_data)
+{
+	gs_unref_object NMPlatform *platform = data;
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	nm_auto_pop_netns NMPNetns *netns = NULL;
+	SysctlWriteEntry *entry;
+	gboolean netns_ok;
+
+	/* the directory fds are bound to the netns in which they were
+	 * opened. Only opening them requires the netns of the platform. */
+	netns_ok = nm_platform_netns_push (platform, &netns);
+
+	g_mutex_lock (&priv->sysctl_writer.lock);
+	while ((entry = c_list_first_entry (&priv->sysctl_writer.pending_lst_head, SysctlWriteEntry, lst))) {
+		c_list_unlink (&entry->lst);
+		if (entry->path[0]) {
+			g_hash_table_remove (priv->sysctl_writer.pending_idx, entry->path);
+			priv->sysctl_writer.current_path = entry->path;
+		}
+		g_mutex_unlock (&priv->sysctl_writer.lock);
+
+		if (netns_ok)
+			_sysctl_writer_process (platform, entry);
+		else
+			entry->errsv = ENETDOWN;
+
+		g_mutex_lock (&priv->sysctl_writer.lock);
+		if (priv->sysctl_writer.current_path) {
+			priv->sysctl_writer.current_path = NULL;
+			g_cond_broadcast (&priv->sysctl_writer.cond);
+		}
+		_sysctl_writer_done_locked (platform, entry);
+	}
+	priv->sysctl_writer.worker_scheduled = FALSE;
+	g_mutex_unlock (&priv->sysctl_writer.lock);
+}
+
+#undef NM_THREAD_SAFE_ON_MAIN_THREAD
+#define NM_THREAD_SAFE_ON_MAIN_THREAD 1
+
+static void
+_sysctl_writer_queue (NMPlatform *platform,
+                      SysctlWriteEntry *entry)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	static GThreadPool *pool = NULL;
+
+	/* called with the lock held. The pool has only one thread, so there
+	 * is at most one worker at a time, which owns the dirfds. */
+	c_list_link_tail (&priv->sysctl_writer.pending_lst_head, &entry->lst);
+	if (entry->path[0])
+		g_hash_table_insert (priv->sysctl_writer.pending_idx, entry->path, entry);
+
+	if (priv->sysctl_writer.worker_scheduled)
+		return;
+
+	if (G_UNLIKELY (!pool))
+		pool = g_thread_pool_new (_sysctl_writer_thread_fn, NULL, 1, FALSE, NULL);
+
+	priv->sysctl_writer.worker_scheduled = TRUE;
+	g_thread_pool_push (pool, g_object_ref (platform), NULL);
+}
+
+static void
+sysctl_ip_conf_set_async (NMPlatform *platform,
+                          int addr_family,
+                          int ifindex,
+                          const char *ifname,
+                          const char *property,
+                          const char *value,
+                          NMPlatformAsyncCallback callback,
+                          gpointer data)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	char buf[NM_UTILS_SYSCTL_IP_CONF_PATH_BUFSIZE];
+	SysctlWriteEntry *entry;
+
+	nm_utils_sysctl_ip_conf_path (addr_family, buf, ifname, property);
+
+	g_mutex_lock (&priv->sysctl_writer.lock);
+
+	if (G_UNLIKELY (!priv->sysctl_writer.pending_idx)) {
+		priv->sysctl_writer.pending_idx = g_hash_table_new (nm_str_hash, g_str_equal);
+		priv->sysctl_writer.context = g_main_context_ref_thread_default ();
+	}
+
+	entry = g_hash_table_lookup (priv->sysctl_writer.pending_idx, buf);
+	if (entry) {
+		/* the worker didn't pick up the previous write yet. Only the
+		 * last value gets written, and all callers get its result. */
+		_LOGt ("sysctl: coalesce queued write of '%s' ('%s' -> '%s')",
+		       buf, entry->value, value);
+		if (!nm_streq (entry->value, value)) {
+			g_free (entry->value);
+			entry->value = g_strdup (value);
+		}
+		entry->ifindex = ifindex;
+	} else {
+		entry = _sysctl_write_entry_new (addr_family, ifindex, ifname, property, value);
+		_sysctl_writer_queue (platform, entry);
+	}
+
+	if (callback) {
+		if (!entry->callbacks)
+			entry->callbacks = g_array_new (FALSE, FALSE, sizeof (SysctlWriteCallback));
+		g_array_append_val (entry->callbacks,
+		                    ((SysctlWriteCallback) {
+		                        .callback      = callback,
+		                        .callback_data = data,
+		                    }));
+	}
+
+	g_mutex_unlock (&priv->sysctl_writer.lock);
+}
+
+static void
+_sysctl_writer_forget_ifindex (NMPlatform *platform, int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	if (!priv->sysctl_writer.pending_idx) {
+		/* the writer was never used. */
+		return;
+	}
+
+	g_mutex_lock (&priv->sysctl_writer.lock);
+	_sysctl_writer_queue (platform,
+	                      _sysctl_write_entry_new (AF_UNSPEC, ifindex, NULL, NULL, NULL));
+	g_mutex_unlock (&priv->sysctl_writer.lock);
+}
+
+/* synchronous access to @path must not race with a queued write. Take a
+ * pending write out of the queue (so that the caller can perform it in
+ * order), or wait until the worker finishes writing @path. */
+static SysctlWriteEntry *
+_sysctl_writer_settle (NMPlatform *platform, const char *path)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	SysctlWriteEntry *entry;
+
+	if (!priv->sysctl_writer.pending_idx)
+		return NULL;
+
+	g_mutex_lock (&priv->sysctl_writer.lock);
+	entry = g_hash_table_lookup (priv->sysctl_writer.pending_idx, path);
+	if (entry) {
+		g_hash_table_remove (priv->sysctl_writer.pending_idx, entry->path);
+		c_list_unlink (&entry->lst);
+	} else {
+		while (nm_streq0 (priv->sysctl_writer.current_path, path))
+			g_cond_wait (&priv->sysctl_writer.cond, &priv->sysctl_writer.lock);
+	}
+	g_mutex_unlock (&priv->sysctl_writer.lock);
+	return entry;
+}
+
+static void
+_sysctl_writer_settle_complete (NMPlatform *platform, SysctlWriteEntry *entry, int errsv)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	entry->errsv = errsv;
+	g_mutex_lock (&priv->sysctl_writer.lock);
+	_sysctl_writer_done_locked (platform, entry);
+	g_mutex_unlock (&priv->sysctl_writer.lock);
+}
+
+/*****************************************************************************/
+
 static gboolean
 sysctl_set (NMPlatform *platform,
             const char *pathid,
@@ -4974,10 +5508,25 @@ sysctl_set (NMPlatform *platform,
 
 	ASSERT_SYSCTL_ARGS (pathid, dirfd, path);
 
-	if (   dirfd < 0
-	    && !nm_platform_netns_push (platform, &netns)) {
-		errno = ENETDOWN;
-		return FALSE;
+	if (dirfd < 0) {
+		SysctlWriteEntry *queued;
+		gboolean success;
+		int errsv;
+
+		if (!nm_platform_netns_push (platform, &netns)) {
+			errno = ENETDOWN;
+			return FALSE;
+		}
+
+		/* this write supersedes a queued one. */
+		queued = _sysctl_writer_settle (platform, path);
+		success = sysctl_set_internal (platform, pathid, dirfd, path, value);
+		if (queued) {
+			errsv = errno;
+			_sysctl_writer_settle_complete (platform, queued, success ? 0 : errsv);
+			errno = errsv;
+		}
+		return success;
 	}
 
 	return sysctl_set_internal (platform, pathid, dirfd, path, value);
@@ -5252,11 +5801,24 @@ sysctl_get (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 	ASSERT_SYSCTL_ARGS (pathid, dirfd, path);
 
 	if (dirfd < 0) {
+		SysctlWriteEntry *queued;
+
 		if (!nm_platform_netns_push (platform, &netns)) {
 			errno = EBUSY;
 			return NULL;
 		}
 		pathid = path;
+
+		/* don't read a value that is about to be overwritten by a queued
+		 * write. Perform the write first. */
+		queued = _sysctl_writer_settle (platform, path);
+		if (queued) {
+			_sysctl_writer_settle_complete (platform,
+			                                queued,
+			                                  sysctl_set_internal (platform, NULL, -1, path, queued->value)
+			                                ? 0
+			                                : errno);
+		}
 	}
 
 	if (!nm_utils_file_get_contents (dirfd,
@@ -5301,6 +5863,17 @@ process_events (NMPlatform *platform)
 	delayed_action_handle_all (platform, TRUE);
 }
 
+static void
+refresh_routes_for_ifindex (NMPlatform *platform, int addr_family, int ifindex)
+{
+	if (!do_request_routes_no_delayed_actions (platform, addr_family, ifindex)) {
+		do_request_all_no_delayed_actions (platform,
+		                                     (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET) ? DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES : DELAYED_ACTION_TYPE_NONE)
+		                                   | (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET6) ? DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES : DELAYED_ACTION_TYPE_NONE));
+	}
+	delayed_action_handle_all (platform, FALSE);
+}
+
 /*****************************************************************************/
 
 static const RefreshAllInfo *
@@ -5427,6 +6000,7 @@ NM_UTILS_LOOKUP_STR_DEFINE (delayed_action_to_string, DelayedActionType,
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_MASTER_CONNECTED,              "master-connected"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_READ_NETLINK,                  "read-netlink"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE,          "wait-for-nl-response"),
+	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_ROUTES,                "refresh-routes"),
 	NM_UTILS_LOOKUP_ITEM_IGNORE (DELAYED_ACTION_TYPE_NONE),
 	NM_UTILS_LOOKUP_ITEM_IGNORE (DELAYED_ACTION_TYPE_REFRESH_ALL),
 	NM_UTILS_LOOKUP_ITEM_IGNORE (DELAYED_ACTION_TYPE_REFRESH_ALL_ROUTING_RULES_ALL),
@@ -5445,6 +6019,7 @@ delayed_action_to_string_full (DelayedActionType action_type, gpointer user_data
 		nm_utils_strbuf_append (&buf, &buf_size, " (master-ifindex %d)", GPOINTER_TO_INT (user_data));
 		break;
 	case DELAYED_ACTION_TYPE_REFRESH_LINK:
+	case DELAYED_ACTION_TYPE_REFRESH_ROUTES:
 		nm_utils_strbuf_append (&buf, &buf_size, " (ifindex %d)", GPOINTER_TO_INT (user_data));
 		break;
 	case DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE:
@@ -5624,6 +6199,16 @@ delayed_action_handle_REFRESH_ALL (NMPlatform *platform, DelayedActionType flags
 	do_request_all_no_delayed_actions (platform, flags);
 }
 
+static void
+delayed_action_handle_REFRESH_ROUTES (NMPlatform *platform, int ifindex)
+{
+	if (!do_request_routes_no_delayed_actions (platform, AF_UNSPEC, ifindex)) {
+		do_request_all_no_delayed_actions (platform,
+		                                     DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES
+		                                   | DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES);
+	}
+}
+
 static void
 delayed_action_handle_READ_NETLINK (NMPlatform *platform)
 {
@@ -5704,6 +6289,22 @@ delayed_action_handle_one (NMPlatform *platform)
 		return TRUE;
 	}
 
+	if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_ROUTES)) {
+		nm_assert (priv->delayed_action.list_refresh_routes->len > 0);
+
+		user_data = priv->delayed_action.list_refresh_routes->pdata[0];
+		g_ptr_array_remove_index_fast (priv->delayed_action.list_refresh_routes, 0);
+		if (priv->delayed_action.list_refresh_routes->len == 0)
+			priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_ROUTES;
+		nm_assert (_nm_utils_ptrarray_find_first ((gconstpointer *) priv->delayed_action.list_refresh_routes->pdata, priv->delayed_action.list_refresh_routes->len, user_data) < 0);
+
+		_LOGt_delayed_action (DELAYED_ACTION_TYPE_REFRESH_ROUTES, user_data, "handle");
+
+		delayed_action_handle_REFRESH_ROUTES (platform, GPOINTER_TO_INT (user_data));
+
+		return TRUE;
+	}
+
 	if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE)) {
 		nm_assert (priv->delayed_action.list_wait_for_nl_response->len > 0);
 		_LOGt_delayed_action (DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE, NULL, "handle");
@@ -5747,6 +6348,10 @@ delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gp
 		if (_nm_utils_ptrarray_find_first ((gconstpointer *) priv->delayed_action.list_refresh_link->pdata, priv->delayed_action.list_refresh_link->len, user_data) < 0)
 			g_ptr_array_add (priv->delayed_action.list_refresh_link, user_data);
 		break;
+	case DELAYED_ACTION_TYPE_REFRESH_ROUTES:
+		if (_nm_utils_ptrarray_find_first ((gconstpointer *) priv->delayed_action.list_refresh_routes->pdata, priv->delayed_action.list_refresh_routes->len, user_data) < 0)
+			g_ptr_array_add (priv->delayed_action.list_refresh_routes, user_data);
+		break;
 	case DELAYED_ACTION_TYPE_MASTER_CONNECTED:
 		if (_nm_utils_ptrarray_find_first ((gconstpointer *) priv->delayed_action.list_master_connected->pdata, priv->delayed_action.list_master_connected->len, user_data) < 0)
 			g_ptr_array_add (priv->delayed_action.list_master_connected, user_data);
@@ -5757,6 +6362,7 @@ delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gp
 	default:
 		nm_assert (!user_data);
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_REFRESH_LINK));
+		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_REFRESH_ROUTES));
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_MASTER_CONNECTED));
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE));
 		break;
@@ -5799,22 +6405,36 @@ cache_prune_one_type (NMPlatform *platform,
                       const NMPLookup *lookup)
 {
 	NMDedupMultiIter iter;
+	const NMDedupMultiHeadEntry *head_entry;
 	const NMPObject *obj;
 	NMPCacheOpsType cache_op;
 	NMPCache *cache = nm_platform_get_cache (platform);
+	guint n_dirty = G_MAXUINT;
+
+	head_entry = nmp_cache_lookup (cache, lookup);
+
+	if (lookup->cache_id_type == NMP_CACHE_ID_TYPE_OBJECT_TYPE) {
+		/* The lookup is the main index, which tracks how many entries
+		 * are dirty. During a dump, every refreshed object is moved to the
+		 * end of the list, so the stale entries are usually in front and
+		 * we can stop once we found all of them. */
+		n_dirty = nm_dedup_multi_head_entry_get_n_dirty (head_entry);
+	}
 
-	nm_dedup_multi_iter_init (&iter,
-	                          nmp_cache_lookup (cache,
-	                                            lookup));
-	while (nm_dedup_multi_iter_next (&iter)) {
+	nm_dedup_multi_iter_init (&iter, head_entry);
+	while (   n_dirty > 0
+	       && nm_dedup_multi_iter_next (&iter)) {
 		const NMDedupMultiEntry *main_entry;
 
 		/* we only track the dirty flag for the OBJECT-TYPE index. That means,
 		 * for other lookup types we need to check the dirty flag of the main-entry. */
 		main_entry = nmp_cache_reresolve_main_entry (cache, iter.current, lookup);
-		if (!main_entry->dirty)
+		if (!nm_dedup_multi_entry_is_dirty (main_entry))
 			continue;
 
+		if (n_dirty != G_MAXUINT)
+			n_dirty--;
+
 		obj = main_entry->obj;
 
 		_LOGt ("cache-prune: prune %s", nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_ALL, NULL, 0));
@@ -5913,6 +6533,7 @@ cache_on_change (NMPlatform *platform,
 				ifindex = obj_new->link.ifindex;
 
 			if (ifindex > 0) {
+				_sysctl_writer_forget_ifindex (platform, ifindex);
 				delayed_action_schedule (platform,
 				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
 				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES |
@@ -5968,11 +6589,13 @@ cache_on_change (NMPlatform *platform,
 			            && !NM_FLAGS_HAS (obj_new->link.n_ifi_flags, IFF_LOWER_UP)))) {
 				/* FIXME: I suspect that IFF_LOWER_UP must not be considered, and I
 				 * think kernel does send RTM_DELROUTE events for IPv6 routes, so
-				 * we might not need to refresh IPv6 routes. */
+				 * we might not need to refresh IPv6 routes.
+				 *
+				 * Only the routes of this link are affected, so we only
+				 * dump those (if kernel supports filtering the dump). */
 				delayed_action_schedule (platform,
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
-				                         NULL);
+				                         DELAYED_ACTION_TYPE_REFRESH_ROUTES,
+				                         GINT_TO_POINTER (obj_new->link.ifindex));
 			}
 		}
 		if (   NM_IN_SET (cache_op, NMP_CACHE_OPS_ADDED, NMP_CACHE_OPS_UPDATED)
@@ -6330,6 +6953,15 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 		                              &lookup);
 	}
 
+	if (   NM_FLAGS_ALL (action_type,   DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES
+	                                  | DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES)
+	    && NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_ROUTES)) {
+		/* dumping all routes also covers the pending per-link route refreshes. */
+		_LOGt_delayed_action (DELAYED_ACTION_TYPE_REFRESH_ROUTES, NULL, "clear (do-request-all)");
+		priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_ROUTES;
+		g_ptr_array_set_size (priv->delayed_action.list_refresh_routes, 0);
+	}
+
 	FOR_EACH_DELAYED_ACTION (iflags, action_type) {
 		RefreshAllType refresh_all_type = delayed_action_type_to_refresh_all_type (iflags);
 		const RefreshAllInfo *refresh_all_info = refresh_all_type_get_info (refresh_all_type);
@@ -6384,6 +7016,159 @@ do_request_one_type_by_needle_object (NMPlatform *platform, const NMPObject *obj
 	delayed_action_handle_all (platform, FALSE);
 }
 
+static struct nl_msg *
+_nl_msg_new_dump_route (int addr_family, int ifindex)
+{
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+	const struct rtmsg rtmsg = {
+		.rtm_family = addr_family,
+	};
+
+	nm_assert (NM_IN_SET (addr_family, AF_INET, AF_INET6));
+	nm_assert (ifindex > 0);
+
+	/* With NETLINK_GET_STRICT_CHK, kernel requires a complete struct rtmsg
+	 * header (instead of a struct rtgenmsg) and filters the dump by RTA_OIF. */
+	nlmsg = nlmsg_alloc_simple (RTM_GETROUTE, NLM_F_DUMP);
+
+	if (nlmsg_append_struct (nlmsg, &rtmsg) < 0)
+		goto nla_put_failure;
+
+	NLA_PUT_U32 (nlmsg, RTA_OIF, ifindex);
+
+	return g_steal_pointer (&nlmsg);
+
+nla_put_failure:
+	g_return_val_if_reached (NULL);
+}
+
+static void
+_request_routes_undo (NMPlatform *platform, int IS_IPv4, gboolean pruning_taken)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const RefreshAllType refresh_all_type = IS_IPv4 ? REFRESH_ALL_TYPE_IP4_ROUTES : REFRESH_ALL_TYPE_IP6_ROUTES;
+
+	/* the request was not sent. Drop the pruning reference that waits for
+	 * its response. The routes of the interface stay dirty: they were not
+	 * synced, and only the reply to a later request may clear the mark. */
+	if (pruning_taken) {
+		nm_assert (priv->pruning[refresh_all_type] > 0);
+		priv->pruning[refresh_all_type] -= 1;
+	}
+}
+
+static gboolean
+do_request_routes_no_delayed_actions (NMPlatform *platform, int addr_family, int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gboolean pruning_taken[2] = { FALSE, FALSE };
+	int IS_IPv4;
+	int nle;
+
+	nm_assert (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET, AF_INET6));
+	nm_assert (ifindex > 0);
+
+	if (priv->nlh_strict_chk_unsupported)
+		return FALSE;
+
+	_LOGD ("do-request-routes: %d (%c)",
+	       ifindex,
+	       nm_utils_addr_family_to_char (addr_family));
+
+	for (IS_IPv4 = 1; IS_IPv4 >= 0; IS_IPv4--) {
+		const int addr_family_i = IS_IPv4 ? AF_INET : AF_INET6;
+		const RefreshAllType refresh_all_type = IS_IPv4 ? REFRESH_ALL_TYPE_IP4_ROUTES : REFRESH_ALL_TYPE_IP6_ROUTES;
+		nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+		int *out_refresh_all_in_progress;
+		NMPLookup lookup;
+
+		if (!NM_IN_SET (addr_family, AF_UNSPEC, addr_family_i))
+			continue;
+
+		/* like for a full dump, mark the routes of the interface as dirty.
+		 * Those that are not part of the response get pruned afterwards.
+		 *
+		 * cache_prune_all() releases one pruning reference per round. The
+		 * requests for several interfaces in the same round must not stack
+		 * up, or the counter would never drop to zero again. */
+		if (priv->pruning[refresh_all_type] == 0) {
+			priv->pruning[refresh_all_type] = 1;
+			pruning_taken[IS_IPv4] = TRUE;
+		}
+		nmp_lookup_init_object (&lookup,
+		                        IS_IPv4 ? NMP_OBJECT_TYPE_IP4_ROUTE : NMP_OBJECT_TYPE_IP6_ROUTE,
+		                        ifindex);
+		nmp_cache_dirty_set_all_main (nm_platform_get_cache (platform),
+		                              &lookup);
+
+		out_refresh_all_in_progress = &priv->delayed_action.refresh_all_in_progress[refresh_all_type];
+		nm_assert (*out_refresh_all_in_progress >= 0);
+		*out_refresh_all_in_progress += 1;
+
+		/* reading netlink may emit signals and callers might issue
+		 * requests of their own. Do that before enabling strict checking. */
+		event_handler_read_netlink (platform, FALSE);
+
+		nlmsg = _nl_msg_new_dump_route (addr_family_i, ifindex);
+		if (!nlmsg)
+			goto next_after_fail;
+
+		/* strict checking also validates other (non-dump) requests more
+		 * rigorously. Only enable it for sending this request. Kernel
+		 * evaluates it while processing sendmsg() and remembers it for the
+		 * remainder of the dump. */
+		nle = nl_socket_set_strict_chk (priv->nlh, TRUE);
+		if (nle < 0) {
+			_LOGD ("do-request-routes: kernel does not support filtering dumps (%s). Fall back to full dumps",
+			       nm_strerror (nle));
+			priv->nlh_strict_chk_unsupported = TRUE;
+			nm_assert (*out_refresh_all_in_progress > 0);
+			*out_refresh_all_in_progress -= 1;
+
+			/* the caller falls back to a full dump, which marks all routes
+			 * dirty again. Also drop the pruning reference of an address
+			 * family that was already requested, the full dump covers it. */
+			_request_routes_undo (platform, IS_IPv4, pruning_taken[IS_IPv4]);
+			if (   !IS_IPv4
+			    && pruning_taken[1])
+				_request_routes_undo (platform, 1, TRUE);
+			return FALSE;
+		}
+
+		nle = _nl_send_nlmsg (platform,
+		                      nlmsg,
+		                      NULL,
+		                      NULL,
+		                      DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS,
+		                      out_refresh_all_in_progress);
+
+		if (nl_socket_set_strict_chk (priv->nlh, FALSE) < 0) {
+			_LOGE ("do-request-routes: failure to disable strict checking on netlink socket");
+			priv->nlh_strict_chk_unsupported = TRUE;
+		}
+
+		if (nle < 0)
+			goto next_after_fail;
+
+		continue;
+
+next_after_fail:
+		nm_assert (*out_refresh_all_in_progress > 0);
+		*out_refresh_all_in_progress -= 1;
+		_request_routes_undo (platform, IS_IPv4, pruning_taken[IS_IPv4]);
+
+		/* resync the dirty routes with a full dump of the address family.
+		 * Its reply refreshes them, or prunes those that are gone. */
+		delayed_action_schedule (platform,
+		                         IS_IPv4
+		                           ? DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES
+		                           : DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
+		                         NULL);
+	}
+
+	return TRUE;
+}
+
 static void
 event_seq_check_refresh_all (NMPlatform *platform, guint32 seq_number)
 {
@@ -6452,16 +7237,38 @@ event_seq_check (NMPlatform *platform, guint32 seq_number, WaitForNlResponseResu
 #endif
 }
 
+static gboolean
+_route_get_is_pending (NMPlatform *platform, guint32 seq_number)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint i;
+
+	if (!NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE))
+		return FALSE;
+
+	for (i = 0; i < priv->delayed_action.list_wait_for_nl_response->len; i++) {
+		const DelayedActionWaitForNlResponseData *data = &g_array_index (priv->delayed_action.list_wait_for_nl_response, DelayedActionWaitForNlResponseData, i);
+
+		if (   data->response_type == DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET
+		    && data->response.out_route_get
+		    && data->seq_number == seq_number)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 static void
 event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_events)
 {
 	NMLinuxPlatformPrivate *priv;
-	nm_auto_nmpobj NMPObject *obj = NULL;
+	nm_auto_nmpobj_unless_stackinit NMPObject *obj = NULL;
+	NMPObject obj_stack;
 	NMPCacheOpsType cache_op;
 	struct nlmsghdr *msghdr;
 	char buf_nlmsghdr[400];
 	gboolean is_del = FALSE;
 	gboolean is_dump = FALSE;
+	gboolean route_ignored = FALSE;
 	NMPCache *cache = nm_platform_get_cache (platform);
 
 	msghdr = nlmsg_hdr (msg);
@@ -6502,7 +7309,25 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 		is_del = TRUE;
 	}
 
-	obj = nmp_object_new_from_nl (platform, cache, msg, is_del);
+	/* routes of ignored tables and protocols are not tracked in the cache.
+	 * Check that before parsing the message, but a route that is the answer
+	 * to nm_platform_ip_route_get() must still reach the caller. */
+	if (   NM_IN_SET (msghdr->nlmsg_type, RTM_NEWROUTE, RTM_DELROUTE)
+	    && _route_ignore_check (platform, msghdr)) {
+		if (   msghdr->nlmsg_type == RTM_DELROUTE
+		    || !_route_get_is_pending (platform, msghdr->nlmsg_seq)) {
+			_LOGT ("event-notification: %s: ignore route",
+			       nl_nlmsghdr_to_str (msghdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
+			/* parts of a dump are the reply to our own request, only
+			 * count the notifications about changes. */
+			if (!NM_FLAGS_HAS (msghdr->nlmsg_flags, NLM_F_MULTI))
+				NM_LINUX_PLATFORM_GET_PRIVATE (platform)->route_ignore.n_dropped++;
+			return;
+		}
+		route_ignored = TRUE;
+	}
+
+	obj = nmp_object_new_from_nl (platform, cache, msg, is_del, &obj_stack);
 	if (!obj) {
 		_LOGT ("event-notification: %s: ignore",
 		       nl_nlmsghdr_to_str (msghdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
@@ -6578,6 +7403,9 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 				}
 			}
 
+			if (route_ignored)
+				break;
+
 			cache_op = nmp_cache_update_netlink_route (cache,
 			                                           obj,
 			                                           is_dump,
@@ -6699,33 +7527,14 @@ do_add_link_with_lookup (NMPlatform *platform,
 }
 
 static int
-do_add_addrroute (NMPlatform *platform,
-                  const NMPObject *obj_id,
-                  struct nl_msg *nlmsg,
-                  gboolean suppress_netlink_failure)
+_do_add_addrroute_complete (NMPlatform *platform,
+                            const NMPObject *obj_id,
+                            WaitForNlResponseResult seq_result,
+                            const char *errmsg,
+                            gboolean suppress_netlink_failure)
 {
-	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
-	gs_free char *errmsg = NULL;
-	int nle;
 	char s_buf[256];
 
-	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id),
-	                      NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS,
-	                      NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE));
-
-	event_handler_read_netlink (platform, FALSE);
-
-	nle = _nl_send_nlmsg (platform, nlmsg, &seq_result, &errmsg, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
-	if (nle < 0) {
-		_LOGE ("do-add-%s[%s]: failure sending netlink request \"%s\" (%d)",
-		       NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
-		       nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
-		       nm_strerror (nle), -nle);
-		return -NME_PL_NETLINK;
-	}
-
-	delayed_action_handle_all (platform, FALSE);
-
 	nm_assert (seq_result);
 
 	_NMLOG ((   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
@@ -6753,29 +7562,46 @@ do_add_addrroute (NMPlatform *platform,
 	return wait_for_nl_response_to_nmerr (seq_result);
 }
 
-static gboolean
-do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *nlmsg)
+static int
+do_add_addrroute (NMPlatform *platform,
+                  const NMPObject *obj_id,
+                  struct nl_msg *nlmsg,
+                  gboolean suppress_netlink_failure)
 {
 	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
 	gs_free char *errmsg = NULL;
 	int nle;
-	char s_buf[256];
-	gboolean success;
-	const char *log_detail = "";
+
+	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id),
+	                      NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS,
+	                      NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE));
 
 	event_handler_read_netlink (platform, FALSE);
 
 	nle = _nl_send_nlmsg (platform, nlmsg, &seq_result, &errmsg, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
 	if (nle < 0) {
-		_LOGE ("do-delete-%s[%s]: failure sending netlink request \"%s\" (%d)",
+		_LOGE ("do-add-%s[%s]: failure sending netlink request \"%s\" (%d)",
 		       NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
 		       nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
 		       nm_strerror (nle), -nle);
-		return FALSE;
+		return -NME_PL_NETLINK;
 	}
 
 	delayed_action_handle_all (platform, FALSE);
 
+	return _do_add_addrroute_complete (platform, obj_id, seq_result, errmsg, suppress_netlink_failure);
+}
+
+static gboolean
+_do_delete_object_complete (NMPlatform *platform,
+                            const NMPObject *obj_id,
+                            WaitForNlResponseResult seq_result,
+                            const char *errmsg)
+{
+	char s_buf[256];
+	gboolean success;
+	const char *log_detail = "";
+
 	nm_assert (seq_result);
 
 	success = TRUE;
@@ -6818,6 +7644,154 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 	return success;
 }
 
+static gboolean
+do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *nlmsg)
+{
+	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+	gs_free char *errmsg = NULL;
+	int nle;
+
+	event_handler_read_netlink (platform, FALSE);
+
+	nle = _nl_send_nlmsg (platform, nlmsg, &seq_result, &errmsg, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+	if (nle < 0) {
+		_LOGE ("do-delete-%s[%s]: failure sending netlink request \"%s\" (%d)",
+		       NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
+		       nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+		       nm_strerror (nle), -nle);
+		return FALSE;
+	}
+
+	delayed_action_handle_all (platform, FALSE);
+
+	return _do_delete_object_complete (platform, obj_id, seq_result, errmsg);
+}
+
+/* The maximum number of requests that we keep in flight when pipelining
+ * route requests. The acknowledgements are queued in the socket's receive
+ * buffer until we read them, so this must be small enough to not
+ * overflow it. */
+#define ROUTE_BATCH_MAX_IN_FLIGHT 256
+
+typedef struct {
+	WaitForNlResponseResult seq_result;
+	char *errmsg;
+	bool sent:1;
+} RouteBatchResponse;
+
+/**
+ * do_route_batch:
+ * @platform: the #NMPlatform
+ * @nlmsg_type: either RTM_NEWROUTE or RTM_DELROUTE
+ * @flags: the #NMPNlmFlags for RTM_NEWROUTE
+ * @objs: the route objects
+ * @len: the number of objects in @objs
+ * @out_add_results: (allow-none): for RTM_NEWROUTE, the per-route result
+ * @out_delete_results: (allow-none): for RTM_DELROUTE, the per-route result
+ *
+ * Sends up to %ROUTE_BATCH_MAX_IN_FLIGHT requests with distinct sequence
+ * numbers before collecting all responses in one pass over the socket. The
+ * responses are then mapped back to the individual routes, like
+ * do_add_addrroute() and do_delete_object() would do for a single request.
+ */
+static void
+do_route_batch (NMPlatform *platform,
+                guint16 nlmsg_type,
+                NMPNlmFlags flags,
+                const NMPObject *const*objs,
+                guint len,
+                int *out_add_results,
+                gboolean *out_delete_results)
+{
+	gs_free RouteBatchResponse *responses = NULL;
+	guint i_start;
+	guint n;
+	guint i;
+
+	nm_assert (NM_IN_SET (nlmsg_type, RTM_NEWROUTE, RTM_DELROUTE));
+	nm_assert (len > 0);
+
+	responses = g_new (RouteBatchResponse, NM_MIN (len, (guint) ROUTE_BATCH_MAX_IN_FLIGHT));
+
+	event_handler_read_netlink (platform, FALSE);
+
+	for (i_start = 0; i_start < len; i_start += n) {
+		n = NM_MIN (len - i_start, (guint) ROUTE_BATCH_MAX_IN_FLIGHT);
+
+		for (i = 0; i < n; i++) {
+			const NMPObject *obj = objs[i_start + i];
+			nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+			RouteBatchResponse *response = &responses[i];
+			NMPObject obj_normalized;
+			int nle;
+
+			nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_TYPE_IP4_ROUTE,
+			                                                 NMP_OBJECT_TYPE_IP6_ROUTE));
+
+			*response = (RouteBatchResponse) {
+				.seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN,
+			};
+
+			if (nlmsg_type == RTM_NEWROUTE) {
+				nmp_object_stackinit (&obj_normalized, NMP_OBJECT_GET_TYPE (obj), &obj->object);
+				nm_platform_ip_route_normalize (NMP_OBJECT_GET_CLASS (obj)->addr_family,
+				                                NMP_OBJECT_CAST_IP_ROUTE (&obj_normalized));
+				nlmsg = _nl_msg_new_route (RTM_NEWROUTE, flags & NMP_NLM_FLAG_FMASK, &obj_normalized);
+			} else
+				nlmsg = _nl_msg_new_route (RTM_DELROUTE, 0, obj);
+			if (!nlmsg) {
+				/* not sent, it is reported as failure below. The requests
+				 * that are already in flight still need to be waited for. */
+				g_warn_if_reached ();
+				continue;
+			}
+
+			nle = _nl_send_nlmsg (platform, nlmsg, &response->seq_result, &response->errmsg,
+			                      DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+			if (nle < 0) {
+				_LOGE ("do-%s-%s[%s]: failure sending netlink request \"%s\" (%d)",
+				       nlmsg_type == RTM_NEWROUTE ? "add" : "delete",
+				       NMP_OBJECT_GET_CLASS (obj)->obj_type_name,
+				       nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+				       nm_strerror (nle), -nle);
+				continue;
+			}
+			response->sent = TRUE;
+		}
+
+		/* wait for all responses of this window at once. */
+		delayed_action_handle_all (platform, FALSE);
+
+		for (i = 0; i < n; i++) {
+			const NMPObject *obj = objs[i_start + i];
+			RouteBatchResponse *response = &responses[i];
+
+			if (nlmsg_type == RTM_NEWROUTE) {
+				if (!response->sent)
+					out_add_results[i_start + i] = -NME_PL_NETLINK;
+				else {
+					out_add_results[i_start + i] = _do_add_addrroute_complete (platform,
+					                                                           obj,
+					                                                           response->seq_result,
+					                                                           response->errmsg,
+					                                                           NM_FLAGS_HAS (flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE));
+				}
+			} else {
+				gboolean success;
+
+				success =    response->sent
+				          && _do_delete_object_complete (platform,
+				                                         obj,
+				                                         response->seq_result,
+				                                         response->errmsg);
+				if (out_delete_results)
+					out_delete_results[i_start + i] = success;
+			}
+			nm_clear_g_free (&response->errmsg);
+		}
+	}
+}
+
 static int
 do_change_link (NMPlatform *platform,
                 ChangeLinkType change_link_type,
@@ -6981,6 +7955,38 @@ link_refresh (NMPlatform *platform, int ifindex)
 	return !!nm_platform_link_get_obj (platform, ifindex, TRUE);
 }
 
+/* Below this number of links, we always request them one by one. */
+#define LINK_REFRESH_STATS_DUMP_MIN 8
+
+static void
+link_refresh_stats (NMPlatform *platform, const int *ifindexes, guint len)
+{
+	const NMDedupMultiHeadEntry *head_entry;
+	guint n_links;
+	guint i;
+
+	if (len == 0)
+		return;
+
+	head_entry = nm_platform_lookup_obj_type (platform, NMP_OBJECT_TYPE_LINK);
+	n_links = head_entry ? head_entry->len : 0u;
+
+	if (   len >= LINK_REFRESH_STATS_DUMP_MIN
+	    && len * 2u >= n_links) {
+		/* most links are requested anyway. Do one RTM_GETLINK dump instead of
+		 * one request per link. The dump also updates the links that nobody
+		 * asked for, so only do it when that is a minority. */
+		_LOGD ("link-stats: refresh %u of %u links with a dump", len, n_links);
+		do_request_all_no_delayed_actions (platform, DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS);
+	} else {
+		/* send all requests first and only then wait for the replies. */
+		for (i = 0; i < len; i++)
+			do_request_link_no_delayed_actions (platform, ifindexes[i], NULL);
+	}
+
+	delayed_action_handle_all (platform, FALSE);
+}
+
 static gboolean
 link_set_netns (NMPlatform *platform,
                 int ifindex,
@@ -8283,6 +9289,34 @@ ip_route_add (NMPlatform *platform,
 	                         NM_FLAGS_HAS (flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE));
 }
 
+static void
+ip_route_add_batch (NMPlatform *platform,
+                    NMPNlmFlags flags,
+                    const NMPObject *const*routes,
+                    guint len,
+                    int *out_results)
+{
+	do_route_batch (platform, RTM_NEWROUTE, flags, routes, len, out_results, NULL);
+}
+
+static void
+object_delete_batch (NMPlatform *platform,
+                     const NMPObject *const*objs,
+                     guint len,
+                     gboolean *out_results)
+{
+	gs_unref_ptrarray GPtrArray *objs_keep_alive = NULL;
+	guint i;
+
+	objs_keep_alive = g_ptr_array_new_full (len, (GDestroyNotify) nmp_object_unref);
+	for (i = 0; i < len; i++) {
+		if (!NMP_OBJECT_IS_STACKINIT (objs[i]))
+			g_ptr_array_add (objs_keep_alive, (gpointer) nmp_object_ref (objs[i]));
+	}
+
+	do_route_batch (platform, RTM_DELROUTE, 0, objs, len, NULL, out_results);
+}
+
 static gboolean
 object_delete (NMPlatform *platform,
                const NMPObject *obj)
@@ -8538,7 +9572,7 @@ event_handler (int fd,
 
 /* copied from libnl3's recvmsgs() */
 static int
-event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
+_event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 	struct nl_sock *sk = priv->nlh;
@@ -8551,11 +9585,24 @@ event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
 	struct sockaddr_nl nla = {0};
 	struct ucred creds;
 	gboolean creds_has;
-	nm_auto_free unsigned char *buf = NULL;
+	const unsigned char *buf;
+	nm_auto_free unsigned char *buf_free = NULL;
 
 continue_reading:
-	nm_clear_pointer (&buf, free);
-	n = nl_recv (sk, &nla, &buf, &creds, &creds_has);
+	nm_clear_pointer (&buf_free, free);
+	if (   priv->nlh_recv_nesting == 1
+	    || nl_recv_ring_has_pending (priv->nlh_recv_ring)) {
+		/* Read the next datagram from the ring. The ring only reads from the
+		 * socket after all previous datagrams were handed out, which would
+		 * overwrite the buffers. Only do that for the outermost call. */
+		n = nl_recv_ring_next (sk, priv->nlh_recv_ring, &nla, &buf, &creds, &creds_has);
+	} else {
+		/* We are called recursively (from a signal handler) while the outer call
+		 * still parses a datagram in the ring, and the ring is empty. Use a
+		 * separate buffer. */
+		n = nl_recv (sk, &nla, &buf_free, &creds, &creds_has);
+		buf = buf_free;
+	}
 
 	if (n <= 0) {
 
@@ -8735,6 +9782,18 @@ stop:
 	return err;
 }
 
+static int
+event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	int r;
+
+	priv->nlh_recv_nesting++;
+	r = _event_handler_recvmsgs (platform, handle_events);
+	priv->nlh_recv_nesting--;
+	return r;
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -8751,6 +9810,7 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 		gint64 timeout_abs_ns;
 		gint64 now_ns;
 	} next;
+	NLRecvRingStats stats_before;
 
 	if (!nm_platform_netns_push (platform, &netns)) {
 		delayed_action_wait_for_nl_response_complete_all (platform,
@@ -8758,6 +9818,8 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 		return FALSE;
 	}
 
+	stats_before = *nl_recv_ring_get_stats (priv->nlh_recv_ring);
+
 	for (;;) {
 		for (;;) {
 			int nle;
@@ -8807,6 +9869,19 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 
 after_read:
 
+		if (_LOGt_ENABLED ()) {
+			const NLRecvRingStats *stats = nl_recv_ring_get_stats (priv->nlh_recv_ring);
+
+			if (stats->n_reads != stats_before.n_reads) {
+				_LOGt ("netlink: read: %"G_GUINT64_FORMAT" datagrams (%"G_GUINT64_FORMAT" bytes, %"G_GUINT64_FORMAT" truncated) in %"G_GUINT64_FORMAT" reads",
+				       stats->n_datagrams - stats_before.n_datagrams,
+				       stats->n_bytes - stats_before.n_bytes,
+				       stats->n_truncated - stats_before.n_truncated,
+				       stats->n_reads - stats_before.n_reads);
+				stats_before = *stats;
+			}
+		}
+
 		if (!NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE))
 			return any;
 
@@ -8974,12 +10049,128 @@ handle_udev_event (NMUdevClient *udev_client,
 
 /*****************************************************************************/
 
+static const struct {
+	const char *name;
+	guint8 rtprot;
+} _route_ignore_protocol_names[] = {
+	/* names as in iproute2's rt_protos. */
+	{ "redirect",   1 },
+	{ "kernel",     2 },
+	{ "boot",       3 },
+	{ "static",     4 },
+	{ "gated",      8 },
+	{ "ra",         9 },
+	{ "mrt",        10 },
+	{ "zebra",      11 },
+	{ "bird",       12 },
+	{ "dnrouted",   13 },
+	{ "xorp",       14 },
+	{ "ntk",        15 },
+	{ "dhcp",       16 },
+	{ "keepalived", 18 },
+	{ "babel",      42 },
+	{ "bgp",        186 },
+	{ "isis",       187 },
+	{ "ospf",       188 },
+	{ "rip",        189 },
+	{ "eigrp",      192 },
+};
+
+static void
+_route_ignore_parse (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gs_free const char **tables = NULL;
+	gs_free const char **protocols = NULL;
+	gsize i, j;
+
+	tables = nm_utils_strsplit_set (priv->route_ignore.tables_str, " \t,;");
+	if (tables) {
+		priv->route_ignore.tables = g_new (guint32, NM_PTRARRAY_LEN (tables));
+		for (i = 0; tables[i]; i++) {
+			gint64 table;
+
+			table = _nm_utils_ascii_str_to_int64 (tables[i], 0, 0, G_MAXUINT32, -1);
+			if (table < 0) {
+				_LOGW ("route-ignore: invalid route table \"%s\"", tables[i]);
+				continue;
+			}
+			if (NM_IN_SET (table, RT_TABLE_UNSPEC, RT_TABLE_MAIN, RT_TABLE_LOCAL)) {
+				_LOGW ("route-ignore: cannot ignore routes in table %u", (guint) table);
+				continue;
+			}
+			priv->route_ignore.tables[priv->route_ignore.n_tables++] = table;
+		}
+	}
+
+	protocols = nm_utils_strsplit_set (priv->route_ignore.protocols_str, " \t,;");
+	for (i = 0; protocols && protocols[i]; i++) {
+		gint64 rtprot;
+
+		rtprot = _nm_utils_ascii_str_to_int64 (protocols[i], 0, 0, 255, -1);
+		if (rtprot < 0) {
+			for (j = 0; j < G_N_ELEMENTS (_route_ignore_protocol_names); j++) {
+				if (nm_streq (protocols[i], _route_ignore_protocol_names[j].name)) {
+					rtprot = _route_ignore_protocol_names[j].rtprot;
+					break;
+				}
+			}
+		}
+		if (rtprot < 0) {
+			_LOGW ("route-ignore: invalid route protocol \"%s\"", protocols[i]);
+			continue;
+		}
+		if (NM_IN_SET (rtprot, RTPROT_UNSPEC, RTPROT_KERNEL, RTPROT_STATIC, RTPROT_RA, RTPROT_DHCP)) {
+			/* NetworkManager configures routes with these protocols itself. */
+			_LOGW ("route-ignore: cannot ignore routes with protocol %u", (guint) rtprot);
+			continue;
+		}
+		priv->route_ignore.protocols[rtprot / 32] |= (1u << (rtprot % 32));
+		priv->route_ignore.has_protocols = TRUE;
+	}
+
+	if (   priv->route_ignore.n_tables > 0
+	    || priv->route_ignore.has_protocols) {
+		_LOGD ("route-ignore: ignore routes in tables \"%s\" and with protocols \"%s\"",
+		       priv->route_ignore.tables_str ?: "",
+		       priv->route_ignore.protocols_str ?: "");
+	}
+}
+
+/**
+ * nm_linux_platform_get_route_ignore_dropped:
+ * @platform: the #NMLinuxPlatform instance
+ *
+ * Returns: the number of route notifications from kernel that were dropped,
+ *   because the route is in an ignored table or has an ignored protocol.
+ *   The replies to dump and route-get requests are not counted.
+ */
+guint64
+nm_linux_platform_get_route_ignore_dropped (NMPlatform *platform)
+{
+	g_return_val_if_fail (NM_IS_LINUX_PLATFORM (platform), 0);
+
+	return NM_LINUX_PLATFORM_GET_PRIVATE (platform)->route_ignore.n_dropped;
+}
+
+/*****************************************************************************/
+
 void
 nm_linux_platform_setup (void)
 {
 	nm_platform_setup (nm_linux_platform_new (FALSE, FALSE));
 }
 
+void
+nm_linux_platform_setup_full (const char *route_ignore_tables,
+                              const char *route_ignore_protocols)
+{
+	nm_platform_setup (nm_linux_platform_new_full (FALSE,
+	                                               FALSE,
+	                                               route_ignore_tables,
+	                                               route_ignore_protocols));
+}
+
 /*****************************************************************************/
 
 static void
@@ -8989,7 +10180,13 @@ nm_linux_platform_init (NMLinuxPlatform *self)
 
 	priv->delayed_action.list_master_connected = g_ptr_array_new ();
 	priv->delayed_action.list_refresh_link = g_ptr_array_new ();
+	priv->delayed_action.list_refresh_routes = g_ptr_array_new ();
 	priv->delayed_action.list_wait_for_nl_response = g_array_new (FALSE, TRUE, sizeof (DelayedActionWaitForNlResponseData));
+
+	g_mutex_init (&priv->sysctl_writer.lock);
+	g_cond_init (&priv->sysctl_writer.cond);
+	c_list_init (&priv->sysctl_writer.pending_lst_head);
+	c_list_init (&priv->sysctl_writer.done_lst_head);
 }
 
 static void
@@ -9002,6 +10199,8 @@ constructed (GObject *_object)
 
 	nm_assert (!platform->_netns || platform->_netns == nmp_netns_get_current ());
 
+	_route_ignore_parse (platform);
+
 	if (nm_platform_get_use_udev (platform)) {
 		priv->udev_client = nm_udev_client_new (NM_MAKE_STRV ("net"),
 		                                        handle_udev_event, platform);
@@ -9056,6 +10255,10 @@ constructed (GObject *_object)
 	nle = nl_socket_set_msg_buf_size (priv->nlh, 32 * 1024);
 	g_assert (!nle);
 
+	/* read up to 16 datagrams per recvmmsg() call into buffers that are
+	 * allocated once. */
+	priv->nlh_recv_ring = nl_recv_ring_new (16);
+
 	nle = nl_socket_add_memberships (priv->nlh,
 	                                 RTNLGRP_IPV4_IFADDR,
 	                                 RTNLGRP_IPV4_ROUTE,
@@ -9127,7 +10330,10 @@ constructed (GObject *_object)
 }
 
 NMPlatform *
-nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support)
+nm_linux_platform_new_full (gboolean log_with_ptr,
+                            gboolean netns_support,
+                            const char *route_ignore_tables,
+                            const char *route_ignore_protocols)
 {
 	gboolean use_udev = FALSE;
 
@@ -9139,9 +10345,38 @@ nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support)
 	                     NM_PLATFORM_LOG_WITH_PTR, log_with_ptr,
 	                     NM_PLATFORM_USE_UDEV, use_udev,
 	                     NM_PLATFORM_NETNS_SUPPORT, netns_support,
+	                     NM_LINUX_PLATFORM_ROUTE_IGNORE_TABLES, route_ignore_tables,
+	                     NM_LINUX_PLATFORM_ROUTE_IGNORE_PROTOCOLS, route_ignore_protocols,
 	                     NULL);
 }
 
+NMPlatform *
+nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support)
+{
+	return nm_linux_platform_new_full (log_with_ptr, netns_support, NULL, NULL);
+}
+
+static void
+set_property (GObject *object, guint prop_id,
+              const GValue *value, GParamSpec *pspec)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (object);
+
+	switch (prop_id) {
+	case PROP_ROUTE_IGNORE_TABLES:
+		/* construct-only */
+		priv->route_ignore.tables_str = g_value_dup_string (value);
+		break;
+	case PROP_ROUTE_IGNORE_PROTOCOLS:
+		/* construct-only */
+		priv->route_ignore.protocols_str = g_value_dup_string (value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+		break;
+	}
+}
+
 static void
 dispose (GObject *object)
 {
@@ -9156,6 +10391,7 @@ dispose (GObject *object)
 	priv->delayed_action.flags = DELAYED_ACTION_TYPE_NONE;
 	g_ptr_array_set_size (priv->delayed_action.list_master_connected, 0);
 	g_ptr_array_set_size (priv->delayed_action.list_refresh_link, 0);
+	g_ptr_array_set_size (priv->delayed_action.list_refresh_routes, 0);
 
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->dispose (object);
 }
@@ -9167,6 +10403,7 @@ finalize (GObject *object)
 
 	g_ptr_array_unref (priv->delayed_action.list_master_connected);
 	g_ptr_array_unref (priv->delayed_action.list_refresh_link);
+	g_ptr_array_unref (priv->delayed_action.list_refresh_routes);
 	g_array_unref (priv->delayed_action.list_wait_for_nl_response);
 
 	nl_socket_free (priv->genl);
@@ -9174,14 +10411,30 @@ finalize (GObject *object)
 	nm_clear_g_source_inst (&priv->event_source);
 
 	nl_socket_free (priv->nlh);
+	nl_recv_ring_free (priv->nlh_recv_ring);
 
 	if (priv->sysctl_get_prev_values) {
 		sysctl_clear_cache_list = g_slist_remove (sysctl_clear_cache_list, object);
 		g_hash_table_destroy (priv->sysctl_get_prev_values);
 	}
 
+	/* the worker and the done-source keep the instance alive. */
+	nm_assert (!priv->sysctl_writer.worker_scheduled);
+	nm_assert (!priv->sysctl_writer.done_source);
+	nm_assert (c_list_is_empty (&priv->sysctl_writer.pending_lst_head));
+	nm_assert (c_list_is_empty (&priv->sysctl_writer.done_lst_head));
+	nm_clear_pointer (&priv->sysctl_writer.pending_idx, g_hash_table_destroy);
+	nm_clear_pointer (&priv->sysctl_writer.dirfds, g_hash_table_destroy);
+	nm_clear_pointer (&priv->sysctl_writer.context, g_main_context_unref);
+	g_mutex_clear (&priv->sysctl_writer.lock);
+	g_cond_clear (&priv->sysctl_writer.cond);
+
 	priv->udev_client = nm_udev_client_unref (priv->udev_client);
 
+	g_free (priv->route_ignore.tables_str);
+	g_free (priv->route_ignore.protocols_str);
+	g_free (priv->route_ignore.tables);
+
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->finalize (object);
 }
 
@@ -9192,17 +10445,36 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	NMPlatformClass *platform_class = NM_PLATFORM_CLASS (klass);
 
 	object_class->constructed = constructed;
+	object_class->set_property = set_property;
 	object_class->dispose = dispose;
 	object_class->finalize = finalize;
 
+	obj_properties[PROP_ROUTE_IGNORE_TABLES] =
+	    g_param_spec_string (NM_LINUX_PLATFORM_ROUTE_IGNORE_TABLES, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE |
+	                         G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	obj_properties[PROP_ROUTE_IGNORE_PROTOCOLS] =
+	    g_param_spec_string (NM_LINUX_PLATFORM_ROUTE_IGNORE_PROTOCOLS, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE |
+	                         G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
+
 	platform_class->sysctl_set = sysctl_set;
 	platform_class->sysctl_set_async = sysctl_set_async;
+	platform_class->sysctl_ip_conf_set_async = sysctl_ip_conf_set_async;
 	platform_class->sysctl_get = sysctl_get;
 
 	platform_class->link_add = link_add;
 	platform_class->link_delete = link_delete;
 
 	platform_class->link_refresh = link_refresh;
+	platform_class->link_refresh_stats = link_refresh_stats;
 
 	platform_class->link_set_netns = link_set_netns;
 
@@ -9270,12 +10542,14 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->link_tun_add = link_tun_add;
 
 	platform_class->object_delete = object_delete;
+	platform_class->object_delete_batch = object_delete_batch;
 	platform_class->ip4_address_add = ip4_address_add;
 	platform_class->ip6_address_add = ip6_address_add;
 	platform_class->ip4_address_delete = ip4_address_delete;
 	platform_class->ip6_address_delete = ip6_address_delete;
 
 	platform_class->ip_route_add = ip_route_add;
+	platform_class->ip_route_add_batch = ip_route_add_batch;
 	platform_class->ip_route_get = ip_route_get;
 
 	platform_class->routing_rule_add = routing_rule_add;
@@ -9283,6 +10557,7 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->qdisc_add = qdisc_add;
 	platform_class->tfilter_add = tfilter_add;
 
+	platform_class->refresh_routes_for_ifindex = refresh_routes_for_ifindex;
 	platform_class->process_events = process_events;
 }
 
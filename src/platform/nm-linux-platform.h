@@ -15,6 +15,9 @@
 #define NM_IS_LINUX_PLATFORM_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), NM_TYPE_LINUX_PLATFORM))
 #define NM_LINUX_PLATFORM_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), NM_TYPE_LINUX_PLATFORM, NMLinuxPlatformClass))
 
+#define NM_LINUX_PLATFORM_ROUTE_IGNORE_TABLES    "route-ignore-tables"
+#define NM_LINUX_PLATFORM_ROUTE_IGNORE_PROTOCOLS "route-ignore-protocols"
+
 typedef struct _NMLinuxPlatform NMLinuxPlatform;
 typedef struct _NMLinuxPlatformClass NMLinuxPlatformClass;
 
@@ -22,6 +25,16 @@ GType nm_linux_platform_get_type (void);
 
 NMPlatform *nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support);
 
+NMPlatform *nm_linux_platform_new_full (gboolean log_with_ptr,
+                                        gboolean netns_support,
+                                        const char *route_ignore_tables,
+                                        const char *route_ignore_protocols);
+
 void nm_linux_platform_setup (void);
 
+void nm_linux_platform_setup_full (const char *route_ignore_tables,
+                                   const char *route_ignore_protocols);
+
+guint64 nm_linux_platform_get_route_ignore_dropped (NMPlatform *platform);
+
 #endif /* __NETWORKMANAGER_LINUX_PLATFORM_H__ */
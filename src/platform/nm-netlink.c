@@ -27,6 +27,10 @@
 #define NETLINK_EXT_ACK         11
 #endif
 
+#ifndef NETLINK_GET_STRICT_CHK
+#define NETLINK_GET_STRICT_CHK  12
+#endif
+
 struct nl_msg {
 	int                     nm_protocol;
 	struct sockaddr_nl      nm_src;
@@ -990,6 +994,22 @@ nl_socket_set_ext_ack (struct nl_sock *sk, gboolean enable)
 	return 0;
 }
 
+int
+nl_socket_set_strict_chk (struct nl_sock *sk, gboolean enable)
+{
+	int err, val;
+
+	if (sk->s_fd == -1)
+		return -NME_NL_BAD_SOCK;
+
+	val = !!enable;
+	err = setsockopt (sk->s_fd, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &val, sizeof (val));
+	if (err < 0)
+		return -nm_errno_from_native (errno);
+
+	return 0;
+}
+
 void nl_socket_disable_msg_peek (struct nl_sock *sk)
 {
 	sk->s_flags |= NL_MSG_PEEK_EXPLICIT;
@@ -1473,3 +1493,225 @@ abort:
 	NM_SET_OUT (out_creds_has, tmpcreds_has);
 	return retval;
 }
+
+/*****************************************************************************/
+
+struct nl_recv_ring {
+	unsigned char *bufs;
+	unsigned char *ctrl_bufs;
+	struct mmsghdr *mmsgs;
+	struct iovec *iovs;
+	struct sockaddr_nl *nlas;
+	size_t buf_size;
+	size_t ctrl_size;
+	guint n_slots;
+
+	/* the datagrams from the last recvmmsg() that were not yet
+	 * returned by nl_recv_ring_next(). */
+	guint n_filled;
+	guint idx_next;
+
+	NLRecvRingStats stats;
+};
+
+static void
+_nl_recv_ring_clear_bufs (struct nl_recv_ring *ring)
+{
+	nm_clear_g_free (&ring->bufs);
+	nm_clear_g_free (&ring->ctrl_bufs);
+	nm_clear_g_free (&ring->mmsgs);
+	nm_clear_g_free (&ring->iovs);
+	nm_clear_g_free (&ring->nlas);
+	ring->buf_size = 0;
+}
+
+static void
+_nl_recv_ring_alloc_bufs (struct nl_recv_ring *ring, size_t buf_size)
+{
+	guint i;
+
+	nm_assert (ring->n_filled == ring->idx_next);
+
+	_nl_recv_ring_clear_bufs (ring);
+
+	ring->buf_size = buf_size;
+	ring->ctrl_size = CMSG_SPACE (sizeof (struct ucred));
+	ring->bufs = g_malloc ((gsize) ring->n_slots * buf_size);
+	ring->ctrl_bufs = g_malloc ((gsize) ring->n_slots * ring->ctrl_size);
+	ring->mmsgs = g_new0 (struct mmsghdr, ring->n_slots);
+	ring->iovs = g_new0 (struct iovec, ring->n_slots);
+	ring->nlas = g_new0 (struct sockaddr_nl, ring->n_slots);
+
+	for (i = 0; i < ring->n_slots; i++) {
+		ring->iovs[i] = (struct iovec) {
+			.iov_base = &ring->bufs[i * buf_size],
+			.iov_len  = buf_size,
+		};
+	}
+}
+
+/**
+ * nl_recv_ring_new:
+ * @n_slots: the maximum number of datagrams to read with one recvmmsg()
+ *   call.
+ *
+ * Creates a receive ring to be used with nl_recv_ring_next(). Contrary to
+ * nl_recv(), the receive buffers are allocated once and reused for each
+ * read. The size of each buffer is the message buffer size of the socket
+ * (nl_socket_get_msg_buf_size()). If that changes, the buffers are
+ * reallocated before the next read.
+ *
+ * Returns: the new ring. Free with nl_recv_ring_free().
+ */
+struct nl_recv_ring *
+nl_recv_ring_new (guint n_slots)
+{
+	struct nl_recv_ring *ring;
+
+	g_return_val_if_fail (n_slots > 0, NULL);
+
+	ring = g_slice_new0 (struct nl_recv_ring);
+	ring->n_slots = n_slots;
+	return ring;
+}
+
+void
+nl_recv_ring_free (struct nl_recv_ring *ring)
+{
+	if (!ring)
+		return;
+
+	_nl_recv_ring_clear_bufs (ring);
+	g_slice_free (struct nl_recv_ring, ring);
+}
+
+gboolean
+nl_recv_ring_has_pending (const struct nl_recv_ring *ring)
+{
+	return ring->idx_next < ring->n_filled;
+}
+
+const NLRecvRingStats *
+nl_recv_ring_get_stats (const struct nl_recv_ring *ring)
+{
+	return &ring->stats;
+}
+
+/**
+ * nl_recv_ring_next:
+ * @sk: the netlink socket. It must have message peeking disabled
+ *   (nl_socket_disable_msg_peek()) and a message buffer size set.
+ * @ring: the receive ring
+ * @nla: (out): the source address of the datagram
+ * @buf: (out) (transfer none): the datagram. It stays valid until the next
+ *   call to nl_recv_ring_next() that reads from the socket, which only
+ *   happens after all previously read datagrams were returned.
+ * @out_creds: (out) (allow-none): the credentials of the sender
+ * @out_creds_has: (out) (allow-none): whether @out_creds is set.
+ *
+ * Like nl_recv(), but returns the next datagram from the ring. Only if the
+ * ring is empty, it reads a new batch of datagrams with one recvmmsg()
+ * call.
+ *
+ * Returns: the length of the datagram, or a negative error code (like
+ *   -EAGAIN). If the datagram was truncated, -NME_NL_MSG_TRUNC is returned
+ *   and the datagram is lost.
+ */
+int
+nl_recv_ring_next (struct nl_sock *sk,
+                   struct nl_recv_ring *ring,
+                   struct sockaddr_nl *nla,
+                   const unsigned char **buf,
+                   struct ucred *out_creds,
+                   gboolean *out_creds_has)
+{
+	const struct mmsghdr *mmsg;
+	gboolean creds_has = FALSE;
+	guint idx;
+	guint i;
+	int n;
+
+	nm_assert (sk);
+	nm_assert (ring);
+	nm_assert (nla);
+	nm_assert (buf);
+	nm_assert (!out_creds_has == !out_creds);
+	nm_assert (!(sk->s_flags & NL_MSG_PEEK));
+	nm_assert (sk->s_bufsize > 0);
+
+	if (ring->idx_next >= ring->n_filled) {
+		ring->idx_next = 0;
+		ring->n_filled = 0;
+
+		if (ring->buf_size != sk->s_bufsize)
+			_nl_recv_ring_alloc_bufs (ring, sk->s_bufsize);
+
+		for (i = 0; i < ring->n_slots; i++) {
+			ring->mmsgs[i] = (struct mmsghdr) {
+				.msg_hdr = {
+					.msg_name = &ring->nlas[i],
+					.msg_namelen = sizeof (struct sockaddr_nl),
+					.msg_iov = &ring->iovs[i],
+					.msg_iovlen = 1,
+				},
+			};
+			if (   out_creds
+			    && (sk->s_flags & NL_SOCK_PASSCRED)) {
+				ring->mmsgs[i].msg_hdr.msg_control = &ring->ctrl_bufs[i * ring->ctrl_size];
+				ring->mmsgs[i].msg_hdr.msg_controllen = ring->ctrl_size;
+			}
+		}
+
+		ring->stats.n_reads++;
+again:
+		n = recvmmsg (sk->s_fd, ring->mmsgs, ring->n_slots, 0, NULL);
+		if (n < 0) {
+			int errsv = errno;
+
+			if (errsv == EINTR)
+				goto again;
+			return -nm_errno_from_native (errsv);
+		}
+		if (n == 0)
+			return 0;
+
+		ring->n_filled = n;
+		ring->stats.n_datagrams += n;
+		ring->stats.last_read_n_datagrams = n;
+		ring->stats.last_read_n_bytes = 0;
+		for (i = 0; i < (guint) n; i++)
+			ring->stats.last_read_n_bytes += ring->mmsgs[i].msg_len;
+		ring->stats.n_bytes += ring->stats.last_read_n_bytes;
+	}
+
+	idx = ring->idx_next++;
+	mmsg = &ring->mmsgs[idx];
+
+	if (NM_FLAGS_ANY (mmsg->msg_hdr.msg_flags, MSG_TRUNC | MSG_CTRUNC)) {
+		ring->stats.n_truncated++;
+		return -NME_NL_MSG_TRUNC;
+	}
+
+	if (mmsg->msg_hdr.msg_namelen != sizeof (struct sockaddr_nl))
+		return -NME_UNSPEC;
+
+	if (   out_creds
+	    && mmsg->msg_hdr.msg_control) {
+		struct cmsghdr *cmsg;
+
+		for (cmsg = CMSG_FIRSTHDR (&mmsg->msg_hdr); cmsg; cmsg = CMSG_NXTHDR ((struct msghdr *) &mmsg->msg_hdr, cmsg)) {
+			if (cmsg->cmsg_level != SOL_SOCKET)
+				continue;
+			if (cmsg->cmsg_type != SCM_CREDENTIALS)
+				continue;
+			memcpy (out_creds, CMSG_DATA (cmsg), sizeof (*out_creds));
+			creds_has = TRUE;
+			break;
+		}
+	}
+	NM_SET_OUT (out_creds_has, creds_has);
+
+	*nla = ring->nlas[idx];
+	*buf = ring->iovs[idx].iov_base;
+	return mmsg->msg_len;
+}
@@ -542,6 +542,39 @@ int nl_recv (struct nl_sock *sk,
              struct ucred *out_creds,
              gboolean *out_creds_has);
 
+/*****************************************************************************/
+
+struct nl_recv_ring;
+
+typedef struct {
+	/* number of recvmmsg() calls. */
+	guint64 n_reads;
+	guint64 n_datagrams;
+	guint64 n_bytes;
+	guint64 n_truncated;
+
+	/* the number of datagrams and bytes of the last recvmmsg() call. */
+	guint last_read_n_datagrams;
+	gsize last_read_n_bytes;
+} NLRecvRingStats;
+
+struct nl_recv_ring *nl_recv_ring_new (guint n_slots);
+
+void nl_recv_ring_free (struct nl_recv_ring *ring);
+
+gboolean nl_recv_ring_has_pending (const struct nl_recv_ring *ring);
+
+const NLRecvRingStats *nl_recv_ring_get_stats (const struct nl_recv_ring *ring);
+
+int nl_recv_ring_next (struct nl_sock *sk,
+                       struct nl_recv_ring *ring,
+                       struct sockaddr_nl *nla,
+                       const unsigned char **buf,
+                       struct ucred *out_creds,
+                       gboolean *out_creds_has);
+
+/*****************************************************************************/
+
 int nl_send (struct nl_sock *sk, struct nl_msg *msg);
 
 int nl_send_auto (struct nl_sock *sk, struct nl_msg *msg);
@@ -589,6 +622,8 @@ int nl_wait_for_ack (struct nl_sock *sk,
 
 int nl_socket_set_ext_ack (struct nl_sock *sk, gboolean enable);
 
+int nl_socket_set_strict_chk (struct nl_sock *sk, gboolean enable);
+
 /*****************************************************************************/
 
 void *genlmsg_put (struct nl_msg *msg, uint32_t port, uint32_t seq, int family,
@@ -169,6 +169,10 @@ typedef struct _NMPlatformPrivate {
 	GHashTable *ip4_dev_route_blacklist_hash;
 	NMDedupMultiIndex *multi_idx;
 	NMPCache *cache;
+
+	CList link_stats_lst_head;
+	guint link_stats_timeout_id;
+	gint64 link_stats_timeout_due_msec;
 } NMPlatformPrivate;
 
 G_DEFINE_TYPE (NMPlatform, nm_platform, G_TYPE_OBJECT)
@@ -431,6 +435,29 @@ nm_platform_process_events (NMPlatform *self)
 		klass->process_events (self);
 }
 
+/**
+ * nm_platform_refresh_routes_for_ifindex:
+ * @self: platform instance
+ * @addr_family: the address family of the routes to refresh or
+ *   AF_UNSPEC for both.
+ * @ifindex: the interface whose routes to refresh.
+ *
+ * Re-read the routes of interface @ifindex from kernel and update the
+ * cache. If possible, only the routes of this interface are requested,
+ * otherwise all routes of the address family are dumped.
+ */
+void
+nm_platform_refresh_routes_for_ifindex (NMPlatform *self, int addr_family, int ifindex)
+{
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET, AF_INET6));
+	g_return_if_fail (ifindex > 0);
+
+	if (klass->refresh_routes_for_ifindex)
+		klass->refresh_routes_for_ifindex (self, addr_family, ifindex);
+}
+
 const NMPlatformLink *
 nm_platform_process_events_ensure_link (NMPlatform *self,
                                         int ifindex,
@@ -804,6 +831,86 @@ nm_platform_sysctl_ip_conf_set (NMPlatform *self,
 	                               value);
 }
 
+static void
+_sysctl_ip_conf_set_async_return_idle (gpointer user_data,
+                                       GCancellable *cancellable)
+{
+	gs_free_error GError *error = NULL;
+	NMPlatformAsyncCallback callback;
+	gpointer callback_data;
+
+	nm_utils_user_data_unpack (user_data, &callback, &callback_data, &error);
+	callback (error, callback_data);
+}
+
+/**
+ * nm_platform_sysctl_ip_conf_set_async:
+ * @self: platform instance
+ * @addr_family: either AF_INET or AF_INET6
+ * @ifname: the interface name
+ * @property: the name of the setting in /proc/sys/net/ipv{4,6}/conf/$IFNAME
+ * @value: the value to write
+ * @callback: (allow-none): function called on termination
+ * @data: data passed to callback function
+ *
+ * Like nm_platform_sysctl_ip_conf_set(), but the write is queued and performed
+ * by a worker thread, in order with other queued writes. If the same setting
+ * is queued again before it was written, only the last value is written and all
+ * callbacks receive its result. A synchronous read or write of the same setting
+ * first settles the queued write. The callback is always invoked, and
+ * asynchronously.
+ */
+void
+nm_platform_sysctl_ip_conf_set_async (NMPlatform *self,
+                                      int addr_family,
+                                      const char *ifname,
+                                      const char *property,
+                                      const char *value,
+                                      NMPlatformAsyncCallback callback,
+                                      gpointer data)
+{
+	const NMPlatformLink *plink;
+	GError *error = NULL;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (ifname);
+	g_return_if_fail (property);
+	g_return_if_fail (value);
+	g_return_if_fail (!data || callback);
+
+	if (klass->sysctl_ip_conf_set_async) {
+		plink = nm_platform_link_get_by_ifname (self, ifname);
+		klass->sysctl_ip_conf_set_async (self,
+		                                 addr_family,
+		                                 plink ? plink->ifindex : 0,
+		                                 ifname,
+		                                 property,
+		                                 value,
+		                                 callback,
+		                                 data);
+		return;
+	}
+
+	if (   !nm_platform_sysctl_ip_conf_set (self, addr_family, ifname, property, value)
+	    && callback) {
+		int errsv = errno;
+
+		g_set_error (&error,
+		             NM_UTILS_ERROR,
+		             NM_UTILS_ERROR_UNKNOWN,
+		             "sysctl: failed setting '%s' to value '%s': %s",
+		             property,
+		             value,
+		             nm_strerror_native (errsv));
+	}
+	if (callback) {
+		nm_utils_invoke_on_idle (NULL,
+		                         _sysctl_ip_conf_set_async_return_idle,
+		                         nm_utils_user_data_pack (callback, data, error));
+	}
+}
+
 gboolean
 nm_platform_sysctl_ip_conf_set_int64 (NMPlatform *self,
                                       int addr_family,
@@ -1485,6 +1592,200 @@ nm_platform_link_refresh (NMPlatform *self, int ifindex)
 	return TRUE;
 }
 
+/*****************************************************************************/
+
+/* Subscriptions whose due time is at most this far in the future are
+ * handled together with the ones that are due now. */
+#define LINK_STATS_TICK_SLACK_MSEC 50
+
+struct _NMPlatformLinkStatsHandle {
+	CList link_stats_lst;
+	NMPlatformLinkStatsCallback callback;
+	gpointer user_data;
+	gint64 due_msec;
+	guint refresh_rate_ms;
+	int ifindex;
+};
+
+static gboolean _link_stats_timeout_cb (gpointer user_data);
+
+static gint64
+_link_stats_next_due (gint64 now_msec, guint refresh_rate_ms)
+{
+	/* the ticks are aligned to multiples of the refresh rate on the monotonic
+	 * clock. That way, all subscriptions with the same rate (or with rates
+	 * that are multiples of each other) get refreshed together. */
+	return ((now_msec / refresh_rate_ms) + 1) * refresh_rate_ms;
+}
+
+static void
+_link_stats_schedule (NMPlatform *self)
+{
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	NMPlatformLinkStatsHandle *handle;
+	gint64 due_msec = 0;
+	gint64 now_msec;
+
+	c_list_for_each_entry (handle, &priv->link_stats_lst_head, link_stats_lst) {
+		if (   due_msec == 0
+		    || handle->due_msec < due_msec)
+			due_msec = handle->due_msec;
+	}
+
+	if (due_msec == 0) {
+		nm_clear_g_source (&priv->link_stats_timeout_id);
+		return;
+	}
+
+	if (   priv->link_stats_timeout_id
+	    && priv->link_stats_timeout_due_msec == due_msec)
+		return;
+
+	nm_clear_g_source (&priv->link_stats_timeout_id);
+	now_msec = nm_utils_get_monotonic_timestamp_msec ();
+	priv->link_stats_timeout_due_msec = due_msec;
+	priv->link_stats_timeout_id = g_timeout_add (NM_MAX (due_msec - now_msec, (gint64) 0),
+	                                             _link_stats_timeout_cb,
+	                                             self);
+}
+
+static gboolean
+_link_stats_timeout_cb (gpointer user_data)
+{
+	NMPlatform *self = user_data;
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	NMPlatformClass *klass = NM_PLATFORM_GET_CLASS (self);
+	gs_unref_object NMPlatform *self_keep_alive = NULL;
+	CList due_lst_head = C_LIST_INIT (due_lst_head);
+	NMPlatformLinkStatsHandle *handle;
+	NMPlatformLinkStatsHandle *handle_safe;
+	gs_unref_array GArray *ifindexes = NULL;
+	gint64 now_msec;
+	guint i;
+
+	priv->link_stats_timeout_id = 0;
+
+	now_msec = nm_utils_get_monotonic_timestamp_msec ();
+
+	ifindexes = g_array_new (FALSE, FALSE, sizeof (int));
+	c_list_for_each_entry_safe (handle, handle_safe, &priv->link_stats_lst_head, link_stats_lst) {
+		if (handle->due_msec > now_msec + LINK_STATS_TICK_SLACK_MSEC)
+			continue;
+		c_list_unlink_stale (&handle->link_stats_lst);
+		c_list_link_tail (&due_lst_head, &handle->link_stats_lst);
+		if (handle->ifindex > 0)
+			g_array_append_val (ifindexes, handle->ifindex);
+	}
+
+	if (ifindexes->len > 0) {
+		_LOGT ("link-stats: refresh %u links", ifindexes->len);
+		if (klass->link_refresh_stats)
+			klass->link_refresh_stats (self, (const int *) ifindexes->data, ifindexes->len);
+		else {
+			for (i = 0; i < ifindexes->len; i++)
+				nm_platform_link_refresh (self, g_array_index (ifindexes, int, i));
+		}
+	}
+
+	/* the callbacks might unsubscribe (any) handle. Requeue each handle before
+	 * invoking its callback, so that nm_platform_link_stats_unsubscribe() works
+	 * as usual. */
+	self_keep_alive = g_object_ref (self);
+	while ((handle = c_list_first_entry (&due_lst_head, NMPlatformLinkStatsHandle, link_stats_lst))) {
+		const NMPlatformLink *plink = NULL;
+
+		c_list_unlink_stale (&handle->link_stats_lst);
+		c_list_link_tail (&priv->link_stats_lst_head, &handle->link_stats_lst);
+		handle->due_msec = _link_stats_next_due (NM_MAX (now_msec, handle->due_msec),
+		                                         handle->refresh_rate_ms);
+
+		if (handle->ifindex > 0)
+			plink = nm_platform_link_get (self, handle->ifindex);
+		handle->callback (self, handle->ifindex, plink, handle->user_data);
+	}
+
+	_link_stats_schedule (self);
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * nm_platform_link_stats_subscribe:
+ * @self: platform instance
+ * @ifindex: the interface index. Can be zero, in which case the link is
+ *   not refreshed but @callback is still invoked (with a %NULL link).
+ * @refresh_rate_ms: the refresh rate. Must be positive.
+ * @callback: the callback to invoke on each refresh
+ * @user_data: user data for @callback
+ *
+ * Periodically refresh the link (and its statistics) and invoke @callback.
+ * All subscriptions share a common timer and their ticks are aligned, so
+ * that links that are due together are refreshed in one batch. Depending
+ * on the platform and the number of links, that is a single dump of all
+ * links.
+ *
+ * Returns: the handle for the subscription, to be released with
+ *   nm_platform_link_stats_unsubscribe().
+ */
+NMPlatformLinkStatsHandle *
+nm_platform_link_stats_subscribe (NMPlatform *self,
+                                  int ifindex,
+                                  guint refresh_rate_ms,
+                                  NMPlatformLinkStatsCallback callback,
+                                  gpointer user_data)
+{
+	NMPlatformPrivate *priv;
+	NMPlatformLinkStatsHandle *handle;
+
+	_CHECK_SELF (self, klass, NULL);
+
+	g_return_val_if_fail (refresh_rate_ms > 0, NULL);
+	g_return_val_if_fail (callback, NULL);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	handle = g_slice_new (NMPlatformLinkStatsHandle);
+	*handle = (NMPlatformLinkStatsHandle) {
+		.callback        = callback,
+		.user_data       = user_data,
+		.refresh_rate_ms = refresh_rate_ms,
+		.ifindex         = NM_MAX (ifindex, 0),
+		.due_msec        = _link_stats_next_due (nm_utils_get_monotonic_timestamp_msec (),
+		                                         refresh_rate_ms),
+	};
+	c_list_link_tail (&priv->link_stats_lst_head, &handle->link_stats_lst);
+
+	_link_stats_schedule (self);
+	return handle;
+}
+
+void
+nm_platform_link_stats_set_ifindex (NMPlatform *self,
+                                    NMPlatformLinkStatsHandle *handle,
+                                    int ifindex)
+{
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (handle);
+	nm_assert (c_list_contains (&NM_PLATFORM_GET_PRIVATE (self)->link_stats_lst_head, &handle->link_stats_lst));
+
+	handle->ifindex = NM_MAX (ifindex, 0);
+}
+
+void
+nm_platform_link_stats_unsubscribe (NMPlatform *self,
+                                    NMPlatformLinkStatsHandle *handle)
+{
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (handle);
+	nm_assert (!c_list_is_empty (&handle->link_stats_lst));
+
+	c_list_unlink_stale (&handle->link_stats_lst);
+	g_slice_free (NMPlatformLinkStatsHandle, handle);
+
+	_link_stats_schedule (self);
+}
+
 int
 nm_platform_link_get_ifi_flags (NMPlatform *self,
                                 int ifindex,
@@ -4284,6 +4585,138 @@ nm_platform_ip_route_get_prune_list (NMPlatform *self,
 	return routes_prune;
 }
 
+static gboolean
+_ip_route_sync_handle_add_failure (NMPlatform *self,
+                                   const NMPlatformVTableRoute *vt,
+                                   const NMPObject *conf_o,
+                                   int r,
+                                   GPtrArray **out_temporary_not_available)
+{
+	const int ifindex = NMP_OBJECT_CAST_IP_ROUTE (conf_o)->ifindex;
+	gboolean gateway_route_added = FALSE;
+	char sbuf1[sizeof (_nm_utils_to_string_buffer)];
+	char sbuf2[sizeof (_nm_utils_to_string_buffer)];
+	const NMDedupMultiEntry *plat_entry;
+	int r2;
+
+again:
+	if (r >= 0)
+		return TRUE;
+
+	if (r == -EEXIST) {
+		/* Don't fail for EEXIST. It's not clear that the existing route
+		 * is identical to the one that we were about to add. However,
+		 * above we should have deleted conflicting (non-identical) routes. */
+		if (_LOGD_ENABLED ()) {
+			plat_entry = nm_platform_lookup_entry (self,
+			                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+			                                       conf_o);
+			if (!plat_entry) {
+				_LOG3D ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
+				        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
+			} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
+			                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
+			                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
+				_LOG3D ("route-sync: adding route %s failed due to existing (different!) route %s",
+				        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+				        nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
+			}
+		}
+		return TRUE;
+	}
+
+	if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
+		_LOG3D ("route-sync: ignore failure to add IPv%c route: %s: %s",
+		       vt->is_ip4 ? '4' : '6',
+		       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+		       nm_strerror (r));
+		return TRUE;
+	}
+
+	if (   r == -EINVAL
+	    && out_temporary_not_available
+	    && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
+		_LOG3D ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
+		        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+		        nm_strerror (r));
+		if (!*out_temporary_not_available)
+			*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
+		g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
+		return TRUE;
+	}
+
+	if (   !gateway_route_added
+	    && (   (   r == -ENETUNREACH
+	            && vt->is_ip4
+	            && !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway)
+	        || (   r == -EHOSTUNREACH
+	            && !vt->is_ip4
+	            && !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))) {
+		NMPObject oo;
+
+		if (vt->is_ip4) {
+			const NMPlatformIP4Route *rt = NMP_OBJECT_CAST_IP4_ROUTE (conf_o);
+
+			nmp_object_stackinit (&oo,
+			                      NMP_OBJECT_TYPE_IP4_ROUTE,
+			                      &((NMPlatformIP4Route) {
+			                          .ifindex = rt->ifindex,
+			                          .network = rt->gateway,
+			                          .plen = 32,
+			                          .metric = rt->metric,
+			                          .rt_source = rt->rt_source,
+			                          .table_coerced = rt->table_coerced,
+			                      }));
+		} else {
+			const NMPlatformIP6Route *rt = NMP_OBJECT_CAST_IP6_ROUTE (conf_o);
+
+			nmp_object_stackinit (&oo,
+			                      NMP_OBJECT_TYPE_IP6_ROUTE,
+			                      &((NMPlatformIP6Route) {
+			                          .ifindex = rt->ifindex,
+			                          .network = rt->gateway,
+			                          .plen = 128,
+			                          .metric = rt->metric,
+			                          .rt_source = rt->rt_source,
+			                          .table_coerced = rt->table_coerced,
+			                      }));
+		}
+
+		_LOG3D ("route-sync: failure to add IPv%c route: %s: %s; try adding direct route to gateway %s",
+		        vt->is_ip4 ? '4' : '6',
+		        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+		        nm_strerror (r),
+		        nmp_object_to_string (&oo, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
+
+		r2 = nm_platform_ip_route_add (self,
+		                                 NMP_NLM_FLAG_APPEND
+		                               | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
+		                               &oo);
+
+		if (r2 < 0) {
+			_LOG3D ("route-sync: failure to add gateway IPv%c route: %s: %s",
+			        vt->is_ip4 ? '4' : '6',
+			        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+			        nm_strerror (r2));
+		}
+
+		gateway_route_added = TRUE;
+
+		/* The retry is rare, don't bother batching it. */
+		r = nm_platform_ip_route_add (self,
+		                                NMP_NLM_FLAG_APPEND
+		                              | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
+		                              conf_o);
+		goto again;
+	}
+
+	_LOG3W ("route-sync: failure to add IPv%c route: %s: %s",
+	       vt->is_ip4 ? '4' : '6',
+	       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+	       nm_strerror (r));
+	return FALSE;
+}
+
 /**
  * nm_platform_ip_route_sync:
  * @self: the #NMPlatform instance.
@@ -4299,6 +4732,10 @@ nm_platform_ip_route_get_prune_list (NMPlatform *self,
  * @out_temporary_not_available: (allow-none) (out): routes that could
  *   currently not be synced. The caller shall keep them and try later again.
  *
+ * The routes are added and deleted with nm_platform_ip_route_add_batch()
+ * and nm_platform_object_delete_batch(), so that the platform implementation
+ * can pipeline the requests instead of waiting for each response in turn.
+ *
  * Returns: %TRUE on success.
  */
 gboolean
@@ -4317,7 +4754,6 @@ nm_platform_ip_route_sync (NMPlatform *self,
 	int i_type;
 	gboolean success = TRUE;
 	char sbuf1[sizeof (_nm_utils_to_string_buffer)];
-	char sbuf2[sizeof (_nm_utils_to_string_buffer)];
 	const gboolean IS_IPv4 = (addr_family == AF_INET);
 
 	nm_assert (NM_IS_PLATFORM (self));
@@ -4327,10 +4763,11 @@ nm_platform_ip_route_sync (NMPlatform *self,
 	vt = &nm_platform_vtable_route.vx[IS_IPv4];
 
 	for (i_type = 0; routes && i_type < 2; i_type++) {
-		for (i = 0; i < routes->len; i++) {
-			int r, r2;
-			gboolean gateway_route_added = FALSE;
+		gs_unref_ptrarray GPtrArray *routes_add = NULL;
+		gs_unref_ptrarray GPtrArray *routes_replace = NULL;
+		gs_free int *results = NULL;
 
+		for (i = 0; i < routes->len; i++) {
 			conf_o = routes->pdata[i];
 
 #define VTABLE_IS_DEVICE_ROUTE(vt, o) (vt->is_ip4 \
@@ -4370,119 +4807,50 @@ nm_platform_ip_route_sync (NMPlatform *self,
 
 				/* we need to replace the existing route with a (slightly) different
 				 * one. Delete it first. */
-				if (!nm_platform_object_delete (self, plat_o)) {
-					/* ignore error. */
-				}
+				if (!routes_replace)
+					routes_replace = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+				g_ptr_array_add (routes_replace, (gpointer) nmp_object_ref (plat_o));
 			}
 
-sync_route_add:
-			r = nm_platform_ip_route_add (self,
-			                                NMP_NLM_FLAG_APPEND
-			                              | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
-			                              conf_o);
-			if (r < 0) {
-				if (r == -EEXIST) {
-					/* Don't fail for EEXIST. It's not clear that the existing route
-					 * is identical to the one that we were about to add. However,
-					 * above we should have deleted conflicting (non-identical) routes. */
-					if (_LOGD_ENABLED ()) {
-						plat_entry = nm_platform_lookup_entry (self,
-						                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
-						                                       conf_o);
-						if (!plat_entry) {
-							_LOG3D ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
-							        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
-						} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
-						                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
-						                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
-							_LOG3D ("route-sync: adding route %s failed due to existing (different!) route %s",
-							        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-							        nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
-						}
-					}
-				} else if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
-					_LOG3D ("route-sync: ignore failure to add IPv%c route: %s: %s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_strerror (r));
-				} else if (   r == -EINVAL
-				           && out_temporary_not_available
-				           && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
-					_LOG3D ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
-					        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					        nm_strerror (r));
-					if (!*out_temporary_not_available)
-						*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
-					g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
-				} else if (   !gateway_route_added
-				           && (   (   r == -ENETUNREACH
-				                   && vt->is_ip4
-				                   && !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway)
-				               || (   r == -EHOSTUNREACH
-				                   && !vt->is_ip4
-				                   && !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))) {
-					NMPObject oo;
-
-					if (vt->is_ip4) {
-						const NMPlatformIP4Route *rt = NMP_OBJECT_CAST_IP4_ROUTE (conf_o);
-
-						nmp_object_stackinit (&oo,
-						                      NMP_OBJECT_TYPE_IP4_ROUTE,
-						                      &((NMPlatformIP4Route) {
-						                          .ifindex = rt->ifindex,
-						                          .network = rt->gateway,
-						                          .plen = 32,
-						                          .metric = rt->metric,
-						                          .rt_source = rt->rt_source,
-						                          .table_coerced = rt->table_coerced,
-						                      }));
-					} else {
-						const NMPlatformIP6Route *rt = NMP_OBJECT_CAST_IP6_ROUTE (conf_o);
-
-						nmp_object_stackinit (&oo,
-						                      NMP_OBJECT_TYPE_IP6_ROUTE,
-						                      &((NMPlatformIP6Route) {
-						                          .ifindex = rt->ifindex,
-						                          .network = rt->gateway,
-						                          .plen = 128,
-						                          .metric = rt->metric,
-						                          .rt_source = rt->rt_source,
-						                          .table_coerced = rt->table_coerced,
-						                      }));
-					}
+			if (!routes_add)
+				routes_add = g_ptr_array_new ();
+			g_ptr_array_add (routes_add, (gpointer) conf_o);
+		}
 
-					_LOG3D ("route-sync: failure to add IPv%c route: %s: %s; try adding direct route to gateway %s",
-					        vt->is_ip4 ? '4' : '6',
-					        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					        nm_strerror (r),
-					        nmp_object_to_string (&oo, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
-
-					r2 = nm_platform_ip_route_add (self,
-					                                 NMP_NLM_FLAG_APPEND
-					                               | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
-					                               &oo);
-
-					if (r2 < 0) {
-						_LOG3D ("route-sync: failure to add gateway IPv%c route: %s: %s",
-						        vt->is_ip4 ? '4' : '6',
-						        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-						        nm_strerror (r2));
-					}
+		if (!routes_add)
+			continue;
 
-					gateway_route_added = TRUE;
-					goto sync_route_add;
-				} else {
-					_LOG3W ("route-sync: failure to add IPv%c route: %s: %s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_strerror (r));
-					success = FALSE;
-				}
-			}
+		if (routes_replace) {
+			nm_platform_object_delete_batch (self,
+			                                 (const NMPObject *const*) routes_replace->pdata,
+			                                 routes_replace->len,
+			                                 NULL);
+			/* ignore errors. */
+		}
+
+		results = g_new (int, routes_add->len);
+		nm_platform_ip_route_add_batch (self,
+		                                  NMP_NLM_FLAG_APPEND
+		                                | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
+		                                (const NMPObject *const*) routes_add->pdata,
+		                                routes_add->len,
+		                                results);
+
+		for (i = 0; i < routes_add->len; i++) {
+			if (results[i] >= 0)
+				continue;
+			if (!_ip_route_sync_handle_add_failure (self,
+			                                        vt,
+			                                        routes_add->pdata[i],
+			                                        results[i],
+			                                        out_temporary_not_available))
+				success = FALSE;
 		}
 	}
 
 	if (routes_prune) {
+		gs_unref_ptrarray GPtrArray *routes_delete = NULL;
+
 		for (i = 0; i < routes_prune->len; i++) {
 			const NMPObject *prune_o;
 
@@ -4500,9 +4868,17 @@ sync_route_add:
 			                               prune_o))
 				continue;
 
-			if (!nm_platform_object_delete (self, prune_o)) {
-				/* ignore error... */
-			}
+			if (!routes_delete)
+				routes_delete = g_ptr_array_new ();
+			g_ptr_array_add (routes_delete, (gpointer) prune_o);
+		}
+
+		if (routes_delete) {
+			nm_platform_object_delete_batch (self,
+			                                 (const NMPObject *const*) routes_delete->pdata,
+			                                 routes_delete->len,
+			                                 NULL);
+			/* ignore errors... */
 		}
 	}
 
@@ -4679,6 +5055,61 @@ nm_platform_ip6_route_add (NMPlatform *self,
 	return _ip_route_add (self, flags, AF_INET6, route);
 }
 
+/**
+ * nm_platform_ip_route_add_batch:
+ * @self: the #NMPlatform instance
+ * @flags: the #NMPNlmFlags used for adding each route
+ * @routes: the route objects to add. Each one must be of type
+ *   %NMP_OBJECT_TYPE_IP4_ROUTE or %NMP_OBJECT_TYPE_IP6_ROUTE.
+ * @len: the number of elements in @routes
+ * @out_results: (out): an array of @len elements that receives, for each
+ *   route, the result that nm_platform_ip_route_add() would have returned.
+ *
+ * This is like calling nm_platform_ip_route_add() for each route in turn,
+ * but it allows the implementation to send the requests pipelined, without
+ * waiting for each acknowledgement before sending the next request.
+ */
+void
+nm_platform_ip_route_add_batch (NMPlatform *self,
+                                NMPNlmFlags flags,
+                                const NMPObject *const*routes,
+                                guint len,
+                                int *out_results)
+{
+	guint i;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	nm_assert (routes || len == 0);
+	nm_assert (out_results || len == 0);
+
+	if (len == 0)
+		return;
+
+	if (!klass->ip_route_add_batch) {
+		for (i = 0; i < len; i++)
+			out_results[i] = nm_platform_ip_route_add (self, flags, routes[i]);
+		return;
+	}
+
+	if (_LOGD_ENABLED ()) {
+		for (i = 0; i < len; i++) {
+			char sbuf[sizeof (_nm_utils_to_string_buffer)];
+			int ifindex = NMP_OBJECT_CAST_IP_ROUTE (routes[i])->ifindex;
+
+			nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (routes[i]), NMP_OBJECT_TYPE_IP4_ROUTE,
+			                                                       NMP_OBJECT_TYPE_IP6_ROUTE));
+
+			_LOG3D ("route: %-10s %s (batched %u/%u)",
+			        _nmp_nlm_flag_to_string (flags & NMP_NLM_FLAG_FMASK),
+			        nmp_object_to_string (routes[i], NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof (sbuf)),
+			        i + 1, len);
+		}
+	}
+
+	klass->ip_route_add_batch (self, flags, routes, len, out_results);
+}
+
 gboolean
 nm_platform_object_delete (NMPlatform *self,
                            const NMPObject *obj)
@@ -4709,6 +5140,62 @@ nm_platform_object_delete (NMPlatform *self,
 	return klass->object_delete (self, obj);
 }
 
+/**
+ * nm_platform_object_delete_batch:
+ * @self: the #NMPlatform instance
+ * @objs: the route objects to delete. Each one must be of type
+ *   %NMP_OBJECT_TYPE_IP4_ROUTE or %NMP_OBJECT_TYPE_IP6_ROUTE.
+ * @len: the number of elements in @objs
+ * @out_results: (allow-none) (out): if not %NULL, an array of @len elements
+ *   that receives for each object the result that nm_platform_object_delete()
+ *   would have returned.
+ *
+ * This is like calling nm_platform_object_delete() for each object in turn,
+ * but it allows the implementation to pipeline the requests.
+ */
+void
+nm_platform_object_delete_batch (NMPlatform *self,
+                                 const NMPObject *const*objs,
+                                 guint len,
+                                 gboolean *out_results)
+{
+	guint i;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	nm_assert (objs || len == 0);
+
+	if (len == 0)
+		return;
+
+	if (!klass->object_delete_batch) {
+		for (i = 0; i < len; i++) {
+			gboolean r;
+
+			r = nm_platform_object_delete (self, objs[i]);
+			if (out_results)
+				out_results[i] = r;
+		}
+		return;
+	}
+
+	if (_LOGD_ENABLED ()) {
+		for (i = 0; i < len; i++) {
+			int ifindex = NMP_OBJECT_CAST_OBJ_WITH_IFINDEX (objs[i])->ifindex;
+
+			nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (objs[i]), NMP_OBJECT_TYPE_IP4_ROUTE,
+			                                                     NMP_OBJECT_TYPE_IP6_ROUTE));
+
+			_LOG3D ("%s: delete %s (batched %u/%u)",
+			        NMP_OBJECT_GET_CLASS (objs[i])->obj_type_name,
+			        nmp_object_to_string (objs[i], NMP_OBJECT_TO_STRING_PUBLIC, NULL, 0),
+			        i + 1, len);
+		}
+	}
+
+	klass->object_delete_batch (self, objs, len, out_results);
+}
+
 /*****************************************************************************/
 
 int
@@ -8061,6 +8548,8 @@ static void
 nm_platform_init (NMPlatform *self)
 {
 	self->_priv = G_TYPE_INSTANCE_GET_PRIVATE (self, NM_TYPE_PLATFORM, NMPlatformPrivate);
+
+	c_list_init (&self->_priv->link_stats_lst_head);
 }
 
 static GObject *
@@ -8095,6 +8584,8 @@ finalize (GObject *object)
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_check_id);
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_gc_timeout_id);
 	nm_clear_pointer (&priv->ip4_dev_route_blacklist_hash, g_hash_table_unref);
+	nm_assert (c_list_is_empty (&priv->link_stats_lst_head));
+	nm_clear_g_source (&priv->link_stats_timeout_id);
 	g_clear_object (&self->_netns);
 	nm_dedup_multi_index_unref (priv->multi_idx);
 	nmp_cache_free (priv->cache);
@@ -902,6 +902,15 @@ typedef enum {
 
 typedef void (*NMPlatformAsyncCallback) (GError *error, gpointer user_data);
 
+typedef struct _NMPlatformLinkStatsHandle NMPlatformLinkStatsHandle;
+
+/* @plink is the freshly refreshed link of @ifindex, or %NULL if the link
+ * does not exist (or @ifindex is not positive). */
+typedef void (*NMPlatformLinkStatsCallback) (NMPlatform *self,
+                                             int ifindex,
+                                             const NMPlatformLink *plink,
+                                             gpointer user_data);
+
 /*****************************************************************************/
 
 typedef enum {
@@ -969,9 +978,18 @@ typedef struct {
 	                           NMPlatformAsyncCallback callback,
 	                           gpointer data,
 	                           GCancellable *cancellable);
+	void (*sysctl_ip_conf_set_async) (NMPlatform *self,
+	                                  int addr_family,
+	                                  int ifindex,
+	                                  const char *ifname,
+	                                  const char *property,
+	                                  const char *value,
+	                                  NMPlatformAsyncCallback callback,
+	                                  gpointer data);
 	char * (*sysctl_get) (NMPlatform *self, const char *pathid, int dirfd, const char *path);
 
 	void (*refresh_all) (NMPlatform *self, NMPObjectType obj_type);
+	void (*refresh_routes_for_ifindex) (NMPlatform *self, int addr_family, int ifindex);
 	void (*process_events) (NMPlatform *self);
 
 	int (*link_add) (NMPlatform *self,
@@ -984,6 +1002,7 @@ typedef struct {
 	                 const NMPlatformLink **out_link);
 	gboolean (*link_delete) (NMPlatform *self, int ifindex);
 	gboolean (*link_refresh) (NMPlatform *self, int ifindex);
+	void (*link_refresh_stats) (NMPlatform *self, const int *ifindexes, guint len);
 	gboolean (*link_set_netns) (NMPlatform *self, int ifindex, int netns_fd);
 	gboolean (*link_set_up) (NMPlatform *self, int ifindex, gboolean *out_no_firmware);
 	gboolean (*link_set_down) (NMPlatform *self, int ifindex);
@@ -1082,6 +1101,10 @@ typedef struct {
 	gboolean    (*wpan_set_channel)      (NMPlatform *self, int ifindex, guint8 page, guint8 channel);
 
 	gboolean (*object_delete) (NMPlatform *self, const NMPObject *obj);
+	void (*object_delete_batch) (NMPlatform *self,
+	                             const NMPObject *const*objs,
+	                             guint len,
+	                             gboolean *out_results);
 
 	gboolean (*ip4_address_add) (NMPlatform *self,
 	                             int ifindex,
@@ -1108,6 +1131,11 @@ typedef struct {
 	                     NMPNlmFlags flags,
 	                     int addr_family,
 	                     const NMPlatformIPRoute *route);
+	void (*ip_route_add_batch) (NMPlatform *self,
+	                            NMPNlmFlags flags,
+	                            const NMPObject *const*routes,
+	                            guint len,
+	                            int *out_results);
 	int (*ip_route_get) (NMPlatform *self,
 	                     int addr_family,
 	                     gconstpointer address,
@@ -1330,6 +1358,14 @@ gboolean nm_platform_sysctl_ip_conf_set (NMPlatform *self,
                                          const char *property,
                                          const char *value);
 
+void nm_platform_sysctl_ip_conf_set_async (NMPlatform *self,
+                                           int addr_family,
+                                           const char *ifname,
+                                           const char *property,
+                                           const char *value,
+                                           NMPlatformAsyncCallback callback,
+                                           gpointer data);
+
 gboolean nm_platform_sysctl_ip_conf_set_int64 (NMPlatform *self,
                                                int addr_family,
                                                const char *ifname,
@@ -1599,7 +1635,20 @@ gboolean nm_platform_link_supports_slaves (NMPlatform *self, int ifindex);
 const char *nm_platform_link_get_type_name (NMPlatform *self, int ifindex);
 
 gboolean nm_platform_link_refresh (NMPlatform *self, int ifindex);
+
+NMPlatformLinkStatsHandle *nm_platform_link_stats_subscribe (NMPlatform *self,
+                                                             int ifindex,
+                                                             guint refresh_rate_ms,
+                                                             NMPlatformLinkStatsCallback callback,
+                                                             gpointer user_data);
+void nm_platform_link_stats_set_ifindex (NMPlatform *self,
+                                         NMPlatformLinkStatsHandle *handle,
+                                         int ifindex);
+void nm_platform_link_stats_unsubscribe (NMPlatform *self,
+                                         NMPlatformLinkStatsHandle *handle);
+
 void nm_platform_process_events (NMPlatform *self);
+void nm_platform_refresh_routes_for_ifindex (NMPlatform *self, int addr_family, int ifindex);
 
 const NMPlatformLink *nm_platform_process_events_ensure_link (NMPlatform *self,
                                                               int ifindex,
@@ -1756,6 +1805,10 @@ int nm_platform_link_wireguard_change (NMPlatform *self,
 const NMPlatformIP6Address *nm_platform_ip6_address_get (NMPlatform *self, int ifindex, struct in6_addr address);
 
 gboolean nm_platform_object_delete (NMPlatform *self, const NMPObject *route);
+void nm_platform_object_delete_batch (NMPlatform *self,
+                                      const NMPObject *const*objs,
+                                      guint len,
+                                      gboolean *out_results);
 
 gboolean nm_platform_ip4_address_add (NMPlatform *self,
                                       int ifindex,
@@ -1791,6 +1844,11 @@ int nm_platform_ip_route_add (NMPlatform *self,
                               const NMPObject *route);
 int nm_platform_ip4_route_add (NMPlatform *self, NMPNlmFlags flags, const NMPlatformIP4Route *route);
 int nm_platform_ip6_route_add (NMPlatform *self, NMPNlmFlags flags, const NMPlatformIP6Route *route);
+void nm_platform_ip_route_add_batch (NMPlatform *self,
+                                     NMPNlmFlags flags,
+                                     const NMPObject *const*routes,
+                                     guint len,
+                                     int *out_results);
 
 GPtrArray *nm_platform_ip_route_get_prune_list (NMPlatform *self,
                                                 int addr_family,
@@ -14,6 +14,7 @@
 
 #include "nm-utils.h"
 #include "nm-glib-aux/nm-secret-utils.h"
+#include "nm-glib-aux/nm-c-list.h"
 
 #include "nm-core-utils.h"
 #include "nm-platform-utils.h"
@@ -756,16 +757,146 @@ _vt_cmd_obj_dispose_lnk_wireguard (NMPObject *obj)
 	_wireguard_clear (&obj->_lnk_wireguard);
 }
 
+/*****************************************************************************/
+
+/* IP addresses and routes are by far the most numerous objects in the cache
+ * (think of a host that receives a full routing table). Instead of allocating
+ * them one by one, they are carved out of fixed-size slabs, one pool per
+ * object type.
+ *
+ * A slab is aligned to its own size, so that on free we find the slab
+ * header by masking the object pointer. A slab that becomes empty is
+ * released, except for one spare slab per pool.
+ *
+ * Like the ref-counting of NMPObject, this is not thread-safe. */
+
+#define _POOL_SLAB_SIZE ((gsize) (64 * 1024))
+
+#define _POOL_ALIGN(size) ((((gsize) (size)) + 15u) & ~((gsize) 15u))
+
+typedef struct {
+	CList slab_lst;
+	gpointer free_list;
+	guint n_used;
+	guint n_bump;
+} NMPPoolSlab;
+
+typedef struct {
+	CList slab_avail_lst_head;
+	NMPPoolSlab *slab_spare;
+	gsize obj_size;
+	gsize slot_size;
+	guint n_slots;
+} NMPPool;
+
+static NMPPool *
+_pool_get (const NMPClass *klass)
+{
+	static NMPPool pools[4];
+	NMPPool *pool;
+
+	switch (klass->obj_type) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS: pool = &pools[0]; break;
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: pool = &pools[1]; break;
+	case NMP_OBJECT_TYPE_IP4_ROUTE:   pool = &pools[2]; break;
+	case NMP_OBJECT_TYPE_IP6_ROUTE:   pool = &pools[3]; break;
+	default:
+		return NULL;
+	}
+
+	if (G_UNLIKELY (pool->n_slots == 0)) {
+		c_list_init (&pool->slab_avail_lst_head);
+		pool->obj_size = klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object);
+		pool->slot_size = _POOL_ALIGN (pool->obj_size);
+		pool->n_slots = (_POOL_SLAB_SIZE - _POOL_ALIGN (sizeof (NMPPoolSlab))) / pool->slot_size;
+		nm_assert (pool->n_slots > 1);
+	}
+	return pool;
+}
+
+static gpointer
+_pool_alloc0 (NMPPool *pool)
+{
+	NMPPoolSlab *slab;
+	gpointer p;
+
+	slab = c_list_first_entry (&pool->slab_avail_lst_head, NMPPoolSlab, slab_lst);
+	if (!slab) {
+		gpointer mem;
+
+		if (posix_memalign (&mem, _POOL_SLAB_SIZE, _POOL_SLAB_SIZE) != 0)
+			g_error ("%s: failed to allocate %"G_GSIZE_FORMAT" bytes", G_STRLOC, _POOL_SLAB_SIZE);
+		slab = mem;
+		*slab = (NMPPoolSlab) { };
+		c_list_link_front (&pool->slab_avail_lst_head, &slab->slab_lst);
+	}
+
+	if (slab->free_list) {
+		p = slab->free_list;
+		slab->free_list = *((gpointer *) p);
+	} else {
+		nm_assert (slab->n_bump < pool->n_slots);
+		p = &((char *) slab)[_POOL_ALIGN (sizeof (NMPPoolSlab)) + (slab->n_bump++) * pool->slot_size];
+	}
+
+	if (slab == pool->slab_spare)
+		pool->slab_spare = NULL;
+	if (++slab->n_used == pool->n_slots) {
+		/* the slab is full. It is only reachable via its objects
+		 * until one of them gets freed. */
+		c_list_unlink (&slab->slab_lst);
+	}
+
+	memset (p, 0, pool->obj_size);
+	return p;
+}
+
+static void
+_pool_free (NMPPool *pool, gpointer p)
+{
+	NMPPoolSlab *slab;
+
+	slab = (NMPPoolSlab *) (((uintptr_t) p) & ~((uintptr_t) (_POOL_SLAB_SIZE - 1)));
+
+	nm_assert (slab->n_used > 0);
+	nm_assert (slab->n_used <= pool->n_slots);
+
+	if (slab->n_used-- == pool->n_slots)
+		c_list_link_front (&pool->slab_avail_lst_head, &slab->slab_lst);
+
+	if (slab->n_used == 0) {
+		if (pool->slab_spare) {
+			c_list_unlink_stale (&slab->slab_lst);
+			free (slab);
+			return;
+		}
+		pool->slab_spare = slab;
+		slab->free_list = NULL;
+		slab->n_bump = 0;
+		return;
+	}
+
+	*((gpointer *) p) = slab->free_list;
+	slab->free_list = p;
+}
+
+/*****************************************************************************/
+
 static NMPObject *
 _nmp_object_new_from_class (const NMPClass *klass)
 {
 	NMPObject *obj;
+	NMPPool *pool;
 
 	nm_assert (klass);
 	nm_assert (klass->sizeof_data > 0);
 	nm_assert (klass->sizeof_public > 0 && klass->sizeof_public <= klass->sizeof_data);
 
-	obj = g_slice_alloc0 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object));
+	pool = _pool_get (klass);
+	if (pool)
+		obj = _pool_alloc0 (pool);
+	else
+		obj = g_slice_alloc0 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object));
 	obj->_class = klass;
 	obj->parent._ref_count = 1;
 	return obj;
@@ -1705,6 +1836,7 @@ _vt_dedup_obj_destroy (NMDedupMultiObj *obj)
 {
 	NMPObject *o = (NMPObject *) obj;
 	const NMPClass *klass;
+	NMPPool *pool;
 
 	nm_assert (o->parent._ref_count == 0);
 	nm_assert (!o->parent._multi_idx);
@@ -1712,7 +1844,11 @@ _vt_dedup_obj_destroy (NMDedupMultiObj *obj)
 	klass = o->_class;
 	if (klass->cmd_obj_dispose)
 		klass->cmd_obj_dispose (o);
-	g_slice_free1 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object), o);
+	pool = _pool_get (klass);
+	if (pool)
+		_pool_free (pool, o);
+	else
+		g_slice_free1 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object), o);
 }
 
 static const NMDedupMultiObj *
@@ -2479,7 +2615,7 @@ nmp_cache_remove (NMPCache *cache,
 		return NMP_CACHE_OPS_UNCHANGED;
 	}
 	if (   only_dirty
-	    && !entry_old->dirty) {
+	    && !nm_dedup_multi_entry_is_dirty (entry_old)) {
 		/* the entry is not dirty. Skip. */
 		return NMP_CACHE_OPS_UNCHANGED;
 	}
@@ -2560,6 +2696,9 @@ nmp_cache_remove_netlink (NMPCache *cache,
  *    calling nmp_cache_update_netlink() you hand @obj over to the cache.
  *    Except, that the cache will increment the ref count as appropriate. You
  *    must still unref the obj to release your part of the ownership.
+ *    Except for links, @obj_hand_over may also be a stack-allocated object.
+ *    The cache then only clones it to the heap if it actually needs to store
+ *    it.
  * @is_dump: whether this update comes during a dump of object of the same kind.
  *    kernel dumps objects in a certain order, which matters especially for routes.
  *    Before a dump we mark all objects as dirty, and remove all untouched objects
@@ -2591,7 +2730,10 @@ nmp_cache_update_netlink (NMPCache *cache,
 
 	nm_assert (cache);
 	nm_assert (NMP_OBJECT_IS_VALID (obj_hand_over));
-	nm_assert (!NMP_OBJECT_IS_STACKINIT (obj_hand_over));
+	/* Links get modified and merged with the udev data below, which is
+	 * not supported for stack objects. */
+	nm_assert (   !NMP_OBJECT_IS_STACKINIT (obj_hand_over)
+	           || NMP_OBJECT_GET_TYPE (obj_hand_over) != NMP_OBJECT_TYPE_LINK);
 	/* A link object from netlink must have the udev related fields unset.
 	 * We could implement to handle that, but there is no need to support such
 	 * a use-case */
@@ -2717,10 +2859,6 @@ nmp_cache_update_netlink_route (NMPCache *cache,
 
 	nm_assert (cache);
 	nm_assert (NMP_OBJECT_IS_VALID (obj_hand_over));
-	nm_assert (!NMP_OBJECT_IS_STACKINIT (obj_hand_over));
-	/* A link object from netlink must have the udev related fields unset.
-	 * We could implement to handle that, but there is no need to support such
-	 * a use-case */
 	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_hand_over), NMP_OBJECT_TYPE_IP4_ROUTE,
 	                                                           NMP_OBJECT_TYPE_IP6_ROUTE));
 	nm_assert (nm_dedup_multi_index_obj_find (cache->multi_idx, obj_hand_over) != obj_hand_over);
@@ -2978,6 +3116,13 @@ nmp_cache_dirty_set_all_main (NMPCache *cache,
 
 	head_entry = nmp_cache_lookup (cache, lookup);
 
+	if (lookup->cache_id_type == NMP_CACHE_ID_TYPE_OBJECT_TYPE) {
+		/* the head is the main index. Mark all entries dirty at once by
+		 * bumping the generation of the head. */
+		nm_dedup_multi_head_entry_dirty_set_all (head_entry);
+		return;
+	}
+
 	nm_dedup_multi_iter_init (&iter, head_entry);
 	while (nm_dedup_multi_iter_next (&iter)) {
 		const NMDedupMultiEntry *main_entry;
@@ -3165,6 +3165,155 @@ test_sysctl_set_async_fail (void)
 	g_main_loop_unref (loop);
 }
 
+typedef struct {
+	GMainLoop *loop;
+	gboolean expected_success;
+	guint n_pending;
+} IPConfSetAsyncData;
+
+static void
+sysctl_ip_conf_set_async_cb (GError *error, gpointer user_data)
+{
+	IPConfSetAsyncData *data = user_data;
+
+	if (data->expected_success)
+		g_assert_no_error (error);
+	else
+		g_assert (error);
+
+	g_assert_cmpint (data->n_pending, >, 0);
+	if (--data->n_pending == 0)
+		g_main_loop_quit (data->loop);
+}
+
+static void
+test_sysctl_ip_conf_set_async (void)
+{
+	NMPlatform *const PL = NM_PLATFORM_GET;
+	const char *const IFNAME = "nm-dummy-0";
+	const char *const PATH = "/proc/sys/net/ipv4/conf/nm-dummy-0/rp_filter";
+	GMainLoop *loop;
+	gboolean proc_writable;
+	IPConfSetAsyncData data;
+	int ifindex;
+	guint i;
+
+	ifindex = nmtstp_link_dummy_add (PL, -1, IFNAME)->ifindex;
+	loop = g_main_loop_new (NULL, FALSE);
+	proc_writable = access (PATH, W_OK) == 0;
+
+	/* repeated writes to the same key get coalesced, but every caller
+	 * is notified. */
+	data = (IPConfSetAsyncData) {
+		.loop = loop,
+		.expected_success = proc_writable,
+		.n_pending = 5,
+	};
+	for (i = 0; i < 5; i++) {
+		nm_platform_sysctl_ip_conf_set_async (PL, AF_INET, IFNAME, "rp_filter",
+		                                      (i % 2) ? "2" : "1",
+		                                      sysctl_ip_conf_set_async_cb,
+		                                      &data);
+	}
+	nm_platform_sysctl_ip_conf_set_async (PL, AF_INET6, IFNAME, "accept_ra", "0", NULL, NULL);
+
+	if (!nmtst_main_loop_run (loop, 2000))
+		g_assert_not_reached ();
+	g_assert_cmpint (data.n_pending, ==, 0);
+
+	if (proc_writable) {
+		g_assert_cmpint (nm_platform_sysctl_ip_conf_get_int_checked (PL, AF_INET, IFNAME, "rp_filter", 10, 0, 2, -1),
+		                 ==,
+		                 1);
+	}
+
+	/* a synchronous read sees the queued value. */
+	data = (IPConfSetAsyncData) {
+		.loop = loop,
+		.expected_success = proc_writable,
+		.n_pending = 1,
+	};
+	nm_platform_sysctl_ip_conf_set_async (PL, AF_INET, IFNAME, "rp_filter", "2",
+	                                      sysctl_ip_conf_set_async_cb,
+	                                      &data);
+	if (proc_writable) {
+		g_assert_cmpint (nm_platform_sysctl_ip_conf_get_int_checked (PL, AF_INET, IFNAME, "rp_filter", 10, 0, 2, -1),
+		                 ==,
+		                 2);
+	}
+
+	if (!nmtst_main_loop_run (loop, 2000))
+		g_assert_not_reached ();
+	g_assert_cmpint (data.n_pending, ==, 0);
+
+	nmtstp_link_delete (NULL, -1, ifindex, IFNAME, TRUE);
+	g_main_loop_unref (loop);
+}
+
+typedef struct {
+	GMainLoop *loop;
+	int ifindex;
+	guint n_calls[2];
+	gint64 last_call_msec[2];
+	NMPlatformLinkStatsHandle *handles[2];
+} LinkStatsData;
+
+static void
+_link_stats_cb (NMPlatform *platform,
+                int ifindex,
+                const NMPlatformLink *plink,
+                gpointer user_data)
+{
+	LinkStatsData *data = user_data;
+	guint idx = (ifindex == data->ifindex) ? 0 : 1;
+
+	if (idx == 0) {
+		g_assert (plink);
+		g_assert_cmpint (plink->ifindex, ==, data->ifindex);
+	} else {
+		g_assert_cmpint (ifindex, ==, 0);
+		g_assert (!plink);
+	}
+
+	data->n_calls[idx]++;
+	data->last_call_msec[idx] = nm_utils_get_monotonic_timestamp_msec ();
+
+	if (data->n_calls[idx] == 2) {
+		/* unsubscribing from within the callback is allowed. */
+		nm_platform_link_stats_unsubscribe (platform, g_steal_pointer (&data->handles[idx]));
+		if (!data->handles[0] && !data->handles[1])
+			g_main_loop_quit (data->loop);
+	}
+}
+
+static void
+test_link_stats_subscribe (void)
+{
+	NMPlatform *const PL = NM_PLATFORM_GET;
+	const char *const IFNAME = "nm-dummy-0";
+	LinkStatsData data = { };
+	guint i;
+
+	data.ifindex = nmtstp_link_dummy_add (PL, -1, IFNAME)->ifindex;
+	data.loop = g_main_loop_new (NULL, FALSE);
+
+	/* subscriptions with the same rate share the ticks. */
+	data.handles[0] = nm_platform_link_stats_subscribe (PL, data.ifindex, 200, _link_stats_cb, &data);
+	data.handles[1] = nm_platform_link_stats_subscribe (PL, 0, 200, _link_stats_cb, &data);
+
+	if (!nmtst_main_loop_run (data.loop, 2000))
+		g_assert_not_reached ();
+
+	for (i = 0; i < 2; i++) {
+		g_assert_cmpint (data.n_calls[i], ==, 2);
+		g_assert (!data.handles[i]);
+	}
+	g_assert_cmpint (data.last_call_msec[1] - data.last_call_msec[0], <, 100);
+
+	nmtstp_link_delete (NULL, -1, data.ifindex, IFNAME, TRUE);
+	g_main_loop_unref (data.loop);
+}
+
 /*****************************************************************************/
 
 static gpointer
@@ -3391,6 +3540,9 @@ _nmtstp_setup_tests (void)
 		g_test_add_func ("/general/sysctl/netns-switch", test_sysctl_netns_switch);
 		g_test_add_func ("/general/sysctl/set-async", test_sysctl_set_async);
 		g_test_add_func ("/general/sysctl/set-async-fail", test_sysctl_set_async_fail);
+		g_test_add_func ("/general/sysctl/ip-conf-set-async", test_sysctl_ip_conf_set_async);
+
+		g_test_add_func ("/link/stats/subscribe", test_link_stats_subscribe);
 
 		g_test_add_func ("/link/ethtool/features/get", test_ethtool_features_get);
 	}
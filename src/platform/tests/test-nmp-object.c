@@ -524,6 +524,127 @@ test_cache_qdisc (void)
 
 /*****************************************************************************/
 
+static void
+test_obj_pool (void)
+{
+	gs_unref_ptrarray GPtrArray *objs = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+	guint i;
+
+	/* IP addresses and routes are allocated from per-type slabs. Allocate
+	 * enough objects to span several slabs, free some of them randomly and
+	 * check that recycled slots come back cleared. */
+	for (i = 0; i < 5000; i++) {
+		NMPObject *obj;
+
+		obj = nmp_object_new (NMP_OBJECT_TYPE_IP6_ADDRESS, NULL);
+		g_assert_cmpint (obj->ip6_address.ifindex, ==, 0);
+		g_assert (IN6_IS_ADDR_UNSPECIFIED (&obj->ip6_address.address));
+		obj->ip6_address.ifindex = i + 1;
+		obj->ip6_address.address.s6_addr[0] = 0xfd;
+		g_ptr_array_add (objs, obj);
+
+		if (nmtst_get_rand_uint32 () % 3 == 0)
+			g_ptr_array_remove_index_fast (objs, nmtst_get_rand_uint32 () % objs->len);
+	}
+
+	for (i = 0; i < objs->len; i++) {
+		const NMPObject *obj = objs->pdata[i];
+
+		g_assert_cmpint (NMP_OBJECT_GET_TYPE (obj), ==, NMP_OBJECT_TYPE_IP6_ADDRESS);
+		g_assert_cmpint (obj->ip6_address.ifindex, >, 0);
+		g_assert_cmpint (obj->ip6_address.address.s6_addr[0], ==, 0xfd);
+	}
+}
+
+/*****************************************************************************/
+
+static NMPObject *
+_cache_route_dump_obj (NMPObject *obj_stack, guint idx)
+{
+	const NMPlatformIP4Route r = {
+		.ifindex   = 1 + (idx % 16),
+		.network   = htonl ((10u << 24) + idx),
+		.plen      = 32,
+		.metric    = 100,
+		.rt_source = NM_IP_CONFIG_SOURCE_RTPROT_BOOT,
+	};
+
+	if (obj_stack)
+		return (NMPObject *) nmp_object_stackinit (obj_stack, NMP_OBJECT_TYPE_IP4_ROUTE, &r);
+	return nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, &r);
+}
+
+static gint64
+_cache_route_dump (NMPCache *cache,
+                   guint n_routes,
+                   gboolean use_stack,
+                   NMPCacheOpsType expected_ops_type)
+{
+	gint64 start_time = nm_utils_get_monotonic_timestamp_nsec ();
+	guint i;
+
+	/* emulate what event_valid_msg() does for each RTM_NEWROUTE message
+	 * of a dump. */
+	for (i = 0; i < n_routes; i++) {
+		nm_auto_nmpobj const NMPObject *obj_old = NULL;
+		nm_auto_nmpobj const NMPObject *obj_new = NULL;
+		NMPObject obj_stack;
+		NMPObject *obj;
+		NMPCacheOpsType ops_type;
+
+		obj = _cache_route_dump_obj (use_stack ? &obj_stack : NULL, i);
+		ops_type = nmp_cache_update_netlink_route (cache,
+		                                           obj,
+		                                           TRUE,
+		                                           0,
+		                                           &obj_old,
+		                                           &obj_new,
+		                                           NULL,
+		                                           NULL);
+		g_assert_cmpint (ops_type, ==, expected_ops_type);
+		g_assert (obj_new);
+		g_assert (!NMP_OBJECT_IS_STACKINIT (obj_new));
+		g_assert (nmp_object_equal (obj_new, obj));
+		if (!use_stack)
+			nmp_object_unref (obj);
+	}
+
+	return nm_utils_get_monotonic_timestamp_nsec () - start_time;
+}
+
+static void
+test_cache_route_dump (void)
+{
+	const guint n_routes = g_test_perf () ? 1000000u : 10000u;
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = nm_dedup_multi_index_new ();
+	NMPCache *cache;
+	NMPLookup lookup;
+	gint64 t_add;
+	gint64 t_stack;
+	gint64 t_heap;
+
+	cache = nmp_cache_new (multi_idx, FALSE);
+
+	t_add = _cache_route_dump (cache, n_routes, TRUE, NMP_CACHE_OPS_ADDED);
+	g_assert_cmpint (nmp_cache_lookup (cache, nmp_lookup_init_obj_type (&lookup, NMP_OBJECT_TYPE_IP4_ROUTE))->len, ==, n_routes);
+
+	/* Re-dump the unchanged routing table. Parsed into a stack object,
+	 * this does not allocate any NMPObject. */
+	t_stack = _cache_route_dump (cache, n_routes, TRUE, NMP_CACHE_OPS_UNCHANGED);
+	t_heap = _cache_route_dump (cache, n_routes, FALSE, NMP_CACHE_OPS_UNCHANGED);
+	g_assert_cmpint (nmp_cache_lookup (cache, nmp_lookup_init_obj_type (&lookup, NMP_OBJECT_TYPE_IP4_ROUTE))->len, ==, n_routes);
+
+	g_test_message ("dump of %u routes: add %"G_GINT64_FORMAT" msec; unchanged %"G_GINT64_FORMAT" msec (stack), %"G_GINT64_FORMAT" msec (heap)",
+	                n_routes,
+	                t_add / NM_UTILS_NSEC_PER_MSEC,
+	                t_stack / NM_UTILS_NSEC_PER_MSEC,
+	                t_heap / NM_UTILS_NSEC_PER_MSEC);
+
+	nmp_cache_free (cache);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -569,6 +690,8 @@ main (int argc, char **argv)
 	g_test_add_func ("/nmp-object/obj-base", test_obj_base);
 	g_test_add_func ("/nmp-object/cache_link", test_cache_link);
 	g_test_add_func ("/nmp-object/cache_qdisc", test_cache_qdisc);
+	g_test_add_func ("/nmp-object/obj_pool", test_obj_pool);
+	g_test_add_func ("/nmp-object/cache_route_dump", test_cache_route_dump);
 
 	result = g_test_run ();
 
@@ -306,6 +306,49 @@ test_ip4_route (void)
 	free_signal (route_removed);
 }
 
+static void
+test_ip4_route_sync_batch (void)
+{
+	const int ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	gs_unref_ptrarray GPtrArray *routes_prune = NULL;
+	/* more routes than the platform keeps in flight at once. */
+	const guint N = 700;
+	const guint32 metric = 22987;
+	guint i;
+
+	routes = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+	for (i = 0; i < N; i++) {
+		const NMPlatformIP4Route rt = {
+			.ifindex = ifindex,
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+			.network = htonl (0x0a000000u | (i << 8)),
+			.plen = 24,
+			.metric = metric,
+		};
+
+		g_ptr_array_add (routes, nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &rt));
+	}
+
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, ifindex, routes, NULL, NULL));
+
+	for (i = 0; i < N; i++)
+		g_assert (nmtstp_ip4_route_get (NM_PLATFORM_GET, ifindex, htonl (0x0a000000u | (i << 8)), 24, metric, 0));
+
+	/* syncing again is a no-op. */
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, ifindex, routes, NULL, NULL));
+
+	routes_prune = nm_platform_ip_route_get_prune_list (NM_PLATFORM_GET,
+	                                                    AF_INET,
+	                                                    ifindex,
+	                                                    NM_IP_ROUTE_TABLE_SYNC_MODE_ALL);
+	g_assert (routes_prune);
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, ifindex, NULL, routes_prune, NULL));
+
+	for (i = 0; i < N; i++)
+		g_assert (!nmtstp_ip4_route_get (NM_PLATFORM_GET, ifindex, htonl (0x0a000000u | (i << 8)), 24, metric, 0));
+}
+
 static void
 test_ip6_route (void)
 {
@@ -469,6 +512,155 @@ test_ip4_zero_gateway (void)
 	nmtstp_wait_for_signal (NM_PLATFORM_GET, 50);
 }
 
+static void
+test_ip4_route_refresh_for_ifindex (void)
+{
+	int ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	guint i;
+
+	nmtstp_run_command_check ("ip route add 1.2.3.0/24 dev %s", DEVICE_NAME);
+
+	/* the refresh re-reads the routes of the interface synchronously. */
+	nm_platform_refresh_routes_for_ifindex (NM_PLATFORM_GET, AF_INET, ifindex);
+	g_assert (nmtstp_ip4_route_get (NM_PLATFORM_GET, ifindex, nmtst_inet4_from_string ("1.2.3.0"), 24, 0, 0));
+
+	nmtstp_run_command_check ("ip route flush dev %s", DEVICE_NAME);
+
+	nm_platform_refresh_routes_for_ifindex (NM_PLATFORM_GET, AF_UNSPEC, ifindex);
+	g_assert (!nmtstp_ip4_route_get (NM_PLATFORM_GET, ifindex, nmtst_inet4_from_string ("1.2.3.0"), 24, 0, 0));
+
+	/* kernel removes routes using a deleted address as preferred source
+	 * without sending RTM_DELROUTE. Only pruning after the refresh can
+	 * get rid of it. Do it twice, pruning must keep working. */
+	for (i = 0; i < 2; i++) {
+		nmtstp_run_command_check ("ip addr add 192.0.2.5/24 dev %s", DEVICE_NAME);
+		nmtstp_run_command_check ("ip route add 1.2.4.0/24 dev %s src 192.0.2.5", DEVICE_NAME);
+		nmtstp_run_command_check ("ip route add 1.2.5.0/24 dev %s", DEVICE_NAME);
+
+		nm_platform_refresh_routes_for_ifindex (NM_PLATFORM_GET, AF_INET, ifindex);
+		g_assert (nmtstp_ip4_route_get (NM_PLATFORM_GET, ifindex, nmtst_inet4_from_string ("1.2.4.0"), 24, 0, 0));
+
+		nmtstp_run_command_check ("ip addr del 192.0.2.5/24 dev %s", DEVICE_NAME);
+
+		nm_platform_refresh_routes_for_ifindex (NM_PLATFORM_GET, i == 0 ? AF_INET : AF_UNSPEC, ifindex);
+		g_assert (!nmtstp_ip4_route_get (NM_PLATFORM_GET, ifindex, nmtst_inet4_from_string ("1.2.4.0"), 24, 0, 0));
+		g_assert (nmtstp_ip4_route_get (NM_PLATFORM_GET, ifindex, nmtst_inet4_from_string ("1.2.5.0"), 24, 0, 0));
+
+		nmtstp_run_command_check ("ip route flush dev %s", DEVICE_NAME);
+		nm_platform_refresh_routes_for_ifindex (NM_PLATFORM_GET, AF_INET, ifindex);
+	}
+}
+
+static gboolean
+_ip4_route_in_table (NMPlatform *platform, int ifindex, const char *network, guint32 table)
+{
+	NMDedupMultiIter iter;
+	const NMPObject *obj;
+
+	nmp_cache_iter_for_each (&iter,
+	                         nm_platform_lookup_object (platform, NMP_OBJECT_TYPE_IP4_ROUTE, ifindex),
+	                         &obj) {
+		const NMPlatformIP4Route *r = NMP_OBJECT_CAST_IP4_ROUTE (obj);
+
+		if (   r->network == nmtst_inet4_from_string (network)
+		    && nm_platform_route_table_uncoerce (r->table_coerced, TRUE) == table)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+test_ip4_route_ignore (void)
+{
+	int ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	gs_unref_object NMPlatform *platform = NULL;
+
+	nmtstp_run_command_check ("ip route add 1.2.6.0/24 dev %s table 4242", DEVICE_NAME);
+
+	/* the routes in the initial dump are dropped, but not counted. */
+	platform = nm_linux_platform_new_full (TRUE, NM_PLATFORM_NETNS_SUPPORT_DEFAULT, "4242", "bird");
+	g_assert (!_ip4_route_in_table (platform, ifindex, "1.2.6.0", 4242));
+	g_assert_cmpint (nm_linux_platform_get_route_ignore_dropped (platform), ==, 0);
+
+	nmtstp_run_command_check ("ip route add 1.2.3.0/24 dev %s table 4242", DEVICE_NAME);
+	nmtstp_run_command_check ("ip route add 1.2.4.0/24 dev %s table 4243 proto bird", DEVICE_NAME);
+	nmtstp_run_command_check ("ip route add 1.2.5.0/24 dev %s table 4243", DEVICE_NAME);
+
+	NMTST_WAIT_ASSERT (100, {
+		nmtstp_wait_for_signal (NM_PLATFORM_GET, 10);
+		if (_ip4_route_in_table (NM_PLATFORM_GET, ifindex, "1.2.5.0", 4243))
+			break;
+	});
+	g_assert (_ip4_route_in_table (NM_PLATFORM_GET, ifindex, "1.2.3.0", 4242));
+	g_assert (_ip4_route_in_table (NM_PLATFORM_GET, ifindex, "1.2.4.0", 4243));
+
+	nm_platform_process_events (platform);
+
+	g_assert (_ip4_route_in_table (platform, ifindex, "1.2.5.0", 4243));
+	g_assert (!_ip4_route_in_table (platform, ifindex, "1.2.3.0", 4242));
+	g_assert (!_ip4_route_in_table (platform, ifindex, "1.2.4.0", 4243));
+	g_assert_cmpint (nm_linux_platform_get_route_ignore_dropped (platform), ==, 2);
+
+	nmtstp_run_command_check ("ip route flush table 4242");
+	nmtstp_run_command_check ("ip route flush table 4243");
+
+	nmtstp_wait_for_signal (NM_PLATFORM_GET, 50);
+}
+
+static void
+test_ip4_route_ignore_get (void)
+{
+	int ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	gs_unref_object NMPlatform *platform = NULL;
+	nm_auto_nmpobj NMPObject *route = NULL;
+	const NMPlatformIP4Route *r;
+	in_addr_t a;
+	int result;
+
+	/* the answer to a route lookup through an ignored table must still
+	 * be returned, although the route is not tracked in the cache. */
+	platform = nm_linux_platform_new_full (TRUE, NM_PLATFORM_NETNS_SUPPORT_DEFAULT, "4242", NULL);
+
+	nmtstp_run_command_check ("ip route add 1.2.3.0/24 dev %s table 4242", DEVICE_NAME);
+	nmtstp_run_command_check ("ip rule add to 1.2.3.0/24 table 4242 priority 4242");
+
+	NMTST_WAIT_ASSERT (100, {
+		nmtstp_wait_for_signal (NM_PLATFORM_GET, 10);
+		if (_ip4_route_in_table (NM_PLATFORM_GET, ifindex, "1.2.3.0", 4242))
+			break;
+	});
+
+	nm_platform_process_events (platform);
+	g_assert (!_ip4_route_in_table (platform, ifindex, "1.2.3.0", 4242));
+	g_assert_cmpint (nm_linux_platform_get_route_ignore_dropped (platform), ==, 1);
+
+	a = nmtst_inet4_from_string ("1.2.3.1");
+	result = nm_platform_ip_route_get (platform,
+	                                   AF_INET,
+	                                   &a,
+	                                   nmtst_get_rand_uint32 () % 2 ? 0 : ifindex,
+	                                   &route);
+
+	g_assert (NMTST_NM_ERR_SUCCESS (result));
+	g_assert (NMP_OBJECT_GET_TYPE (route) == NMP_OBJECT_TYPE_IP4_ROUTE);
+	r = NMP_OBJECT_CAST_IP4_ROUTE (route);
+	g_assert (NM_FLAGS_HAS (r->r_rtm_flags, RTM_F_CLONED));
+	g_assert (r->ifindex == ifindex);
+	g_assert (r->network == a);
+	g_assert_cmpint (nm_platform_route_table_uncoerce (r->table_coerced, TRUE), ==, 4242);
+
+	nm_platform_process_events (platform);
+	g_assert (!_ip4_route_in_table (platform, ifindex, "1.2.3.0", 4242));
+
+	/* the reply to the route-get request is no dropped notification. */
+	g_assert_cmpint (nm_linux_platform_get_route_ignore_dropped (platform), ==, 1);
+
+	nmtstp_run_command_check ("ip rule del to 1.2.3.0/24 table 4242 priority 4242");
+	nmtstp_run_command_check ("ip route flush table 4242");
+
+	nmtstp_wait_for_signal (NM_PLATFORM_GET, 50);
+}
+
 static void
 test_ip4_route_options (gconstpointer test_data)
 {
@@ -1736,6 +1928,7 @@ _nmtstp_setup_tests (void)
 	add_test_func ("/route/ip4", test_ip4_route);
 	add_test_func ("/route/ip6", test_ip6_route);
 	add_test_func ("/route/ip4_metric0", test_ip4_route_metric0);
+	add_test_func ("/route/ip4_sync_batch", test_ip4_route_sync_batch);
 	add_test_func_data ("/route/ip4_options/1", test_ip4_route_options, GINT_TO_POINTER (1));
 	if (nmtstp_is_root_test ())
 		add_test_func_data ("/route/ip4_options/2", test_ip4_route_options, GINT_TO_POINTER (2));
@@ -1748,6 +1941,9 @@ _nmtstp_setup_tests (void)
 		add_test_func ("/route/ip4_route_get", test_ip4_route_get);
 		add_test_func ("/route/ip6_route_get", test_ip6_route_get);
 		add_test_func ("/route/ip4_zero_gateway", test_ip4_zero_gateway);
+		add_test_func ("/route/ip4_refresh_for_ifindex", test_ip4_route_refresh_for_ifindex);
+		add_test_func ("/route/ip4_ignore", test_ip4_route_ignore);
+		add_test_func ("/route/ip4_ignore_get", test_ip4_route_ignore_get);
 	}
 
 	if (nmtstp_is_root_test ()) {
@@ -72,6 +72,11 @@ enum {
 
 static guint signals[LAST_SIGNAL] = { 0 };
 
+/* Incremented whenever a profile changes in a way that might affect the
+ * order of nm_settings_connection_cmp_autoconnect_priority(). This allows
+ * callers to cache a sorted list. */
+static guint _autoconnect_priority_generation;
+
 typedef struct _NMSettingsConnectionPrivate {
 
 	NMSettings *settings;
@@ -281,6 +286,7 @@ _nm_settings_connection_set_connection (NMSettingsConnection *self,
 		connection_old = priv->connection;
 		priv->connection = g_object_ref (new_connection);
 		nmtst_connection_assert_unchanging (priv->connection);
+		_autoconnect_priority_generation++;
 
 		/* note that we only return @connection_old if the new connection actually differs from
 		 * before.
@@ -1307,22 +1313,22 @@ auth_start (NMSettingsConnection *self,
 
 /**** DBus method handlers ************************************/
 
-static void
-get_settings_auth_cb (NMSettingsConnection *self,
-                      GDBusMethodInvocation *context,
-                      NMAuthSubject *subject,
-                      GError *error,
-                      gpointer data)
+/**
+ * nm_settings_connection_to_dbus_get_settings:
+ * @self: the #NMSettingsConnection
+ *
+ * Returns: (transfer floating): the settings of @self, as they are returned
+ *   by the GetSettings() D-Bus method. That is, without secrets but with
+ *   the current timestamp and seen-bssids.
+ */
+GVariant *
+nm_settings_connection_to_dbus_get_settings (NMSettingsConnection *self)
 {
 	gs_free const char **seen_bssids = NULL;
 	NMConnectionSerializationOptions options = {
 	};
-	GVariant *settings;
 
-	if (error) {
-		g_dbus_method_invocation_return_gerror (context, error);
-		return;
-	}
+	g_return_val_if_fail (NM_IS_SETTINGS_CONNECTION (self), NULL);
 
 	/* Timestamp is not updated in connection's 'timestamp' property,
 	 * because it would force updating the connection and in turn
@@ -1344,11 +1350,26 @@ get_settings_auth_cb (NMSettingsConnection *self,
 	 * get returned by the GetSecrets method which can be better
 	 * protected against leakage of secrets to unprivileged callers.
 	 */
-	settings = nm_connection_to_dbus_full (nm_settings_connection_get_connection (self),
-	                                       NM_CONNECTION_SERIALIZE_NO_SECRETS,
-	                                       &options);
+	return nm_connection_to_dbus_full (nm_settings_connection_get_connection (self),
+	                                   NM_CONNECTION_SERIALIZE_NO_SECRETS,
+	                                   &options);
+}
+
+static void
+get_settings_auth_cb (NMSettingsConnection *self,
+                      GDBusMethodInvocation *context,
+                      NMAuthSubject *subject,
+                      GError *error,
+                      gpointer data)
+{
+	if (error) {
+		g_dbus_method_invocation_return_gerror (context, error);
+		return;
+	}
+
 	g_dbus_method_invocation_return_value (context,
-	                                       g_variant_new ("(@a{sa{sv}})", settings));
+	                                       g_variant_new ("(@a{sa{sv}})",
+	                                                      nm_settings_connection_to_dbus_get_settings (self)));
 }
 
 static void
@@ -2081,6 +2102,12 @@ nm_settings_connection_cmp_timestamp_p_with_data (gconstpointer pa, gconstpointe
 	                                             *((NMSettingsConnection **) pb));
 }
 
+guint
+nm_settings_connection_autoconnect_priority_generation (void)
+{
+	return _autoconnect_priority_generation;
+}
+
 int
 nm_settings_connection_cmp_autoconnect_priority (NMSettingsConnection *a, NMSettingsConnection *b)
 {
@@ -2144,6 +2171,7 @@ nm_settings_connection_update_timestamp (NMSettingsConnection *self,
 
 	priv->timestamp = timestamp;
 	priv->timestamp_set = TRUE;
+	_autoconnect_priority_generation++;
 
 	if (!priv->kf_db_timestamps)
 		return;
@@ -2185,6 +2213,7 @@ _nm_settings_connection_register_kf_dbs (NMSettingsConnection *self,
 		if (timestamp != G_MAXUINT64) {
 			priv->timestamp = timestamp;
 			priv->timestamp_set = TRUE;
+			_autoconnect_priority_generation++;
 			_LOGT ("read timestamp %"G_GUINT64_FORMAT" from keyfile database \"%s\"",
 			       timestamp, nm_key_file_db_get_filename (priv->kf_db_timestamps));
 		} else
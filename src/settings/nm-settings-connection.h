@@ -277,6 +277,8 @@ gboolean nm_settings_connection_check_visibility (NMSettingsConnection *self,
 gboolean nm_settings_connection_check_permission (NMSettingsConnection *self,
                                                   const char *permission);
 
+GVariant *nm_settings_connection_to_dbus_get_settings (NMSettingsConnection *self);
+
 /*****************************************************************************/
 
 NMDevice *nm_settings_connection_default_wired_get_device (NMSettingsConnection *self);
@@ -309,6 +311,7 @@ int nm_settings_connection_cmp_timestamp (NMSettingsConnection *ac, NMSettingsCo
 int nm_settings_connection_cmp_timestamp_p_with_data (gconstpointer pa, gconstpointer pb, gpointer user_data);
 int nm_settings_connection_cmp_autoconnect_priority (NMSettingsConnection *a, NMSettingsConnection *b);
 int nm_settings_connection_cmp_autoconnect_priority_p_with_data (gconstpointer pa, gconstpointer pb, gpointer user_data);
+guint nm_settings_connection_autoconnect_priority_generation (void);
 
 struct _NMKeyFileDB;
 
@@ -159,3 +159,147 @@ nm_sett_util_storages_steal (NMSettUtilStorages *storages,
 
 	return storage;
 }
+
+/*****************************************************************************/
+
+void
+nm_sett_util_autoconnect_cache_clear (NMSettUtilAutoconnectCache *cache)
+{
+	nm_clear_g_free (&cache->list);
+	nm_clear_pointer (&cache->idx, g_hash_table_unref);
+}
+
+static void
+_autoconnect_cache_idx_add (GHashTable *idx,
+                            const char *connection_type,
+                            const char *ifname,
+                            guint position)
+{
+	gs_free char *key = NULL;
+	GArray *positions;
+
+	key = g_strdup_printf ("%s/%s", connection_type, ifname);
+	positions = g_hash_table_lookup (idx, key);
+	if (!positions) {
+		positions = g_array_new (FALSE, FALSE, sizeof (guint));
+		g_hash_table_insert (idx, g_steal_pointer (&key), positions);
+	}
+	g_array_append_val (positions, position);
+}
+
+static GArray *
+_autoconnect_cache_idx_lookup (GHashTable *idx,
+                               const char *connection_type,
+                               const char *ifname)
+{
+	gs_free char *key = NULL;
+
+	key = g_strdup_printf ("%s/%s", connection_type, ifname);
+	return g_hash_table_lookup (idx, key);
+}
+
+/**
+ * nm_sett_util_autoconnect_cache_set:
+ * @cache: the cache
+ * @generation: the generation for which the cache is built
+ * @list_take: the %NULL terminated list of profiles, sorted by
+ *   autoconnect priority. The cache takes ownership of the array.
+ * @len: the number of profiles in @list_take
+ * @connection_types: the connection type of each profile, or %NULL
+ * @ifnames: the connection.interface-name of each profile, or %NULL
+ *
+ * Replaces the content of @cache. @connection_types and @ifnames
+ * are only used while building the index.
+ */
+void
+nm_sett_util_autoconnect_cache_set (NMSettUtilAutoconnectCache *cache,
+                                    guint generation,
+                                    NMSettingsConnection **list_take,
+                                    guint len,
+                                    const char *const*connection_types,
+                                    const char *const*ifnames)
+{
+	guint i;
+
+	nm_assert (list_take);
+	nm_assert (NM_PTRARRAY_LEN (list_take) == len);
+
+	nm_sett_util_autoconnect_cache_clear (cache);
+
+	cache->generation = generation;
+	cache->list = list_take;
+	cache->idx = g_hash_table_new_full (nm_str_hash,
+	                                    g_str_equal,
+	                                    g_free,
+	                                    (GDestroyNotify) g_array_unref);
+
+	for (i = 0; i < len; i++) {
+		const char *connection_type = connection_types[i] ?: "";
+		const char *ifname = ifnames[i] ?: "";
+
+		/* Each profile is indexed by its type and interface-name, and again by
+		 * interface-name only (with wildcard type "*"). A profile without
+		 * interface-name has ifname "" and is a candidate for every interface. */
+		_autoconnect_cache_idx_add (cache->idx, connection_type, ifname, i);
+		_autoconnect_cache_idx_add (cache->idx, "*", ifname, i);
+	}
+}
+
+/**
+ * nm_sett_util_autoconnect_cache_lookup:
+ * @cache: the cache
+ * @connection_type: (allow-none): if not %NULL, only return profiles
+ *   of this connection type.
+ * @ifname: the interface name of the device.
+ * @out_len: (allow-none): the number of returned profiles.
+ *
+ * Returns: (transfer container): a %NULL terminated array of the profiles
+ *   without interface-name or with interface-name @ifname, in the order
+ *   of the cached list.
+ */
+NMSettingsConnection **
+nm_sett_util_autoconnect_cache_lookup (const NMSettUtilAutoconnectCache *cache,
+                                       const char *connection_type,
+                                       const char *ifname,
+                                       guint *out_len)
+{
+	NMSettingsConnection **list;
+	GArray *positions_iface;
+	GArray *positions_any;
+	guint len_iface;
+	guint len_any;
+	guint i, j, k;
+
+	nm_assert (cache->list);
+	nm_assert (ifname);
+
+	if (!connection_type)
+		connection_type = "*";
+
+	positions_iface = ifname[0]
+	                  ? _autoconnect_cache_idx_lookup (cache->idx, connection_type, ifname)
+	                  : NULL;
+	positions_any = _autoconnect_cache_idx_lookup (cache->idx, connection_type, "");
+
+	len_iface = positions_iface ? positions_iface->len : 0u;
+	len_any = positions_any ? positions_any->len : 0u;
+
+	/* both position lists are ascending. Merge them to keep the
+	 * autoconnect priority order. */
+	list = g_new (NMSettingsConnection *, (gsize) len_iface + len_any + 1);
+	for (i = 0, j = 0, k = 0; i < len_iface || j < len_any; ) {
+		guint pos;
+
+		if (   j >= len_any
+		    || (   i < len_iface
+		        && g_array_index (positions_iface, guint, i) < g_array_index (positions_any, guint, j)))
+			pos = g_array_index (positions_iface, guint, i++);
+		else
+			pos = g_array_index (positions_any, guint, j++);
+		list[k++] = cache->list[pos];
+	}
+	list[k] = NULL;
+
+	NM_SET_OUT (out_len, k);
+	return list;
+}
@@ -93,4 +93,37 @@ typedef struct {
 gboolean nm_sett_util_allow_filename_cb (const char *filename,
                                          gpointer user_data);
 
+/*****************************************************************************/
+
+/* The profiles sorted by autoconnect priority, together with an index of
+ * their positions by connection type and interface name. The cache is
+ * valid as long as the generation it was built for is current. */
+typedef struct {
+	NMSettingsConnection **list;
+	GHashTable *idx;
+	guint generation;
+} NMSettUtilAutoconnectCache;
+
+void nm_sett_util_autoconnect_cache_clear (NMSettUtilAutoconnectCache *cache);
+
+static inline gboolean
+nm_sett_util_autoconnect_cache_is_valid (const NMSettUtilAutoconnectCache *cache,
+                                         guint generation)
+{
+	return    cache->list
+	       && cache->generation == generation;
+}
+
+void nm_sett_util_autoconnect_cache_set (NMSettUtilAutoconnectCache *cache,
+                                         guint generation,
+                                         NMSettingsConnection **list_take,
+                                         guint len,
+                                         const char *const*connection_types,
+                                         const char *const*ifnames);
+
+NMSettingsConnection **nm_sett_util_autoconnect_cache_lookup (const NMSettUtilAutoconnectCache *cache,
+                                                              const char *connection_type,
+                                                              const char *ifname,
+                                                              guint *out_len);
+
 #endif /* __NM_SETTINGS_UTILS_H__ */
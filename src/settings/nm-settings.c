@@ -52,6 +52,7 @@
 #include "devices/nm-device-ethernet.h"
 #include "nm-settings-connection.h"
 #include "nm-settings-plugin.h"
+#include "nm-settings-utils.h"
 #include "nm-dbus-manager.h"
 #include "nm-auth-utils.h"
 #include "nm-libnm-core-intern/nm-auth-subject.h"
@@ -369,6 +370,11 @@ typedef struct {
 
 	NMSettingsConnection **connections_cached_list;
 
+	/* all connections sorted by autoconnect priority, and an index
+	 * of positions in that list by connection type and interface name.
+	 * See nm_settings_get_autoconnect_candidates(). */
+	NMSettUtilAutoconnectCache autoconnect_cache;
+
 	GSList *unmanaged_specs;
 	GSList *unrecognized_specs;
 
@@ -2835,6 +2841,8 @@ impl_settings_reload_connections (NMDBusObject *obj,
 static void
 _clear_connections_cached_list (NMSettingsPrivate *priv)
 {
+	nm_sett_util_autoconnect_cache_clear (&priv->autoconnect_cache);
+
 	if (!priv->connections_cached_list)
 		return;
 
@@ -2874,6 +2882,78 @@ impl_settings_list_connections (NMDBusObject *obj,
 	                                       g_variant_new ("(^ao)", strv));
 }
 
+static void
+_get_all_settings_add (GVariantBuilder *builder,
+                       NMSettingsConnection *sett_conn,
+                       NMAuthSubject *subject)
+{
+	GVariant *settings;
+
+	if (!nm_dbus_object_is_exported (NM_DBUS_OBJECT (sett_conn)))
+		return;
+
+	/* like GetSettings(), silently skip profiles that are not visible
+	 * to the requesting user. */
+	if (!nm_auth_is_subject_in_acl (nm_settings_connection_get_connection (sett_conn),
+	                                subject,
+	                                NULL))
+		return;
+
+	settings = nm_settings_connection_to_dbus_get_settings (sett_conn);
+	if (!settings)
+		return;
+
+	g_variant_builder_add (builder,
+	                       "{o@a{sa{sv}}}",
+	                       nm_dbus_object_get_path (NM_DBUS_OBJECT (sett_conn)),
+	                       settings);
+}
+
+static void
+impl_settings_get_all_settings (NMDBusObject *obj,
+                                const NMDBusInterfaceInfoExtended *interface_info,
+                                const NMDBusMethodInfoExtended *method_info,
+                                GDBusConnection *dbus_connection,
+                                const char *sender,
+                                GDBusMethodInvocation *invocation,
+                                GVariant *parameters)
+{
+	NMSettings *self = NM_SETTINGS (obj);
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	gs_unref_object NMAuthSubject *subject = NULL;
+	gs_free const char **paths = NULL;
+	NMSettingsConnection *sett_conn;
+	GVariantBuilder builder;
+	gsize i;
+
+	g_variant_get (parameters, "(^a&o)", &paths);
+
+	subject = nm_dbus_manager_new_auth_subject_from_context (invocation);
+	if (!subject) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+		                                               NM_SETTINGS_ERROR,
+		                                               NM_SETTINGS_ERROR_PERMISSION_DENIED,
+		                                               NM_UTILS_ERROR_MSG_REQ_UID_UKNOWN);
+		return;
+	}
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
+
+	if (!paths || !paths[0]) {
+		c_list_for_each_entry (sett_conn, &priv->connections_lst_head, _connections_lst)
+			_get_all_settings_add (&builder, sett_conn, subject);
+	} else {
+		for (i = 0; paths[i]; i++) {
+			sett_conn = nm_settings_get_connection_by_path (self, paths[i]);
+			if (sett_conn)
+				_get_all_settings_add (&builder, sett_conn, subject);
+		}
+	}
+
+	g_dbus_method_invocation_return_value (invocation,
+	                                       g_variant_new ("(a{oa{sa{sv}}})", &builder));
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 {
@@ -3050,6 +3130,81 @@ nm_settings_get_connections_clone (NMSettings *self,
 	return list;
 }
 
+static void
+_autoconnect_cache_ensure (NMSettings *self)
+{
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	NMSettingsConnection **list;
+	gs_free const char **connection_types = NULL;
+	gs_free const char **ifnames = NULL;
+	guint generation;
+	guint len;
+	guint i;
+
+	generation = nm_settings_connection_autoconnect_priority_generation ();
+	if (nm_sett_util_autoconnect_cache_is_valid (&priv->autoconnect_cache, generation))
+		return;
+
+	list = nm_settings_get_connections_clone (self,
+	                                          &len,
+	                                          NULL,
+	                                          NULL,
+	                                          nm_settings_connection_cmp_autoconnect_priority_p_with_data,
+	                                          NULL);
+
+	connection_types = g_new (const char *, len + 1);
+	ifnames = g_new (const char *, len + 1);
+	for (i = 0; i < len; i++) {
+		NMConnection *connection = nm_settings_connection_get_connection (list[i]);
+
+		connection_types[i] = nm_connection_get_connection_type (connection);
+		ifnames[i] = nm_connection_get_interface_name (connection);
+	}
+
+	nm_sett_util_autoconnect_cache_set (&priv->autoconnect_cache,
+	                                    generation,
+	                                    list,
+	                                    len,
+	                                    connection_types,
+	                                    ifnames);
+}
+
+/**
+ * nm_settings_get_autoconnect_candidates:
+ * @self: the #NMSettings
+ * @connection_type: (allow-none): if not %NULL, only return profiles
+ *   of this connection type.
+ * @ifname: the interface name of the device.
+ * @out_len: (allow-none): the number of returned profiles.
+ *
+ * Returns the profiles that could possibly be activated on a device with
+ * interface name @ifname, sorted by autoconnect priority (see
+ * nm_settings_connection_cmp_autoconnect_priority()). Profiles which
+ * have a connection.interface-name set that differs from @ifname are
+ * excluded. The sorted list and the index are cached and only rebuilt
+ * after a profile was added, removed or changed.
+ *
+ * Returns: (transfer container): a %NULL terminated array of profiles.
+ *   The caller must free the array with g_free(), the profiles are not
+ *   referenced.
+ */
+NMSettingsConnection **
+nm_settings_get_autoconnect_candidates (NMSettings *self,
+                                        const char *connection_type,
+                                        const char *ifname,
+                                        guint *out_len)
+{
+	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
+	g_return_val_if_fail (ifname, NULL);
+
+	_autoconnect_cache_ensure (self);
+
+	return nm_sett_util_autoconnect_cache_lookup (&NM_SETTINGS_GET_PRIVATE (self)->autoconnect_cache,
+	                                              connection_type,
+	                                              ifname,
+	                                              out_len);
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_path (NMSettings *self, const char *path)
 {
@@ -3943,6 +4098,18 @@ static const NMDBusInterfaceInfoExtended interface_info_settings = {
 				),
 				.handle = impl_settings_get_connection_by_uuid,
 			),
+			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
+				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
+					"GetAllSettings",
+					.in_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("connections", "ao"),
+					),
+					.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("settings", "a{oa{sa{sv}}}"),
+					),
+				),
+				.handle = impl_settings_get_all_settings,
+			),
 			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
 				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
 					"AddConnection",
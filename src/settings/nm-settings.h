@@ -83,6 +83,11 @@ NMSettingsConnection **nm_settings_get_connections_clone (NMSettings *self,
                                                           GCompareDataFunc sort_compare_func,
                                                           gpointer sort_data);
 
+NMSettingsConnection **nm_settings_get_autoconnect_candidates (NMSettings *self,
+                                                               const char *connection_type,
+                                                               const char *ifname,
+                                                               guint *out_len);
+
 gboolean nm_settings_add_connection (NMSettings *settings,
                                      NMConnection *connection,
                                      NMSettingsConnectionPersistMode persist_mode,
@@ -0,0 +1,394 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nms-keyfile-cache.h"
+
+#include "nm-glib-aux/nm-io-utils.h"
+#include "nm-core-internal.h"
+#include "NetworkManagerUtils.h"
+
+#include "nms-keyfile-utils.h"
+
+/*****************************************************************************/
+
+/* The cache stores the already parsed and normalized profiles, so that on the
+ * next start we don't need to parse the keyfiles again. It is a single
+ * serialized GVariant, which we mmap() and access in place.
+ *
+ * An entry is only used if path, mtime, inode and size of the keyfile are
+ * unchanged. Otherwise, the file is parsed again and the cache gets rewritten
+ * after loading all files.
+ *
+ * Whenever the format or the meaning of an entry changes, bump
+ * CACHE_FORMAT_VERSION. */
+
+#define CACHE_MAGIC          "NetworkManager-keyfile-cache"
+#define CACHE_FORMAT_VERSION ((guint32) 1)
+
+/* path, mtime (sec, nsec), inode, size, is-nm-generated, is-volatile, shadowed-owned,
+ * shadowed-storage, connection. */
+#define CACHE_ENTRY_TYPE     "(sxxttiiisa{sa{sv}})"
+
+/* magic, format version, NetworkManager version, profile directory, entries. */
+#define CACHE_TYPE           "(sussa" CACHE_ENTRY_TYPE ")"
+
+#define _NMLOG_PREFIX_NAME      "keyfile"
+#define _NMLOG_DOMAIN           LOGD_SETTINGS
+#define _NMLOG(level, ...) \
+    nm_log ((level), _NMLOG_DOMAIN, NULL, NULL, \
+            "%s" _NM_UTILS_MACRO_FIRST (__VA_ARGS__), \
+            _NMLOG_PREFIX_NAME": cache: " \
+            _NM_UTILS_MACRO_REST (__VA_ARGS__))
+
+/*****************************************************************************/
+
+struct _NMSKeyfileCache {
+	char *filename;
+	char *profile_dir;
+
+	/* profiles below this directory are volatile and never cached,
+	 * because the cache is persisted and they can contain secrets. */
+	char *volatile_dir;
+
+	/* the entries of the loaded cache file (or %NULL), and an index
+	 * from the path to the position in @entries. Both are only read
+	 * after construction and can be accessed from multiple threads. */
+	GVariant *entries;
+	GHashTable *idx;
+
+	/* the entries for the cache file that we are going to write. */
+	GPtrArray *new_entries;
+	bool dirty:1;
+};
+
+/*****************************************************************************/
+
+static gboolean
+_load (NMSKeyfileCache *cache)
+{
+	gs_free_error GError *error = NULL;
+	gs_unref_variant GVariant *root = NULL;
+	gs_unref_bytes GBytes *bytes = NULL;
+	GMappedFile *mapped;
+	const char *magic;
+	const char *version;
+	const char *profile_dir;
+	guint32 format_version;
+	struct stat st;
+	gsize i, n;
+
+	/* the cache contains secrets and is trusted to contain valid profiles.
+	 * Require the same permissions as for keyfiles. */
+	if (stat (cache->filename, &st) != 0)
+		return FALSE;
+	if (!nms_keyfile_utils_check_file_permissions_stat (NMS_KEYFILE_FILETYPE_KEYFILE,
+	                                                    &st,
+	                                                    &error)) {
+		_LOGD ("ignore \"%s\": %s", cache->filename, error->message);
+		return FALSE;
+	}
+
+	mapped = g_mapped_file_new (cache->filename, FALSE, &error);
+	if (!mapped) {
+		_LOGD ("cannot map \"%s\": %s", cache->filename, error->message);
+		return FALSE;
+	}
+	bytes = g_mapped_file_get_bytes (mapped);
+	g_mapped_file_unref (mapped);
+
+	/* the data is not trusted, meaning GVariant will deal with
+	 * malformed input. We validate the content we care about. */
+	root = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (CACHE_TYPE), bytes, FALSE));
+
+	g_variant_get (root, "(&su&s&s@a" CACHE_ENTRY_TYPE ")",
+	               &magic,
+	               &format_version,
+	               &version,
+	               &profile_dir,
+	               &cache->entries);
+
+	if (   !nm_streq (magic, CACHE_MAGIC)
+	    || format_version != CACHE_FORMAT_VERSION
+	    || !nm_streq (version, VERSION)
+	    || !nm_streq (profile_dir, cache->profile_dir)) {
+		_LOGD ("ignore \"%s\": outdated cache", cache->filename);
+		g_clear_pointer (&cache->entries, g_variant_unref);
+		return FALSE;
+	}
+
+	n = g_variant_n_children (cache->entries);
+	cache->idx = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+	for (i = 0; i < n; i++) {
+		gs_unref_variant GVariant *entry = g_variant_get_child_value (cache->entries, i);
+		gs_unref_variant GVariant *v_path = g_variant_get_child_value (entry, 0);
+
+		g_hash_table_insert (cache->idx,
+		                     g_variant_dup_string (v_path, NULL),
+		                     GSIZE_TO_POINTER (i + 1));
+	}
+
+	_LOGD ("loaded \"%s\" with %u entries", cache->filename, g_hash_table_size (cache->idx));
+	return TRUE;
+}
+
+NMSKeyfileCache *
+nms_keyfile_cache_new (const char *filename,
+                       const char *profile_dir,
+                       const char *volatile_dir)
+{
+	NMSKeyfileCache *cache;
+
+	nm_assert (filename && filename[0] == '/');
+	nm_assert (profile_dir && profile_dir[0] == '/');
+	nm_assert (!volatile_dir || volatile_dir[0] == '/');
+
+	cache = g_slice_new (NMSKeyfileCache);
+	*cache = (NMSKeyfileCache) {
+		.filename     = g_strdup (filename),
+		.profile_dir  = g_strdup (profile_dir),
+		.volatile_dir = g_strdup (volatile_dir),
+		.new_entries = g_ptr_array_new_with_free_func ((GDestroyNotify) g_variant_unref),
+	};
+
+	if (!_load (cache))
+		cache->dirty = TRUE;
+	return cache;
+}
+
+void
+nms_keyfile_cache_free (NMSKeyfileCache *cache)
+{
+	if (!cache)
+		return;
+
+	nm_g_variant_unref (cache->entries);
+	if (cache->idx)
+		g_hash_table_unref (cache->idx);
+	g_ptr_array_unref (cache->new_entries);
+	g_free (cache->filename);
+	g_free (cache->profile_dir);
+	g_free (cache->volatile_dir);
+	nm_g_slice_free (cache);
+}
+
+/*****************************************************************************/
+
+static GVariant *
+_lookup_entry (const NMSKeyfileCache *cache,
+               const char *full_filename,
+               const struct stat *st)
+{
+	gs_unref_variant GVariant *entry = NULL;
+	gint64 mtime_sec;
+	gint64 mtime_nsec;
+	guint64 inode;
+	guint64 size;
+	gsize i;
+
+	if (!cache->idx)
+		return NULL;
+
+	if (   cache->volatile_dir
+	    && nm_utils_file_is_in_path (full_filename, cache->volatile_dir))
+		return NULL;
+
+	i = GPOINTER_TO_SIZE (g_hash_table_lookup (cache->idx, full_filename));
+	if (i == 0)
+		return NULL;
+
+	entry = g_variant_get_child_value (cache->entries, i - 1);
+	g_variant_get (entry, "(&sxxttiii&s@a{sa{sv}})",
+	               NULL,
+	               &mtime_sec,
+	               &mtime_nsec,
+	               &inode,
+	               &size,
+	               NULL, NULL, NULL, NULL, NULL);
+
+	if (   mtime_sec  != (gint64) st->st_mtim.tv_sec
+	    || mtime_nsec != (gint64) st->st_mtim.tv_nsec
+	    || inode      != (guint64) st->st_ino
+	    || size       != (guint64) st->st_size)
+		return NULL;
+
+	return g_steal_pointer (&entry);
+}
+
+/**
+ * nms_keyfile_cache_lookup:
+ * @cache: the cache
+ * @full_filename: the keyfile
+ * @st: the current stat of @full_filename
+ * @out_is_nm_generated: (out):
+ * @out_is_volatile: (out):
+ * @out_shadowed_storage: (out) (transfer full):
+ * @out_shadowed_owned: (out):
+ *
+ * Returns the cached profile for @full_filename, like nms_keyfile_reader_from_file()
+ * would. This fails if the cache has no entry for the file, if the file changed
+ * since the entry was written, or if the entry cannot be parsed. In that case,
+ * the caller must read the file itself.
+ *
+ * This function can be called from multiple threads at the same time.
+ *
+ * Returns: (transfer full): the normalized profile or %NULL.
+ */
+NMConnection *
+nms_keyfile_cache_lookup (const NMSKeyfileCache *cache,
+                          const char *full_filename,
+                          const struct stat *st,
+                          NMTernary *out_is_nm_generated,
+                          NMTernary *out_is_volatile,
+                          char **out_shadowed_storage,
+                          NMTernary *out_shadowed_owned)
+{
+	gs_unref_variant GVariant *entry = NULL;
+	gs_unref_variant GVariant *dict = NULL;
+	NMConnection *connection;
+	const char *shadowed_storage;
+	gint32 is_nm_generated;
+	gint32 is_volatile;
+	gint32 shadowed_owned;
+
+	entry = _lookup_entry (cache, full_filename, st);
+	if (!entry)
+		return NULL;
+
+	g_variant_get (entry, "(&sxxttiii&s@a{sa{sv}})",
+	               NULL, NULL, NULL, NULL, NULL,
+	               &is_nm_generated,
+	               &is_volatile,
+	               &shadowed_owned,
+	               &shadowed_storage,
+	               &dict);
+
+	/* the cached profile is already normalized. Still, verify it, so that
+	 * a bogus entry results in parsing the file instead of a broken profile. */
+	connection = _nm_simple_connection_new_from_dbus (dict,
+	                                                  NM_SETTING_PARSE_FLAGS_STRICT
+	                                                  | NM_SETTING_PARSE_FLAGS_NORMALIZE,
+	                                                  NULL);
+	if (!connection)
+		return NULL;
+
+	NM_SET_OUT (out_is_nm_generated, NM_CLAMP (is_nm_generated, NM_TERNARY_DEFAULT, NM_TERNARY_TRUE));
+	NM_SET_OUT (out_is_volatile, NM_CLAMP (is_volatile, NM_TERNARY_DEFAULT, NM_TERNARY_TRUE));
+	NM_SET_OUT (out_shadowed_storage, shadowed_storage[0] ? g_strdup (shadowed_storage) : NULL);
+	NM_SET_OUT (out_shadowed_owned, NM_CLAMP (shadowed_owned, NM_TERNARY_DEFAULT, NM_TERNARY_TRUE));
+	return connection;
+}
+
+/**
+ * nms_keyfile_cache_add:
+ * @cache: the cache
+ * @full_filename: the keyfile
+ * @connection: the profile as returned by nms_keyfile_reader_from_file()
+ *   or nms_keyfile_cache_lookup().
+ * @st: the stat of @full_filename at the time it was read.
+ * @is_nm_generated:
+ * @is_volatile:
+ * @shadowed_storage:
+ * @shadowed_owned:
+ * @from_cache: whether @connection was returned by nms_keyfile_cache_lookup().
+ *
+ * Record the profile for the cache file that nms_keyfile_cache_commit() writes.
+ * Profiles below the volatile directory of the cache are ignored.
+ * Must be called on the main thread, after all lookups are done.
+ */
+void
+nms_keyfile_cache_add (NMSKeyfileCache *cache,
+                       const char *full_filename,
+                       NMConnection *connection,
+                       const struct stat *st,
+                       NMTernary is_nm_generated,
+                       NMTernary is_volatile,
+                       const char *shadowed_storage,
+                       NMTernary shadowed_owned,
+                       gboolean from_cache)
+{
+	GVariant *entry;
+
+	nm_assert (cache);
+	nm_assert (full_filename && full_filename[0] == '/');
+	nm_assert (NM_IS_CONNECTION (connection));
+
+	if (   cache->volatile_dir
+	    && nm_utils_file_is_in_path (full_filename, cache->volatile_dir))
+		return;
+
+	if (from_cache) {
+		entry = _lookup_entry (cache, full_filename, st);
+		if (entry) {
+			g_ptr_array_add (cache->new_entries, entry);
+			return;
+		}
+	}
+
+	cache->dirty = TRUE;
+
+	/* a file modified within the last second might be modified again without
+	 * changing mtime or size. Don't cache it yet, the next load will. */
+	if (st->st_mtim.tv_sec >= (time (NULL) - 1))
+		return;
+
+	entry = g_variant_new ("(sxxttiiis@a{sa{sv}})",
+	                       full_filename,
+	                       (gint64) st->st_mtim.tv_sec,
+	                       (gint64) st->st_mtim.tv_nsec,
+	                       (guint64) st->st_ino,
+	                       (guint64) st->st_size,
+	                       (gint32) is_nm_generated,
+	                       (gint32) is_volatile,
+	                       (gint32) shadowed_owned,
+	                       shadowed_storage ?: "",
+	                       nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL));
+	g_ptr_array_add (cache->new_entries, g_variant_ref_sink (entry));
+}
+
+/**
+ * nms_keyfile_cache_commit:
+ * @cache: the cache
+ * @error: (allow-none): the error
+ *
+ * Writes the entries added with nms_keyfile_cache_add() to the cache file,
+ * unless they are identical to the loaded cache.
+ *
+ * Returns: %FALSE if writing the cache failed.
+ */
+gboolean
+nms_keyfile_cache_commit (NMSKeyfileCache *cache,
+                          GError **error)
+{
+	gs_unref_variant GVariant *root = NULL;
+	GVariant *entries;
+
+	if (   !cache->dirty
+	    && cache->new_entries->len == (cache->idx ? g_hash_table_size (cache->idx) : 0u))
+		return TRUE;
+
+	entries = g_variant_new_array (G_VARIANT_TYPE (CACHE_ENTRY_TYPE),
+	                               (GVariant *const*) cache->new_entries->pdata,
+	                               cache->new_entries->len);
+	root = g_variant_ref_sink (g_variant_new ("(suss@a" CACHE_ENTRY_TYPE ")",
+	                                          CACHE_MAGIC,
+	                                          CACHE_FORMAT_VERSION,
+	                                          VERSION,
+	                                          cache->profile_dir,
+	                                          entries));
+
+	if (!nm_utils_file_set_contents (cache->filename,
+	                                 g_variant_get_data (root),
+	                                 g_variant_get_size (root),
+	                                 0600,
+	                                 NULL,
+	                                 error))
+		return FALSE;
+
+	_LOGD ("wrote \"%s\" with %u entries", cache->filename, cache->new_entries->len);
+	cache->dirty = FALSE;
+	return TRUE;
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#ifndef __NMS_KEYFILE_CACHE_H__
+#define __NMS_KEYFILE_CACHE_H__
+
+#include <sys/stat.h>
+
+#include "nm-connection.h"
+
+#define NMS_KEYFILE_CACHE_FILE NMSTATEDIR "/keyfile-cache"
+
+typedef struct _NMSKeyfileCache NMSKeyfileCache;
+
+NMSKeyfileCache *nms_keyfile_cache_new (const char *filename,
+                                        const char *profile_dir,
+                                        const char *volatile_dir);
+
+void nms_keyfile_cache_free (NMSKeyfileCache *cache);
+
+NM_AUTO_DEFINE_FCN0 (NMSKeyfileCache *, _nm_auto_free_keyfile_cache, nms_keyfile_cache_free);
+#define nm_auto_free_keyfile_cache nm_auto (_nm_auto_free_keyfile_cache)
+
+NMConnection *nms_keyfile_cache_lookup (const NMSKeyfileCache *cache,
+                                        const char *full_filename,
+                                        const struct stat *st,
+                                        NMTernary *out_is_nm_generated,
+                                        NMTernary *out_is_volatile,
+                                        char **out_shadowed_storage,
+                                        NMTernary *out_shadowed_owned);
+
+void nms_keyfile_cache_add (NMSKeyfileCache *cache,
+                            const char *full_filename,
+                            NMConnection *connection,
+                            const struct stat *st,
+                            NMTernary is_nm_generated,
+                            NMTernary is_volatile,
+                            const char *shadowed_storage,
+                            NMTernary shadowed_owned,
+                            gboolean from_cache);
+
+gboolean nms_keyfile_cache_commit (NMSKeyfileCache *cache,
+                                   GError **error);
+
+#endif /* __NMS_KEYFILE_CACHE_H__ */
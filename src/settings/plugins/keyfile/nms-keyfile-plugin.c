@@ -31,6 +31,7 @@
 #include "settings/nm-settings-storage.h"
 #include "settings/nm-settings-utils.h"
 
+#include "nms-keyfile-cache.h"
 #include "nms-keyfile-storage.h"
 #include "nms-keyfile-writer.h"
 #include "nms-keyfile-reader.h"
@@ -196,37 +197,6 @@ _path_detect_storage_type (const char *full_filename,
 
 /*****************************************************************************/
 
-static NMConnection *
-_read_from_file (const char *full_filename,
-                 const char *plugin_dir,
-                 struct stat *out_stat,
-                 NMTernary *out_is_nm_generated,
-                 NMTernary *out_is_volatile,
-                 char **out_shadowed_storage,
-                 NMTernary *out_shadowed_owned,
-                 GError **error)
-{
-	NMConnection *connection;
-
-	nm_assert (full_filename && full_filename[0] == '/');
-
-	connection = nms_keyfile_reader_from_file (full_filename,
-	                                           plugin_dir,
-	                                           out_stat,
-	                                           out_is_nm_generated,
-	                                           out_is_volatile,
-	                                           out_shadowed_storage,
-	                                           out_shadowed_owned,
-	                                           error);
-
-	nm_assert (!connection || (_nm_connection_verify (connection, NULL) == NM_SETTING_VERIFY_SUCCESS));
-	nm_assert (!connection || nm_utils_is_uuid (nm_connection_get_uuid (connection)));
-
-	return connection;
-}
-
-/*****************************************************************************/
-
 static void
 _nm_assert_storage (gpointer plugin  /* NMSKeyfilePlugin  */,
                     gpointer storage /* NMSKeyfileStorage */,
@@ -276,100 +246,117 @@ _nm_assert_storage (gpointer plugin  /* NMSKeyfilePlugin  */,
 /*****************************************************************************/
 
 static NMSKeyfileStorage *
-_load_file (NMSKeyfilePlugin *self,
-            const char *dirname,
-            const char *filename,
-            NMSKeyfileStorageType storage_type,
-            GError **error)
+_load_file_nmmeta (NMSKeyfilePlugin *self,
+                   const char *dirname,
+                   const char *filename,
+                   NMSKeyfileStorageType storage_type,
+                   GError **error)
 {
-	NMSKeyfilePluginPrivate *priv;
-	gs_unref_object NMConnection *connection = NULL;
-	NMTernary is_volatile_opt;
-	NMTernary is_nm_generated_opt;
-	NMTernary shadowed_owned_opt;
-	gs_free char *shadowed_storage = NULL;
-	gs_free_error GError *local = NULL;
 	gs_free char *full_filename = NULL;
-	struct stat st;
+	gs_free char *nmmeta = NULL;
+	gs_free char *loaded_path = NULL;
+	gs_free char *shadowed_storage_filename = NULL;
 
-	if (_ignore_filename (storage_type, filename)) {
-		gs_free char *nmmeta = NULL;
-		gs_free char *loaded_path = NULL;
-		gs_free char *shadowed_storage_filename = NULL;
-
-		if (!nms_keyfile_nmmeta_check_filename (filename, NULL)) {
-			if (error)
-				nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip due to invalid filename");
-			else
-				_LOGT ("load: \"%s/%s\": skip file due to invalid filename", dirname, filename);
-			return NULL;
-		}
-		if (!nms_keyfile_nmmeta_read (dirname,
-		                              filename,
-		                              &full_filename,
-		                              &nmmeta,
-		                              &loaded_path,
-		                              &shadowed_storage_filename,
-		                              NULL)) {
-			if (error)
-				nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip unreadable nmmeta file");
-			else
-				_LOGT ("load: \"%s/%s\": skip unreadable nmmeta file", dirname, filename);
-			return NULL;
-		}
-		nm_assert (loaded_path);
-		if (!NM_IN_SET (storage_type, NMS_KEYFILE_STORAGE_TYPE_RUN,
-		                              NMS_KEYFILE_STORAGE_TYPE_ETC)) {
-			if (error)
-				nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip nmmeta file from read-only directory");
-			else
-				_LOGT ("load: \"%s/%s\": skip nmmeta file from read-only directory", dirname, filename);
-			return NULL;
-		}
-		if (!nm_streq (loaded_path, NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL)) {
-			if (error)
-				nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip nmmeta file not symlinking %s", NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
-			else
-				_LOGT ("load: \"%s/%s\": skip nmmeta file not symlinking to %s", dirname, filename, NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
-			return NULL;
-		}
-
-		return nms_keyfile_storage_new_tombstone (self,
-		                                          nmmeta,
-		                                          full_filename,
-		                                          storage_type,
-		                                          shadowed_storage_filename);
+	if (!nms_keyfile_nmmeta_check_filename (filename, NULL)) {
+		if (error)
+			nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip due to invalid filename");
+		else
+			_LOGT ("load: \"%s/%s\": skip file due to invalid filename", dirname, filename);
+		return NULL;
+	}
+	if (!nms_keyfile_nmmeta_read (dirname,
+	                              filename,
+	                              &full_filename,
+	                              &nmmeta,
+	                              &loaded_path,
+	                              &shadowed_storage_filename,
+	                              NULL)) {
+		if (error)
+			nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip unreadable nmmeta file");
+		else
+			_LOGT ("load: \"%s/%s\": skip unreadable nmmeta file", dirname, filename);
+		return NULL;
+	}
+	nm_assert (loaded_path);
+	if (!NM_IN_SET (storage_type, NMS_KEYFILE_STORAGE_TYPE_RUN,
+	                              NMS_KEYFILE_STORAGE_TYPE_ETC)) {
+		if (error)
+			nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip nmmeta file from read-only directory");
+		else
+			_LOGT ("load: \"%s/%s\": skip nmmeta file from read-only directory", dirname, filename);
+		return NULL;
+	}
+	if (!nm_streq (loaded_path, NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL)) {
+		if (error)
+			nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN, "skip nmmeta file not symlinking %s", NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
+		else
+			_LOGT ("load: \"%s/%s\": skip nmmeta file not symlinking to %s", dirname, filename, NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
+		return NULL;
 	}
 
-	full_filename = g_build_filename (dirname, filename, NULL);
-
-	priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	return nms_keyfile_storage_new_tombstone (self,
+	                                          nmmeta,
+	                                          full_filename,
+	                                          storage_type,
+	                                          shadowed_storage_filename);
+}
 
-	connection = _read_from_file (full_filename,
-	                              _get_plugin_dir (priv),
-	                              &st,
-	                              &is_nm_generated_opt,
-	                              &is_volatile_opt,
-	                              &shadowed_storage,
-	                              &shadowed_owned_opt,
-	                              &local);
-	if (!connection) {
+static NMSKeyfileStorage *
+_load_file_finish (NMSKeyfilePlugin *self,
+                   NMSKeyfileReaderFileData *file_data,
+                   NMSKeyfileStorageType storage_type,
+                   GError **error)
+{
+	if (!file_data->connection) {
+		nm_assert (file_data->error);
 		if (error)
-			g_propagate_error (error, g_steal_pointer (&local));
+			g_propagate_error (error, g_steal_pointer (&file_data->error));
 		else
-			_LOGW ("load: \"%s\": failed to load connection: %s", full_filename, local->message);
+			_LOGW ("load: \"%s\": failed to load connection: %s", file_data->full_filename, file_data->error->message);
 		return NULL;
 	}
 
+	nm_assert (_nm_connection_verify (file_data->connection, NULL) == NM_SETTING_VERIFY_SUCCESS);
+	nm_assert (nm_utils_is_uuid (nm_connection_get_uuid (file_data->connection)));
+
 	return nms_keyfile_storage_new_connection (self,
-	                                           g_steal_pointer (&connection),
-	                                           full_filename,
+	                                           g_steal_pointer (&file_data->connection),
+	                                           file_data->full_filename,
 	                                           storage_type,
-	                                           is_nm_generated_opt,
-	                                           is_volatile_opt,
-	                                           shadowed_storage,
-	                                           shadowed_owned_opt,
-	                                           &st.st_mtim);
+	                                           file_data->is_nm_generated,
+	                                           file_data->is_volatile,
+	                                           file_data->shadowed_storage,
+	                                           file_data->shadowed_owned,
+	                                           &file_data->st.st_mtim);
+}
+
+static NMSKeyfileStorage *
+_load_file (NMSKeyfilePlugin *self,
+            const char *dirname,
+            const char *filename,
+            NMSKeyfileStorageType storage_type,
+            GError **error)
+{
+	gs_free char *full_filename = NULL;
+	NMSKeyfileReaderFileData file_data;
+	NMSKeyfileStorage *storage;
+
+	if (_ignore_filename (storage_type, filename))
+		return _load_file_nmmeta (self, dirname, filename, storage_type, error);
+
+	full_filename = g_build_filename (dirname, filename, NULL);
+
+	file_data = (NMSKeyfileReaderFileData) {
+		.full_filename = full_filename,
+	};
+	nms_keyfile_reader_from_files (&file_data,
+	                               1,
+	                               _get_plugin_dir (NMS_KEYFILE_PLUGIN_GET_PRIVATE (self)),
+	                               NULL,
+	                               1);
+	storage = _load_file_finish (self, &file_data, storage_type, error);
+	nms_keyfile_reader_file_data_clear (&file_data);
+	return storage;
 }
 
 static NMSKeyfileStorage *
@@ -398,37 +385,91 @@ static void
 _load_dir (NMSKeyfilePlugin *self,
            NMSKeyfileStorageType storage_type,
            const char *dirname,
+           NMSKeyfileCache *cache,
            NMSettUtilStorages *storages)
 {
 	const char *filename;
 	GDir *dir;
 	gs_unref_hashtable GHashTable *dupl_filenames = NULL;
+	gs_unref_ptrarray GPtrArray *filenames = NULL;
+	gs_free NMSKeyfileReaderFileData *files = NULL;
+	guint n_files;
+	guint i_file;
+	guint i;
 
 	dir = g_dir_open (dirname, 0, NULL);
 	if (!dir)
 		return;
 
 	dupl_filenames = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, g_free);
+	filenames = g_ptr_array_new ();
 
 	while ((filename = g_dir_read_name (dir))) {
-		gs_unref_object NMSKeyfileStorage *storage = NULL;
-
 		filename = g_strdup (filename);
 		if (!g_hash_table_add (dupl_filenames, (char *) filename))
 			continue;
+		g_ptr_array_add (filenames, (char *) filename);
+	}
 
-		storage = _load_file (self,
-		                      dirname,
-		                      filename,
-		                      storage_type,
-		                      NULL);
+	g_dir_close (dir);
+
+	/* the order in which readdir() returns the files is arbitrary. Process them
+	 * sorted by name, so that the storages end up in a deterministic order. */
+	g_ptr_array_sort (filenames, nm_strcmp_p);
+
+	/* reading, parsing and normalizing the keyfiles is the expensive part
+	 * and independent from each other. Do it for all files at once on a
+	 * thread pool, and only create the storages afterwards, here on the
+	 * main thread. */
+	files = g_new (NMSKeyfileReaderFileData, filenames->len);
+	n_files = 0;
+	for (i = 0; i < filenames->len; i++) {
+		filename = filenames->pdata[i];
+		if (_ignore_filename (storage_type, filename))
+			continue;
+		files[n_files++] = (NMSKeyfileReaderFileData) {
+			.full_filename = g_build_filename (dirname, filename, NULL),
+		};
+	}
+
+	nms_keyfile_reader_from_files (files,
+	                               n_files,
+	                               _get_plugin_dir (NMS_KEYFILE_PLUGIN_GET_PRIVATE (self)),
+	                               cache,
+	                               0);
+
+	i_file = 0;
+	for (i = 0; i < filenames->len; i++) {
+		gs_unref_object NMSKeyfileStorage *storage = NULL;
+
+		filename = filenames->pdata[i];
+		if (_ignore_filename (storage_type, filename))
+			storage = _load_file_nmmeta (self, dirname, filename, storage_type, NULL);
+		else {
+			NMSKeyfileReaderFileData *file_data = &files[i_file++];
+
+			if (   cache
+			    && file_data->connection) {
+				nms_keyfile_cache_add (cache,
+				                       file_data->full_filename,
+				                       file_data->connection,
+				                       &file_data->st,
+				                       file_data->is_nm_generated,
+				                       file_data->is_volatile,
+				                       file_data->shadowed_storage,
+				                       file_data->shadowed_owned,
+				                       file_data->from_cache);
+			}
+			storage = _load_file_finish (self, file_data, storage_type, NULL);
+			nms_keyfile_reader_file_data_clear (file_data);
+			g_free ((char *) file_data->full_filename);
+		}
 		if (!storage)
 			continue;
 
 		nm_sett_util_storages_add_take (storages, g_steal_pointer (&storage));
 	}
-
-	g_dir_close (dir);
+	nm_assert (i_file == n_files);
 
 #if NM_MORE_ASSERTS
 	{
@@ -554,13 +595,27 @@ reload_connections (NMSettingsPlugin *plugin,
 	NMSKeyfilePlugin *self = NMS_KEYFILE_PLUGIN (plugin);
 	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
 	nm_auto_clear_sett_util_storages NMSettUtilStorages storages_new = NM_SETT_UTIL_STORAGES_INIT (storages_new, nms_keyfile_storage_destroy);
+	nm_auto_free_keyfile_cache NMSKeyfileCache *cache = NULL;
+	gs_free_error GError *error = NULL;
 	int i;
 
-	_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_RUN, priv->dirname_run, &storages_new);
+	if (nm_config_data_get_value_boolean (nm_config_get_data (priv->config),
+	                                      NM_CONFIG_KEYFILE_GROUP_KEYFILE,
+	                                      NM_CONFIG_KEYFILE_KEY_KEYFILE_CACHE,
+	                                      TRUE))
+		cache = nms_keyfile_cache_new (NMS_KEYFILE_CACHE_FILE, _get_plugin_dir (priv), priv->dirname_run);
+
+	/* the cache is persisted under /var/lib. Profiles in /run (and their
+	 * secrets) must not end up there. */
+	_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_RUN, priv->dirname_run, NULL, &storages_new);
 	if (priv->dirname_etc)
-		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_ETC, priv->dirname_etc, &storages_new);
+		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_ETC, priv->dirname_etc, cache, &storages_new);
 	for (i = 0; priv->dirname_libs[i]; i++)
-		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_LIB (i), priv->dirname_libs[i], &storages_new);
+		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_LIB (i), priv->dirname_libs[i], cache, &storages_new);
+
+	if (   cache
+	    && !nms_keyfile_cache_commit (cache, &error))
+		_LOGD ("failed to write cache \"%s\": %s", NMS_KEYFILE_CACHE_FILE, error->message);
 
 	_storages_consolidate (self,
 	                       &storages_new,
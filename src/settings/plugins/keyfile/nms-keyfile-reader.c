@@ -16,6 +16,14 @@
 
 /*****************************************************************************/
 
+/* NOTE: nms_keyfile_reader_from_file() is called from worker threads by
+ * nms_keyfile_reader_from_files(). Hence, we require locking from nm-logging.
+ * Indicate that by setting NM_THREAD_SAFE_ON_MAIN_THREAD to zero. */
+#undef NM_THREAD_SAFE_ON_MAIN_THREAD
+#define NM_THREAD_SAFE_ON_MAIN_THREAD 0
+
+/*****************************************************************************/
+
 static const char *
 _fmt_warn (const char *group, NMSetting *setting, const char *property_name, const char *message, char **out_message)
 {
@@ -211,3 +219,120 @@ nms_keyfile_reader_from_file (const char *full_filename,
 	return connection;
 }
 
+/*****************************************************************************/
+
+/* Below this many files, spawning worker threads costs more than it saves. */
+#define FROM_FILES_PARALLEL_THRESHOLD 32u
+
+void
+nms_keyfile_reader_file_data_clear (NMSKeyfileReaderFileData *file_data)
+{
+	g_clear_object (&file_data->connection);
+	g_clear_error (&file_data->error);
+	nm_clear_g_free (&file_data->shadowed_storage);
+}
+
+typedef struct {
+	const char *profile_dir;
+	const NMSKeyfileCache *cache;
+} FromFilesData;
+
+static void
+_from_files_read (NMSKeyfileReaderFileData *file_data,
+                  const FromFilesData *data)
+{
+	const char *profile_dir = data->profile_dir;
+
+	nm_assert (!file_data->connection);
+	nm_assert (!file_data->error);
+
+	if (   data->cache
+	    && nms_keyfile_utils_check_file_permissions (NMS_KEYFILE_FILETYPE_KEYFILE,
+	                                                 file_data->full_filename,
+	                                                 &file_data->st,
+	                                                 NULL)) {
+		file_data->connection = nms_keyfile_cache_lookup (data->cache,
+		                                                  file_data->full_filename,
+		                                                  &file_data->st,
+		                                                  &file_data->is_nm_generated,
+		                                                  &file_data->is_volatile,
+		                                                  &file_data->shadowed_storage,
+		                                                  &file_data->shadowed_owned);
+		if (file_data->connection) {
+			file_data->from_cache = TRUE;
+			return;
+		}
+	}
+
+	file_data->connection = nms_keyfile_reader_from_file (file_data->full_filename,
+	                                                      profile_dir,
+	                                                      &file_data->st,
+	                                                      &file_data->is_nm_generated,
+	                                                      &file_data->is_volatile,
+	                                                      &file_data->shadowed_storage,
+	                                                      &file_data->shadowed_owned,
+	                                                      &file_data->error);
+	nm_assert ((!!file_data->connection) != (!!file_data->error));
+}
+
+static void
+_from_files_thread_fcn (gpointer data, gpointer user_data)
+{
+	_from_files_read (data, user_data);
+}
+
+/**
+ * nms_keyfile_reader_from_files:
+ * @files: the array of files to read.
+ * @n_files: the number of entries in @files.
+ * @profile_dir: the profile directory, as for nms_keyfile_reader_from_file().
+ * @cache: (allow-none): if given, take the profiles from the cache when
+ *   the file did not change since the cache was written.
+ * @max_threads: the maximum number of worker threads. If zero, this
+ *   is chosen based on the number of available CPUs. If one, the files
+ *   are read sequentially on the calling thread.
+ *
+ * Reads, parses and normalizes all files in @files, filling the output
+ * fields of each entry. Reading the files is independent from each other
+ * and does not touch any global state, so this is done in parallel on a
+ * thread pool. The function only returns after all files were processed,
+ * so the caller can process the results in the order of @files.
+ */
+void
+nms_keyfile_reader_from_files (NMSKeyfileReaderFileData *files,
+                               guint n_files,
+                               const char *profile_dir,
+                               const NMSKeyfileCache *cache,
+                               guint max_threads)
+{
+	const FromFilesData data = {
+		.profile_dir = profile_dir,
+		.cache       = cache,
+	};
+	GThreadPool *pool;
+	guint i;
+
+	nm_assert (files || n_files == 0);
+
+	if (max_threads == 0)
+		max_threads = NM_MIN (g_get_num_processors (), 8u);
+	max_threads = NM_MIN (max_threads, n_files / (FROM_FILES_PARALLEL_THRESHOLD / 2u));
+
+	if (   n_files < FROM_FILES_PARALLEL_THRESHOLD
+	    || max_threads <= 1) {
+		for (i = 0; i < n_files; i++)
+			_from_files_read (&files[i], &data);
+		return;
+	}
+
+	pool = g_thread_pool_new (_from_files_thread_fcn,
+	                          (gpointer) &data,
+	                          max_threads,
+	                          FALSE,
+	                          NULL);
+	for (i = 0; i < n_files; i++)
+		g_thread_pool_push (pool, &files[i], NULL);
+
+	/* wait for all queued files to be processed. */
+	g_thread_pool_free (pool, FALSE, TRUE);
+}
@@ -7,8 +7,12 @@
 #ifndef __NMS_KEYFILE_READER_H__
 #define __NMS_KEYFILE_READER_H__
 
+#include <sys/stat.h>
+
 #include "nm-connection.h"
 
+#include "nms-keyfile-cache.h"
+
 NMConnection *nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
                                                const char *filename,
                                                const char *base_dir,
@@ -16,8 +20,6 @@ NMConnection *nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
                                                gboolean verbose,
                                                GError **error);
 
-struct stat;
-
 NMConnection *nms_keyfile_reader_from_file (const char *full_filename,
                                             const char *profile_dir,
                                             struct stat *out_stat,
@@ -27,4 +29,30 @@ NMConnection *nms_keyfile_reader_from_file (const char *full_filename,
                                             NMTernary *out_shadowed_owned,
                                             GError **error);
 
+typedef struct {
+	/* in: the absolute path of the file to read. */
+	const char *full_filename;
+
+	/* out: the result of nms_keyfile_reader_from_file(). Either @connection
+	 * or @error is set. */
+	NMConnection *connection;
+	GError *error;
+	char *shadowed_storage;
+	struct stat st;
+	NMTernary is_nm_generated;
+	NMTernary is_volatile;
+	NMTernary shadowed_owned;
+
+	/* out: whether @connection was taken from the cache. */
+	bool from_cache:1;
+} NMSKeyfileReaderFileData;
+
+void nms_keyfile_reader_file_data_clear (NMSKeyfileReaderFileData *file_data);
+
+void nms_keyfile_reader_from_files (NMSKeyfileReaderFileData *files,
+                                    guint n_files,
+                                    const char *profile_dir,
+                                    const NMSKeyfileCache *cache,
+                                    guint max_threads);
+
 #endif /* __NMS_KEYFILE_READER_H__ */
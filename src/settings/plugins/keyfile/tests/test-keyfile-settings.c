@@ -12,6 +12,8 @@
 #include <arpa/inet.h>
 #include <sys/socket.h>
 #include <linux/pkt_sched.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 #include "nm-core-internal.h"
 
@@ -2599,6 +2601,255 @@ test_nmmeta (void)
 
 /*****************************************************************************/
 
+static gboolean
+_read_from_files_perf_is_invalid (guint i)
+{
+	return (i % 97 == 13);
+}
+
+static void
+_read_from_files_perf_check (NMSKeyfileReaderFileData *files,
+                             NMSKeyfileReaderFileData *files_exp,
+                             guint n_files,
+                             gboolean exp_from_cache)
+{
+	guint i;
+
+	for (i = 0; i < n_files; i++) {
+		if (_read_from_files_perf_is_invalid (i)) {
+			g_assert (!files[i].connection);
+			g_assert (files[i].error);
+			g_assert (!files[i].from_cache);
+		} else {
+			gs_free char *id = g_strdup_printf ("perf-%u", i);
+
+			g_assert (NM_IS_CONNECTION (files[i].connection));
+			g_assert_cmpstr (nm_connection_get_id (files[i].connection), ==, id);
+			g_assert_cmpint (files[i].from_cache, ==, exp_from_cache);
+			if (files_exp)
+				nmtst_assert_connection_equals (files_exp[i].connection, FALSE, files[i].connection, FALSE);
+		}
+	}
+}
+
+static void
+_read_from_files_perf (guint n_files)
+{
+	gs_free char *dirname = g_strdup_printf ("%s/perf-%u", TEST_SCRATCH_DIR, n_files);
+	gs_free char *cache_filename = g_strdup_printf ("%s/perf-%u.cache", TEST_SCRATCH_DIR, n_files);
+	gs_strfreev char **full_filenames = g_new0 (char *, n_files + 1);
+	gs_free NMSKeyfileReaderFileData *files_seq = g_new0 (NMSKeyfileReaderFileData, n_files);
+	gs_free NMSKeyfileReaderFileData *files_par = g_new0 (NMSKeyfileReaderFileData, n_files);
+	gs_free NMSKeyfileReaderFileData *files_miss = g_new0 (NMSKeyfileReaderFileData, n_files);
+	gs_free NMSKeyfileReaderFileData *files_hit = g_new0 (NMSKeyfileReaderFileData, n_files);
+	NMSKeyfileCache *cache;
+	gint64 t_start;
+	guint i;
+
+	g_assert_cmpint (g_mkdir_with_parents (dirname, 0755), ==, 0);
+	(void) unlink (cache_filename);
+
+	for (i = 0; i < n_files; i++) {
+		gs_free_error GError *error = NULL;
+		gs_free char *contents = NULL;
+		const struct timespec times[2] = {
+			{ .tv_sec = 1500000000, .tv_nsec = i, },
+			{ .tv_sec = 1500000000, .tv_nsec = i, },
+		};
+
+		full_filenames[i] = g_strdup_printf ("%s/perf-%06u.nmconnection", dirname, i);
+
+		if (_read_from_files_perf_is_invalid (i)) {
+			/* sprinkle some invalid files in, to check that the results stay
+			 * associated with the right file. */
+			contents = g_strdup ("not a keyfile\n");
+		} else {
+			contents = g_strdup_printf ("[connection]\n"
+			                            "id=perf-%u\n"
+			                            "type=ethernet\n"
+			                            "interface-name=eth%u\n"
+			                            "\n"
+			                            "[ethernet]\n"
+			                            "mac-address=02:00:00:%02X:%02X:%02X\n"
+			                            "\n"
+			                            "[ipv4]\n"
+			                            "method=manual\n"
+			                            "address1=10.%u.%u.1/24,10.%u.%u.254\n"
+			                            "dns=192.168.0.1;\n"
+			                            "\n"
+			                            "[ipv6]\n"
+			                            "method=auto\n",
+			                            i, i % 1000,
+			                            (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF,
+			                            (i >> 8) & 0xFF, i & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+		}
+		if (!g_file_set_contents (full_filenames[i], contents, -1, &error))
+			g_error ("failure to write \"%s\": %s", full_filenames[i], error->message);
+
+		/* the cache skips files that were modified just now. Pretend the
+		 * files are old. */
+		g_assert_cmpint (utimensat (AT_FDCWD, full_filenames[i], times, 0), ==, 0);
+
+		files_seq[i].full_filename = full_filenames[i];
+		files_par[i].full_filename = full_filenames[i];
+		files_miss[i].full_filename = full_filenames[i];
+		files_hit[i].full_filename = full_filenames[i];
+	}
+
+	t_start = g_get_monotonic_time ();
+	nms_keyfile_reader_from_files (files_seq, n_files, dirname, NULL, 1);
+	g_test_message ("read %u keyfiles sequentially: %.3f msec",
+	                n_files, (g_get_monotonic_time () - t_start) / 1000.0);
+	_read_from_files_perf_check (files_seq, NULL, n_files, FALSE);
+
+	t_start = g_get_monotonic_time ();
+	nms_keyfile_reader_from_files (files_par, n_files, dirname, NULL, 0);
+	g_test_message ("read %u keyfiles on %u CPUs: %.3f msec",
+	                n_files, g_get_num_processors (),
+	                (g_get_monotonic_time () - t_start) / 1000.0);
+	_read_from_files_perf_check (files_par, files_seq, n_files, FALSE);
+
+	/* the cache file does not exist yet. All files are parsed, and
+	 * the result gets written to the cache. */
+	t_start = g_get_monotonic_time ();
+	cache = nms_keyfile_cache_new (cache_filename, dirname, NULL);
+	nms_keyfile_reader_from_files (files_miss, n_files, dirname, cache, 0);
+	for (i = 0; i < n_files; i++) {
+		if (!files_miss[i].connection)
+			continue;
+		nms_keyfile_cache_add (cache,
+		                       files_miss[i].full_filename,
+		                       files_miss[i].connection,
+		                       &files_miss[i].st,
+		                       files_miss[i].is_nm_generated,
+		                       files_miss[i].is_volatile,
+		                       files_miss[i].shadowed_storage,
+		                       files_miss[i].shadowed_owned,
+		                       files_miss[i].from_cache);
+	}
+	g_assert (nms_keyfile_cache_commit (cache, NULL));
+	nms_keyfile_cache_free (cache);
+	g_test_message ("read %u keyfiles and write cache: %.3f msec",
+	                n_files, (g_get_monotonic_time () - t_start) / 1000.0);
+	_read_from_files_perf_check (files_miss, files_seq, n_files, FALSE);
+
+	/* now all valid profiles come from the cache. */
+	t_start = g_get_monotonic_time ();
+	cache = nms_keyfile_cache_new (cache_filename, dirname, NULL);
+	nms_keyfile_reader_from_files (files_hit, n_files, dirname, cache, 0);
+	nms_keyfile_cache_free (cache);
+	g_test_message ("read %u keyfiles from cache: %.3f msec",
+	                n_files, (g_get_monotonic_time () - t_start) / 1000.0);
+	_read_from_files_perf_check (files_hit, files_seq, n_files, TRUE);
+
+	for (i = 0; i < n_files; i++) {
+		nms_keyfile_reader_file_data_clear (&files_seq[i]);
+		nms_keyfile_reader_file_data_clear (&files_par[i]);
+		nms_keyfile_reader_file_data_clear (&files_miss[i]);
+		nms_keyfile_reader_file_data_clear (&files_hit[i]);
+		(void) unlink (full_filenames[i]);
+	}
+	(void) unlink (cache_filename);
+	(void) rmdir (dirname);
+}
+
+static void
+test_read_from_files_perf (void)
+{
+	/* by default, only run a small set. Use "-m perf" to time
+	 * reading 1k, 10k and 50k keyfiles, with and without cache. */
+	_read_from_files_perf (g_test_perf () ? 1000 : 200);
+	if (g_test_perf ()) {
+		_read_from_files_perf (10000);
+		_read_from_files_perf (50000);
+	}
+}
+
+static void
+test_cache_volatile_dir (void)
+{
+	gs_free char *dirname_etc = g_strdup_printf ("%s/cache-etc", TEST_SCRATCH_DIR);
+	gs_free char *dirname_run = g_strdup_printf ("%s/cache-run", TEST_SCRATCH_DIR);
+	gs_free char *cache_filename = g_strdup_printf ("%s/cache-volatile.cache", TEST_SCRATCH_DIR);
+	gs_free char *cache_contents = NULL;
+	gsize cache_len;
+	const struct timespec times[2] = {
+		{ .tv_sec = 1500000000, },
+		{ .tv_sec = 1500000000, },
+	};
+	const char *const dirnames[2] = { dirname_etc, dirname_run };
+	char *full_filenames[2];
+	NMSKeyfileReaderFileData files[2] = { };
+	NMSKeyfileCache *cache;
+	guint i;
+
+	for (i = 0; i < 2; i++) {
+		gs_free_error GError *error = NULL;
+		gs_free char *contents = NULL;
+
+		g_assert_cmpint (g_mkdir_with_parents (dirnames[i], 0755), ==, 0);
+		full_filenames[i] = g_strdup_printf ("%s/wifi.nmconnection", dirnames[i]);
+		contents = g_strdup_printf ("[connection]\n"
+		                            "id=cache-%u\n"
+		                            "type=wifi\n"
+		                            "\n"
+		                            "[wifi]\n"
+		                            "ssid=cache-%u\n"
+		                            "\n"
+		                            "[wifi-security]\n"
+		                            "key-mgmt=wpa-psk\n"
+		                            "psk=secret-psk-%u\n",
+		                            i, i, i);
+		if (!g_file_set_contents (full_filenames[i], contents, -1, &error))
+			g_error ("failure to write \"%s\": %s", full_filenames[i], error->message);
+		g_assert_cmpint (utimensat (AT_FDCWD, full_filenames[i], times, 0), ==, 0);
+		files[i].full_filename = full_filenames[i];
+	}
+	(void) unlink (cache_filename);
+
+	cache = nms_keyfile_cache_new (cache_filename, dirname_etc, dirname_run);
+	nms_keyfile_reader_from_files (files, 2, dirname_etc, cache, 1);
+	for (i = 0; i < 2; i++) {
+		g_assert (NM_IS_CONNECTION (files[i].connection));
+		nms_keyfile_cache_add (cache,
+		                       files[i].full_filename,
+		                       files[i].connection,
+		                       &files[i].st,
+		                       files[i].is_nm_generated,
+		                       files[i].is_volatile,
+		                       files[i].shadowed_storage,
+		                       files[i].shadowed_owned,
+		                       files[i].from_cache);
+		nms_keyfile_reader_file_data_clear (&files[i]);
+	}
+	g_assert (nms_keyfile_cache_commit (cache, NULL));
+	nms_keyfile_cache_free (cache);
+
+	/* the profile from the volatile directory has no entry, and
+	 * its secret is not written to disk. */
+	g_assert (g_file_get_contents (cache_filename, &cache_contents, &cache_len, NULL));
+	g_assert (memmem (cache_contents, cache_len, "secret-psk-0", NM_STRLEN ("secret-psk-0")));
+	g_assert (!memmem (cache_contents, cache_len, "secret-psk-1", NM_STRLEN ("secret-psk-1")));
+	g_assert (!memmem (cache_contents, cache_len, full_filenames[1], strlen (full_filenames[1])));
+
+	cache = nms_keyfile_cache_new (cache_filename, dirname_etc, dirname_run);
+	nms_keyfile_reader_from_files (files, 2, dirname_etc, cache, 1);
+	nms_keyfile_cache_free (cache);
+	g_assert (files[0].from_cache);
+	g_assert (!files[1].from_cache);
+	g_assert_cmpstr (nm_connection_get_id (files[1].connection), ==, "cache-1");
+
+	for (i = 0; i < 2; i++) {
+		nms_keyfile_reader_file_data_clear (&files[i]);
+		(void) unlink (full_filenames[i]);
+		(void) rmdir (dirnames[i]);
+		g_free (full_filenames[i]);
+	}
+	(void) unlink (cache_filename);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -2688,5 +2939,8 @@ int main (int argc, char **argv)
 
 	g_test_add_func ("/keyfile/test_nmmeta", test_nmmeta);
 
+	g_test_add_func ("/keyfile/test_read_from_files_perf", test_read_from_files_perf);
+	g_test_add_func ("/keyfile/test_cache_volatile_dir", test_cache_volatile_dir);
+
 	return g_test_run ();
 }
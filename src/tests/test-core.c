@@ -7,6 +7,7 @@
 
 #include <net/if.h>
 #include <byteswap.h>
+#include <fcntl.h>
 
 /* need math.h for isinf() and INFINITY. No need to link with -lm */
 #include <math.h>
@@ -16,7 +17,9 @@
 #include "nm-core-utils.h"
 #include "systemd/nm-sd-utils-core.h"
 
-#include "dns/nm-dns-manager.h"
+#include "dns/nm-dns-manager-private.h"
+#include "nm-device-index.h"
+#include "settings/nm-settings-utils.h"
 #include "nm-connectivity.h"
 
 #include "nm-test-utils-core.h"
@@ -1990,6 +1993,370 @@ test_dns_create_resolv_conf (void)
 
 }
 
+static void
+test_dns_state_hash (void)
+{
+	gs_unref_object NMIP4Config *a = nmtst_ip4_config_new (1);
+	gs_unref_object NMIP4Config *b = nmtst_ip4_config_new (1);
+	gs_unref_object NMIP4Config *c = nmtst_ip4_config_new (2);
+	const NMIPConfig *configs[2];
+	gs_free char *hash_a = NULL;
+	gs_free char *hash_b = NULL;
+
+#define _STATE_HASH(hostname, ...) \
+	({ \
+		const NMIPConfig *const _configs[] = { __VA_ARGS__ }; \
+		\
+		nmtst_dns_state_hash (_configs, G_N_ELEMENTS (_configs), (hostname)); \
+	})
+
+#define _ASSERT_STATE_HASH(equal, hash1, hash2) \
+	G_STMT_START { \
+		gs_free char *_hash1 = (hash1); \
+		gs_free char *_hash2 = (hash2); \
+		\
+		if (equal) \
+			g_assert_cmpstr (_hash1, ==, _hash2); \
+		else \
+			g_assert_cmpstr (_hash1, !=, _hash2); \
+	} G_STMT_END
+
+	nm_ip4_config_add_nameserver (a, nmtst_inet4_from_string ("8.8.8.8"));
+	nm_ip4_config_add_nameserver (b, nmtst_inet4_from_string ("8.8.8.8"));
+	nm_ip4_config_add_nameserver (c, nmtst_inet4_from_string ("8.8.8.8"));
+
+	/* the same content in different instances gives the same state. */
+	_ASSERT_STATE_HASH (TRUE,  _STATE_HASH ("host", NM_IP_CONFIG_CAST (a)), _STATE_HASH ("host", NM_IP_CONFIG_CAST (b)));
+	_ASSERT_STATE_HASH (TRUE,  _STATE_HASH (NULL, NM_IP_CONFIG_CAST (a)), _STATE_HASH ("", NM_IP_CONFIG_CAST (b)));
+
+	/* the interface, the hostname and the order of the configurations matter. */
+	_ASSERT_STATE_HASH (FALSE, _STATE_HASH ("host", NM_IP_CONFIG_CAST (a)), _STATE_HASH ("host", NM_IP_CONFIG_CAST (c)));
+	_ASSERT_STATE_HASH (FALSE, _STATE_HASH ("host", NM_IP_CONFIG_CAST (a)), _STATE_HASH ("host2", NM_IP_CONFIG_CAST (a)));
+	_ASSERT_STATE_HASH (FALSE, _STATE_HASH ("host", NM_IP_CONFIG_CAST (a), NM_IP_CONFIG_CAST (c)),
+	                           _STATE_HASH ("host", NM_IP_CONFIG_CAST (c), NM_IP_CONFIG_CAST (a)));
+
+	/* any DNS parameter changes the state. */
+	nm_ip4_config_add_search (b, "example.com");
+	_ASSERT_STATE_HASH (FALSE, _STATE_HASH ("host", NM_IP_CONFIG_CAST (a)), _STATE_HASH ("host", NM_IP_CONFIG_CAST (b)));
+	nm_ip4_config_add_search (a, "example.com");
+	_ASSERT_STATE_HASH (TRUE,  _STATE_HASH ("host", NM_IP_CONFIG_CAST (a)), _STATE_HASH ("host", NM_IP_CONFIG_CAST (b)));
+
+	nm_ip4_config_set_dns_priority (b, 50);
+	_ASSERT_STATE_HASH (FALSE, _STATE_HASH ("host", NM_IP_CONFIG_CAST (a)), _STATE_HASH ("host", NM_IP_CONFIG_CAST (b)));
+	nm_ip4_config_set_dns_priority (a, 50);
+	_ASSERT_STATE_HASH (TRUE,  _STATE_HASH ("host", NM_IP_CONFIG_CAST (a)), _STATE_HASH ("host", NM_IP_CONFIG_CAST (b)));
+
+	/* the state is stable, so that an update without changes can be skipped. */
+	configs[0] = NM_IP_CONFIG_CAST (a);
+	configs[1] = NM_IP_CONFIG_CAST (c);
+	hash_a = nmtst_dns_state_hash (configs, 2, "host");
+	hash_b = nmtst_dns_state_hash (configs, 2, "host");
+	g_assert_cmpstr (hash_a, ==, hash_b);
+
+#undef _STATE_HASH
+#undef _ASSERT_STATE_HASH
+}
+
+static void
+test_dns_update_delay (void)
+{
+	/* the first update and updates without delay are done right away. */
+	g_assert_cmpint (nmtst_dns_update_delay_msec (0, 1000, 5000), ==, 0);
+	g_assert_cmpint (nmtst_dns_update_delay_msec (5000, 0, 5000), ==, 0);
+
+	/* updates within the window wait until the window ends. */
+	g_assert_cmpint (nmtst_dns_update_delay_msec (5000, 1000, 5000), ==, 1000);
+	g_assert_cmpint (nmtst_dns_update_delay_msec (5000, 1000, 5400), ==, 600);
+	g_assert_cmpint (nmtst_dns_update_delay_msec (5000, 1000, 5999), ==, 1);
+
+	/* and later ones are not delayed. */
+	g_assert_cmpint (nmtst_dns_update_delay_msec (5000, 1000, 6000), ==, 0);
+	g_assert_cmpint (nmtst_dns_update_delay_msec (5000, 1000, 90000), ==, 0);
+}
+
+static void
+_written_content_write (const char *path, const char *content)
+{
+	const struct timespec times[2] = {
+		{ .tv_sec = 1500000000, },
+		{ .tv_sec = 1500000000, },
+	};
+	gs_free_error GError *error = NULL;
+
+	if (!g_file_set_contents (path, content, -1, &error))
+		g_assert_no_error (error);
+
+	/* use an old timestamp, so that a later modification is noticed even
+	 * with a coarse file system clock. */
+	g_assert_cmpint (utimensat (AT_FDCWD, path, times, 0), ==, 0);
+}
+
+static void
+test_dns_written_content (void)
+{
+	const char *const paths[] = { "test-dns-written-content-1.conf",
+	                              "test-dns-written-content-2.conf" };
+	NMDnsWrittenContent wc = { };
+	FILE *f;
+
+	g_assert (!nmtst_dns_written_content_unchanged (&wc, "a"));
+
+	_written_content_write (paths[0], "a");
+	_written_content_write (paths[1], "a");
+	nmtst_dns_written_content_set (&wc, paths, G_N_ELEMENTS (paths), "a");
+	g_assert (nmtst_dns_written_content_unchanged (&wc, "a"));
+	g_assert (!nmtst_dns_written_content_unchanged (&wc, "b"));
+
+	/* another process replaced the file, even with the same content. */
+	_written_content_write (paths[1], "a");
+	g_assert (!nmtst_dns_written_content_unchanged (&wc, "a"));
+
+	/* another process modified the file in place. */
+	nmtst_dns_written_content_set (&wc, paths, G_N_ELEMENTS (paths), "a");
+	g_assert (nmtst_dns_written_content_unchanged (&wc, "a"));
+	f = fopen (paths[0], "we");
+	g_assert (f);
+	g_assert_cmpint (fputs ("b", f), >=, 0);
+	g_assert_cmpint (fclose (f), ==, 0);
+	g_assert (!nmtst_dns_written_content_unchanged (&wc, "a"));
+
+	/* another process deleted the file. */
+	nmtst_dns_written_content_set (&wc, paths, G_N_ELEMENTS (paths), "a");
+	g_assert (nmtst_dns_written_content_unchanged (&wc, "a"));
+	g_assert_cmpint (unlink (paths[1]), ==, 0);
+	g_assert (!nmtst_dns_written_content_unchanged (&wc, "a"));
+
+	/* when a file is missing after writing, nothing is remembered. */
+	nmtst_dns_written_content_set (&wc, paths, G_N_ELEMENTS (paths), "a");
+	g_assert (!wc.content);
+	g_assert (!nmtst_dns_written_content_unchanged (&wc, "a"));
+
+	/* without files, only the content is compared. */
+	nmtst_dns_written_content_set (&wc, paths, 0, "a");
+	g_assert (nmtst_dns_written_content_unchanged (&wc, "a"));
+	g_assert (!nmtst_dns_written_content_unchanged (&wc, "b"));
+
+	g_free (wc.content);
+	unlink (paths[0]);
+}
+
+/*****************************************************************************/
+
+static void
+_device_index_assert (const GPtrArray *devices, guint n, ...)
+{
+	va_list ap;
+	guint i;
+
+	if (n == 0) {
+		g_assert (!devices);
+		return;
+	}
+
+	g_assert (devices);
+	g_assert_cmpint (devices->len, ==, n);
+	va_start (ap, n);
+	for (i = 0; i < n; i++)
+		g_assert (devices->pdata[i] == va_arg (ap, NMDevice *));
+	va_end (ap);
+}
+
+static void
+test_device_index (void)
+{
+	NMDeviceIndex *idx;
+	char dummy[3];
+	NMDevice *dev0 = (NMDevice *) &dummy[0];
+	NMDevice *dev1 = (NMDevice *) &dummy[1];
+	NMDevice *dev2 = (NMDevice *) &dummy[2];
+
+	idx = nm_device_index_new ();
+
+	nm_device_index_add (idx, dev0);
+	nm_device_index_add (idx, dev1);
+	g_assert_cmpint (nm_device_index_get_size (idx), ==, 2);
+
+	/* devices without keys are not found. */
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth0"), 0);
+	_device_index_assert (nm_device_index_lookup_ifindex (idx, 0), 0);
+
+	/* an unrealized device has an interface name, but no ifindex. */
+	nm_device_index_update (idx, dev0, 0, "eth0", NULL, NULL);
+	nm_device_index_update (idx, dev1, 5, "eth0", "eth0", "00:11:22:33:44:55");
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth0"), 2, dev0, dev1);
+	_device_index_assert (nm_device_index_lookup_ip_iface (idx, "eth0"), 1, dev1);
+	_device_index_assert (nm_device_index_lookup_ifindex (idx, 5), 1, dev1);
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "00:11:22:33:44:55"), 1, dev1);
+
+	/* the MAC address is matched in any notation. */
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "00:11:22:AA:BB:CC"), 0);
+	nm_device_index_update (idx, dev1, 5, "eth0", "eth0", "00:11:22:aa:bb:cc");
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "00:11:22:AA:BB:CC"), 1, dev1);
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "00:11:22:33:44:55"), 0);
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "not-a-mac"), 0);
+
+	/* ifindex change. */
+	nm_device_index_update (idx, dev1, 7, "eth0", "eth0", "00:11:22:aa:bb:cc");
+	_device_index_assert (nm_device_index_lookup_ifindex (idx, 5), 0);
+	_device_index_assert (nm_device_index_lookup_ifindex (idx, 7), 1, dev1);
+
+	/* iface change. */
+	nm_device_index_update (idx, dev1, 7, "eth1", "eth0", "00:11:22:aa:bb:cc");
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth0"), 1, dev0);
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth1"), 1, dev1);
+
+	/* ip-iface change, e.g. a PPP interface on top of a modem. */
+	nm_device_index_update (idx, dev1, 7, "eth1", "ppp0", "00:11:22:aa:bb:cc");
+	_device_index_assert (nm_device_index_lookup_ip_iface (idx, "eth0"), 0);
+	_device_index_assert (nm_device_index_lookup_ip_iface (idx, "ppp0"), 1, dev1);
+
+	/* a device that is added later gets appended to the existing key. */
+	nm_device_index_add (idx, dev2);
+	nm_device_index_update (idx, dev2, 9, "eth1", "eth1", "00:11:22:aa:bb:cc");
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth1"), 2, dev1, dev2);
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "00:11:22:aa:bb:cc"), 2, dev1, dev2);
+
+	/* after removal, the device is gone from all indexes. */
+	nm_device_index_remove (idx, dev1);
+	g_assert_cmpint (nm_device_index_get_size (idx), ==, 2);
+	_device_index_assert (nm_device_index_lookup_ifindex (idx, 7), 0);
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth1"), 1, dev2);
+	_device_index_assert (nm_device_index_lookup_ip_iface (idx, "ppp0"), 0);
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "00:11:22:aa:bb:cc"), 1, dev2);
+
+	/* updating a device that is not tracked does nothing. */
+	nm_device_index_update (idx, dev1, 7, "eth1", "ppp0", NULL);
+	_device_index_assert (nm_device_index_lookup_ifindex (idx, 7), 0);
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth1"), 1, dev2);
+
+	/* losing the keys, e.g. when a device gets unrealized. */
+	nm_device_index_update (idx, dev2, 0, "eth1", NULL, NULL);
+	_device_index_assert (nm_device_index_lookup_ifindex (idx, 9), 0);
+	_device_index_assert (nm_device_index_lookup_ip_iface (idx, "eth1"), 0);
+	_device_index_assert (nm_device_index_lookup_perm_hw_addr (idx, "00:11:22:aa:bb:cc"), 0);
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth1"), 1, dev2);
+
+	nm_device_index_remove (idx, dev0);
+	nm_device_index_remove (idx, dev2);
+	g_assert_cmpint (nm_device_index_get_size (idx), ==, 0);
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth0"), 0);
+	_device_index_assert (nm_device_index_lookup_iface (idx, "eth1"), 0);
+
+	nm_device_index_free (idx);
+}
+
+/*****************************************************************************/
+
+static void
+_autoconnect_cache_set (NMSettUtilAutoconnectCache *cache,
+                        guint generation,
+                        NMSettingsConnection *const*profiles,
+                        const char *const*connection_types,
+                        const char *const*ifnames,
+                        guint len)
+{
+	nm_sett_util_autoconnect_cache_set (cache,
+	                                    generation,
+	                                    nm_memdup (profiles, sizeof (NMSettingsConnection *) * (len + 1)),
+	                                    len,
+	                                    connection_types,
+	                                    ifnames);
+	g_assert (nm_sett_util_autoconnect_cache_is_valid (cache, generation));
+}
+
+#define _autoconnect_cache_assert(cache, connection_type, ifname, ...) \
+	G_STMT_START { \
+		NMSettingsConnection *const _expected[] = { __VA_ARGS__ }; \
+		gs_free NMSettingsConnection **_list = NULL; \
+		guint _len; \
+		guint _i; \
+		\
+		_list = nm_sett_util_autoconnect_cache_lookup ((cache), (connection_type), (ifname), &_len); \
+		g_assert (_list); \
+		g_assert_cmpint (_len, ==, G_N_ELEMENTS (_expected) - 1); \
+		for (_i = 0; _i < _len; _i++) \
+			g_assert (_list[_i] == _expected[_i]); \
+		g_assert (!_list[_len]); \
+	} G_STMT_END
+
+static void
+test_settings_autoconnect_cache (void)
+{
+	NMSettUtilAutoconnectCache cache = { };
+	char dummy[5];
+	NMSettingsConnection *p0 = (NMSettingsConnection *) &dummy[0];
+	NMSettingsConnection *p1 = (NMSettingsConnection *) &dummy[1];
+	NMSettingsConnection *p2 = (NMSettingsConnection *) &dummy[2];
+	NMSettingsConnection *p3 = (NMSettingsConnection *) &dummy[3];
+	NMSettingsConnection *p4 = (NMSettingsConnection *) &dummy[4];
+
+	g_assert (!nm_sett_util_autoconnect_cache_is_valid (&cache, 0));
+
+	/* initial profiles, sorted by autoconnect priority. */
+	{
+		NMSettingsConnection *const profiles[] = { p0, p1, p2, p3, NULL };
+		const char *const types[]              = { "802-3-ethernet", "802-3-ethernet", "802-11-wireless", "802-3-ethernet" };
+		const char *const ifnames[]            = { "eth0",           NULL,             "wlan0",           "eth1"           };
+
+		_autoconnect_cache_set (&cache, 1, profiles, types, ifnames, 4);
+	}
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "eth0", p0, p1, NULL);
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "eth1", p1, p3, NULL);
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "eth2", p1, NULL);
+	_autoconnect_cache_assert (&cache, "802-11-wireless", "wlan0", p2, NULL);
+	_autoconnect_cache_assert (&cache, "802-11-wireless", "eth0", NULL);
+	_autoconnect_cache_assert (&cache, NULL, "wlan0", p1, p2, NULL);
+	_autoconnect_cache_assert (&cache, NULL, "", p1, NULL);
+
+	/* a profile changed: the generation counter moves on and the
+	 * cached list must be rebuilt. */
+	g_assert (nm_sett_util_autoconnect_cache_is_valid (&cache, 1));
+	g_assert (!nm_sett_util_autoconnect_cache_is_valid (&cache, 2));
+
+	/* update: p3 moves to eth0, p2 changes its type and p1 gets an
+	 * interface-name. p3 now has the highest priority. */
+	{
+		NMSettingsConnection *const profiles[] = { p3, p0, p1, p2, NULL };
+		const char *const types[]              = { "802-3-ethernet", "802-3-ethernet", "802-3-ethernet", "802-3-ethernet" };
+		const char *const ifnames[]            = { "eth0",           "eth0",           "eth2",           "wlan0"          };
+
+		_autoconnect_cache_set (&cache, 2, profiles, types, ifnames, 4);
+	}
+	g_assert (!nm_sett_util_autoconnect_cache_is_valid (&cache, 1));
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "eth0", p3, p0, NULL);
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "eth1", NULL);
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "eth2", p1, NULL);
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "wlan0", p2, NULL);
+	_autoconnect_cache_assert (&cache, "802-11-wireless", "wlan0", NULL);
+	_autoconnect_cache_assert (&cache, NULL, "", NULL);
+
+	/* adding or removing a profile drops the cache. */
+	nm_sett_util_autoconnect_cache_clear (&cache);
+	g_assert (!nm_sett_util_autoconnect_cache_is_valid (&cache, 2));
+
+	/* remove p0, add p4 without interface-name. */
+	{
+		NMSettingsConnection *const profiles[] = { p3, p4, p1, p2, NULL };
+		const char *const types[]              = { "802-3-ethernet", "802-3-ethernet", "802-3-ethernet", "802-3-ethernet" };
+		const char *const ifnames[]            = { "eth0",           NULL,             "eth2",           "wlan0"          };
+
+		_autoconnect_cache_set (&cache, 2, profiles, types, ifnames, 4);
+	}
+	_autoconnect_cache_assert (&cache, "802-3-ethernet", "eth0", p3, p4, NULL);
+	_autoconnect_cache_assert (&cache, NULL, "eth2", p4, p1, NULL);
+	_autoconnect_cache_assert (&cache, NULL, "", p4, NULL);
+
+	/* no profiles at all. */
+	{
+		NMSettingsConnection *const profiles[] = { NULL };
+
+		_autoconnect_cache_set (&cache, 3, profiles, NULL, NULL, 0);
+	}
+	_autoconnect_cache_assert (&cache, NULL, "eth0", NULL);
+
+	nm_sett_util_autoconnect_cache_clear (&cache);
+}
+
 /*****************************************************************************/
 
 static void
@@ -2224,6 +2591,11 @@ main (int argc, char **argv)
 	g_test_add_func ("/general/test_utils_file_is_in_path", test_utils_file_is_in_path);
 
 	g_test_add_func ("/general/test_dns_create_resolv_conf", test_dns_create_resolv_conf);
+	g_test_add_func ("/general/test_dns_state_hash", test_dns_state_hash);
+	g_test_add_func ("/general/test_dns_update_delay", test_dns_update_delay);
+	g_test_add_func ("/general/test_dns_written_content", test_dns_written_content);
+	g_test_add_func ("/general/test_device_index", test_device_index);
+	g_test_add_func ("/general/test_settings_autoconnect_cache", test_settings_autoconnect_cache);
 
 	g_test_add_data_func ("/general/nm_utils_dhcp_client_id_systemd_node_specific/0", GINT_TO_POINTER (0), test_nm_utils_dhcp_client_id_systemd_node_specific);
 	g_test_add_data_func ("/general/nm_utils_dhcp_client_id_systemd_node_specific/1", GINT_TO_POINTER (1), test_nm_utils_dhcp_client_id_systemd_node_specific);
@@ -9,6 +9,7 @@
 
 #include "nm-ip4-config.h"
 #include "platform/nm-platform.h"
+#include "platform/nm-fake-platform.h"
 
 #include "nm-test-utils-core.h"
 
@@ -357,6 +358,189 @@ test_strip_search_trailing_dot (void)
 	g_object_unref (config);
 }
 
+static void
+test_fingerprint (void)
+{
+	gs_unref_object NMIP4Config *a = NULL;
+	gs_unref_object NMIP4Config *b = NULL;
+	gs_unref_object NMIP4Config *empty = NULL;
+	NMPlatformIP4Route route;
+	guint64 fingerprint;
+	guint i;
+
+	empty = nmtst_ip4_config_new (1);
+	g_assert (nm_ip4_config_equal (empty, NULL));
+	g_assert_cmpuint (nm_ip4_config_get_fingerprint (empty, TRUE), ==, 0);
+
+	a = build_test_config ();
+	b = build_test_config ();
+	g_assert (nm_ip4_config_equal (a, b));
+	g_assert (!nm_ip4_config_equal (a, empty));
+	g_assert_cmpuint (nm_ip4_config_get_fingerprint (a, TRUE), !=, 0);
+
+	/* the same routes in reverse order give the same fingerprint. */
+	for (i = 0; i < 100; i++) {
+		route = *nmtst_platform_ip4_route (nm_sprintf_bufa (32, "10.%u.0.0", i), 16, "192.168.1.1");
+		nm_ip4_config_add_route (a, &route, NULL);
+	}
+	for (i = 100; i > 0; i--) {
+		route = *nmtst_platform_ip4_route (nm_sprintf_bufa (32, "10.%u.0.0", i - 1), 16, "192.168.1.1");
+		nm_ip4_config_add_route (b, &route, NULL);
+	}
+	g_assert (nm_ip4_config_equal (a, b));
+
+	/* a route with a different gateway changes the fingerprint. */
+	fingerprint = nm_ip4_config_get_fingerprint (a, FALSE);
+	route = *nmtst_platform_ip4_route ("10.7.0.0", 16, "192.168.1.2");
+	nm_ip4_config_add_route (a, &route, NULL);
+	g_assert_cmpuint (nm_ip4_config_get_fingerprint (a, FALSE), !=, fingerprint);
+	g_assert (!nm_ip4_config_equal (a, b));
+	nm_ip4_config_add_route (b, &route, NULL);
+	g_assert (nm_ip4_config_equal (a, b));
+
+	/* removing routes and DNS parameters */
+	_nmtst_ip4_config_del_route (a, 0);
+	g_assert (!nm_ip4_config_equal (a, b));
+	nm_ip4_config_reset_routes (a);
+	nm_ip4_config_reset_routes (b);
+	g_assert (nm_ip4_config_equal (a, b));
+
+	fingerprint = nm_ip4_config_get_fingerprint (a, TRUE);
+	nm_ip4_config_add_nameserver (a, nmtst_inet4_from_string ("8.8.8.8"));
+	g_assert (!nm_ip4_config_equal (a, b));
+	nm_ip4_config_del_nameserver (a, nm_ip4_config_get_num_nameservers (a) - 1);
+	g_assert (nm_ip4_config_equal (a, b));
+	g_assert_cmpuint (nm_ip4_config_get_fingerprint (a, TRUE), ==, fingerprint);
+}
+
+/*****************************************************************************/
+
+static void
+_assert_routes_equal (const NMIP4Config *a, const NMIP4Config *b)
+{
+	NMDedupMultiIter ipconf_iter;
+	const NMPlatformIP4Route *route;
+	const NMPObject *o;
+
+	g_assert_cmpuint (nm_ip4_config_get_num_routes (a), ==, nm_ip4_config_get_num_routes (b));
+	nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, a, &route) {
+		o = nm_ip4_config_nmpobj_lookup (b, NMP_OBJECT_UP_CAST (route));
+		g_assert (o);
+		g_assert (nmp_object_equal (o, NMP_OBJECT_UP_CAST (route)));
+	}
+	g_assert (nm_ip4_config_equal (a, b));
+}
+
+static NMPObject *
+_route_delta_add (NMPlatform *platform,
+                  int ifindex,
+                  const char *network,
+                  guint plen,
+                  guint metric,
+                  guint mss)
+{
+	NMPlatformIP4Route route;
+
+	route = *nmtst_platform_ip4_route_full (network, plen, NULL, ifindex,
+	                                        NM_IP_CONFIG_SOURCE_USER,
+	                                        metric, mss, 0, NULL);
+	g_assert (nm_platform_ip4_route_add (platform, NMP_NLM_FLAG_REPLACE, &route) >= 0);
+	return nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &route);
+}
+
+static gboolean
+_route_delta_exclude (const NMPObject *obj, gpointer user_data)
+{
+	return nm_ip4_config_nmpobj_lookup (user_data, obj) != NULL;
+}
+
+static void
+test_route_delta_apply (void)
+{
+	NMPlatform *platform = NM_PLATFORM_GET;
+	NMDedupMultiIndex *multi_idx = nm_platform_get_multi_idx (platform);
+	gs_unref_object NMIP4Config *config = NULL;
+	gs_unref_object NMIP4Config *captured = NULL;
+	gs_unref_object NMIP4Config *internal = NULL;
+	gs_unref_ptrarray GPtrArray *delta = NULL;
+	const NMPlatformLink *link;
+	const NMPObject *plobj;
+	NMPObject *obj;
+	int ifindex;
+	int ifindex_other;
+	guint i;
+
+	g_assert (nm_platform_link_dummy_add (platform, "delta0", &link) >= 0);
+	ifindex = link->ifindex;
+	g_assert (nm_platform_link_dummy_add (platform, "delta1", &link) >= 0);
+	ifindex_other = link->ifindex;
+
+	for (i = 0; i < 5; i++)
+		nmp_object_unref (_route_delta_add (platform, ifindex, nm_sprintf_bufa (32, "10.%u.0.0", i), 16, 100, 0));
+
+	config = nm_ip4_config_capture (multi_idx, platform, ifindex);
+	g_assert_cmpuint (nm_ip4_config_get_num_routes (config), ==, 5);
+
+	delta = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+
+	/* add new routes, delete and modify existing ones. A route that is added
+	 * and deleted again before the delta is applied is also tracked. */
+	g_ptr_array_add (delta, _route_delta_add (platform, ifindex, "10.5.0.0", 16, 100, 0));
+	g_ptr_array_add (delta, _route_delta_add (platform, ifindex, "10.6.0.0", 16, 100, 0));
+	g_ptr_array_add (delta, _route_delta_add (platform, ifindex, "10.0.0.0", 16, 100, 1400));
+	g_ptr_array_add (delta, _route_delta_add (platform, ifindex, "10.1.0.0", 16, 200, 0));
+	g_ptr_array_add (delta, _route_delta_add (platform, ifindex, "10.7.0.0", 16, 100, 0));
+	g_assert (nm_platform_object_delete (platform, delta->pdata[delta->len - 1]));
+	obj = _route_delta_add (platform, ifindex, "10.2.0.0", 16, 100, 0);
+	g_assert (nm_platform_object_delete (platform, obj));
+	g_ptr_array_add (delta, obj);
+
+	/* routes on other interfaces never show up. */
+	g_ptr_array_add (delta, _route_delta_add (platform, ifindex_other, "10.8.0.0", 16, 100, 0));
+
+	for (i = 0; i < delta->len; i++) {
+		nm_ip_config_route_delta_apply (NM_IP_CONFIG_CAST (config),
+		                                platform,
+		                                delta->pdata[i],
+		                                NULL,
+		                                NULL,
+		                                &plobj);
+		g_assert ((!!plobj) == (i < 4));
+	}
+
+	captured = nm_ip4_config_capture (multi_idx, platform, ifindex);
+	g_assert_cmpuint (nm_ip4_config_get_num_routes (captured), ==, 7);
+	_assert_routes_equal (config, captured);
+
+	/* applying the same changes again is a no-op. */
+	for (i = 0; i < delta->len; i++) {
+		g_assert (!nm_ip_config_route_delta_apply (NM_IP_CONFIG_CAST (config),
+		                                           platform,
+		                                           delta->pdata[i],
+		                                           NULL,
+		                                           NULL,
+		                                           NULL));
+	}
+	_assert_routes_equal (config, captured);
+
+	/* excluded routes are removed, like subtracting the internal configuration
+	 * from a full capture. */
+	internal = nm_ip4_config_new (multi_idx, ifindex);
+	nm_ip4_config_add_route (internal, NMP_OBJECT_CAST_IP4_ROUTE (delta->pdata[0]), NULL);
+	g_assert (nm_ip_config_route_delta_apply (NM_IP_CONFIG_CAST (config),
+	                                          platform,
+	                                          delta->pdata[0],
+	                                          _route_delta_exclude,
+	                                          internal,
+	                                          &plobj));
+	g_assert (plobj);
+	nm_ip4_config_subtract (captured, internal, 0);
+	_assert_routes_equal (config, captured);
+
+	nm_platform_link_delete (platform, ifindex);
+	nm_platform_link_delete (platform, ifindex_other);
+}
+
 /*****************************************************************************/
 
 NMTST_DEFINE ();
@@ -366,6 +550,8 @@ main (int argc, char **argv)
 {
 	nmtst_init_with_logging (&argc, &argv, NULL, "DEFAULT");
 
+	nm_fake_platform_setup ();
+
 	g_test_add_func ("/ip4-config/replace", test_replace);
 	g_test_add_func ("/ip4-config/subtract", test_subtract);
 	g_test_add_func ("/ip4-config/compare-with-source", test_compare_with_source);
@@ -373,6 +559,8 @@ main (int argc, char **argv)
 	g_test_add_func ("/ip4-config/add-route-with-source", test_add_route_with_source);
 	g_test_add_func ("/ip4-config/merge-subtract-mtu", test_merge_subtract_mtu);
 	g_test_add_func ("/ip4-config/strip-search-trailing-dot", test_strip_search_trailing_dot);
+	g_test_add_func ("/ip4-config/fingerprint", test_fingerprint);
+	g_test_add_func ("/ip4-config/route-delta-apply", test_route_delta_apply);
 
 	return g_test_run ();
 }
@@ -392,6 +392,9 @@ class BusErr:
     class UserCanceledException(dbus.DBusException):
         _dbus_error_name = IFACE_AGENT_MANAGER + '.UserCanceled'
 
+    class SettingsFailedException(dbus.DBusException):
+        _dbus_error_name = IFACE_SETTINGS + '.Failed'
+
     @staticmethod
     def from_nmerror(e):
         try:
@@ -1528,6 +1531,14 @@ class NetworkManager(ExportedObj):
         assert(len(cons) == 1)
         cons[0].SetVisible(vis)
 
+    @dbus.service.method(dbus_interface=IFACE_TEST, in_signature='', out_signature='uu')
+    def GetSettingsCallCounts(self):
+        return (gl.settings.get_settings_calls, gl.settings.get_all_settings_calls)
+
+    @dbus.service.method(dbus_interface=IFACE_TEST, in_signature='b', out_signature='')
+    def SetGetAllSettingsFail(self, fail):
+        gl.settings.get_all_settings_fail = fail
+
     @dbus.service.method(dbus_interface=IFACE_TEST, in_signature='', out_signature='')
     def Restart(self):
         gl.bus.release_name("org.freedesktop.NetworkManager")
@@ -1594,6 +1605,7 @@ class Connection(ExportedObj):
 
     @dbus.service.method(dbus_interface=IFACE_CONNECTION, in_signature='', out_signature='a{sa{sv}}')
     def GetSettings(self):
+        gl.settings.get_settings_calls += 1
         if hasattr(self, '_remove_next_connection_cb'):
             self._remove_next_connection_cb()
             raise BusErr.UnknownConnectionException("Connection not found")
@@ -1640,6 +1652,9 @@ class Settings(ExportedObj):
         self.connections = {}
         self.c_counter = 0
         self.remove_next_connection = False
+        self.get_settings_calls = 0
+        self.get_all_settings_calls = 0
+        self.get_all_settings_fail = False
 
         props = {
             PRP_SETTINGS_HOSTNAME:    "foobar.baz",
@@ -1682,6 +1697,21 @@ class Settings(ExportedObj):
     def ListConnections(self):
         return self.get_connection_paths()
 
+    @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='ao', out_signature='a{oa{sa{sv}}}')
+    def GetAllSettings(self, paths):
+        self.get_all_settings_calls += 1
+        if self.get_all_settings_fail:
+            raise BusErr.SettingsFailedException('GetAllSettings failed')
+        if not paths:
+            paths = self.get_connection_paths()
+        settings = {}
+        for path in paths:
+            con_inst = self.connections.get(path)
+            if con_inst is None or not con_inst.visible:
+                continue
+            settings[path] = con_inst.con_hash
+        return settings
+
     @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='a{sa{sv}}', out_signature='o')
     def AddConnection(self, con_hash):
         return self.add_connection(con_hash)